@@ -0,0 +1,252 @@
+/*
+* FILE          : Backorder.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of the backorder demand index including:
+*      - Doubly linked lists threaded through per-order arrays, so adding
+*        and removing an order is constant time
+*      - Part ID lookup through the record ID index
+*/
+
+#include "Backorder.h"
+#include <stdlib.h>
+
+//
+// FUNCTION    : backorderInit
+// DESCRIPTION : Prepares an empty index that is not bound to a store
+// PARAMETERS  :
+//      BackorderIndex* index : Index to initialize
+// RETURNS     : void
+//
+void backorderInit(BackorderIndex* index) {
+    index->partLists.slots = NULL;
+    index->partLists.capacity = 0;
+    index->listHead = NULL;
+    index->listCapacity = 0;
+    index->next = NULL;
+    index->prev = NULL;
+    index->waitList = NULL;
+    index->orderCapacity = 0;
+    backorderReset(index, NULL);
+}
+
+//
+// FUNCTION    : backorderReset
+// DESCRIPTION : Empties an index and binds it to an order store. Memory is
+//               kept for reuse.
+// PARAMETERS  :
+//      BackorderIndex* index : Index to reset
+//      const void* base      : Order store the positions will refer to
+// RETURNS     : void
+//
+void backorderReset(BackorderIndex* index, const void* base) {
+    idIndexReset(&index->partLists, NULL, 0);
+    index->listCount = 0;
+    for (int i = 0; i < index->orderCapacity; i++) {
+        index->waitList[i] = BACKORDER_NONE;
+    }
+    index->waiting = 0;
+    index->base = base;
+}
+
+//
+// FUNCTION    : backorderFree
+// DESCRIPTION : Releases index memory and leaves the index empty and unbound
+// PARAMETERS  :
+//      BackorderIndex* index : Index to free
+// RETURNS     : void
+//
+void backorderFree(BackorderIndex* index) {
+    idIndexFree(&index->partLists);
+    free(index->listHead);
+    free(index->next);
+    free(index->prev);
+    free(index->waitList);
+    backorderInit(index);
+}
+
+//
+// FUNCTION    : growOrders
+// DESCRIPTION : Makes room for an order position in the per-order arrays
+// PARAMETERS  :
+//      BackorderIndex* index : Index to grow
+//      int position          : Position that must fit
+// RETURNS     : bool - false if out of memory
+//
+static bool growOrders(BackorderIndex* index, int position) {
+    if (position < index->orderCapacity) return true;
+
+    int capacity = index->orderCapacity > 0 ? index->orderCapacity : BACKORDER_MIN_ENTRIES;
+    while (capacity <= position) capacity *= 2;
+
+    int* next = (int*)realloc(index->next, sizeof(int) * (size_t)capacity);
+    if (next == NULL) return false;
+    index->next = next;
+
+    int* prev = (int*)realloc(index->prev, sizeof(int) * (size_t)capacity);
+    if (prev == NULL) return false;
+    index->prev = prev;
+
+    int* waitList = (int*)realloc(index->waitList, sizeof(int) * (size_t)capacity);
+    if (waitList == NULL) return false;
+    index->waitList = waitList;
+
+    for (int i = index->orderCapacity; i < capacity; i++) {
+        index->waitList[i] = BACKORDER_NONE;
+    }
+    index->orderCapacity = capacity;
+    return true;
+}
+
+//
+// FUNCTION    : findList
+// DESCRIPTION : Looks up the list of a part, creating it if asked
+// PARAMETERS  :
+//      BackorderIndex* index : Index to search
+//      long long partID      : Part ID
+//      bool create           : Add an empty list if the part has none
+// RETURNS     : int - List number, BACKORDER_NONE if absent or out of memory
+//
+static int findList(BackorderIndex* index, long long partID, bool create) {
+    int list = idIndexFind(&index->partLists, partID);
+    if (list != -1 || !create) return list != -1 ? list : BACKORDER_NONE;
+
+    if (index->listCount == index->listCapacity) {
+        int capacity = index->listCapacity > 0 ? index->listCapacity * 2 : BACKORDER_MIN_ENTRIES;
+        int* listHead = (int*)realloc(index->listHead, sizeof(int) * (size_t)capacity);
+        if (listHead == NULL) return BACKORDER_NONE;
+
+        index->listHead = listHead;
+        index->listCapacity = capacity;
+    }
+
+    if (!idIndexInsert(&index->partLists, partID, index->listCount)) return BACKORDER_NONE;
+    index->listHead[index->listCount] = BACKORDER_NONE;
+    return index->listCount++;
+}
+
+//
+// FUNCTION    : backorderAdd
+// DESCRIPTION : Puts an order at the end of a part's list. An order that
+//               already waits on another part is moved.
+// PARAMETERS  :
+//      BackorderIndex* index : Index to add to
+//      long long partID      : Part the order waits on
+//      int position          : Store position of the order
+// RETURNS     : bool - false if out of memory
+//
+bool backorderAdd(BackorderIndex* index, long long partID, int position) {
+    if (!growOrders(index, position)) return false;
+    backorderRemove(index, position);
+
+    int list = findList(index, partID, true);
+    if (list == BACKORDER_NONE) return false;
+
+    // Lists are circular through prev, so the head's prev is the tail
+    int head = index->listHead[list];
+    if (head == BACKORDER_NONE) {
+        index->listHead[list] = position;
+        index->prev[position] = position;
+    }
+    else {
+        int tail = index->prev[head];
+        index->next[tail] = position;
+        index->prev[position] = tail;
+        index->prev[head] = position;
+    }
+    index->next[position] = BACKORDER_NONE;
+    index->waitList[position] = list;
+    index->waiting++;
+    return true;
+}
+
+//
+// FUNCTION    : backorderRemove
+// DESCRIPTION : Takes an order off the list it waits in, if any
+// PARAMETERS  :
+//      BackorderIndex* index : Index to update
+//      int position          : Store position of the order
+// RETURNS     : void
+//
+void backorderRemove(BackorderIndex* index, int position) {
+    if (position >= index->orderCapacity || index->waitList[position] == BACKORDER_NONE) return;
+
+    int list = index->waitList[position];
+    int head = index->listHead[list];
+    int before = index->prev[position];
+    int after = index->next[position];
+
+    if (position == head) {
+        index->listHead[list] = after;
+        if (after != BACKORDER_NONE) index->prev[after] = before;
+    }
+    else {
+        index->next[before] = after;
+        if (after != BACKORDER_NONE) index->prev[after] = before;
+        else index->prev[head] = before;
+    }
+
+    index->waitList[position] = BACKORDER_NONE;
+    index->waiting--;
+}
+
+//
+// FUNCTION    : backorderTakeList
+// DESCRIPTION : Detaches every order of a list. The orders no longer wait;
+//               walk them with backorderNext before adding any back.
+// PARAMETERS  :
+//      BackorderIndex* index : Index to take from
+//      int list              : List number
+// RETURNS     : int - First order of the list, BACKORDER_NONE if empty
+//
+int backorderTakeList(BackorderIndex* index, int list) {
+    int head = index->listHead[list];
+    index->listHead[list] = BACKORDER_NONE;
+
+    for (int i = head; i != BACKORDER_NONE; i = index->next[i]) {
+        index->waitList[i] = BACKORDER_NONE;
+        index->waiting--;
+    }
+    return head;
+}
+
+//
+// FUNCTION    : backorderTake
+// DESCRIPTION : Detaches every order waiting on a part
+// PARAMETERS  :
+//      BackorderIndex* index : Index to take from
+//      long long partID      : Restocked part
+// RETURNS     : int - First order of the list, BACKORDER_NONE if none wait
+//
+int backorderTake(BackorderIndex* index, long long partID) {
+    int list = findList(index, partID, false);
+    return list != BACKORDER_NONE ? backorderTakeList(index, list) : BACKORDER_NONE;
+}
+
+//
+// FUNCTION    : backorderWaiting
+// DESCRIPTION : Tells whether any order waits on a part, without changing
+//               the index
+// PARAMETERS  :
+//      const BackorderIndex* index : Index to search
+//      long long partID            : Part ID
+// RETURNS     : bool - true if the part's list has an order in it
+//
+bool backorderWaiting(const BackorderIndex* index, long long partID) {
+    int list = idIndexFind(&index->partLists, partID);
+    return list != -1 && index->listHead[list] != BACKORDER_NONE;
+}
+
+//
+// FUNCTION    : backorderNext
+// DESCRIPTION : Steps through a detached list
+// PARAMETERS  :
+//      const BackorderIndex* index : Index the list came from
+//      int position                : Current order
+// RETURNS     : int - Next order, BACKORDER_NONE at the end
+//
+int backorderNext(const BackorderIndex* index, int position) {
+    return index->next[position];
+}
@@ -0,0 +1,48 @@
+/*
+* FILE          : Backorder.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for the backorder demand index including:
+*      - One list of waiting orders per part ID
+*      - Function prototypes for adding, removing and taking waiting orders
+*      An order waits on one part at a time: a part it was short of. When
+*      that part is restocked the order is taken off the list and checked
+*      again, and waits on its next short part if it still cannot be filled.
+*/
+
+#ifndef BACKORDER_H
+#define BACKORDER_H
+
+#include "IdIndex.h"
+
+#define BACKORDER_NONE -1           // End of a list / order not waiting
+#define BACKORDER_MIN_ENTRIES 64    // Smallest array allocated
+
+// Waiting orders of one order store, listed by the part they wait on
+typedef struct {
+    IdIndex partLists;          // Part ID -> list number
+    int* listHead;              // First waiting order of each list
+    int listCount;              // Lists in use
+    int listCapacity;           // Lists allocated
+    int* next;                  // Next order in the same list, per order position
+    int* prev;                  // Previous order in the same list, per order position
+    int* waitList;              // List each order waits in, BACKORDER_NONE if not waiting
+    int orderCapacity;          // Order positions allocated
+    int waiting;                // Orders in all lists
+    const void* base;           // Order store the positions refer to
+} BackorderIndex;
+
+// Function prototypes
+void backorderInit(BackorderIndex* index);                                 // Prepare an empty, unbound index
+void backorderReset(BackorderIndex* index, const void* base);              // Empty index and bind it to a store
+void backorderFree(BackorderIndex* index);                                 // Release index memory
+bool backorderAdd(BackorderIndex* index, long long partID, int position);  // Make an order wait on a part
+void backorderRemove(BackorderIndex* index, int position);                 // Stop an order waiting
+int backorderTake(BackorderIndex* index, long long partID);                // Detach a part's list, returns first order
+int backorderTakeList(BackorderIndex* index, int list);                    // Detach a list by number, returns first order
+int backorderNext(const BackorderIndex* index, int position);              // Next order of a detached list
+bool backorderWaiting(const BackorderIndex* index, long long partID);      // Some order waits on a part
+
+#endif
@@ -0,0 +1,341 @@
+/*
+* FILE          : Checkpoint.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of background checkpoints including:
+*      - Copying the chunks changed since the last checkpoint
+*      - Background thread saving the copies to their snapshots
+*      - Dropping the saved records from the write-ahead log
+*      - Index files saved with the snapshots under lazy start-up
+*      The copies are only written by checkpointTake and only read by the
+*      saver, never both at once, so the saver needs no store locks. Its
+*      snapshots hold every change logged before the position recorded
+*      when the copies were taken; the log keeps everything after it.
+*/
+
+#include "Checkpoint.h"
+#include "Customer.h"
+#include "Part.h"
+#include "Order.h"
+#include "Snapshot.h"
+#include "System.h"
+#include "Wal.h"
+#include "Warmup.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Checkpoint copy of one store
+typedef struct {
+    RecordStore* live;          // Store the copy is taken from
+    RecordStore copy;           // Records as of the last checkpoint
+    bool stale;                 // The whole store must be copied again
+} CheckpointImage;
+
+// Copies kept, in the order they are saved (lines before their orders)
+enum {
+    IMAGE_CUSTOMERS,
+    IMAGE_PARTS,
+    IMAGE_ORDER_LINES,
+    IMAGE_ORDERS,
+    IMAGE_COUNT
+};
+
+int checkpointSeconds = CHECKPOINT_SECONDS;
+
+static std::mutex checkpointLock;               // Guards everything below
+static std::condition_variable checkpointWork;  // Wakes the saver
+static std::condition_variable checkpointDone;  // Wakes threads waiting for a save
+static std::thread checkpointSaver;
+static CheckpointImage images[IMAGE_COUNT];
+static bool checkpointStarted = false;
+static bool checkpointSaving = false;           // The saver is reading the copies
+static bool checkpointStopping = false;
+static bool checkpointFailed = false;           // The last save did not finish
+static unsigned int unsavedStores = 0;          // CHECKPOINT_* stores whose copy is newer than the snapshot
+static unsigned long long takenPosition = 0;    // Log position of the last checkpoint taken
+static std::chrono::steady_clock::time_point lastTaken;
+
+//
+// FUNCTION    : copyChanges
+// DESCRIPTION : Brings a checkpoint copy up to date with its store by
+//               copying the chunks flagged as changed, then clears the
+//               flags. Called while no thread changes the store.
+// PARAMETERS  :
+//      CheckpointImage* image : Copy to update
+//      bool* changed          : Set to true if anything was copied
+// RETURNS     : bool - false if out of memory (the whole store is copied
+//               next time)
+//
+static bool copyChanges(CheckpointImage* image, bool* changed) {
+    RecordStore* live = image->live;
+    RecordStore* copy = &image->copy;
+    if (image->stale || copy->count != live->count) *changed = true;
+
+    if (!storeResize(copy, live->count)) {
+        image->stale = true;
+        return false;
+    }
+
+    int chunks = (live->count + STORE_CHUNK_MASK) >> STORE_CHUNK_SHIFT;
+    for (int c = 0; c < chunks; c++) {
+        if (!image->stale && !live->dirty[c]) continue;
+
+        int first = c << STORE_CHUNK_SHIFT;
+        int records = live->count - first < STORE_CHUNK_RECORDS ? live->count - first : STORE_CHUNK_RECORDS;
+        storeCopy(copy, first, live, first, records);
+        *changed = true;
+    }
+
+    if (live->chunkCapacity > 0) memset(live->dirty, 0, (size_t)live->chunkCapacity);
+    image->stale = false;
+    return true;
+}
+
+//
+// FUNCTION    : saveLoop
+// DESCRIPTION : Saver thread. Saves the copy of every store that changed
+//               to its snapshot, then drops the records they hold from
+//               the write-ahead log. Stops when asked with nothing taken.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+static void saveLoop() {
+    std::unique_lock<std::mutex> lock(checkpointLock);
+    while (true) {
+        checkpointWork.wait(lock, [] { return checkpointStopping || checkpointSaving; });
+        if (!checkpointSaving) break;
+
+        unsigned int saving = unsavedStores;
+        unsigned long long position = takenPosition;
+        lock.unlock();
+
+        unsigned int saved = 0;
+        if ((saving & CHECKPOINT_CUSTOMERS) &&
+            saveSnapshot(CUSTOMER_SNAPSHOT_FILE, SNAPSHOT_CUSTOMERS, &images[IMAGE_CUSTOMERS].copy)) {
+            saveCustomerIndex(&images[IMAGE_CUSTOMERS].copy);
+            saved |= CHECKPOINT_CUSTOMERS;
+        }
+        if ((saving & CHECKPOINT_PARTS) &&
+            saveSnapshot(PART_SNAPSHOT_FILE, SNAPSHOT_PARTS, &images[IMAGE_PARTS].copy)) {
+            savePartIndex(&images[IMAGE_PARTS].copy);
+            saved |= CHECKPOINT_PARTS;
+        }
+        if ((saving & CHECKPOINT_ORDERS) &&
+            saveSnapshot(ORDER_LINES_SNAPSHOT_FILE, SNAPSHOT_ORDER_LINES, &images[IMAGE_ORDER_LINES].copy) &&
+            saveSnapshot(ORDER_SNAPSHOT_FILE, SNAPSHOT_ORDERS, &images[IMAGE_ORDERS].copy)) {
+            saveOrderIndex(&images[IMAGE_ORDERS].copy);
+            saved |= CHECKPOINT_ORDERS;
+        }
+
+        // A store that failed keeps the whole log; the next checkpoint saves it again
+        bool finished = saved == saving && walCheckpointAt(position);
+
+        lock.lock();
+        unsavedStores &= ~saved;
+        if (finished) {
+            checkpointFailed = false;
+            logMessage("Checkpoint saved");
+        }
+        else if (!checkpointFailed) {
+            checkpointFailed = true;
+            printf("Checkpoint could not be saved; changes stay in %s.\n", WAL_FILE);
+            logMessage("Checkpoint failed");
+        }
+        checkpointSaving = false;
+        checkpointDone.notify_all();
+    }
+}
+
+//
+// FUNCTION    : seedImage
+// DESCRIPTION : Lazy start-up: makes a checkpoint copy of a store mapped
+//               from its snapshot by mapping the same snapshot again, so
+//               nothing is copied until a chunk changes. Only a store with
+//               no change flag set is exactly as mapped.
+// PARAMETERS  :
+//      CheckpointImage* image : Copy to fill (empty)
+//      const char* filename   : Snapshot the store was mapped from
+//      SnapshotKind kind      : Store in the snapshot
+// RETURNS     : bool - false if the store was not mapped, has changed or
+//               the snapshot could not be mapped again (copyChanges is
+//               used instead)
+//
+static bool seedImage(CheckpointImage* image, const char* filename, SnapshotKind kind) {
+    RecordStore* live = image->live;
+    if (!lazyStart || live->mappedChunks == 0) return false;
+    for (int c = 0; c < live->chunkCapacity; c++) {
+        if (live->dirty[c]) return false;
+    }
+
+    if (!mapSnapshot(filename, kind, &image->copy, NULL, false)) return false;
+    if (image->copy.count != live->count) {
+        storeFree(&image->copy);
+        return false;
+    }
+    image->stale = false;
+    return true;
+}
+
+//
+// FUNCTION    : checkpointStart
+// DESCRIPTION : Copies the stores as loaded and starts the saver. Call once
+//               after loading and before replaying the write-ahead log, so
+//               the replayed changes are in the first checkpoint. Stores
+//               mapped by lazy start-up are not copied: their copies map
+//               the same snapshots.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+//      unsigned int unsaved   : CHECKPOINT_* stores not loaded from their snapshot
+// RETURNS     : void
+//
+void checkpointStart(RecordStore* customers, RecordStore* parts, RecordStore* orders, unsigned int unsaved) {
+    std::lock_guard<std::mutex> lock(checkpointLock);
+    if (checkpointStarted) return;
+
+    RecordStore* live[IMAGE_COUNT];
+    live[IMAGE_CUSTOMERS] = customers;
+    live[IMAGE_PARTS] = parts;
+    live[IMAGE_ORDER_LINES] = &orderLines;
+    live[IMAGE_ORDERS] = orders;
+    static const char* const snapshotFile[IMAGE_COUNT] = {
+        CUSTOMER_SNAPSHOT_FILE, PART_SNAPSHOT_FILE, ORDER_LINES_SNAPSHOT_FILE, ORDER_SNAPSHOT_FILE
+    };
+    static const SnapshotKind snapshotKind[IMAGE_COUNT] = {
+        SNAPSHOT_CUSTOMERS, SNAPSHOT_PARTS, SNAPSHOT_ORDER_LINES, SNAPSHOT_ORDERS
+    };
+    for (int i = 0; i < IMAGE_COUNT; i++) {
+        images[i].live = live[i];
+        storeInit(&images[i].copy, live[i]->recordSize);
+        images[i].stale = true;
+
+        bool changed = false;
+        if (!seedImage(&images[i], snapshotFile[i], snapshotKind[i])) copyChanges(&images[i], &changed);
+    }
+
+    unsavedStores = unsaved;
+    checkpointFailed = false;
+    lastTaken = std::chrono::steady_clock::now();
+    checkpointStopping = false;
+    checkpointSaver = std::thread(saveLoop);
+    checkpointStarted = true;
+    atexit(checkpointStop);
+}
+
+//
+// FUNCTION    : checkpointDue
+// DESCRIPTION : Tells whether a checkpoint should be taken: none is being
+//               saved, and the log holds changes older than
+//               checkpointSeconds or has grown past CHECKPOINT_LOG_BYTES.
+//               None is due while mapped snapshots are still being checked.
+// PARAMETERS  : None
+// RETURNS     : bool - true if checkpointTake should be called
+//
+bool checkpointDue() {
+    if (checkpointSeconds <= 0 || !warmupFinished()) return false;
+
+    std::chrono::steady_clock::time_point taken;
+    {
+        std::lock_guard<std::mutex> lock(checkpointLock);
+        if (!checkpointStarted || checkpointSaving) return false;
+        taken = lastTaken;
+    }
+
+    unsigned long long length = walLength();
+    if (length >= CHECKPOINT_LOG_BYTES) return true;
+    return length > 0 && std::chrono::steady_clock::now() - taken >= std::chrono::seconds(checkpointSeconds);
+}
+
+//
+// FUNCTION    : checkpointTake
+// DESCRIPTION : Copies what changed since the last checkpoint and hands
+//               the copies to the saver. The caller must make sure no
+//               thread changes a store until this returns; it takes time
+//               in proportion to the chunks that changed. Under lazy
+//               start-up it first waits for the mapped snapshots to be
+//               checked, so a damaged one is never saved over.
+// PARAMETERS  : None
+// RETURNS     : bool - false if checkpoints are not running, one is still
+//               being saved or the copies ran out of memory
+//
+bool checkpointTake() {
+    warmupWait();
+
+    std::lock_guard<std::mutex> lock(checkpointLock);
+    if (!checkpointStarted || checkpointSaving) return false;
+
+    static const unsigned int storeOf[IMAGE_COUNT] = {
+        CHECKPOINT_CUSTOMERS, CHECKPOINT_PARTS, CHECKPOINT_ORDERS, CHECKPOINT_ORDERS
+    };
+    bool copied = true;
+    for (int i = 0; i < IMAGE_COUNT; i++) {
+        bool changed = false;
+        copied = copyChanges(&images[i], &changed) && copied;
+        if (changed) unsavedStores |= storeOf[i];
+    }
+    if (!copied) {
+        printf("Not enough memory for a checkpoint; changes stay in %s.\n", WAL_FILE);
+        return false;
+    }
+
+    takenPosition = walPosition();
+    lastTaken = std::chrono::steady_clock::now();
+    checkpointSaving = true;
+    checkpointWork.notify_one();
+    return true;
+}
+
+//
+// FUNCTION    : checkpointPoll
+// DESCRIPTION : Takes a checkpoint if one is due. For single-threaded
+//               callers, between changes.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void checkpointPoll() {
+    if (checkpointDue()) checkpointTake();
+}
+
+//
+// FUNCTION    : checkpointWait
+// DESCRIPTION : Waits until the checkpoint being saved, if any, is done
+// PARAMETERS  : None
+// RETURNS     : bool - false if the last checkpoint could not be saved
+//
+bool checkpointWait() {
+    std::unique_lock<std::mutex> lock(checkpointLock);
+    checkpointDone.wait(lock, [] { return !checkpointSaving; });
+    return !checkpointFailed;
+}
+
+//
+// FUNCTION    : checkpointStop
+// DESCRIPTION : Lets the saver finish the checkpoint it is saving, stops
+//               it and frees the copies. Safe to call more than once.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void checkpointStop() {
+    {
+        std::lock_guard<std::mutex> lock(checkpointLock);
+        if (!checkpointStarted) return;
+        checkpointStarted = false;
+        checkpointStopping = true;
+        checkpointWork.notify_one();
+    }
+    checkpointSaver.join();
+
+    std::lock_guard<std::mutex> lock(checkpointLock);
+    for (int i = 0; i < IMAGE_COUNT; i++) {
+        storeFree(&images[i].copy);
+    }
+    checkpointStopping = false;
+}
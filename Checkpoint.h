@@ -0,0 +1,43 @@
+/*
+* FILE          : Checkpoint.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for background checkpoints including:
+*      - Checkpoint interval setting and log size trigger
+*      - Function prototypes for taking and saving checkpoints
+*      A checkpoint keeps its own copy of the customer, part, order and
+*      order line stores. Taking one copies only the chunks flagged as
+*      changed since the last one into that copy, which is quick and is
+*      the only part that needs the stores left alone. A background
+*      thread then saves each store that changed to its snapshot (write
+*      to a temporary file, then rename) and drops the saved records from
+*      the write-ahead log. Stores that did not change are not rewritten.
+*/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "RecordStore.h"
+
+#define CHECKPOINT_SECONDS 300                      // Default checkpointSeconds
+#define CHECKPOINT_LOG_BYTES (64 * 1024 * 1024)     // Log size that makes a checkpoint due at once
+
+// Stores whose snapshot does not hold what was loaded (checkpointStart)
+#define CHECKPOINT_CUSTOMERS 1
+#define CHECKPOINT_PARTS 2
+#define CHECKPOINT_ORDERS 4
+
+extern int checkpointSeconds;   // Seconds between checkpoints while changes are logged (0 = none)
+
+// Function prototypes
+void checkpointStart(RecordStore* customers, RecordStore* parts, RecordStore* orders,
+    unsigned int unsaved);                                  // Copy the loaded stores; call before replay
+bool checkpointDue();                                       // A checkpoint should be taken now
+bool checkpointTake();                                      // Copy the changes and start saving them
+void checkpointPoll();                                      // Take a checkpoint if one is due
+bool checkpointWait();                                      // Wait for the checkpoint being saved
+void checkpointStop();                                      // Finish the checkpoint being saved and stop
+
+#endif
@@ -0,0 +1,899 @@
+/*
+* FILE          : Command.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of headless operation including:
+*      - Parsing of command lines into a verb, an object and arguments
+*      - Dispatch to the same functions the menus call, without prompts
+*      - Script and command-line option handling with optional timing
+*      A command that fails stops the run. Each command's changes are
+*      committed to the write-ahead log (Wal.h) when it finishes; the
+*      snapshots are saved when the script asks for it and by background
+*      checkpoints (Checkpoint.h) taken between commands.
+*/
+
+#include "Command.h"
+#include "Order.h"
+#include "Ingest.h"
+#include "Service.h"
+#include "Fulfillment.h"
+#include "DbReader.h"
+#include "FileIo.h"
+#include "System.h"
+#include "TaskPool.h"
+#include "Wal.h"
+#include "Checkpoint.h"
+#include "Warmup.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+// One store loaded by loadAllData
+typedef struct {
+    RecordStore* store;         // Store to fill
+    bool imported;              // Loaded from its text database, not a snapshot
+    HeldOutput output;          // Messages of the load, printed in store order
+} StoreLoad;
+
+//
+// FUNCTION    : loadCustomerStore
+// DESCRIPTION : Start-up load task for the customer store: its snapshot,
+//               or customers.db if there is no usable snapshot
+// PARAMETERS  :
+//      void* arg : StoreLoad
+// RETURNS     : void
+//
+static void loadCustomerStore(void* arg) {
+    StoreLoad* load = (StoreLoad*)arg;
+    HeldOutput* previous = holdOutput(&load->output);
+    if (!loadCustomerSnapshot(load->store)) {
+        loadCustomers(load->store);
+        load->imported = true;
+    }
+    holdOutput(previous);
+}
+
+//
+// FUNCTION    : loadPartStore
+// DESCRIPTION : Start-up load task for the part store: its snapshot, or
+//               parts.db if there is no usable snapshot
+// PARAMETERS  :
+//      void* arg : StoreLoad
+// RETURNS     : void
+//
+static void loadPartStore(void* arg) {
+    StoreLoad* load = (StoreLoad*)arg;
+    HeldOutput* previous = holdOutput(&load->output);
+    if (!loadPartSnapshot(load->store)) {
+        loadfromfile("parts.db", load->store);
+        load->imported = true;
+    }
+    holdOutput(previous);
+}
+
+//
+// FUNCTION    : loadOrderStore
+// DESCRIPTION : Start-up load task for the order store: its snapshots, or
+//               orders.db if there is no usable snapshot. The orders are
+//               loaded without the customers, which load at the same time;
+//               loadAllData queues them afterwards.
+// PARAMETERS  :
+//      void* arg : StoreLoad
+// RETURNS     : void
+//
+static void loadOrderStore(void* arg) {
+    StoreLoad* load = (StoreLoad*)arg;
+    HeldOutput* previous = holdOutput(&load->output);
+    if (!loadOrderSnapshot(load->store, NULL)) {
+        loadOrderFromFile(load->store, NULL);
+        load->imported = true;
+    }
+    holdOutput(previous);
+}
+
+//
+// FUNCTION    : loadAllData
+// DESCRIPTION : Loads every store from its binary snapshot, importing the
+//               text database for any store whose snapshot is missing or
+//               out of date, then replays the changes logged since the
+//               last save and starts logging and checkpoints. The three
+//               stores load side by side on the task pool and report in a
+//               fixed order; the placed orders are then ranked against the
+//               customers in one parallel pass. With lazy start the
+//               snapshots are mapped, the orders are queued when first
+//               needed, and the warm-up thread starts reading and checking
+//               the snapshots once everything is loaded.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : void
+//
+void loadAllData(RecordStore* customers, RecordStore* parts, RecordStore* orders) {
+    static StoreLoad loads[3];
+    static const TaskFunction loaders[3] = { loadCustomerStore, loadPartStore, loadOrderStore };
+    static const unsigned int storeOf[3] = { CHECKPOINT_CUSTOMERS, CHECKPOINT_PARTS, CHECKPOINT_ORDERS };
+    RecordStore* stores[3] = { customers, parts, orders };
+
+    TaskGroup group;
+    taskGroupInit(&group);
+    for (int i = 0; i < 3; i++) {
+        loads[i].store = stores[i];
+        loads[i].imported = false;
+        loads[i].output.length = 0;
+        taskSpawn(&group, loaders[i], &loads[i]);
+    }
+    taskGroupWait(&group);
+
+    unsigned int imported = 0;
+    for (int i = 0; i < 3; i++) {
+        printHeldOutput(&loads[i].output);
+        if (loads[i].imported) imported |= storeOf[i];
+    }
+    if (!lazyStart) queueOrders(orders, customers);
+
+    checkpointStart(customers, parts, orders, imported);
+    walRecover(customers, parts, orders);
+    warmupStart();
+}
+
+//
+// FUNCTION    : repairIndexes
+// DESCRIPTION : Rebuilds any ID index the warm-up thread found damaged
+//               since the last call. Run between commands.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : void
+//
+void repairIndexes(RecordStore* customers, RecordStore* parts, RecordStore* orders) {
+    if (!warmupRebuildPending()) return;
+    repairCustomerIndex(customers);
+    repairPartIndex(parts);
+    repairOrderIndex(orders);
+}
+
+//
+// FUNCTION    : saveAllData
+// DESCRIPTION : Saves every store to its binary snapshot. Text databases are
+//               only rewritten if a snapshot cannot be saved. The change
+//               log is emptied only when every snapshot was saved. Mapped
+//               snapshots are checked before anything is written.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : void
+//
+void saveAllData(RecordStore* customers, RecordStore* parts, RecordStore* orders) {
+    // The log must hold every change the snapshots do before they replace
+    // the old ones, or a crash before the checkpoint would replay too little.
+    // A background checkpoint writes the same files, so it finishes first.
+    walCommit();
+    checkpointWait();
+    warmupWait();
+
+    bool saved = true;
+    if (!saveCustomerSnapshot(customers)) {
+        saveCustomers(customers);
+        saved = false;
+    }
+    if (!savePartSnapshot(parts)) {
+        SaveToFile("parts.db", parts);
+        saved = false;
+    }
+    if (!saveOrderSnapshot(orders)) {
+        saveOrderToFile(orders);
+        saved = false;
+    }
+    if (saved) walCheckpoint();
+}
+
+//
+// FUNCTION    : nextWord
+// DESCRIPTION : Cuts the next space-separated word off a command line
+// PARAMETERS  :
+//      char** text : Remaining text (advanced past the word)
+// RETURNS     : char* - The word, empty at the end of the line
+//
+static char* nextWord(char** text) {
+    char* word = *text + strspn(*text, " \t");
+    char* end = word + strcspn(word, " \t");
+    *text = end;
+    if (*end != '\0') {
+        *end = '\0';
+        *text = end + 1;
+    }
+    return word;
+}
+
+//
+// FUNCTION    : restOfLine
+// DESCRIPTION : Returns what is left of a command line without the leading
+//               and trailing blanks
+// PARAMETERS  :
+//      char* text : Remaining text
+// RETURNS     : char* - Trimmed text
+//
+static char* restOfLine(char* text) {
+    text += strspn(text, " \t");
+    size_t length = strlen(text);
+    while (length > 0 && (text[length - 1] == ' ' || text[length - 1] == '\t')) {
+        text[--length] = '\0';
+    }
+    return text;
+}
+
+//
+// FUNCTION    : splitFields
+// DESCRIPTION : Splits '|' separated arguments the way database lines are
+//               split
+// PARAMETERS  :
+//      const char* text          : Arguments
+//      std::string_view fields[] : Receives the fields
+//      int maxFields             : Size of fields (further fields are dropped)
+// RETURNS     : int - Number of fields, -1 if there are none
+//
+static int splitFields(const char* text, std::string_view fields[], int maxFields) {
+    MappedFile view = { text, strlen(text), NULL, NULL, NULL };
+    size_t offset = 0;
+    return nextDbRecord(&view, &offset, DB_TRIM_CRLF, fields, maxFields);
+}
+
+//
+// FUNCTION    : copyArgument
+// DESCRIPTION : Copies a field into a buffer if it is 1 to maxLength
+//               characters long
+// PARAMETERS  :
+//      char* dest             : Destination buffer
+//      size_t destSize        : Size of dest
+//      std::string_view field : Field text
+//      size_t maxLength       : Longest allowed value
+// RETURNS     : bool - false if the field is empty or too long
+//
+static bool copyArgument(char* dest, size_t destSize, std::string_view field, size_t maxLength) {
+    if (field.empty() || field.size() > maxLength || field.size() >= destSize) return false;
+    memcpy(dest, field.data(), field.size());
+    dest[field.size()] = '\0';
+    return true;
+}
+
+//
+// FUNCTION    : parseCount
+// DESCRIPTION : Converts a whole word to a non-negative int
+// PARAMETERS  :
+//      const char* word : Word to convert
+//      int* value       : Receives the number
+// RETURNS     : bool - false if the word is not a non-negative number
+//
+static bool parseCount(const char* word, int* value) {
+    return parseIntField(word, value) && *value >= 0;
+}
+
+//
+// FUNCTION    : addCustomerCommand
+// DESCRIPTION : add customer Name|Address|City|Province|Postal|Phone|Email
+// PARAMETERS  :
+//      const char* arguments  : '|' separated fields
+//      RecordStore* customers : Customer store
+// RETURNS     : bool - true if the customer was added
+//
+static bool addCustomerCommand(const char* arguments, RecordStore* customers) {
+    std::string_view fields[8];
+    if (splitFields(arguments, fields, 8) != 7) {
+        printf("Usage: add customer Name|Address|City|Province|Postal|Phone|Email\n");
+        return false;
+    }
+
+    Customer c;
+    memset(&c, 0, sizeof(c));
+    if (!copyArgument(c.name, sizeof(c.name), fields[0], 50)) {
+        printf("Invalid name.\n");
+        return false;
+    }
+    if (!copyArgument(c.address, sizeof(c.address), fields[1], 100)) {
+        printf("Invalid address.\n");
+        return false;
+    }
+    if (!copyArgument(c.city, sizeof(c.city), fields[2], 100)) {
+        printf("Invalid city.\n");
+        return false;
+    }
+    if (!isValidProvince(fields[3]) || !copyArgument(c.province, sizeof(c.province), fields[3], 2)) {
+        printf("Invalid province.\n");
+        return false;
+    }
+    if (!isValidPostalCode(fields[4]) || !copyArgument(c.postalCode, sizeof(c.postalCode), fields[4], 6)) {
+        printf("Invalid postal code.\n");
+        return false;
+    }
+    if (!isValidPhone(fields[5]) || !copyArgument(c.phone, sizeof(c.phone), fields[5], 12)) {
+        printf("Invalid phone.\n");
+        return false;
+    }
+    if (!copyArgument(c.email, sizeof(c.email), fields[6], 50)) {
+        printf("Invalid email.\n");
+        return false;
+    }
+
+    return addCustomerRecord(customers, &c);
+}
+
+//
+// FUNCTION    : addPartCommand
+// DESCRIPTION : add part Name|Number|Location|Cost|Quantity|ID. Orders
+//               waiting on the new part are retried.
+// PARAMETERS  :
+//      const char* arguments  : '|' separated fields
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : bool - true if the part was added
+//
+static bool addPartCommand(const char* arguments, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders) {
+    std::string_view fields[7];
+    if (splitFields(arguments, fields, 7) != 6) {
+        printf("Usage: add part Name|Number|Location|Cost|Quantity|ID\n");
+        return false;
+    }
+
+    Parts newPart;
+    memset(&newPart, 0, sizeof(newPart));
+    if (!copyArgument(newPart.PartName, sizeof(newPart.PartName), fields[0], 50)) {
+        printf("Invalid part name.\n");
+        return false;
+    }
+    if (!copyArgument(newPart.PartNumber, sizeof(newPart.PartNumber), fields[1], 50)) {
+        printf("Invalid part number.\n");
+        return false;
+    }
+    if (!copyArgument(newPart.PartLocate, sizeof(newPart.PartLocate), fields[2], 50)
+        || !isValidPartLocation(newPart.PartLocate)) {
+        printf("Invalid format. Please use A###-S###-L###-B### format.\n");
+        return false;
+    }
+    if (!parseFloatField(fields[3], &newPart.PartCost) || newPart.PartCost <= 0.0f) {
+        printf("Invalid cost.\n");
+        return false;
+    }
+    if (!parseIntField(fields[4], &newPart.QuantityOnHand) || newPart.QuantityOnHand < 0) {
+        printf("Invalid quantity.\n");
+        return false;
+    }
+    if (!parseIntField(fields[5], &newPart.PartID) || newPart.PartID <= 0) {
+        printf("Invalid ID.\n");
+        return false;
+    }
+
+    if (!addPartRecord(parts, &newPart)) return false;
+    fulfillBackorders(orders, customers, parts, newPart.PartID);
+    return true;
+}
+
+//
+// FUNCTION    : addOrderCommand
+// DESCRIPTION : add order CustomerID|PartID|Quantity|PartID|Quantity...
+// PARAMETERS  :
+//      const char* arguments  : '|' separated fields
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : bool - true if the order was placed
+//
+static bool addOrderCommand(const char* arguments, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders) {
+    std::string_view* fields = (std::string_view*)malloc(sizeof(std::string_view) * INGEST_MAX_FIELDS);
+    OrderItem* items = (OrderItem*)malloc(sizeof(OrderItem) * MAX_PARTS_PER_ORDER);
+    bool placed = false;
+
+    if (fields == NULL || items == NULL) {
+        printf("Memory allocation failed.\n");
+    }
+    else {
+        int fieldCount = splitFields(arguments, fields, INGEST_MAX_FIELDS);
+        int customerID;
+        int count = (fieldCount - 1) / 2;
+        bool valid = fieldCount >= 3 && fieldCount % 2 == 1 && fieldCount <= INGEST_MAX_FIELDS
+            && parseIntField(fields[0], &customerID);
+
+        for (int i = 0; valid && i < count; i++) {
+            valid = parseIntField(fields[1 + i * 2], &items[i].PartID)
+                && parseIntField(fields[2 + i * 2], &items[i].NumberOfParts);
+        }
+
+        if (valid) {
+            PlaceResult result = placeOrder(orders, customers, parts, customerID, items, count);
+            printPlaceResult(result, orders);
+            placed = result == PLACE_OK;
+        }
+        else printf("Usage: add order CustomerID|PartID|Quantity|PartID|Quantity...\n");
+    }
+
+    free(items);
+    free(fields);
+    return placed;
+}
+
+//
+// FUNCTION    : loadCommand
+// DESCRIPTION : load customers|parts|orders|all. Imports the text
+//               databases as the submenus do.
+// PARAMETERS  :
+//      const char* what       : Store to load
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : bool - false for an unknown store
+//
+static bool loadCommand(const char* what, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders) {
+    bool all = strcmp(what, "all") == 0;
+    if (!all && strcmp(what, "customers") != 0 && strcmp(what, "parts") != 0 && strcmp(what, "orders") != 0) {
+        printf("Usage: load customers|parts|orders|all\n");
+        return false;
+    }
+
+    if (all || strcmp(what, "customers") == 0) loadCustomers(customers);
+    if (all || strcmp(what, "parts") == 0) {
+        loadfromfile("parts.db", parts);
+        fulfillBackorders(orders, customers, parts, BACKORDER_ALL_PARTS);
+    }
+    if (all || strcmp(what, "orders") == 0) loadOrderFromFile(orders, customers);
+    return true;
+}
+
+//
+// FUNCTION    : exportCommand
+// DESCRIPTION : export customers|parts|orders|all. Writes the text
+//               databases as the submenus do.
+// PARAMETERS  :
+//      const char* what       : Store to write
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : bool - false for an unknown store
+//
+static bool exportCommand(const char* what, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders) {
+    bool all = strcmp(what, "all") == 0;
+    if (!all && strcmp(what, "customers") != 0 && strcmp(what, "parts") != 0 && strcmp(what, "orders") != 0) {
+        printf("Usage: export customers|parts|orders|all\n");
+        return false;
+    }
+
+    if (all || strcmp(what, "customers") == 0) saveCustomers(customers);
+    if (all || strcmp(what, "parts") == 0) SaveToFile("parts.db", parts);
+    if (all || strcmp(what, "orders") == 0) saveOrderToFile(orders);
+    return true;
+}
+
+//
+// FUNCTION    : listCommand
+// DESCRIPTION : list customers|parts|orders|bad-credit
+// PARAMETERS  :
+//      const char* what       : What to list
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : bool - false for an unknown list
+//
+static bool listCommand(const char* what, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders) {
+    if (strcmp(what, "customers") == 0) listAllCustomers(customers);
+    else if (strcmp(what, "parts") == 0) ListallParts(parts);
+    else if (strcmp(what, "orders") == 0) listAllOrders(orders);
+    else if (strcmp(what, "bad-credit") == 0) listBadCreditCustomers(customers);
+    else {
+        printf("Usage: list customers|parts|orders|bad-credit\n");
+        return false;
+    }
+    return true;
+}
+
+//
+// FUNCTION    : searchCommand
+// DESCRIPTION : search customer <keyword> | part <id> | order <id>. A
+//               keyword matching no customer is not an error; an ID that
+//               is not found is.
+// PARAMETERS  :
+//      char* arguments        : Object and key
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : bool - false for bad arguments or an unknown ID
+//
+static bool searchCommand(char* arguments, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders) {
+    char* what = nextWord(&arguments);
+    char* key = restOfLine(arguments);
+
+    if (strcmp(what, "customer") == 0) {
+        searchCustomers(customers, key);
+        return true;
+    }
+    if (strcmp(what, "part") == 0) {
+        int id;
+        if (!parseIntField(key, &id)) {
+            printf("Invalid input.\n");
+            return false;
+        }
+        int index = findPart(parts, id);
+        if (index == -1) {
+            printf("Part not found.\n");
+            return false;
+        }
+        DisplayPart(partAt(parts, index));
+        return true;
+    }
+    if (strcmp(what, "order") == 0) {
+        long long id;
+        if (!parseLongLongField(key, &id)) {
+            printf("Invalid order ID.\n");
+            return false;
+        }
+        if (findOrder(orders, id) == -1) {
+            printf("Order not found.\n");
+            return false;
+        }
+        displayOrderDetails(id, orders);
+        return true;
+    }
+
+    printf("Usage: search customer <keyword> | part <id> | order <id>\n");
+    return false;
+}
+
+//
+// FUNCTION    : updateCommand
+// DESCRIPTION : update part <id> <quantity> | customer <id> <field> <value> |
+//               order <id> <status>. A restocked part retries the orders
+//               waiting on it.
+// PARAMETERS  :
+//      char* arguments        : Object, ID and new value
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : bool - false for bad arguments, an unknown ID or a rejected value
+//
+static bool updateCommand(char* arguments, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders) {
+    char* what = nextWord(&arguments);
+    char* idText = nextWord(&arguments);
+
+    if (strcmp(what, "part") == 0) {
+        int id, quantity;
+        if (!parseIntField(idText, &id) || !parseCount(restOfLine(arguments), &quantity)) {
+            printf("Usage: update part <id> <quantity>\n");
+            return false;
+        }
+        int index = findPart(parts, id);
+        if (index == -1) {
+            printf("Part not found.\n");
+            return false;
+        }
+        int restocked = setPartQuantity(parts, index, quantity);
+        if (restocked != -1) fulfillBackorders(orders, customers, parts, restocked);
+        return true;
+    }
+    if (strcmp(what, "customer") == 0) {
+        int id;
+        char* field = nextWord(&arguments);
+        char* value = restOfLine(arguments);
+        if (!parseIntField(idText, &id) || *field == '\0') {
+            printf("Usage: update customer <id> <field> <value>\n");
+            return false;
+        }
+        int index = findCustomer(customers, id);
+        if (index == -1) {
+            printf("Customer not found.\n");
+            return false;
+        }
+        if (!setCustomerField(customers, index, field, value)) return false;
+        printf("Customer record updated.\n");
+        logMessage("Customer information updated");
+        return true;
+    }
+    if (strcmp(what, "order") == 0) {
+        long long id;
+        int status;
+        if (!parseLongLongField(idText, &id) || !parseIntField(restOfLine(arguments), &status)) {
+            printf("Usage: update order <id> <status>\n");
+            return false;
+        }
+        if (findOrder(orders, id) == -1) {
+            printf("Order not found.\n");
+            return false;
+        }
+        updateOrderStatus(id, status, orders);
+        return true;
+    }
+
+    printf("Usage: update part|customer|order <id> ...\n");
+    return false;
+}
+
+//
+// FUNCTION    : useUring
+// DESCRIPTION : Selects the io_uring file backend, or stays on stdio with a
+//               message where io_uring cannot be used
+// PARAMETERS  : None
+// RETURNS     : void
+//
+static void useUring() {
+    fileIoMode = fileIoAvailable() ? FILE_IO_URING : FILE_IO_STDIO;
+    if (fileIoMode == FILE_IO_STDIO) printf("io_uring is not available here; using stdio.\n");
+}
+
+//
+// FUNCTION    : setCommand
+// DESCRIPTION : set pool-threads|eod-threads|load-threads|ingest-threads|
+//               service-threads|checkpoint-seconds <count> | load-mode
+//               stdio|mapped | io-mode stdio|uring. A new pool size stops
+//               the pool; the next parallel step starts it again with that
+//               many threads. io-mode uring falls back to stdio where
+//               io_uring cannot be used.
+// PARAMETERS  :
+//      char* arguments : Setting and value
+// RETURNS     : bool - false for an unknown setting or a bad value
+//
+static bool setCommand(char* arguments) {
+    char* setting = nextWord(&arguments);
+    char* value = restOfLine(arguments);
+    int count;
+
+    if (strcmp(setting, "load-mode") == 0) {
+        if (strcmp(value, "stdio") == 0) dbLoadMode = DB_LOAD_STDIO;
+        else if (strcmp(value, "mapped") == 0) dbLoadMode = DB_LOAD_MAPPED;
+        else {
+            printf("Usage: set load-mode stdio|mapped\n");
+            return false;
+        }
+        return true;
+    }
+    if (strcmp(setting, "io-mode") == 0) {
+        if (strcmp(value, "stdio") == 0) fileIoMode = FILE_IO_STDIO;
+        else if (strcmp(value, "uring") == 0) useUring();
+        else {
+            printf("Usage: set io-mode stdio|uring\n");
+            return false;
+        }
+        return true;
+    }
+
+    int* target = NULL;
+    if (strcmp(setting, "pool-threads") == 0) target = &poolThreads;
+    else if (strcmp(setting, "eod-threads") == 0) target = &eodThreads;
+    else if (strcmp(setting, "load-threads") == 0) target = &dbLoadThreads;
+    else if (strcmp(setting, "ingest-threads") == 0) target = &ingestThreads;
+    else if (strcmp(setting, "service-threads") == 0) target = &serviceThreads;
+    else if (strcmp(setting, "checkpoint-seconds") == 0) target = &checkpointSeconds;
+
+    if (target == NULL || !parseCount(value, &count)) {
+        printf("Usage: set pool-threads|eod-threads|load-threads|ingest-threads|service-threads|checkpoint-seconds <count>"
+            " | load-mode stdio|mapped | io-mode stdio|uring\n");
+        return false;
+    }
+    if (target == &poolThreads) taskPoolStop();
+    *target = count;
+    return true;
+}
+
+//
+// FUNCTION    : runCommand
+// DESCRIPTION : Runs one command line. Blank lines and lines starting with
+//               '#' do nothing. The line is modified while it is parsed.
+// PARAMETERS  :
+//      char* line             : Command line
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : bool - false if the command is unknown or failed
+//
+bool runCommand(char* line, RecordStore* customers, RecordStore* parts, RecordStore* orders) {
+    line[strcspn(line, "\r\n")] = '\0';
+    char* verb = nextWord(&line);
+
+    if (*verb == '\0' || *verb == '#') return true;
+
+    if (strcmp(verb, "load") == 0) return loadCommand(restOfLine(line), customers, parts, orders);
+    if (strcmp(verb, "export") == 0) return exportCommand(restOfLine(line), customers, parts, orders);
+    if (strcmp(verb, "list") == 0) return listCommand(restOfLine(line), customers, parts, orders);
+    if (strcmp(verb, "search") == 0) return searchCommand(line, customers, parts, orders);
+    if (strcmp(verb, "update") == 0) return updateCommand(line, customers, parts, orders);
+    if (strcmp(verb, "set") == 0) return setCommand(line);
+
+    if (strcmp(verb, "add") == 0) {
+        char* what = nextWord(&line);
+        char* arguments = restOfLine(line);
+        if (strcmp(what, "customer") == 0) return addCustomerCommand(arguments, customers);
+        if (strcmp(what, "part") == 0) return addPartCommand(arguments, customers, parts, orders);
+        if (strcmp(what, "order") == 0) return addOrderCommand(arguments, customers, parts, orders);
+        printf("Usage: add customer|part|order <fields>\n");
+        return false;
+    }
+    if (strcmp(verb, "ingest") == 0) {
+        char* filename = restOfLine(line);
+        if (*filename == '\0') {
+            printf("Usage: ingest <feed file, - for stdin>\n");
+            return false;
+        }
+        ingestOrderFeed(filename, orders, customers, parts);
+        return true;
+    }
+    if (strcmp(verb, "eod") == 0) {
+        processEndOfDayOrders(orders, customers, parts);
+        return true;
+    }
+    if (strcmp(verb, "serve") == 0) {
+        char* socketPath = restOfLine(line);
+        return runService(*socketPath != '\0' ? socketPath : SERVICE_DEFAULT_SOCKET, customers, parts, orders);
+    }
+    if (strcmp(verb, "save") == 0) {
+        saveAllData(customers, parts, orders);
+        printf("Data saved.\n");
+        return true;
+    }
+    if (strcmp(verb, "checkpoint") == 0) {
+        checkpointWait();
+        if (!checkpointTake() || !checkpointWait()) {
+            printf("Checkpoint failed.\n");
+            return false;
+        }
+        printf("Checkpoint saved.\n");
+        return true;
+    }
+
+    printf("Unknown command: %s\n", verb);
+    return false;
+}
+
+//
+// FUNCTION    : timedCommand
+// DESCRIPTION : Runs one command line and waits until its changes are in
+//               the write-ahead log, reporting its run time on stderr when
+//               timing is on. A checkpoint that is due is taken after it,
+//               and indexes the warm-up thread found damaged are rebuilt.
+// PARAMETERS  :
+//      char* line             : Command line
+//      bool timing            : Report the run time
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : bool - false if the command is unknown or failed, or its
+//               changes could not be logged
+//
+static bool timedCommand(char* line, bool timing, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders) {
+    char text[80];
+    if (timing) {
+        strncpy_s(text, sizeof(text), line, _TRUNCATE);
+        text[strcspn(text, "\r\n")] = '\0';
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool succeeded = runCommand(line, customers, parts, orders);
+    if (!walCommit()) succeeded = false;
+    checkpointPoll();
+    repairIndexes(customers, parts, orders);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (timing && text[strspn(text, " \t")] != '\0' && text[strspn(text, " \t")] != '#') {
+        fprintf(stderr, "%10.3f ms  %s\n", ms, text);
+    }
+    return succeeded;
+}
+
+//
+// FUNCTION    : runScript
+// DESCRIPTION : Runs every line of a command script until one fails
+// PARAMETERS  :
+//      const char* filename   : Script file, "-" for stdin
+//      bool timing            : Report each command's run time
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : bool - false if the script could not be read or a command failed
+//
+static bool runScript(const char* filename, bool timing, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders) {
+    static char line[COMMAND_MAX_LENGTH];
+    FILE* script = stdin;
+
+    if (strcmp(filename, "-") != 0 && (fopen_s(&script, filename, "r") != 0 || script == NULL)) {
+        printf("Error opening script %s\n", filename);
+        return false;
+    }
+
+    bool succeeded = true;
+    int lineNumber = 0;
+    while (succeeded && fgets(line, sizeof(line), script) != NULL) {
+        lineNumber++;
+        if (strchr(line, '\n') == NULL && !feof(script)) {
+            printf("%s line %d: command too long\n", filename, lineNumber);
+            succeeded = false;
+        }
+        else if (!timedCommand(line, timing, customers, parts, orders)) {
+            printf("%s line %d: command failed\n", filename, lineNumber);
+            succeeded = false;
+        }
+    }
+
+    if (script != stdin) fclose(script);
+    return succeeded;
+}
+
+//
+// FUNCTION    : applyStartupOptions
+// DESCRIPTION : Applies the options that change how data is loaded before
+//               anything is loaded: -u (io_uring file backend) and -l
+//               (lazy start, Warmup.h). -l loads normally with a message
+//               where it is not available.
+// PARAMETERS  :
+//      int argc     : Argument count
+//      char* argv[] : Arguments
+// RETURNS     : bool - true if other options were given (run headless),
+//               false to show the menus
+//
+bool applyStartupOptions(int argc, char* argv[]) {
+    bool headless = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-u") == 0) useUring();
+        else if (strcmp(argv[i], "-l") == 0) {
+            lazyStart = lazyStartAvailable();
+            if (!lazyStart) printf("Lazy start is not available here; loading everything.\n");
+        }
+        else headless = true;
+    }
+    return headless;
+}
+
+//
+// FUNCTION    : runHeadless
+// DESCRIPTION : Runs the commands given on the command line, in order:
+//                   -c "<command>"   Run one command
+//                   -f <script>      Run a command script ("-" = stdin)
+//                   -t               Report each command's run time on stderr
+//                   -u               io_uring file backend (see applyStartupOptions)
+//                   -l               Lazy start (see applyStartupOptions)
+//               Stops at the first command that fails.
+// PARAMETERS  :
+//      int argc               : Argument count
+//      char* argv[]           : Arguments
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : int - 0 if every command succeeded, 1 if one failed, 2 for
+//               bad options
+//
+int runHeadless(int argc, char* argv[], RecordStore* customers, RecordStore* parts,
+    RecordStore* orders) {
+    bool timing = false;
+
+    // Check every option before running anything
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0) timing = true;
+        else if (strcmp(argv[i], "-u") == 0 || strcmp(argv[i], "-l") == 0) continue;
+        else if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "-f") == 0) && i + 1 < argc) i++;
+        else {
+            printf("Usage: %s [-t] [-u] [-l] [-c \"command\"]... [-f script|-]...\n", argv[0]);
+            return 2;
+        }
+    }
+
+    static char line[COMMAND_MAX_LENGTH];
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0) {
+            strncpy_s(line, sizeof(line), argv[++i], _TRUNCATE);
+            if (!timedCommand(line, timing, customers, parts, orders)) return 1;
+        }
+        else if (strcmp(argv[i], "-f") == 0) {
+            if (!runScript(argv[++i], timing, customers, parts, orders)) return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+/*
+* FILE          : Command.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for headless (scripted) operation including:
+*      - Command-line options for running commands without menus
+*      - Function prototypes for running one command or a whole script
+*      - Start-up load and shutdown save shared with the menu program
+*      Usage: pwh [-t] [-u] [-l] [-c "command"]... [-f script|-]...
+*      With no options other than -u and -l the interactive menus run as
+*      before. -t reports each command's run time; -u selects the io_uring
+*      file backend (FileIo.h) before the start-up load; -l maps the
+*      snapshots and their saved ID indexes instead of reading them
+*      (Warmup.h).
+*      Commands, one per line ('#' starts a comment):
+*          load customers|parts|orders|all     Import the text databases
+*          save                                Save snapshots (as option 4)
+*          checkpoint                          Save the changed stores now (Checkpoint.h)
+*          export customers|parts|orders|all   Write the text databases
+*          list customers|parts|orders|bad-credit
+*          search customer <keyword> | part <id> | order <id>
+*          add customer Name|Address|City|Province|Postal|Phone|Email
+*          add part Name|Number|Location|Cost|Quantity|ID
+*          add order CustomerID|PartID|Quantity|PartID|Quantity...
+*          update part <id> <quantity>
+*          update customer <id> email|phone|address|city|province|postal <value>
+*          update order <id> <status>
+*          ingest <feed file, - for stdin>
+*          eod
+*          serve [socket path]                 Serve requests until SHUTDOWN (Service.h)
+*          set pool-threads <count>            Threads of the shared task pool (TaskPool.h)
+*          set eod-threads|load-threads|ingest-threads|service-threads <count>
+*          set checkpoint-seconds <seconds>    Background checkpoint interval (0 = none)
+*          set load-mode stdio|mapped
+*          set io-mode stdio|uring             File I/O backend for loads, snapshots and the log (FileIo.h)
+*/
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include "RecordStore.h"
+
+#define COMMAND_MAX_LENGTH 32768    // Longest script line
+
+// Function prototypes
+bool applyStartupOptions(int argc, char* argv[]);                                   // Apply -u and -l before loading
+void loadAllData(RecordStore* customers, RecordStore* parts, RecordStore* orders);  // Start-up load
+void saveAllData(RecordStore* customers, RecordStore* parts, RecordStore* orders);  // Snapshot save
+void repairIndexes(RecordStore* customers, RecordStore* parts, RecordStore* orders); // Rebuild damaged mapped indexes
+bool runCommand(char* line, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders);                                           // Run one command line
+int runHeadless(int argc, char* argv[], RecordStore* customers, RecordStore* parts,
+    RecordStore* orders);                                           // Run -c/-f options, returns exit status
+
+#endif
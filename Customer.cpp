@@ -13,21 +13,124 @@
 
 #include "Customer.h"
 #include "System.h"
+#include "IdIndex.h"
+#include "DbReader.h"
+#include "Snapshot.h"
+#include "TaskPool.h"
+#include "Wal.h"
+#include "Checkpoint.h"
+#include "Warmup.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <ctype.h>
 
+static IdIndex customerIndex;   // Customer ID -> position in the customer store
+static unsigned int customerVersion = 0; // Changed whenever customers are loaded or added
+
+// Keyword search shared by the pool tasks scanning the store
+typedef struct {
+    RecordStore* customers;
+    const char* keyword;
+    unsigned char* matched;     // One flag per customer, set if it contains the keyword
+} CustomerSearch;
+
+//
+// FUNCTION    : indexCustomers
+// DESCRIPTION : Rebuilds the customer ID index from the customer store
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+// RETURNS     : void
+//
+void indexCustomers(RecordStore* customers) {
+    idIndexReset(&customerIndex, customers, customers->count);
+    for (int i = 0; i < customers->count; i++) {
+        idIndexInsert(&customerIndex, customerAt(customers, i)->customerID, i);
+    }
+    customerIndex.indexedRecords = customers->count;
+    customerVersion++;
+}
+
+//
+// FUNCTION    : repairCustomerIndex
+// DESCRIPTION : Rebuilds the customer ID index if the warm-up thread
+//               found the mapped customers.idx damaged. Called between
+//               commands, never while lookups may be running.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+// RETURNS     : void
+//
+void repairCustomerIndex(RecordStore* customers) {
+    if (warmupRebuildNeeded(CUSTOMER_INDEX_FILE)) indexCustomers(customers);
+}
+
+//
+// FUNCTION    : syncCustomerIndex
+// DESCRIPTION : Brings the customer ID index up to date with the store.
+//               Records appended since the last call are inserted; a
+//               different store or a shrunken count triggers a full rebuild.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+// RETURNS     : void
+//
+static void syncCustomerIndex(RecordStore* customers) {
+    if (customerIndex.base != customers || customerIndex.indexedRecords > customers->count) {
+        indexCustomers(customers);
+        return;
+    }
+    while (customerIndex.indexedRecords < customers->count) {
+        int i = customerIndex.indexedRecords++;
+        idIndexInsert(&customerIndex, customerAt(customers, i)->customerID, i);
+        customerVersion++;
+    }
+}
+
+//
+// FUNCTION    : findCustomer
+// DESCRIPTION : Finds a customer by ID through the customer ID index. A
+//               position outside the store or holding another ID means
+//               the index does not match the store; it is then rebuilt.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+//      int customerID         : Customer ID to find
+// RETURNS     : int - Store position of the customer, -1 if not found
+//
+int findCustomer(RecordStore* customers, int customerID) {
+    syncCustomerIndex(customers);
+    int position = idIndexFind(&customerIndex, customerID);
+    if (position == -1) return -1;
+    if (position >= 0 && position < customers->count && customerAt(customers, position)->customerID == customerID) {
+        return position;
+    }
+
+    indexCustomers(customers);
+    return idIndexFind(&customerIndex, customerID);
+}
+
+//
+// FUNCTION    : customerStoreVersion
+// DESCRIPTION : Returns a number that changes whenever customers are
+//               loaded or added, so data derived from customer records
+//               (such as order priorities) can tell when to recompute
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+// RETURNS     : unsigned int - Current version
+//
+unsigned int customerStoreVersion(RecordStore* customers) {
+    syncCustomerIndex(customers);
+    return customerVersion;
+}
+
 //
 // FUNCTION    : Display_AllCustomers_Horizontal
 // DESCRIPTION : Displays all customers in pipe-delimited horizontal format
 // PARAMETERS  :
-//      Customer customers[] : Array of customer records
-//      int count           : Number of customers to display
+//      RecordStore* customers : Customer store
 // RETURNS     : void
 //
-void Display_AllCustomers_Horizontal(Customer customers[], int count) {
+void Display_AllCustomers_Horizontal(RecordStore* customers) {
+    int count = customers->count;
     printf("ID|Name|Address|City|Province|PostalCode|Phone|Email|CreditLimit|AccountBalance|JoinDate|LastPayment\n");
     printf("----------------------------------------------------------------------------------------------------------\n");
 
@@ -37,46 +140,55 @@ void Display_AllCustomers_Horizontal(Customer customers[], int count) {
     }
 
     for (int i = 0; i < count; i++) {
-        Customer c = customers[i];
+        const Customer* c = customerAt(customers, i);
         printf("%d|%s|%s|%s|%s|%s|%s|%s|%.2f|%.2f|%s|%s\n",
-            c.customerID, c.name, c.address,
-            c.city, c.province, c.postalCode,
-            c.phone, c.email, c.creditLimit,
-            c.accountBalance, c.joinDate,
-            strlen(c.lastPayment) > 0 ? c.lastPayment : "(none)");
+            c->customerID, c->name, c->address,
+            c->city, c->province, c->postalCode,
+            c->phone, c->email, c->creditLimit,
+            c->accountBalance, c->joinDate,
+            strlen(c->lastPayment) > 0 ? c->lastPayment : "(none)");
     }
 }
 
+//
+// FUNCTION    : Display_Customer_Vertical
+// DESCRIPTION : Displays one customer in formatted vertical layout
+// PARAMETERS  :
+//      const Customer* c : Customer record to display
+// RETURNS     : void
+//
+void Display_Customer_Vertical(const Customer* c) {
+    printf("------------------------------\n");
+    printf("Customer ID       : %d\n", c->customerID);
+    printf("Name              : %s\n", c->name);
+    printf("Address           : %s\n", c->address);
+    printf("City              : %s\n", c->city);
+    printf("Province          : %s\n", c->province);
+    printf("Postal Code       : %s\n", c->postalCode);
+    printf("Phone             : %s\n", c->phone);
+    printf("Email             : %s\n", c->email);
+    printf("Credit Limit      : $%.2f\n", c->creditLimit);
+    printf("Account Balance   : $%.2f\n", c->accountBalance);
+    printf("Join Date         : %s\n", c->joinDate);
+    printf("Last Payment      : %s\n", strlen(c->lastPayment) > 0 ? c->lastPayment : "(none)");
+    printf("------------------------------\n");
+}
+
 //
 // FUNCTION    : Display_AllCustomers_Vertical
 // DESCRIPTION : Displays all customers in formatted vertical layout
 // PARAMETERS  :
-//      Customer customers[] : Array of customer records
-//      int count           : Number of customers to display
+//      RecordStore* customers : Customer store
 // RETURNS     : void
 //
-void Display_AllCustomers_Vertical(Customer customers[], int count) {
-    if (count == 0) {
+void Display_AllCustomers_Vertical(RecordStore* customers) {
+    if (customers->count == 0) {
         printf("No customers in database.\n");
         return;
     }
 
-    for (int i = 0; i < count; i++) {
-        Customer c = customers[i];
-        printf("------------------------------\n");
-        printf("Customer ID       : %d\n", c.customerID);
-        printf("Name              : %s\n", c.name);
-        printf("Address           : %s\n", c.address);
-        printf("City              : %s\n", c.city);
-        printf("Province          : %s\n", c.province);
-        printf("Postal Code       : %s\n", c.postalCode);
-        printf("Phone             : %s\n", c.phone);
-        printf("Email             : %s\n", c.email);
-        printf("Credit Limit      : $%.2f\n", c.creditLimit);
-        printf("Account Balance   : $%.2f\n", c.accountBalance);
-        printf("Join Date         : %s\n", c.joinDate);
-        printf("Last Payment      : %s\n", strlen(c.lastPayment) > 0 ? c.lastPayment : "(none)");
-        printf("------------------------------\n");
+    for (int i = 0; i < customers->count; i++) {
+        Display_Customer_Vertical(customerAt(customers, i));
     }
 }
 
@@ -84,16 +196,16 @@ void Display_AllCustomers_Vertical(Customer customers[], int count) {
 // FUNCTION    : isValidProvince
 // DESCRIPTION : Validates Canadian province/territory codes
 // PARAMETERS  :
-//      const char* code : 2-letter province code to validate
+//      std::string_view code : 2-letter province code to validate
 // RETURNS     : int - 1 if valid, 0 if invalid
 //
-int isValidProvince(const char* code) {
+int isValidProvince(std::string_view code) {
     const char* provinces[] = {
         "ON", "QC", "NS", "NB", "MB", "BC", "PE", "SK",
         "AB", "NL", "NT", "YT", "NU"
     };
     for (int i = 0; i < sizeof(provinces) / sizeof(provinces[0]); i++) {
-        if (strcmp(code, provinces[i]) == 0)
+        if (code == provinces[i])
             return 1;
     }
     return 0;
@@ -103,14 +215,14 @@ int isValidProvince(const char* code) {
 // FUNCTION    : isValidPostalCode
 // DESCRIPTION : Validates Canadian postal code format (A1A1A1)
 // PARAMETERS  :
-//      const char* code : Postal code to validate
+//      std::string_view code : Postal code to validate
 // RETURNS     : int - 1 if valid, 0 if invalid
 //
-int isValidPostalCode(const char* code) {
-    if (strlen(code) != 6) return 0;
+int isValidPostalCode(std::string_view code) {
+    if (code.size() != 6) return 0;
     for (int i = 0; i < 6; i++) {
-        if (i % 2 == 0 && !isalpha(code[i])) return 0;
-        if (i % 2 == 1 && !isdigit(code[i])) return 0;
+        if (i % 2 == 0 && !isalpha((unsigned char)code[i])) return 0;
+        if (i % 2 == 1 && !isdigit((unsigned char)code[i])) return 0;
     }
     return 1;
 }
@@ -119,16 +231,16 @@ int isValidPostalCode(const char* code) {
 // FUNCTION    : isValidPhone
 // DESCRIPTION : Validates phone number format (###-###-####)
 // PARAMETERS  :
-//      const char* phone : Phone number to validate
+//      std::string_view phone : Phone number to validate
 // RETURNS     : int - 1 if valid, 0 if invalid
 //
-int isValidPhone(const char* phone) {
-    if (strlen(phone) != 12) return 0;
+int isValidPhone(std::string_view phone) {
+    if (phone.size() != 12) return 0;
     for (int i = 0; i < 12; i++) {
         if (i == 3 || i == 7) {
             if (phone[i] != '-') return 0;
         }
-        else if (!isdigit(phone[i])) return 0;
+        else if (!isdigit((unsigned char)phone[i])) return 0;
     }
     return 1;
 }
@@ -137,21 +249,22 @@ int isValidPhone(const char* phone) {
 // FUNCTION    : isValidDateFormat
 // DESCRIPTION : Validates date format (YYYY-MM-DD)
 // PARAMETERS  :
-//      const char* date : Date string to validate
+//      std::string_view date : Date string to validate
 // RETURNS     : int - 1 if valid, 0 if invalid
 //
-int isValidDateFormat(const char* date) {
-    if (strlen(date) != 10) return 0;
+int isValidDateFormat(std::string_view date) {
+    if (date.size() != 10) return 0;
     if (date[4] != '-' || date[7] != '-') return 0;
 
     for (int i = 0; i < 10; i++) {
         if (i == 4 || i == 7) continue;
-        if (!isdigit(date[i])) return 0;
+        if (!isdigit((unsigned char)date[i])) return 0;
     }
 
-    int year, month, day;
-    if (sscanf_s(date, "%d-%d-%d", &year, &month, &day) != 3)
-        return 0;
+    // Every digit position is checked above, so the parts convert directly
+    int year = (date[0] - '0') * 1000 + (date[1] - '0') * 100 + (date[2] - '0') * 10 + (date[3] - '0');
+    int month = (date[5] - '0') * 10 + (date[6] - '0');
+    int day = (date[8] - '0') * 10 + (date[9] - '0');
 
     if (year < 2000 || year > 2100) return 0;
     if (month < 1 || month > 12) return 0;
@@ -160,15 +273,82 @@ int isValidDateFormat(const char* date) {
     return 1;
 }
 
+//
+// FUNCTION    : copyField
+// DESCRIPTION : Copies a validated field into a fixed record buffer
+// PARAMETERS  :
+//      char* dest             : Destination buffer
+//      size_t destSize        : Size of destination buffer
+//      std::string_view field : Field text (shorter than destSize)
+// RETURNS     : void
+//
+static void copyField(char* dest, size_t destSize, std::string_view field) {
+    size_t length = field.size() < destSize ? field.size() : destSize - 1;
+    memcpy(dest, field.data(), length);
+    dest[length] = '\0';
+}
+
+//
+// FUNCTION    : parseCustomerRecord
+// DESCRIPTION : Validates the fields of one customers.db line and fills a
+//               customer record. Shared by both loader modes; the mapped
+//               loader calls it from several threads, so it touches no
+//               shared state.
+// PARAMETERS  :
+//      const std::string_view fields[] : Fields of the line
+//      int fieldCount                  : Number of fields
+//      void* record                    : Receives the customer (Customer)
+//      RecordStore* extra              : Unused (no extra data)
+// RETURNS     : bool - true if the line holds a valid customer
+//
+static bool parseCustomerRecord(const std::string_view fields[], int fieldCount, void* record,
+    RecordStore* extra) {
+    (void)extra;
+    Customer* c = (Customer*)record;
+    if (fieldCount < 11) return false;
+
+    if (fields[0].size() == 0 || fields[0].size() > 50) return false;
+    if (fields[1].size() == 0 || fields[1].size() > 100) return false;
+    if (fields[2].size() == 0 || fields[2].size() > 100) return false;
+    if (fields[3].size() != 2 || !isValidProvince(fields[3])) return false;
+    if (fields[4].size() != 6 || !isValidPostalCode(fields[4])) return false;
+    if (fields[5].size() != 12 || !isValidPhone(fields[5])) return false;
+    if (fields[6].size() == 0 || fields[6].size() > 50) return false;
+
+    if (!parseIntField(fields[7], &c->customerID) || c->customerID <= 0) return false;
+    if (!parseFloatField(fields[8], &c->creditLimit) || c->creditLimit <= 0.0f) return false;
+    if (!parseFloatField(fields[9], &c->accountBalance) || c->accountBalance < 0.0f) return false;
+
+    if (fields[10].size() != 10 || !isValidDateFormat(fields[10])) return false;
+
+    if (fieldCount == 12 && fields[11].size() > 0) {
+        if (fields[11].size() > 10 || !isValidDateFormat(fields[11])) return false;
+        copyField(c->lastPayment, sizeof(c->lastPayment), fields[11]);
+    }
+    else {
+        c->lastPayment[0] = '\0';
+    }
+
+    // Text fields are copied only once the whole line has passed
+    copyField(c->name, sizeof(c->name), fields[0]);
+    copyField(c->address, sizeof(c->address), fields[1]);
+    copyField(c->city, sizeof(c->city), fields[2]);
+    copyField(c->province, sizeof(c->province), fields[3]);
+    copyField(c->postalCode, sizeof(c->postalCode), fields[4]);
+    copyField(c->phone, sizeof(c->phone), fields[5]);
+    copyField(c->email, sizeof(c->email), fields[6]);
+    copyField(c->joinDate, sizeof(c->joinDate), fields[10]);
+    return true;
+}
+
 //
 // FUNCTION    : listAllCustomers
 // DESCRIPTION : Provides menu for selecting customer display format
 // PARAMETERS  :
-//      Customer customers[] : Array of customer records
-//      int count           : Number of customers
+//      RecordStore* customers : Customer store
 // RETURNS     : void
 //
-void listAllCustomers(Customer customers[], int count) {
+void listAllCustomers(RecordStore* customers) {
     int choice;
     char buffer[MAX_INPUT_LENGTH];
 
@@ -186,8 +366,8 @@ void listAllCustomers(Customer customers[], int count) {
         }
 
         switch (choice) {
-        case 1: Display_AllCustomers_Horizontal(customers, count); break;
-        case 2: Display_AllCustomers_Vertical(customers, count); break;
+        case 1: Display_AllCustomers_Horizontal(customers); break;
+        case 2: Display_AllCustomers_Vertical(customers); break;
         case 3: return;
         default: printf("Invalid option. Try again.\n");
         }
@@ -198,15 +378,13 @@ void listAllCustomers(Customer customers[], int count) {
 // FUNCTION    : searchCustomer
 // DESCRIPTION : Searches customers by keyword across all fields
 // PARAMETERS  :
-//      Customer customers[] : Array of customer records
-//      int count           : Number of customers
+//      RecordStore* customers : Customer store
 // RETURNS     : void
 //
-void searchCustomer(Customer customers[], int count) {
+void searchCustomer(RecordStore* customers) {
     char keyword[51];
-    int found = 0;
 
-    if (count == 0) {
+    if (customers->count == 0) {
         printf("No customers in database.\n");
         return;
     }
@@ -215,57 +393,102 @@ void searchCustomer(Customer customers[], int count) {
     fgets(keyword, sizeof(keyword), stdin);
     keyword[strcspn(keyword, "\n")] = '\0';
 
+    searchCustomers(customers, keyword);
+}
+
+//
+// FUNCTION    : customerMatches
+// DESCRIPTION : Tells whether a customer's record line contains a keyword
+// PARAMETERS  :
+//      const Customer* c   : Customer
+//      const char* keyword : Text to look for
+// RETURNS     : bool - true if the keyword was found
+//
+static bool customerMatches(const Customer* c, const char* keyword) {
+    char recordLine[512];
+    sprintf_s(recordLine, sizeof(recordLine), "%d|%s|%s|%s|%s|%s|%s|%s|%.2f|%.2f|%s|%s",
+        c->customerID, c->name, c->address, c->city, c->province, c->postalCode,
+        c->phone, c->email, c->creditLimit, c->accountBalance, c->joinDate,
+        strlen(c->lastPayment) > 0 ? c->lastPayment : "(none)");
+
+    return strstr(recordLine, keyword) != NULL;
+}
+
+//
+// FUNCTION    : matchCustomers
+// DESCRIPTION : Flags the customers of one piece of a search
+// PARAMETERS  :
+//      void* arg : CustomerSearch
+//      int first : First customer of the piece
+//      int last  : One past the last customer
+// RETURNS     : void
+//
+static void matchCustomers(void* arg, int first, int last) {
+    CustomerSearch* search = (CustomerSearch*)arg;
+    for (int i = first; i < last; i++) {
+        search->matched[i] = customerMatches(customerAt(search->customers, i), search->keyword);
+    }
+}
+
+//
+// FUNCTION    : searchCustomers
+// DESCRIPTION : Displays every customer whose record contains a keyword.
+//               The store is scanned on the task pool and the matches are
+//               displayed in store order.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+//      const char* keyword    : Text to look for
+// RETURNS     : int - Number of customers found
+//
+int searchCustomers(RecordStore* customers, const char* keyword) {
+    int count = customers->count;
+    int found = 0;
+
+    if (count == 0) {
+        printf("No customers in database.\n");
+        return 0;
+    }
+
     if (strlen(keyword) == 0) {
         printf("No keyword entered.\n");
-        return;
+        return 0;
+    }
+
+    CustomerSearch search;
+    search.customers = customers;
+    search.keyword = keyword;
+    search.matched = (unsigned char*)malloc((size_t)count);
+    if (search.matched != NULL) {
+        taskParallelFor(count, STORE_CHUNK_RECORDS, 0, matchCustomers, &search);
     }
 
     printf("\n----- Search Results -----\n");
     for (int i = 0; i < count; i++) {
-        Customer c = customers[i];
-        char recordLine[512];
-        sprintf_s(recordLine, sizeof(recordLine), "%d|%s|%s|%s|%s|%s|%s|%s|%.2f|%.2f|%s|%s",
-            c.customerID, c.name, c.address, c.city, c.province, c.postalCode,
-            c.phone, c.email, c.creditLimit, c.accountBalance, c.joinDate,
-            strlen(c.lastPayment) > 0 ? c.lastPayment : "(none)");
-
-        if (strstr(recordLine, keyword)) {
-            Display_AllCustomers_Vertical(&c, 1);
-            found = 1;
+        const Customer* c = customerAt(customers, i);
+        bool matched = search.matched != NULL ? search.matched[i] != 0 : customerMatches(c, keyword);
+
+        if (matched) {
+            Display_Customer_Vertical(c);
+            found++;
         }
     }
+    free(search.matched);
 
     if (!found) {
         printf("No matches found.\n");
     }
+    return found;
 }
 
 //
 // FUNCTION    : addCustomer
 // DESCRIPTION : Adds a new customer with validated input
 // PARAMETERS  :
-//      Customer customers[] : Array of customer records
-//      int* count          : Pointer to customer count (will be incremented)
+//      RecordStore* customers : Customer store (will grow by one)
 // RETURNS     : void
 //
-void addCustomer(Customer customers[], int* count) {
-    if (*count >= MAX_CUSTOMERS) {
-        printf("Customer limit reached.\n");
-        return;
-    }
-
+void addCustomer(RecordStore* customers) {
     Customer c;
-    c.customerID = (*count == 0) ? 1 : customers[*count - 1].customerID + 1;
-    c.creditLimit = 500.00f;
-    c.accountBalance = 0.00f;
-    strcpy_s(c.lastPayment, sizeof(c.lastPayment), "");
-
-    time_t t = time(NULL);
-    struct tm tm_info;
-    if (localtime_s(&tm_info, &t) == 0) {
-        strftime(c.joinDate, sizeof(c.joinDate), "%Y-%m-%d", &tm_info);
-    }
-
     char buffer[MAX_INPUT_LENGTH];
 
     while (1) {
@@ -345,21 +568,51 @@ void addCustomer(Customer customers[], int* count) {
         printf("Invalid email.\n");
     }
 
-    customers[*count] = c;
-    (*count)++;
-    printf("Customer added with ID %d\n", c.customerID);
+    addCustomerRecord(customers, &c);
+}
+
+//
+// FUNCTION    : addCustomerRecord
+// DESCRIPTION : Adds a new customer whose contact fields are filled in. The
+//               ID, credit limit, balance and dates are set here.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store (will grow by one)
+//      Customer* c            : New customer (receives the assigned fields)
+// RETURNS     : bool - true if the customer was added
+//
+bool addCustomerRecord(RecordStore* customers, Customer* c) {
+    c->customerID = (customers->count == 0) ? 1 : customerAt(customers, customers->count - 1)->customerID + 1;
+    c->creditLimit = 500.00f;
+    c->accountBalance = 0.00f;
+    strcpy_s(c->lastPayment, sizeof(c->lastPayment), "");
+
+    time_t t = time(NULL);
+    struct tm tm_info;
+    if (localtime_s(&tm_info, &t) == 0) {
+        strftime(c->joinDate, sizeof(c->joinDate), "%Y-%m-%d", &tm_info);
+    }
+
+    Customer* slot = (Customer*)storeAppend(customers);
+    if (slot == NULL) {
+        printf("Not enough memory to add customer.\n");
+        return false;
+    }
+    *slot = *c;
+    walLogCustomer(slot);
+    syncCustomerIndex(customers);
+    printf("Customer added with ID %d\n", c->customerID);
     logMessage("New customer added");
+    return true;
 }
 
 //
 // FUNCTION    : updateCustomerInfo
 // DESCRIPTION : Updates existing customer information with validation
 // PARAMETERS  :
-//      Customer customers[] : Array of customer records
-//      int count           : Number of customers
+//      RecordStore* customers : Customer store
 // RETURNS     : void
 //
-void updateCustomerInfo(Customer customers[], int count) {
+void updateCustomerInfo(RecordStore* customers) {
     int id;
     char buffer[MAX_INPUT_LENGTH];
 
@@ -370,118 +623,134 @@ void updateCustomerInfo(Customer customers[], int count) {
         return;
     }
 
-    int index = -1;
-    for (int i = 0; i < count; i++) {
-        if (customers[i].customerID == id) {
-            index = i;
-            break;
-        }
-    }
-
+    int index = findCustomer(customers, id);
     if (index == -1) {
         printf("Customer not found.\n");
         return;
     }
 
-    Customer* c = &customers[index];
+    Customer* c = customerAt(customers, index);
     printf("Updating info for %s (ID %d)\n", c->name, c->customerID);
 
-    printf("Enter new email (blank to skip): ");
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = '\0';
-    if (strlen(buffer) > 0) {
-        if (strlen(buffer) <= 50) {
-            strcpy_s(c->email, sizeof(c->email), buffer);
-        }
-        else {
-            printf("Invalid email length.\n");
-        }
+    static const char* const prompts[][2] = {
+        { "email", "Enter new email (blank to skip): " },
+        { "phone", "Enter new phone (123-456-7890, blank to skip): " },
+        { "address", "Enter new address (blank to skip): " },
+        { "city", "Enter new city (blank to skip): " },
+        { "province", "Enter new province (2 letters, blank to skip): " },
+        { "postal", "Enter new postal code (A1A1A1, blank to skip): " }
+    };
+    for (int i = 0; i < (int)(sizeof(prompts) / sizeof(prompts[0])); i++) {
+        printf("%s", prompts[i][1]);
+        fgets(buffer, sizeof(buffer), stdin);
+        buffer[strcspn(buffer, "\n")] = '\0';
+        if (strlen(buffer) > 0) setCustomerField(customers, index, prompts[i][0], buffer);
     }
 
-    printf("Enter new phone (123-456-7890, blank to skip): ");
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = '\0';
-    if (strlen(buffer) > 0) {
-        if (isValidPhone(buffer)) {
-            strcpy_s(c->phone, sizeof(c->phone), buffer);
-        }
-        else {
-            printf("Invalid phone format.\n");
-        }
-    }
+    printf("Customer record updated.\n");
+    logMessage("Customer information updated");
+}
 
-    printf("Enter new address (blank to skip): ");
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = '\0';
-    if (strlen(buffer) > 0) {
-        if (strlen(buffer) <= 100) {
-            strcpy_s(c->address, sizeof(c->address), buffer);
-        }
-        else {
-            printf("Invalid address length.\n");
-        }
-    }
+//
+// FUNCTION    : changeCustomerField
+// DESCRIPTION : Changes one contact field of a customer after validating
+//               the new value
+// PARAMETERS  :
+//      Customer* c       : Customer to update
+//      const char* field : email, phone, address, city, province or postal
+//      const char* value : New value
+// RETURNS     : bool - true if the field was changed
+//
+static bool changeCustomerField(Customer* c, const char* field, const char* value) {
+    size_t length = strlen(value);
 
-    printf("Enter new city (blank to skip): ");
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = '\0';
-    if (strlen(buffer) > 0) {
-        if (strlen(buffer) <= 100) {
-            strcpy_s(c->city, sizeof(c->city), buffer);
+    if (strcmp(field, "email") == 0) {
+        if (length > 0 && length <= 50) {
+            strcpy_s(c->email, sizeof(c->email), value);
+            return true;
         }
-        else {
-            printf("Invalid city length.\n");
+        printf("Invalid email length.\n");
+    }
+    else if (strcmp(field, "phone") == 0) {
+        if (isValidPhone(value)) {
+            strcpy_s(c->phone, sizeof(c->phone), value);
+            return true;
         }
+        printf("Invalid phone format.\n");
     }
-
-    printf("Enter new province (2 letters, blank to skip): ");
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = '\0';
-    if (strlen(buffer) > 0) {
-        if (strlen(buffer) == 2 && isValidProvince(buffer)) {
-            strcpy_s(c->province, sizeof(c->province), buffer);
+    else if (strcmp(field, "address") == 0) {
+        if (length > 0 && length <= 100) {
+            strcpy_s(c->address, sizeof(c->address), value);
+            return true;
         }
-        else {
-            printf("Invalid province code.\n");
+        printf("Invalid address length.\n");
+    }
+    else if (strcmp(field, "city") == 0) {
+        if (length > 0 && length <= 100) {
+            strcpy_s(c->city, sizeof(c->city), value);
+            return true;
         }
+        printf("Invalid city length.\n");
     }
-
-    printf("Enter new postal code (A1A1A1, blank to skip): ");
-    fgets(buffer, sizeof(buffer), stdin);
-    buffer[strcspn(buffer, "\n")] = '\0';
-    if (strlen(buffer) > 0) {
-        if (isValidPostalCode(buffer)) {
-            strcpy_s(c->postalCode, sizeof(c->postalCode), buffer);
+    else if (strcmp(field, "province") == 0) {
+        if (length == 2 && isValidProvince(value)) {
+            strcpy_s(c->province, sizeof(c->province), value);
+            return true;
         }
-        else {
-            printf("Invalid postal code.\n");
+        printf("Invalid province code.\n");
+    }
+    else if (strcmp(field, "postal") == 0) {
+        if (isValidPostalCode(value)) {
+            strcpy_s(c->postalCode, sizeof(c->postalCode), value);
+            return true;
         }
+        printf("Invalid postal code.\n");
     }
+    else {
+        printf("Unknown customer field %s.\n", field);
+    }
+    return false;
+}
 
-    printf("Customer record updated.\n");
-    logMessage("Customer information updated");
+//
+// FUNCTION    : setCustomerField
+// DESCRIPTION : Changes one contact field of a customer after validating
+//               the new value, and logs the changed customer
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+//      int index              : Store position of the customer
+//      const char* field      : email, phone, address, city, province or postal
+//      const char* value      : New value
+// RETURNS     : bool - true if the field was changed
+//
+bool setCustomerField(RecordStore* customers, int index, const char* field, const char* value) {
+    Customer* c = customerAt(customers, index);
+    if (!changeCustomerField(c, field, value)) return false;
+    storeMarkDirty(customers, index);
+    walLogCustomer(c);
+    return true;
 }
 
 //
 // FUNCTION    : listBadCreditCustomers
 // DESCRIPTION : Lists customers who have exceeded their credit limit
 // PARAMETERS  :
-//      Customer customers[] : Array of customer records
-//      int count           : Number of customers
+//      RecordStore* customers : Customer store
 // RETURNS     : void
 //
-void listBadCreditCustomers(Customer customers[], int count) {
+void listBadCreditCustomers(RecordStore* customers) {
     printf("\n--- Customers in Bad Credit Standing ---\n");
     int found = 0;
 
-    for (int i = 0; i < count; i++) {
-        if (customers[i].accountBalance > customers[i].creditLimit) {
+    for (int i = 0; i < customers->count; i++) {
+        const Customer* c = customerAt(customers, i);
+        if (c->accountBalance > c->creditLimit) {
             printf("ID: %d | Name: %s | Email: %s | Balance: $%.2f | Limit: $%.2f\n",
-                customers[i].customerID,
-                customers[i].name,
-                customers[i].email,
-                customers[i].accountBalance,
-                customers[i].creditLimit);
+                c->customerID,
+                c->name,
+                c->email,
+                c->accountBalance,
+                c->creditLimit);
             found = 1;
         }
     }
@@ -492,30 +761,47 @@ void listBadCreditCustomers(Customer customers[], int count) {
 }
 
 //
-// FUNCTION    : loadCustomers
-// DESCRIPTION : Loads customers from file with validation
+// FUNCTION    : appendCustomer
+// DESCRIPTION : Adds a loaded customer to the end of the store
 // PARAMETERS  :
-//      Customer customers[] : Array to store loaded customers
-//      int max             : Maximum number of customers to load
-// RETURNS     : int - Number of customers successfully loaded
+//      RecordStore* customers : Customer store
+//      const Customer* c      : Customer to add
+// RETURNS     : bool - true on success, false if out of memory
+//
+static bool appendCustomer(RecordStore* customers, const Customer* c) {
+    Customer* slot = (Customer*)storeAppend(customers);
+    if (slot == NULL) {
+        statusPrintf("Not enough memory to load all customers.\n");
+        return false;
+    }
+    *slot = *c;
+    return true;
+}
+
 //
-int loadCustomers(Customer customers[], int max) {
+// FUNCTION    : loadCustomersStdio
+// DESCRIPTION : Reads customers.db line by line with fgets and strtok_s
+// PARAMETERS  :
+//      RecordStore* customers : Customer store to fill
+// RETURNS     : bool - false if the file could not be opened
+//
+static bool loadCustomersStdio(RecordStore* customers) {
     FILE* fp = NULL;
     errno_t err = fopen_s(&fp, "customers.db", "r");
     if (err != 0 || fp == NULL) {
-        printf("Error loading customers.\n");
-        return 0;
+        return false;
     }
 
     char line[MAX_LINE_LENGTH];
-    int count = 0;
+    storeClear(customers);
+    storeReserveForFile(customers, "customers.db", CUSTOMER_MIN_LINE);
 
-    while (fgets(line, sizeof(line), fp) && count < max) {
+    while (fgets(line, sizeof(line), fp)) {
         line[strcspn(line, "\r\n")] = '\0';
 
         Customer c;
         char* context = NULL;
-        char* fields[12] = { NULL };
+        std::string_view fields[12];
         int fieldCount = 0;
 
         char* token = strtok_s(line, "|", &context);
@@ -524,64 +810,78 @@ int loadCustomers(Customer customers[], int max) {
             token = strtok_s(NULL, "|", &context);
         }
 
-        if (fieldCount < 11) continue;
-
-        if (strlen(fields[0]) == 0 || strlen(fields[0]) > 50) continue;
-        strcpy_s(c.name, sizeof(c.name), fields[0]);
-
-        if (strlen(fields[1]) == 0 || strlen(fields[1]) > 100) continue;
-        strcpy_s(c.address, sizeof(c.address), fields[1]);
-
-        if (strlen(fields[2]) == 0 || strlen(fields[2]) > 100) continue;
-        strcpy_s(c.city, sizeof(c.city), fields[2]);
-
-        if (strlen(fields[3]) != 2 || !isValidProvince(fields[3])) continue;
-        strcpy_s(c.province, sizeof(c.province), fields[3]);
-
-        if (strlen(fields[4]) != 6 || !isValidPostalCode(fields[4])) continue;
-        strcpy_s(c.postalCode, sizeof(c.postalCode), fields[4]);
-
-        if (strlen(fields[5]) != 12 || !isValidPhone(fields[5])) continue;
-        strcpy_s(c.phone, sizeof(c.phone), fields[5]);
-
-        if (strlen(fields[6]) == 0 || strlen(fields[6]) > 50) continue;
-        strcpy_s(c.email, sizeof(c.email), fields[6]);
+        if (!parseCustomerRecord(fields, fieldCount, &c, NULL)) continue;
+        if (!appendCustomer(customers, &c)) break;
+    }
 
-        if (sscanf_s(fields[7], "%d", &c.customerID) != 1 || c.customerID <= 0) continue;
+    fclose(fp);
+    return true;
+}
 
-        if (sscanf_s(fields[8], "%f", &c.creditLimit) != 1 || c.creditLimit <= 0.0f) continue;
+//
+// FUNCTION    : loadCustomersMapped
+// DESCRIPTION : Reads customers.db through a read-only memory mapping.
+//               Fields are validated in place; large files are parsed on
+//               several threads and merged back in file order.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store to fill
+// RETURNS     : bool - false if the file could not be mapped
+//
+static bool loadCustomersMapped(RecordStore* customers) {
+    MappedFile file;
+    if (!mapDbFile(&file, "customers.db")) {
+        return false;
+    }
 
-        if (sscanf_s(fields[9], "%f", &c.accountBalance) != 1 || c.accountBalance < 0.0f) continue;
+    storeClear(customers);
+    storeReserveForFile(customers, "customers.db", CUSTOMER_MIN_LINE);
 
-        if (strlen(fields[10]) != 10 || !isValidDateFormat(fields[10])) continue;
-        strcpy_s(c.joinDate, sizeof(c.joinDate), fields[10]);
+    if (!loadDbRecords(&file, DB_CUT_AT_CR, 12, parseCustomerRecord, customers, NULL)) {
+        statusPrintf("Not enough memory to load all customers.\n");
+    }
 
-        if (fieldCount == 12 && strlen(fields[11]) > 0) {
-            if (strlen(fields[11]) > 10 || !isValidDateFormat(fields[11])) continue;
-            strcpy_s(c.lastPayment, sizeof(c.lastPayment), fields[11]);
-        }
-        else {
-            c.lastPayment[0] = '\0';
-        }
+    unmapDbFile(&file);
+    return true;
+}
 
-        customers[count++] = c;
+//
+// FUNCTION    : loadCustomers
+// DESCRIPTION : Loads customers from file with validation, replacing the
+//               contents of the store. Uses the reader set by dbLoadMode and
+//               falls back to stdio if the file cannot be mapped.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store to fill
+// RETURNS     : int - Number of customers successfully loaded
+//
+int loadCustomers(RecordStore* customers) {
+    bool loaded = dbLoadMode == DB_LOAD_MAPPED && loadCustomersMapped(customers);
+    if (!loaded && !loadCustomersStdio(customers)) {
+        statusPrintf("Error loading customers.\n");
+        storeClear(customers);
+        indexCustomers(customers);
+        return 0;
     }
 
-    fclose(fp);
-    printf("Loaded %d customers from customers.db\n", count);
+    int count = customers->count;
+    indexCustomers(customers);
+    walLogReload(SNAPSHOT_CUSTOMERS);
+    statusPrintf("Loaded %d customers from customers.db\n", count);
     logMessage("Customer database loaded");
     return count;
 }
 
 //
 // FUNCTION    : saveCustomers
-// DESCRIPTION : Saves all customers to file in pipe-delimited format
+// DESCRIPTION : Saves all customers to file in pipe-delimited format. With
+//               lazy start it first waits for the mapped snapshots to be
+//               checked.
 // PARAMETERS  :
-//      Customer customers[] : Array of customer records to save
-//      int count           : Number of customers to save
+//      RecordStore* customers : Customer store to save
 // RETURNS     : void
 //
-void saveCustomers(Customer customers[], int count) {
+void saveCustomers(RecordStore* customers) {
+    warmupWait();
+    int count = customers->count;
     FILE* fp = NULL;
     errno_t err = fopen_s(&fp, "customers.db", "w");
     if (err != 0 || fp == NULL) {
@@ -590,19 +890,20 @@ void saveCustomers(Customer customers[], int count) {
     }
 
     for (int i = 0; i < count; i++) {
+        const Customer* c = customerAt(customers, i);
         fprintf(fp, "%s|%s|%s|%s|%s|%s|%s|%d|%.2f|%.2f|%s|%s|\n",
-            customers[i].name,
-            customers[i].address,
-            customers[i].city,
-            customers[i].province,
-            customers[i].postalCode,
-            customers[i].phone,
-            customers[i].email,
-            customers[i].customerID,
-            customers[i].creditLimit,
-            customers[i].accountBalance,
-            customers[i].joinDate,
-            customers[i].lastPayment);
+            c->name,
+            c->address,
+            c->city,
+            c->province,
+            c->postalCode,
+            c->phone,
+            c->email,
+            c->customerID,
+            c->creditLimit,
+            c->accountBalance,
+            c->joinDate,
+            c->lastPayment);
     }
 
     fclose(fp);
@@ -610,15 +911,111 @@ void saveCustomers(Customer customers[], int count) {
     logMessage("Customer database saved");
 }
 
+//
+// FUNCTION    : mapCustomerSnapshot
+// DESCRIPTION : Lazy start-up (pwh -l): maps customers.snap and the ID
+//               index saved with it instead of reading them. An index
+//               that is missing, damaged or from another snapshot is
+//               rebuilt and saved for the next start.
+// PARAMETERS  :
+//      RecordStore* customers : Empty customer store to fill
+// RETURNS     : bool - false if the snapshot could not be mapped
+//
+static bool mapCustomerSnapshot(RecordStore* customers) {
+    unsigned long long tag;
+    if (!mapSnapshot(CUSTOMER_SNAPSHOT_FILE, SNAPSHOT_CUSTOMERS, customers, &tag, true)) return false;
+
+    long long largestId;
+    if (idIndexMap(&customerIndex, CUSTOMER_INDEX_FILE, tag, customers, customers->count, &largestId)) {
+        customerVersion++;
+    }
+    else {
+        indexCustomers(customers);
+        idIndexSave(&customerIndex, CUSTOMER_INDEX_FILE, tag);
+    }
+
+    statusPrintf("Mapped %d customers from customers.snap\n", customers->count);
+    logMessage("Customer snapshot mapped");
+    return true;
+}
+
+//
+// FUNCTION    : loadCustomerSnapshot
+// DESCRIPTION : Loads customers from customers.snap when it is at least as new
+//               as customers.db, replacing the contents of the store. With
+//               lazy start the snapshot is mapped instead.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store to fill
+// RETURNS     : bool - false if there is no usable snapshot, in which case
+//               customers.db should be imported instead
+//
+bool loadCustomerSnapshot(RecordStore* customers) {
+    if (!snapshotIsCurrent(CUSTOMER_SNAPSHOT_FILE, "customers.db")) return false;
+    if (lazyStart && mapCustomerSnapshot(customers)) return true;
+
+    if (!loadSnapshot(CUSTOMER_SNAPSHOT_FILE, SNAPSHOT_CUSTOMERS, customers)) {
+        statusPrintf("Ignoring unusable customers.snap, importing customers.db\n");
+        return false;
+    }
+
+    indexCustomers(customers);
+    statusPrintf("Loaded %d customers from customers.snap\n", customers->count);
+    logMessage("Customer snapshot loaded");
+    return true;
+}
+
+//
+// FUNCTION    : saveCustomerSnapshot
+// DESCRIPTION : Saves all customers to customers.snap (and their ID index
+//               with lazy start)
+// PARAMETERS  :
+//      RecordStore* customers : Customer store to save
+// RETURNS     : bool - true on success
+//
+bool saveCustomerSnapshot(RecordStore* customers) {
+    if (!saveSnapshot(CUSTOMER_SNAPSHOT_FILE, SNAPSHOT_CUSTOMERS, customers)) {
+        printf("Error saving customers.snap.\n");
+        return false;
+    }
+    saveCustomerIndex(customers);
+
+    printf("Saved %d customers to customers.snap\n", customers->count);
+    logMessage("Customer snapshot saved");
+    return true;
+}
+
+//
+// FUNCTION    : saveCustomerIndex
+// DESCRIPTION : With lazy start, builds the ID index of a customer store
+//               just saved to customers.snap and saves it beside it, so
+//               the next start maps it. Does nothing otherwise; a start
+//               that finds no usable index builds it then.
+// PARAMETERS  :
+//      const RecordStore* customers : Store as saved to the snapshot
+// RETURNS     : void
+//
+void saveCustomerIndex(const RecordStore* customers) {
+    unsigned long long tag;
+    if (!lazyStart || !snapshotTag(CUSTOMER_SNAPSHOT_FILE, &tag)) return;
+
+    IdIndex index;
+    memset(&index, 0, sizeof(index));
+    idIndexReset(&index, customers, customers->count);
+    for (int i = 0; i < customers->count; i++) {
+        idIndexInsert(&index, customerAt(customers, i)->customerID, i);
+    }
+    idIndexSave(&index, CUSTOMER_INDEX_FILE, tag);
+    idIndexFree(&index);
+}
+
 //
 // FUNCTION    : customersMenu
 // DESCRIPTION : Main customer management menu interface
 // PARAMETERS  :
-//      Customer customers[] : Array of customer records
-//      int* count          : Pointer to customer count
+//      RecordStore* customers : Customer store
 // RETURNS     : void
 //
-void customersMenu(Customer customers[], int* count) {
+void customersMenu(RecordStore* customers) {
     int choice;
     char buffer[MAX_INPUT_LENGTH];
 
@@ -632,15 +1029,18 @@ void customersMenu(Customer customers[], int* count) {
         }
 
         switch (choice) {
-        case 1: listAllCustomers(customers, *count); break;
-        case 2: searchCustomer(customers, *count); break;
-        case 3: addCustomer(customers, count); break;
-        case 4: updateCustomerInfo(customers, *count); break;
-        case 5: listBadCreditCustomers(customers, *count); break;
-        case 6: *count = loadCustomers(customers, MAX_CUSTOMERS); break;
-        case 7: saveCustomers(customers, *count); break;
+        case 1: listAllCustomers(customers); break;
+        case 2: searchCustomer(customers); break;
+        case 3: addCustomer(customers); break;
+        case 4: updateCustomerInfo(customers); break;
+        case 5: listBadCreditCustomers(customers); break;
+        case 6: loadCustomers(customers); break;
+        case 7: saveCustomers(customers); break;
         case 8: return;
         default: printf("Invalid choice.\n");
         }
+        walCommit();
+        checkpointPoll();
+        repairCustomerIndex(customers);
     } while (1);
 }
\ No newline at end of file
@@ -13,9 +13,14 @@
 #ifndef CUSTOMER_H
 #define CUSTOMER_H
 
-#define MAX_CUSTOMERS 50        // Maximum number of customers in system
+#include "RecordStore.h"
+#include <string_view>
+
 #define MAX_LINE_LENGTH 512     // Maximum length for file input lines
 #define MAX_INPUT_LENGTH 100    // Maximum length for user input
+#define CUSTOMER_MIN_LINE 50    // Shortest valid customers.db line (for store sizing)
+#define CUSTOMER_SNAPSHOT_FILE "customers.snap" // Binary snapshot of the customer store
+#define CUSTOMER_INDEX_FILE "customers.idx" // Customer ID index saved with the snapshot (lazy start)
 
 // Customer data structure
 typedef struct {
@@ -33,18 +38,40 @@ typedef struct {
     char lastPayment[11];       // Date of last payment (YYYY-MM-DD + null)
 } Customer;
 
+//
+// FUNCTION    : customerAt
+// DESCRIPTION : Returns the customer stored at a position
+// PARAMETERS  :
+//      const RecordStore* customers : Customer store
+//      int index                   : Record position
+// RETURNS     : Customer* - Address of the customer
+//
+inline Customer* customerAt(const RecordStore* customers, int index) {
+    return (Customer*)storeAt(customers, index);
+}
+
 // Function prototypes
-void customersMenu(Customer customers[], int* count);            // Main customer menu
-void listAllCustomers(Customer customers[], int count);          // List all customers
-void searchCustomer(Customer customers[], int count);            // Search customers
-void addCustomer(Customer customers[], int* count);              // Add new customer
-void updateCustomerInfo(Customer customers[], int count);        // Update customer info
-void listBadCreditCustomers(Customer customers[], int count);    // List customers with bad credit
-int loadCustomers(Customer customers[], int max);                // Load customers from file
-void saveCustomers(Customer customers[], int count);             // Save customers to file
-int isValidProvince(const char* code);                          // Validate province code
-int isValidPostalCode(const char* code);                        // Validate postal code
-int isValidPhone(const char* phone);                            // Validate phone format
-int isValidDateFormat(const char* date);                        // Validate date format
+void customersMenu(RecordStore* customers);                     // Main customer menu
+void listAllCustomers(RecordStore* customers);                  // List all customers
+void searchCustomer(RecordStore* customers);                    // Search customers
+void addCustomer(RecordStore* customers);                       // Add new customer
+void updateCustomerInfo(RecordStore* customers);                // Update customer info
+int searchCustomers(RecordStore* customers, const char* keyword); // Show customers matching a keyword
+bool addCustomerRecord(RecordStore* customers, Customer* c);    // Add a customer without prompting
+bool setCustomerField(RecordStore* customers, int index, const char* field, const char* value); // Change one contact field
+void listBadCreditCustomers(RecordStore* customers);            // List customers with bad credit
+int loadCustomers(RecordStore* customers);                      // Load customers from file
+void saveCustomers(RecordStore* customers);                     // Save customers to file
+bool loadCustomerSnapshot(RecordStore* customers);              // Load customers from snapshot
+bool saveCustomerSnapshot(RecordStore* customers);              // Save customers to snapshot
+void saveCustomerIndex(const RecordStore* customers);           // Save the ID index for a saved snapshot
+void indexCustomers(RecordStore* customers);                    // Rebuild customer ID index
+void repairCustomerIndex(RecordStore* customers);               // Rebuild the index if the warm-up check failed it
+int findCustomer(RecordStore* customers, int customerID);       // Find customer position by ID
+unsigned int customerStoreVersion(RecordStore* customers);      // Changes when customers are loaded or added
+int isValidProvince(std::string_view code);                     // Validate province code
+int isValidPostalCode(std::string_view code);                   // Validate postal code
+int isValidPhone(std::string_view phone);                       // Validate phone format
+int isValidDateFormat(std::string_view date);                   // Validate date format
 
 #endif
\ No newline at end of file
@@ -0,0 +1,773 @@
+/*
+* FILE          : DbReader.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of database file reading including:
+*      - Memory mapping on Windows and POSIX systems, or a whole-file
+*        read when the io_uring backend is selected
+*      - Parallel chunked parsing with an in-order merge
+*      - Record splitting with SSE2/AVX2 delimiter scanning and a
+*        scalar fallback
+*      - Locale-free integer and decimal parsing
+*/
+
+#include "DbReader.h"
+#include "FileIo.h"
+#include "TaskPool.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+
+// Widest vector unit the build targets. Builds with /arch:AVX2 (MSVC) or
+// -mavx2 (GCC/Clang) scan 32 bytes at a time; x64 builds always have SSE2.
+#if defined(__AVX2__)
+#define DB_SCAN_AVX2
+#define DB_SCAN_BLOCK 32
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DB_SCAN_SSE2
+#define DB_SCAN_BLOCK 16
+#include <emmintrin.h>
+#else
+#define DB_SCAN_BLOCK 32
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define DB_FAST_FLOAT_MANTISSA  (1ULL << 24)  // Largest mantissa a float holds exactly
+#define DB_FAST_FLOAT_EXPONENT  10            // Largest power of ten a float holds exactly
+#define DB_MAX_MANTISSA_DIGITS  19            // Digits that always fit in 64 bits
+
+static const float powersOfTen[DB_FAST_FLOAT_EXPONENT + 1] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// One line-aligned piece of a file and the records parsed from it
+typedef struct {
+    size_t start;               // Offset of the first byte of the piece
+    size_t end;                 // Offset one past the last byte
+    RecordStore records;        // Records parsed from the piece, in file order
+    RecordStore extraRecords;   // Extra data of those records
+    bool complete;              // false if the piece ran out of memory
+    int firstIndex;             // Position of the first record in the merged store
+    int firstExtra;             // Position of the first extra entry in the merged extra store
+} DbChunk;
+
+// Work shared by the threads of one parallel load
+typedef struct {
+    const MappedFile* file;
+    DbReturnMode returnMode;
+    int maxFields;
+    DbRecordParser parser;
+    DbChunk* chunks;
+    int chunkCount;
+    RecordStore* store;         // Store receiving the merged records
+    const DbExtraData* extra;   // Extra data of the load, NULL if none
+    std::atomic<int> nextChunk; // Next piece to hand out
+    TaskGroup* group;           // Tasks of the current pass, cancelled when memory runs out
+} DbLoadJob;
+
+DbLoadMode dbLoadMode = DB_LOAD_MAPPED;
+int dbLoadThreads = 0;
+
+//
+// FUNCTION    : mapDbFile
+// DESCRIPTION : Maps a database file into memory read-only. An empty file
+//               maps successfully with no data. With the io_uring backend
+//               the file is read into a buffer instead, in large blocks
+//               with read-ahead; if that read fails the file is mapped.
+// PARAMETERS  :
+//      MappedFile* file     : Receives the mapping
+//      const char* filename : File to map
+// RETURNS     : bool - true on success, false if the file cannot be mapped
+//
+bool mapDbFile(MappedFile* file, const char* filename) {
+    file->data = NULL;
+    file->size = 0;
+    file->fileHandle = NULL;
+    file->mappingHandle = NULL;
+    file->buffer = NULL;
+
+    if (fileIoMode == FILE_IO_URING && fileIoAvailable()) {
+        char* data = NULL;
+        size_t size = 0;
+        if (ioReadFile(filename, &data, &size)) {
+            file->data = data;
+            file->size = size;
+            file->buffer = data;
+            return true;
+        }
+    }
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) {
+        CloseHandle(handle);
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(handle);
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    const char* data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == NULL) {
+        CloseHandle(mapping);
+        CloseHandle(handle);
+        return false;
+    }
+
+    file->data = data;
+    file->size = (size_t)size.QuadPart;
+    file->fileHandle = handle;
+    file->mappingHandle = mapping;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    if (info.st_size == 0) {
+        close(fd);
+        return true;
+    }
+
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+    file->data = (const char*)data;
+    file->size = (size_t)info.st_size;
+#endif
+    return true;
+}
+
+//
+// FUNCTION    : unmapDbFile
+// DESCRIPTION : Releases a mapping or buffer made by mapDbFile
+// PARAMETERS  :
+//      MappedFile* file : Mapping to release
+// RETURNS     : void
+//
+void unmapDbFile(MappedFile* file) {
+    if (file->buffer != NULL) {
+        ioFreeBuffer(file->buffer);
+        file->data = NULL;
+    }
+#ifdef _WIN32
+    if (file->data != NULL) UnmapViewOfFile(file->data);
+    if (file->mappingHandle != NULL) CloseHandle((HANDLE)file->mappingHandle);
+    if (file->fileHandle != NULL) CloseHandle((HANDLE)file->fileHandle);
+#else
+    if (file->data != NULL) munmap((void*)file->data, file->size);
+#endif
+    file->data = NULL;
+    file->size = 0;
+    file->fileHandle = NULL;
+    file->mappingHandle = NULL;
+    file->buffer = NULL;
+}
+
+//
+// FUNCTION    : lowestSetBit
+// DESCRIPTION : Index of the lowest set bit of a non-zero delimiter mask
+// PARAMETERS  :
+//      unsigned int mask : Non-zero mask
+// RETURNS     : int - Bit index
+//
+static inline int lowestSetBit(unsigned int mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+//
+// FUNCTION    : delimiterMask
+// DESCRIPTION : Classifies one block of up to DB_SCAN_BLOCK bytes in a
+//               single pass. Full blocks are compared against '|', '\n' and
+//               '\r' with AVX2 or SSE2; the short block at the end of a file
+//               is examined a byte at a time so no load passes the mapping.
+// PARAMETERS  :
+//      const char* block : Start of the block
+//      size_t length     : Bytes available from block
+// RETURNS     : unsigned int - Bit i set if block[i] is a delimiter
+//
+static inline unsigned int delimiterMask(const char* block, size_t length) {
+    if (length >= DB_SCAN_BLOCK) {
+#if defined(DB_SCAN_AVX2)
+        __m256i bytes = _mm256_loadu_si256((const __m256i*)block);
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('|')),
+            _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n')),
+                _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\r'))));
+        return (unsigned int)_mm256_movemask_epi8(hits);
+#elif defined(DB_SCAN_SSE2)
+        __m128i bytes = _mm_loadu_si128((const __m128i*)block);
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('|')),
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')),
+                _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r'))));
+        return (unsigned int)_mm_movemask_epi8(hits);
+#endif
+    }
+
+    unsigned int mask = 0;
+    size_t count = length < DB_SCAN_BLOCK ? length : DB_SCAN_BLOCK;
+    for (size_t i = 0; i < count; i++) {
+        if (block[i] == '|' || block[i] == '\n' || block[i] == '\r') mask |= 1u << i;
+    }
+    return mask;
+}
+
+//
+// FUNCTION    : nextDbRecord
+// DESCRIPTION : Splits the next line of a mapped file on '|'. The line is
+//               read block by block and every delimiter in a block is taken
+//               from one mask, so the bytes are examined only once. Empty
+//               fields are skipped, matching strtok_s, so both loader modes
+//               accept the same lines. Lines have no length limit; fields
+//               beyond maxFields are dropped.
+// PARAMETERS  :
+//      const MappedFile* file    : Mapped file
+//      size_t* offset            : Read position, advanced past the line
+//      DbReturnMode returnMode   : How a '\r' inside the line is treated
+//      std::string_view fields[] : Receives the fields
+//      int maxFields             : Capacity of fields[]
+// RETURNS     : int - Number of fields found, or -1 at the end of the file
+//
+int nextDbRecord(const MappedFile* file, size_t* offset, DbReturnMode returnMode,
+    std::string_view fields[], int maxFields) {
+    if (*offset >= file->size) return -1;
+
+    const char* end = file->data + file->size;
+    const char* fieldStart = file->data + *offset;
+    bool lineCut = false;
+    int count = 0;
+
+    for (const char* block = fieldStart; block < end; block += DB_SCAN_BLOCK) {
+        unsigned int mask = delimiterMask(block, (size_t)(end - block));
+
+        while (mask != 0) {
+            const char* delimiter = block + lowestSetBit(mask);
+            mask &= mask - 1;
+
+            if (*delimiter == '\n') {
+                const char* fieldEnd = delimiter;
+                if (fieldEnd > fieldStart && fieldEnd[-1] == '\r') fieldEnd--;
+                if (!lineCut && fieldEnd > fieldStart && count < maxFields) {
+                    fields[count++] = std::string_view(fieldStart, (size_t)(fieldEnd - fieldStart));
+                }
+                *offset = (size_t)(delimiter - file->data) + 1;
+                return count;
+            }
+            if (lineCut) continue;
+
+            // A '\r' kept by DB_TRIM_CRLF is ordinary field text
+            if (*delimiter == '|' || returnMode == DB_CUT_AT_CR) {
+                if (delimiter > fieldStart && count < maxFields) {
+                    fields[count++] = std::string_view(fieldStart, (size_t)(delimiter - fieldStart));
+                }
+                fieldStart = delimiter + 1;
+                lineCut = *delimiter == '\r';
+            }
+        }
+    }
+
+    // Last line without a newline
+    if (!lineCut) {
+        const char* fieldEnd = end;
+        if (fieldEnd > fieldStart && fieldEnd[-1] == '\r') fieldEnd--;
+        if (fieldEnd > fieldStart && count < maxFields) {
+            fields[count++] = std::string_view(fieldStart, (size_t)(fieldEnd - fieldStart));
+        }
+    }
+    *offset = file->size;
+    return count;
+}
+
+//
+// FUNCTION    : parseDbRange
+// DESCRIPTION : Parses the lines in a byte range of a mapped file and
+//               appends the valid records to a store. Each record is parsed
+//               straight into its slot, which is released again if the
+//               parser rejects the line.
+// PARAMETERS  :
+//      const MappedFile* file  : Mapped file
+//      size_t start            : First byte of the range (start of a line)
+//      size_t end              : One past the last byte (after a newline or at end of file)
+//      DbReturnMode returnMode : How a '\r' inside a line is treated
+//      int maxFields           : Most fields passed to the parser
+//      DbRecordParser parser   : Validates a line and fills a record
+//      RecordStore* store      : Store receiving the records
+//      RecordStore* extra      : Store receiving extra data (NULL if none)
+// RETURNS     : bool - true if the whole range was parsed, false if out of memory
+//
+static bool parseDbRange(const MappedFile* file, size_t start, size_t end, DbReturnMode returnMode,
+    int maxFields, DbRecordParser parser, RecordStore* store, RecordStore* extra) {
+    MappedFile range = *file;
+    range.data = file->data + start;
+    range.size = end - start;
+
+    std::string_view* fields = new std::string_view[maxFields];
+    size_t offset = 0;
+    int fieldCount;
+    bool parsed = true;
+
+    while ((fieldCount = nextDbRecord(&range, &offset, returnMode, fields, maxFields)) >= 0) {
+        void* record = storeAppend(store);
+        if (record == NULL) {
+            parsed = false;
+            break;
+        }
+        if (!parser(fields, fieldCount, record, extra)) {
+            storeResize(store, store->count - 1);
+        }
+    }
+
+    delete[] fields;
+    return parsed;
+}
+
+//
+// FUNCTION    : nextLineStart
+// DESCRIPTION : Moves a split position forward to the start of a line
+// PARAMETERS  :
+//      const MappedFile* file : Mapped file
+//      size_t position        : Proposed split position
+// RETURNS     : size_t - First line start at or after position (file size if none)
+//
+static size_t nextLineStart(const MappedFile* file, size_t position) {
+    if (position >= file->size) return file->size;
+    if (position == 0) return 0;
+
+    const char* newline = (const char*)memchr(file->data + position - 1, '\n', file->size - position + 1);
+    return newline != NULL ? (size_t)(newline - file->data) + 1 : file->size;
+}
+
+//
+// FUNCTION    : parseDbChunks
+// DESCRIPTION : Worker loop that parses pieces until none are left. Once
+//               a piece runs out of memory no further pieces are taken:
+//               the pieces after it would be dropped anyway, and every
+//               piece before it has already been taken.
+// PARAMETERS  :
+//      void* arg : DbLoadJob of the shared load
+// RETURNS     : void
+//
+static void parseDbChunks(void* arg) {
+    DbLoadJob* job = (DbLoadJob*)arg;
+    int index;
+    while (!taskGroupCancelled(job->group) && (index = job->nextChunk.fetch_add(1)) < job->chunkCount) {
+        DbChunk* chunk = &job->chunks[index];
+        chunk->complete = parseDbRange(job->file, chunk->start, chunk->end, job->returnMode,
+            job->maxFields, job->parser, &chunk->records, job->extra ? &chunk->extraRecords : NULL);
+        if (!chunk->complete) taskGroupCancel(job->group);
+    }
+}
+
+//
+// FUNCTION    : copyDbChunks
+// DESCRIPTION : Worker loop that copies parsed pieces and their extra data
+//               to their place in the merged stores, moves the records'
+//               extra positions to match, and releases the pieces
+// PARAMETERS  :
+//      void* arg : DbLoadJob of the shared load
+// RETURNS     : void
+//
+static void copyDbChunks(void* arg) {
+    DbLoadJob* job = (DbLoadJob*)arg;
+    int index;
+    while ((index = job->nextChunk.fetch_add(1)) < job->chunkCount) {
+        DbChunk* chunk = &job->chunks[index];
+        int records = job->store->count - chunk->firstIndex;
+        if (records > chunk->records.count) records = chunk->records.count;
+
+        if (records > 0) {
+            storeCopyRecords(job->store, chunk->firstIndex, &chunk->records, 0, records);
+        }
+        storeFree(&chunk->records);
+
+        if (job->extra != NULL) {
+            int entries = job->extra->store->count - chunk->firstExtra;
+            if (entries > chunk->extraRecords.count) entries = chunk->extraRecords.count;
+
+            if (entries > 0) {
+                storeCopyRecords(job->extra->store, chunk->firstExtra, &chunk->extraRecords, 0, entries);
+            }
+            for (int i = 0; i < records && chunk->firstExtra > 0; i++) {
+                job->extra->rebase(storeAt(job->store, chunk->firstIndex + i), chunk->firstExtra);
+            }
+            storeFree(&chunk->extraRecords);
+        }
+    }
+}
+
+//
+// FUNCTION    : runDbWorkers
+// DESCRIPTION : Runs a worker loop on the calling thread and as
+//               threadCount - 1 pool tasks, and waits for all of them.
+//               Copies that start late find the pieces taken and return.
+// PARAMETERS  :
+//      DbLoadJob* job    : Shared load (its piece counter is reset)
+//      int threadCount   : Threads to use, including the caller
+//      TaskFunction work : Worker loop
+// RETURNS     : void
+//
+static void runDbWorkers(DbLoadJob* job, int threadCount, TaskFunction work) {
+    TaskGroup group;
+    taskGroupInit(&group);
+
+    job->nextChunk = 0;
+    job->group = &group;
+    taskRunShared(&group, threadCount, work, job);
+    job->group = NULL;
+}
+
+//
+// FUNCTION    : loadDbRecords
+// DESCRIPTION : Parses every line of a mapped file and appends the valid
+//               records to a store in file order. Large files are cut into
+//               line-aligned pieces that pool tasks parse into private
+//               stores; the pieces are then copied into place in order, so
+//               the result is the same as a single-threaded pass. If memory
+//               runs out, the records before the failing line are kept.
+// PARAMETERS  :
+//      const MappedFile* file  : Mapped file
+//      DbReturnMode returnMode : How a '\r' inside a line is treated
+//      int maxFields           : Most fields passed to the parser
+//      DbRecordParser parser   : Validates a line and fills a record
+//      RecordStore* store      : Store receiving the records
+//      const DbExtraData* extra : Extra data of the records, NULL if none
+// RETURNS     : bool - true if every line was parsed, false if out of memory
+//
+bool loadDbRecords(const MappedFile* file, DbReturnMode returnMode, int maxFields,
+    DbRecordParser parser, RecordStore* store, const DbExtraData* extra) {
+    int threadCount = 1;
+    if (file->size >= DB_PARALLEL_MIN_BYTES) {
+        threadCount = dbLoadThreads > 0 ? dbLoadThreads : taskPoolThreads();
+    }
+
+    if (threadCount <= 1) {
+        return parseDbRange(file, 0, file->size, returnMode, maxFields, parser, store,
+            extra ? extra->store : NULL);
+    }
+
+    size_t chunkBytes = file->size / ((size_t)threadCount * DB_CHUNKS_PER_THREAD);
+    if (chunkBytes < DB_CHUNK_MIN_BYTES) chunkBytes = DB_CHUNK_MIN_BYTES;
+
+    int chunkCount = (int)((file->size + chunkBytes - 1) / chunkBytes);
+    if (threadCount > chunkCount) threadCount = chunkCount;
+
+    DbLoadJob job;
+    job.file = file;
+    job.returnMode = returnMode;
+    job.maxFields = maxFields;
+    job.parser = parser;
+    job.chunks = new DbChunk[chunkCount];
+    job.chunkCount = chunkCount;
+    job.store = store;
+    job.extra = extra;
+
+    size_t start = 0;
+    for (int i = 0; i < chunkCount; i++) {
+        DbChunk* chunk = &job.chunks[i];
+        chunk->start = start;
+        chunk->end = i == chunkCount - 1 ? file->size : nextLineStart(file, (size_t)(i + 1) * chunkBytes);
+        storeInit(&chunk->records, store->recordSize);
+        storeInit(&chunk->extraRecords, extra ? extra->store->recordSize : 1);
+        chunk->complete = false;
+        start = chunk->end;
+    }
+
+    runDbWorkers(&job, threadCount, parseDbChunks);
+
+    // Lay the pieces out in file order, stopping after one that ran out of memory
+    bool loaded = true;
+    int first = store->count;
+    int firstExtra = extra ? extra->store->count : 0;
+    int total = first;
+    int totalExtra = firstExtra;
+    for (int i = 0; i < chunkCount; i++) {
+        DbChunk* chunk = &job.chunks[i];
+        chunk->firstIndex = total;
+        chunk->firstExtra = totalExtra;
+        if (!loaded) {
+            chunk->records.count = 0;
+            chunk->extraRecords.count = 0;
+            continue;
+        }
+        total += chunk->records.count;
+        totalExtra += chunk->extraRecords.count;
+        loaded = chunk->complete;
+    }
+
+    if (extra != NULL && !storeResize(extra->store, totalExtra)) {
+        loaded = false;
+        total = store->count;       // Records without their extra data are dropped
+    }
+    if (!storeResize(store, total)) loaded = false;
+
+    runDbWorkers(&job, threadCount, copyDbChunks);
+
+    // The workers copy without flags (pieces can share a chunk); flag here
+    storeMarkRange(store, first, store->count - first);
+    if (extra != NULL) storeMarkRange(extra->store, firstExtra, extra->store->count - firstExtra);
+
+    delete[] job.chunks;
+    return loaded;
+}
+
+//
+// FUNCTION    : skipNumberSpace
+// DESCRIPTION : Skips the leading white space sscanf ignores before a number
+// PARAMETERS  :
+//      const char* text : Start of the field
+//      const char* end  : End of the field
+// RETURNS     : const char* - First non-space character
+//
+static const char* skipNumberSpace(const char* text, const char* end) {
+    while (text < end && (*text == ' ' || (*text >= '\t' && *text <= '\r'))) {
+        text++;
+    }
+    return text;
+}
+
+//
+// FUNCTION    : parseWholeNumber
+// DESCRIPTION : Reads an optionally signed run of decimal digits. Values out
+//               of range for the destination saturate, as strtol does.
+// PARAMETERS  :
+//      std::string_view field : Field text
+//      long long minimum      : Smallest value of the destination type
+//      long long maximum      : Largest value of the destination type
+//      long long* value       : Receives the number
+// RETURNS     : bool - true if at least one digit was read
+//
+static bool parseWholeNumber(std::string_view field, long long minimum, long long maximum, long long* value) {
+    const char* end = field.data() + field.size();
+    const char* text = skipNumberSpace(field.data(), end);
+    bool negative = false;
+
+    if (text < end && (*text == '-' || *text == '+')) {
+        negative = *text == '-';
+        text++;
+    }
+
+    unsigned long long limit = negative ? 0ULL - (unsigned long long)minimum : (unsigned long long)maximum;
+    const char* digits = text;
+    unsigned long long number = 0;
+    bool overflow = false;
+    while (text < end && (unsigned char)(*text - '0') <= 9) {
+        unsigned long long digit = (unsigned long long)(*text - '0');
+        if (number > (limit - digit) / 10) {
+            overflow = true;
+        }
+        else {
+            number = number * 10 + digit;
+        }
+        text++;
+    }
+    if (text == digits) return false;
+
+    if (overflow) {
+        *value = negative ? minimum : maximum;
+    }
+    else {
+        *value = negative ? (long long)(0ULL - number) : (long long)number;
+    }
+    return true;
+}
+
+//
+// FUNCTION    : parseIntField
+// DESCRIPTION : Converts a field to int with sscanf "%d" semantics without
+//               going through the C runtime or its locale
+// PARAMETERS  :
+//      std::string_view field : Field text
+//      int* value             : Receives the number
+// RETURNS     : bool - true if a number was read
+//
+bool parseIntField(std::string_view field, int* value) {
+    long long number;
+    if (!parseWholeNumber(field, INT_MIN, INT_MAX, &number)) return false;
+    *value = (int)number;
+    return true;
+}
+
+//
+// FUNCTION    : parseLongField
+// DESCRIPTION : Converts a field to long with sscanf "%ld" semantics without
+//               going through the C runtime or its locale
+// PARAMETERS  :
+//      std::string_view field : Field text
+//      long* value            : Receives the number
+// RETURNS     : bool - true if a number was read
+//
+bool parseLongField(std::string_view field, long* value) {
+    long long number;
+    if (!parseWholeNumber(field, LONG_MIN, LONG_MAX, &number)) return false;
+    *value = (long)number;
+    return true;
+}
+
+//
+// FUNCTION    : parseLongLongField
+// DESCRIPTION : Converts a field to long long with sscanf "%lld" semantics
+//               without going through the C runtime or its locale
+// PARAMETERS  :
+//      std::string_view field : Field text
+//      long long* value       : Receives the number
+// RETURNS     : bool - true if a number was read
+//
+bool parseLongLongField(std::string_view field, long long* value) {
+    return parseWholeNumber(field, LLONG_MIN, LLONG_MAX, value);
+}
+
+//
+// FUNCTION    : parseFloatSlow
+// DESCRIPTION : Converts a field with strtof. Used only for text the fast
+//               path cannot round exactly (long mantissas, large exponents,
+//               hexadecimal, inf and nan).
+// PARAMETERS  :
+//      std::string_view field : Field text
+//      float* value           : Receives the number
+// RETURNS     : bool - true if a number was read
+//
+static bool parseFloatSlow(std::string_view field, float* value) {
+    char buffer[DB_NUMBER_LENGTH];
+    size_t length = field.size() < DB_NUMBER_LENGTH - 1 ? field.size() : DB_NUMBER_LENGTH - 1;
+    memcpy(buffer, field.data(), length);
+    buffer[length] = '\0';
+
+    char* stop;
+    float number = strtof(buffer, &stop);
+    if (stop == buffer) return false;
+    *value = number;
+    return true;
+}
+
+//
+// FUNCTION    : parseFloatField
+// DESCRIPTION : Converts a field to float with sscanf "%f" semantics. The
+//               decimal point is always '.', whatever the locale. Numbers
+//               with a mantissa below 2^24 and a power of ten within 10 are
+//               rounded exactly with one float multiply or divide; anything
+//               else is handed to parseFloatSlow.
+// PARAMETERS  :
+//      std::string_view field : Field text
+//      float* value           : Receives the number
+// RETURNS     : bool - true if a number was read
+//
+bool parseFloatField(std::string_view field, float* value) {
+    const char* end = field.data() + field.size();
+    const char* text = skipNumberSpace(field.data(), end);
+    bool negative = false;
+
+    if (text < end && (*text == '-' || *text == '+')) {
+        negative = *text == '-';
+        text++;
+    }
+
+    if (end - text >= 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        return parseFloatSlow(field, value);
+    }
+
+    unsigned long long mantissa = 0;
+    int mantissaDigits = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+
+    while (text < end && (unsigned char)(*text - '0') <= 9) {
+        if (mantissa != 0 || *text != '0') {
+            if (mantissaDigits == DB_MAX_MANTISSA_DIGITS) return parseFloatSlow(field, value);
+            mantissa = mantissa * 10 + (unsigned long long)(*text - '0');
+            mantissaDigits++;
+        }
+        anyDigits = true;
+        text++;
+    }
+    if (text < end && *text == '.') {
+        text++;
+        while (text < end && (unsigned char)(*text - '0') <= 9) {
+            if (mantissa != 0 || *text != '0') {
+                if (mantissaDigits == DB_MAX_MANTISSA_DIGITS) return parseFloatSlow(field, value);
+                mantissa = mantissa * 10 + (unsigned long long)(*text - '0');
+                mantissaDigits++;
+            }
+            exponent--;
+            anyDigits = true;
+            text++;
+        }
+    }
+    if (!anyDigits) return parseFloatSlow(field, value);
+
+    if (text < end && (*text == 'e' || *text == 'E')) {
+        const char* mark = text + 1;
+        bool negativeExponent = false;
+        if (mark < end && (*mark == '-' || *mark == '+')) {
+            negativeExponent = *mark == '-';
+            mark++;
+        }
+        if (mark < end && (unsigned char)(*mark - '0') <= 9) {
+            int written = 0;
+            while (mark < end && (unsigned char)(*mark - '0') <= 9) {
+                if (written > 1000) return parseFloatSlow(field, value);
+                written = written * 10 + (*mark - '0');
+                mark++;
+            }
+            exponent += negativeExponent ? -written : written;
+        }
+    }
+
+    while (mantissa != 0 && mantissa % 10 == 0) {
+        mantissa /= 10;
+        exponent++;
+    }
+
+    float number;
+    if (mantissa == 0) {
+        number = 0.0f;
+    }
+    else if (mantissa <= DB_FAST_FLOAT_MANTISSA &&
+        exponent >= -DB_FAST_FLOAT_EXPONENT && exponent <= DB_FAST_FLOAT_EXPONENT) {
+        number = (float)mantissa;
+        number = exponent < 0 ? number / powersOfTen[-exponent] : number * powersOfTen[exponent];
+    }
+    else {
+        return parseFloatSlow(field, value);
+    }
+
+    *value = negative ? -number : number;
+    return true;
+}
@@ -0,0 +1,80 @@
+/*
+* FILE          : DbReader.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for database file reading including:
+*      - Loader mode selection (stdio or memory-mapped)
+*      - Read-only memory mapping of database files, or whole-file reads
+*        through the io_uring backend (FileIo.h)
+*      - Zero-copy record splitting with a vectorized delimiter scan
+*      - Parallel parsing of large files in line-aligned chunks
+*      - Locale-free numeric field conversion
+*/
+
+#ifndef DBREADER_H
+#define DBREADER_H
+
+#include "RecordStore.h"
+#include <stddef.h>
+#include <string_view>
+
+#define DB_NUMBER_LENGTH 64                 // Longest numeric field text examined by the parsers
+#define DB_PARALLEL_MIN_BYTES (1 << 20)     // Smaller files are parsed on the calling thread
+#define DB_CHUNK_MIN_BYTES (256 << 10)      // Smallest piece of a file given to one worker
+#define DB_CHUNKS_PER_THREAD 4              // Pieces per worker, so uneven pieces balance out
+
+// How the database loaders read their files
+typedef enum {
+    DB_LOAD_STDIO,              // fgets/strtok line reader (fixed line buffers)
+    DB_LOAD_MAPPED              // Memory-mapped zero-copy reader (no line limit)
+} DbLoadMode;
+
+// Read-only view of a whole database file
+typedef struct {
+    const char* data;           // First byte of the file (NULL for an empty file)
+    size_t size;                // File size in bytes
+    void* fileHandle;           // Platform file handle (Windows only)
+    void* mappingHandle;        // Platform mapping handle (Windows only)
+    char* buffer;               // File read into memory instead of mapped (NULL when mapped)
+} MappedFile;
+
+// How a carriage return inside a line is treated by nextDbRecord
+typedef enum {
+    DB_TRIM_CRLF,               // Only a "\r\n" line ending is removed
+    DB_CUT_AT_CR                // The line ends at its first '\r'
+} DbReturnMode;
+
+// Validates the fields of one line and fills a record. Returns false for a
+// line the loader skips, after removing anything it appended to extra.
+// Called from several threads at once, so it must not touch shared state.
+// extra is NULL unless the load has extra data.
+typedef bool (*DbRecordParser)(const std::string_view fields[], int fieldCount, void* record,
+    RecordStore* extra);
+
+// Variable-length data kept beside the records of a load (e.g. order lines).
+// The parser appends entries to the extra store it is given and saves their
+// position in the record. Pieces parsed in parallel use private extra
+// stores, so their records are moved by rebase once the pieces are merged.
+typedef struct {
+    RecordStore* store;                         // Store receiving the entries
+    void (*rebase)(void* record, int offset);   // Adds offset to the positions a record holds
+} DbExtraData;
+
+extern DbLoadMode dbLoadMode;   // Loader mode used by all three loaders
+extern int dbLoadThreads;       // Pool threads a mapped load uses (0 = the whole pool)
+
+// Function prototypes
+bool mapDbFile(MappedFile* file, const char* filename);                    // Map (or read) a database file read-only
+void unmapDbFile(MappedFile* file);                                        // Release a mapped file
+int nextDbRecord(const MappedFile* file, size_t* offset, DbReturnMode returnMode,
+    std::string_view fields[], int maxFields);                              // Split the next line on '|'
+bool loadDbRecords(const MappedFile* file, DbReturnMode returnMode, int maxFields,
+    DbRecordParser parser, RecordStore* store, const DbExtraData* extra);   // Parse every line into a store
+bool parseIntField(std::string_view field, int* value);                    // Convert field like sscanf "%d"
+bool parseLongField(std::string_view field, long* value);                  // Convert field like sscanf "%ld"
+bool parseLongLongField(std::string_view field, long long* value);         // Convert field like sscanf "%lld"
+bool parseFloatField(std::string_view field, float* value);                // Convert field like sscanf "%f"
+
+#endif
@@ -0,0 +1,630 @@
+/*
+* FILE          : FileIo.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of the file I/O backend including:
+*      - A per-thread io_uring set up with raw system calls (no liburing)
+*      - Positioned reads and writes kept IO_QUEUE_DEPTH deep and
+*        submitted in batches; a written file gets one sync at the end
+*      - Whole-file reads in IO_BLOCK_BYTES blocks
+*      - Log appends submitted with their sync as one linked pair
+*      - The stdio path for every function, used when io_uring is off or
+*        cannot be set up
+*/
+
+#include "FileIo.h"
+#include "Snapshot.h"
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#ifdef __linux__
+#define FILE_IO_HAVE_URING
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+FileIoMode fileIoMode = FILE_IO_STDIO;
+
+//
+// FUNCTION    : allocateAligned
+// DESCRIPTION : Allocates a buffer aligned to IO_ALIGNMENT, rounded up to
+//               whole IO_ALIGNMENT blocks
+// PARAMETERS  :
+//      size_t size : Bytes needed
+// RETURNS     : char* - Buffer, NULL if out of memory
+//
+static char* allocateAligned(size_t size) {
+    size_t rounded = (size + IO_ALIGNMENT - 1) & ~(size_t)(IO_ALIGNMENT - 1);
+#ifdef _WIN32
+    return (char*)_aligned_malloc(rounded, IO_ALIGNMENT);
+#else
+    void* data = NULL;
+    return posix_memalign(&data, IO_ALIGNMENT, rounded) == 0 ? (char*)data : NULL;
+#endif
+}
+
+//
+// FUNCTION    : ioFreeBuffer
+// DESCRIPTION : Frees a buffer returned by ioReadFile
+// PARAMETERS  :
+//      char* data : Buffer (NULL is ignored)
+// RETURNS     : void
+//
+void ioFreeBuffer(char* data) {
+#ifdef _WIN32
+    _aligned_free(data);
+#else
+    free(data);
+#endif
+}
+
+#ifdef FILE_IO_HAVE_URING
+
+// Submission and completion rings of one thread's io_uring
+struct IoRing {
+    int fd;                         // Ring descriptor (-1 until set up)
+    bool failed;                    // Set-up failed on this thread
+    unsigned* sqHead;               // Next submission the kernel takes
+    unsigned* sqTail;               // End of the submissions handed over
+    unsigned* sqArray;              // Submission order (index into sqes)
+    unsigned sqMask;
+    unsigned sqEntries;
+    unsigned sqPrepared;            // Tail including submissions not handed over yet
+    unsigned* cqHead;               // Next completion to read
+    unsigned* cqTail;               // End of the completions posted
+    unsigned cqMask;
+    struct io_uring_sqe* sqes;
+    struct io_uring_cqe* cqes;
+    void* sqMap;
+    size_t sqMapSize;
+    void* cqMap;
+    size_t cqMapSize;
+    size_t sqesSize;
+
+    IoRing() : fd(-1), failed(false) {}
+    ~IoRing();
+};
+
+static thread_local IoRing threadRing;
+static std::atomic<bool> uringRefused(false);   // Set-up failed once; other threads do not retry
+
+//
+// FUNCTION    : ringClose
+// DESCRIPTION : Unmaps a ring and closes its descriptor
+// PARAMETERS  :
+//      IoRing* ring : Ring to close
+// RETURNS     : void
+//
+static void ringClose(IoRing* ring) {
+    if (ring->fd < 0) return;
+    if (ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqesSize);
+    if (ring->cqMap != MAP_FAILED && ring->cqMap != ring->sqMap) munmap(ring->cqMap, ring->cqMapSize);
+    if (ring->sqMap != MAP_FAILED) munmap(ring->sqMap, ring->sqMapSize);
+    close(ring->fd);
+    ring->fd = -1;
+}
+
+IoRing::~IoRing() {
+    ringClose(this);
+}
+
+//
+// FUNCTION    : ringOpen
+// DESCRIPTION : Sets up the calling thread's ring on first use
+// PARAMETERS  :
+//      IoRing* ring : The thread's ring
+// RETURNS     : bool - false if io_uring cannot be used
+//
+static bool ringOpen(IoRing* ring) {
+    if (ring->fd >= 0) return true;
+    if (ring->failed || uringRefused.load(std::memory_order_relaxed)) return false;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = (int)syscall(__NR_io_uring_setup, IO_QUEUE_DEPTH * 2, &params);
+    if (fd < 0 || (params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+        if (fd >= 0) close(fd);
+        ring->failed = true;
+        uringRefused.store(true, std::memory_order_relaxed);
+        return false;
+    }
+
+    ring->fd = fd;
+    ring->sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    // Newer kernels map both rings in one region
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cqMapSize > ring->sqMapSize) ring->sqMapSize = ring->cqMapSize;
+        ring->cqMapSize = ring->sqMapSize;
+    }
+    ring->sqMap = mmap(NULL, ring->sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    ring->cqMap = (params.features & IORING_FEAT_SINGLE_MMAP) ? ring->sqMap :
+        mmap(NULL, ring->cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sqMap == MAP_FAILED || ring->cqMap == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        ringClose(ring);
+        ring->failed = true;
+        return false;
+    }
+
+    char* sq = (char*)ring->sqMap;
+    char* cq = (char*)ring->cqMap;
+    ring->sqHead = (unsigned*)(sq + params.sq_off.head);
+    ring->sqTail = (unsigned*)(sq + params.sq_off.tail);
+    ring->sqArray = (unsigned*)(sq + params.sq_off.array);
+    ring->sqMask = *(unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sqEntries = params.sq_entries;
+    ring->sqPrepared = *ring->sqTail;
+    ring->cqHead = (unsigned*)(cq + params.cq_off.head);
+    ring->cqTail = (unsigned*)(cq + params.cq_off.tail);
+    ring->cqMask = *(unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    return true;
+}
+
+//
+// FUNCTION    : ringPrepare
+// DESCRIPTION : Fills the next submission entry. It is handed to the
+//               kernel by the next ringSubmit.
+// PARAMETERS  :
+//      IoRing* ring              : The thread's ring
+//      unsigned char opcode      : IORING_OP_READ, IORING_OP_WRITE or IORING_OP_FSYNC
+//      int fd                    : File
+//      const void* data          : Buffer (NULL for a sync)
+//      size_t length             : Bytes to transfer
+//      unsigned long long offset : File position
+//      unsigned long long tag    : Returned with the completion
+//      unsigned char flags       : IOSQE_* flags
+// RETURNS     : void
+//
+static void ringPrepare(IoRing* ring, unsigned char opcode, int fd, const void* data, size_t length,
+    unsigned long long offset, unsigned long long tag, unsigned char flags) {
+    unsigned index = ring->sqPrepared & ring->sqMask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->flags = flags;
+    sqe->fd = fd;
+    sqe->off = offset;
+    sqe->addr = (unsigned long long)(size_t)data;
+    sqe->len = (unsigned)length;
+    sqe->user_data = tag;
+    ring->sqArray[index] = index;
+    ring->sqPrepared++;
+}
+
+//
+// FUNCTION    : ringSubmit
+// DESCRIPTION : Hands the prepared entries to the kernel and waits for a
+//               number of completions
+// PARAMETERS  :
+//      IoRing* ring      : The thread's ring
+//      unsigned waitFor  : Completions to wait for (0 to only submit)
+// RETURNS     : bool - false if the kernel refused the submission
+//
+static bool ringSubmit(IoRing* ring, unsigned waitFor) {
+    unsigned submit = ring->sqPrepared - *ring->sqTail;
+    __atomic_store_n(ring->sqTail, ring->sqPrepared, __ATOMIC_RELEASE);
+
+    while (true) {
+        long result = syscall(__NR_io_uring_enter, ring->fd, submit, waitFor,
+            waitFor > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        if (result >= 0) return true;
+        if (errno != EINTR) return false;
+        submit = 0;
+    }
+}
+
+//
+// FUNCTION    : ringNextCompletion
+// DESCRIPTION : Takes the next posted completion, if any
+// PARAMETERS  :
+//      IoRing* ring              : The thread's ring
+//      struct io_uring_cqe* cqe  : Receives the completion
+// RETURNS     : bool - false if none is posted
+//
+static bool ringNextCompletion(IoRing* ring, struct io_uring_cqe* cqe) {
+    unsigned head = *ring->cqHead;
+    if (head == __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) return false;
+
+    *cqe = ring->cqes[head & ring->cqMask];
+    __atomic_store_n(ring->cqHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+//
+// FUNCTION    : fileReap
+// DESCRIPTION : Handles a file's posted completions. A short transfer is
+//               queued again for the rest of its data; a read that hits
+//               the end of the file fails.
+// PARAMETERS  :
+//      IoFile* file : File
+// RETURNS     : void
+//
+static void fileReap(IoFile* file) {
+    struct io_uring_cqe cqe;
+    while (ringNextCompletion(&threadRing, &cqe)) {
+        IoRequest* request = &file->requests[cqe.user_data];
+
+        if (cqe.res <= 0) {
+            file->failed = true;
+        }
+        else if ((size_t)cqe.res < request->length) {
+            request->data += cqe.res;
+            request->length -= (size_t)cqe.res;
+            request->offset += (unsigned long long)cqe.res;
+            ringPrepare(&threadRing, file->writing ? IORING_OP_WRITE : IORING_OP_READ, file->fd,
+                request->data, request->length, request->offset, cqe.user_data, 0);
+            file->queued++;
+            continue;
+        }
+        request->busy = false;
+        file->pending--;
+    }
+}
+
+//
+// FUNCTION    : fileSubmit
+// DESCRIPTION : Submits a file's queued requests and waits for at least
+//               one request to complete
+// PARAMETERS  :
+//      IoFile* file : File
+// RETURNS     : void
+//
+static void fileSubmit(IoFile* file) {
+    file->pending += file->queued;
+    file->queued = 0;
+    if (!ringSubmit(&threadRing, 1)) {
+        // Nothing was handed over, so nothing will complete
+        threadRing.sqPrepared = *threadRing.sqTail;
+        for (int i = 0; i < IO_QUEUE_DEPTH; i++) file->requests[i].busy = false;
+        file->pending = 0;
+        file->failed = true;
+        return;
+    }
+    fileReap(file);
+}
+
+//
+// FUNCTION    : fileQueue
+// DESCRIPTION : Queues one request of at most IO_BLOCK_BYTES, first
+//               waiting for a free slot if all IO_QUEUE_DEPTH are in use
+// PARAMETERS  :
+//      IoFile* file              : File
+//      char* data                : Buffer
+//      size_t length             : Bytes to transfer
+//      unsigned long long offset : File position
+// RETURNS     : void
+//
+static void fileQueue(IoFile* file, char* data, size_t length, unsigned long long offset) {
+    int slot = -1;
+    while (slot == -1 && !file->failed) {
+        for (int i = 0; i < IO_QUEUE_DEPTH; i++) {
+            if (!file->requests[i].busy) {
+                slot = i;
+                break;
+            }
+        }
+        if (slot == -1) fileSubmit(file);
+    }
+    if (file->failed) return;
+
+    IoRequest* request = &file->requests[slot];
+    request->data = data;
+    request->length = length;
+    request->offset = offset;
+    request->busy = true;
+    ringPrepare(&threadRing, file->writing ? IORING_OP_WRITE : IORING_OP_READ, file->fd,
+        data, length, offset, (unsigned long long)slot, 0);
+    file->queued++;
+}
+
+#endif
+
+//
+// FUNCTION    : fileIoAvailable
+// DESCRIPTION : Tells whether io_uring can be used on this system, setting
+//               up the calling thread's ring
+// PARAMETERS  : None
+// RETURNS     : bool - true if the io_uring backend works here
+//
+bool fileIoAvailable() {
+#ifdef FILE_IO_HAVE_URING
+    return ringOpen(&threadRing);
+#else
+    return false;
+#endif
+}
+
+//
+// FUNCTION    : openFile
+// DESCRIPTION : Opens a file with the selected backend
+// PARAMETERS  :
+//      IoFile* file         : Receives the file
+//      const char* filename : File to open
+//      bool writing         : Create or truncate for writing (else read)
+// RETURNS     : bool - true if the file was opened
+//
+static bool openFile(IoFile* file, const char* filename, bool writing) {
+    file->fp = NULL;
+    file->fd = -1;
+    file->writing = writing;
+    file->failed = false;
+    file->queued = 0;
+    file->pending = 0;
+    for (int i = 0; i < IO_QUEUE_DEPTH; i++) file->requests[i].busy = false;
+
+#ifdef FILE_IO_HAVE_URING
+    if (fileIoMode == FILE_IO_URING && ringOpen(&threadRing)) {
+        file->fd = writing ? open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666) :
+            open(filename, O_RDONLY | O_CLOEXEC);
+        if (file->fd >= 0 && !writing) posix_fadvise(file->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        return file->fd >= 0;
+    }
+#endif
+    errno_t err = fopen_s(&file->fp, filename, writing ? "wb" : "rb");
+    return err == 0 && file->fp != NULL;
+}
+
+//
+// FUNCTION    : ioOpenRead
+// DESCRIPTION : Opens an existing file for positioned reads
+// PARAMETERS  :
+//      IoFile* file             : Receives the file
+//      const char* filename     : File to read
+//      unsigned long long* size : Receives the file size
+// RETURNS     : bool - true if the file was opened (close it with ioClose)
+//
+bool ioOpenRead(IoFile* file, const char* filename, unsigned long long* size) {
+    if (!openFile(file, filename, false)) return false;
+
+    long long length = -1;
+#ifdef FILE_IO_HAVE_URING
+    struct stat info;
+    if (file->fd >= 0 && fstat(file->fd, &info) == 0) length = (long long)info.st_size;
+#endif
+    if (file->fp != NULL && _fseeki64(file->fp, 0, SEEK_END) == 0) length = _ftelli64(file->fp);
+
+    if (length < 0) {
+        ioClose(file);
+        return false;
+    }
+    *size = (unsigned long long)length;
+    return true;
+}
+
+//
+// FUNCTION    : ioOpenWrite
+// DESCRIPTION : Creates or truncates a file for positioned writes
+// PARAMETERS  :
+//      IoFile* file         : Receives the file
+//      const char* filename : File to write
+// RETURNS     : bool - true if the file was opened (close it with ioClose)
+//
+bool ioOpenWrite(IoFile* file, const char* filename) {
+    return openFile(file, filename, true);
+}
+
+//
+// FUNCTION    : ioRead
+// DESCRIPTION : Queues a read at a file position, in IO_BLOCK_BYTES
+//               requests. With stdio it is read at once. The data is only
+//               there once ioWait or ioClose succeeds.
+// PARAMETERS  :
+//      IoFile* file              : File opened by ioOpenRead
+//      void* data                : Receives the bytes
+//      size_t length             : Bytes to read (all must exist)
+//      unsigned long long offset : File position
+// RETURNS     : void
+//
+void ioRead(IoFile* file, void* data, size_t length, unsigned long long offset) {
+    if (file->failed || length == 0) return;
+
+    if (file->fp != NULL) {
+        if (_fseeki64(file->fp, (long long)offset, SEEK_SET) != 0 ||
+            fread(data, 1, length, file->fp) != length) {
+            file->failed = true;
+        }
+        return;
+    }
+
+#ifdef FILE_IO_HAVE_URING
+    for (size_t done = 0; done < length; done += IO_BLOCK_BYTES) {
+        size_t bytes = length - done < IO_BLOCK_BYTES ? length - done : IO_BLOCK_BYTES;
+        fileQueue(file, (char*)data + done, bytes, offset + done);
+    }
+#endif
+}
+
+//
+// FUNCTION    : ioWrite
+// DESCRIPTION : Queues a write at a file position, in IO_BLOCK_BYTES
+//               requests. With io_uring the writes are submitted in
+//               batches as the queue fills; with stdio it is written at
+//               once.
+// PARAMETERS  :
+//      IoFile* file              : File opened by ioOpenWrite
+//      const void* data          : Bytes to write
+//      size_t length             : Bytes at data
+//      unsigned long long offset : File position
+// RETURNS     : void
+//
+void ioWrite(IoFile* file, const void* data, size_t length, unsigned long long offset) {
+    if (file->failed || length == 0) return;
+
+    if (file->fp != NULL) {
+        if ((unsigned long long)_ftelli64(file->fp) != offset &&
+            _fseeki64(file->fp, (long long)offset, SEEK_SET) != 0) {
+            file->failed = true;
+        }
+        else if (fwrite(data, 1, length, file->fp) != length) {
+            file->failed = true;
+        }
+        return;
+    }
+
+#ifdef FILE_IO_HAVE_URING
+    for (size_t done = 0; done < length; done += IO_BLOCK_BYTES) {
+        size_t bytes = length - done < IO_BLOCK_BYTES ? length - done : IO_BLOCK_BYTES;
+        fileQueue(file, (char*)data + done, bytes, offset + done);
+    }
+#endif
+}
+
+//
+// FUNCTION    : ioWait
+// DESCRIPTION : Waits until every request queued on a file has completed
+// PARAMETERS  :
+//      IoFile* file : File
+// RETURNS     : bool - false if any request on the file has failed
+//
+bool ioWait(IoFile* file) {
+#ifdef FILE_IO_HAVE_URING
+    if (file->fd >= 0) {
+        while (file->queued > 0 || file->pending > 0) fileSubmit(file);
+    }
+#endif
+    return !file->failed;
+}
+
+//
+// FUNCTION    : ioClose
+// DESCRIPTION : Waits for every queued request, syncs a written file to
+//               disk and closes the file
+// PARAMETERS  :
+//      IoFile* file : File
+// RETURNS     : bool - true if every request (and the sync) succeeded
+//
+bool ioClose(IoFile* file) {
+    if (file->fp != NULL) {
+        bool done = !file->failed && (!file->writing || syncFile(file->fp));
+        if (fclose(file->fp) != 0 && file->writing) done = false;
+        file->fp = NULL;
+        return done;
+    }
+
+#ifdef FILE_IO_HAVE_URING
+    if (file->fd < 0) return false;
+    ioWait(file);
+
+    if (file->writing && !file->failed) {
+        ringPrepare(&threadRing, IORING_OP_FSYNC, file->fd, NULL, 0, 0, 0, 0);
+        struct io_uring_cqe cqe;
+        if (!ringSubmit(&threadRing, 1)) {
+            threadRing.sqPrepared = *threadRing.sqTail;
+            file->failed = true;
+        }
+        else {
+            while (!ringNextCompletion(&threadRing, &cqe)) ringSubmit(&threadRing, 1);
+            if (cqe.res < 0) file->failed = true;
+        }
+    }
+    if (close(file->fd) != 0 && file->writing) file->failed = true;
+    file->fd = -1;
+    return !file->failed;
+#else
+    return false;
+#endif
+}
+
+//
+// FUNCTION    : ioReadFile
+// DESCRIPTION : Reads a whole file into a buffer aligned to IO_ALIGNMENT.
+//               With io_uring IO_QUEUE_DEPTH blocks are read at once.
+// PARAMETERS  :
+//      const char* filename : File to read
+//      char** data          : Receives the buffer, freed with ioFreeBuffer
+//                             (NULL for an empty file)
+//      size_t* size         : Receives the file size
+// RETURNS     : bool - true on success
+//
+bool ioReadFile(const char* filename, char** data, size_t* size) {
+    *data = NULL;
+    *size = 0;
+
+    IoFile file;
+    unsigned long long length;
+    if (!ioOpenRead(&file, filename, &length)) return false;
+    if (length == 0) return ioClose(&file);
+
+    char* buffer = allocateAligned((size_t)length);
+    if (buffer == NULL) {
+        ioClose(&file);
+        return false;
+    }
+    ioRead(&file, buffer, (size_t)length, 0);
+    if (!ioClose(&file)) {
+        ioFreeBuffer(buffer);
+        return false;
+    }
+
+    *data = buffer;
+    *size = (size_t)length;
+    return true;
+}
+
+//
+// FUNCTION    : ioAppendSync
+// DESCRIPTION : Appends bytes to a file opened for appending and syncs it
+//               to disk. With io_uring the write and the sync go to the
+//               kernel as one linked pair in a single call.
+// PARAMETERS  :
+//      FILE* fp          : File opened in append mode
+//      const void* data  : Bytes to append
+//      size_t length     : Bytes at data
+// RETURNS     : bool - true if the bytes are on disk
+//
+bool ioAppendSync(FILE* fp, const void* data, size_t length) {
+#ifdef FILE_IO_HAVE_URING
+    if (fileIoMode == FILE_IO_URING && ringOpen(&threadRing)) {
+        if (fflush(fp) != 0) return false;
+        int fd = fileno(fp);
+        const char* next = (const char*)data;
+
+        // A short write cancels the linked sync; the rest is sent again
+        while (true) {
+            ringPrepare(&threadRing, IORING_OP_WRITE, fd, next, length, (unsigned long long)-1, 1, IOSQE_IO_LINK);
+            ringPrepare(&threadRing, IORING_OP_FSYNC, fd, NULL, 0, 0, 2, 0);
+            if (!ringSubmit(&threadRing, 2)) {
+                threadRing.sqPrepared = *threadRing.sqTail;
+                return false;
+            }
+
+            int written = -1;
+            int synced = -1;
+            for (int seen = 0; seen < 2;) {
+                struct io_uring_cqe cqe;
+                if (!ringNextCompletion(&threadRing, &cqe)) {
+                    ringSubmit(&threadRing, 1);
+                    continue;
+                }
+                if (cqe.user_data == 1) written = cqe.res;
+                else synced = cqe.res;
+                seen++;
+            }
+
+            if (written < 0) return false;
+            if ((size_t)written == length) return synced == 0;
+            if (written == 0) return false;
+            next += written;
+            length -= (size_t)written;
+        }
+    }
+#endif
+    return fwrite(data, 1, length, fp) == length && syncFile(fp);
+}
@@ -0,0 +1,73 @@
+/*
+* FILE          : FileIo.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for the file I/O backend including:
+*      - Backend selection (stdio and memory mapping, or Linux io_uring)
+*      - Batched positioned reads and writes (snapshot loads and saves)
+*      - Whole-file reads in large aligned blocks with read-ahead
+*      - Log appends written and synced in one submission
+*      With io_uring each thread has its own ring. Up to IO_QUEUE_DEPTH
+*      requests are kept in flight: they are submitted in one call when
+*      the queue fills or the caller waits, and a short transfer is
+*      queued again for the rest. Where io_uring is not available
+*      (Windows, older kernels, blocked by policy) every function uses
+*      the stdio path, which carries out each request at once.
+*/
+
+#ifndef FILEIO_H
+#define FILEIO_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define IO_BLOCK_BYTES (1 << 20)    // Largest single read or write request
+#define IO_ALIGNMENT 4096           // Alignment of read buffers
+#define IO_QUEUE_DEPTH 16           // Requests one thread keeps in flight
+
+// Which backend file reads and writes use
+typedef enum {
+    FILE_IO_STDIO,              // Blocking stdio writes, memory-mapped reads
+    FILE_IO_URING               // Linux io_uring (falls back to stdio)
+} FileIoMode;
+
+// Read or write queued on an IoFile and not yet completed
+typedef struct {
+    char* data;                 // Bytes still to transfer
+    size_t length;
+    unsigned long long offset;  // File position of data
+    bool busy;                  // Slot holds a queued request
+} IoRequest;
+
+// File read or written with positioned requests. Use one file per thread
+// at a time; the buffers passed to ioRead and ioWrite must stay valid
+// until ioWait or ioClose returns.
+typedef struct {
+    FILE* fp;                   // stdio backend (NULL with io_uring)
+    int fd;                     // io_uring backend (-1 with stdio)
+    bool writing;               // Opened by ioOpenWrite
+    bool failed;                // A request failed
+    int queued;                 // Requests prepared and not yet submitted
+    int pending;                // Requests submitted and not yet completed
+    IoRequest requests[IO_QUEUE_DEPTH];
+} IoFile;
+
+extern FileIoMode fileIoMode;   // Backend used by loads, snapshot saves and the log
+
+// Function prototypes
+bool fileIoAvailable();                                                 // io_uring can be used here
+bool ioOpenRead(IoFile* file, const char* filename, unsigned long long* size); // Open a file for reading
+bool ioOpenWrite(IoFile* file, const char* filename);                   // Create or truncate a file for writing
+void ioRead(IoFile* file, void* data, size_t length,
+    unsigned long long offset);                                         // Queue a read at a file position
+void ioWrite(IoFile* file, const void* data, size_t length,
+    unsigned long long offset);                                         // Queue a write at a file position
+bool ioWait(IoFile* file);                                              // Wait for every queued request
+bool ioClose(IoFile* file);                                             // Wait, sync a written file and close
+bool ioReadFile(const char* filename, char** data, size_t* size);      // Read a whole file into an aligned buffer
+void ioFreeBuffer(char* data);                                          // Free a buffer from ioReadFile
+bool ioAppendSync(FILE* fp, const void* data, size_t length);          // Append to a file and sync it
+
+#endif
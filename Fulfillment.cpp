@@ -0,0 +1,369 @@
+/*
+* FILE          : Fulfillment.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of the end-of-day fulfillment engine including:
+*      - Credit and inventory checks for one order
+*      - Splitting a batch into levels of orders that share no part or
+*        customer
+*      - Pool tasks that run each level in parallel, one level after
+*        another (fork-join per level)
+*      Every order runs after all earlier orders that touch any of its
+*      records, so the results are the same as a single-threaded pass in
+*      priority order.
+*/
+
+#include "Fulfillment.h"
+#include "Inventory.h"
+#include "TaskPool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+
+// Execution plan of a batch. A step is one level run in parallel, or a
+// run of small levels that one thread takes in level order.
+typedef struct {
+    int* members;               // Batch order indexes by level, priority order within a level
+    int* stepStart;             // First member of each step (stepCount + 1 entries)
+    int* stepChunk;             // Orders a thread takes at a time in each step
+    int stepCount;              // Number of steps
+} FulfillmentPlan;
+
+// Work shared by the tasks running one step
+typedef struct {
+    FulfillmentBatch* batch;
+    const FulfillmentPlan* plan;
+    RecordStore* orders;
+    RecordStore* customers;
+    RecordStore* parts;
+    int step;                       // Step being run
+    std::atomic<int> nextMember;    // Next member of the step to take
+} FulfillmentJob;
+
+int eodThreads = 0;
+
+//
+// FUNCTION    : fulfillmentInit
+// DESCRIPTION : Prepares an empty batch
+// PARAMETERS  :
+//      FulfillmentBatch* batch : Batch to initialize
+// RETURNS     : void
+//
+void fulfillmentInit(FulfillmentBatch* batch) {
+    batch->orders = NULL;
+    batch->count = 0;
+    batch->capacity = 0;
+    batch->linePart = NULL;
+    batch->lineQuantity = NULL;
+    batch->lineOnHand = NULL;
+    batch->lineCount = 0;
+    batch->lineCapacity = 0;
+}
+
+//
+// FUNCTION    : fulfillmentFree
+// DESCRIPTION : Releases batch memory and leaves the batch empty
+// PARAMETERS  :
+//      FulfillmentBatch* batch : Batch to free
+// RETURNS     : void
+//
+void fulfillmentFree(FulfillmentBatch* batch) {
+    free(batch->orders);
+    free(batch->linePart);
+    free(batch->lineQuantity);
+    free(batch->lineOnHand);
+    fulfillmentInit(batch);
+}
+
+//
+// FUNCTION    : growArray
+// DESCRIPTION : Doubles an array until it holds at least a given count
+// PARAMETERS  :
+//      void** array       : Array to grow (unchanged on failure)
+//      int* capacity      : Elements allocated, updated
+//      int needed         : Elements required
+//      size_t elementSize : Size of one element
+// RETURNS     : bool - false if out of memory
+//
+static bool growArray(void** array, int* capacity, int needed, size_t elementSize) {
+    if (needed <= *capacity) return true;
+
+    int newCapacity = *capacity > 0 ? *capacity : 256;
+    while (newCapacity < needed) newCapacity *= 2;
+
+    void* grown = realloc(*array, elementSize * (size_t)newCapacity);
+    if (grown == NULL) return false;
+
+    *array = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+//
+// FUNCTION    : fulfillmentAdd
+// DESCRIPTION : Adds an order to the end of a batch and looks up its parts.
+//               Lookups go through the ID indexes, so batches are built on
+//               one thread before they run.
+// PARAMETERS  :
+//      FulfillmentBatch* batch : Batch to add to
+//      RecordStore* orders     : Order store
+//      int orderPosition       : Position of the order
+//      int customerPosition    : Position of the ordering customer
+//      RecordStore* parts      : Part store
+// RETURNS     : bool - false if out of memory
+//
+bool fulfillmentAdd(FulfillmentBatch* batch, RecordStore* orders, int orderPosition,
+    int customerPosition, RecordStore* parts) {
+    const Order* order = orderAt(orders, orderPosition);
+    int lines = order->DistinctParts;
+
+    // The line arrays share lineCapacity, which only grows once all have
+    int partCapacity = batch->lineCapacity;
+    int quantityCapacity = batch->lineCapacity;
+    int onHandCapacity = batch->lineCapacity;
+    if (!growArray((void**)&batch->orders, &batch->capacity, batch->count + 1, sizeof(FulfillmentOrder)) ||
+        !growArray((void**)&batch->linePart, &partCapacity, batch->lineCount + lines, sizeof(int)) ||
+        !growArray((void**)&batch->lineQuantity, &quantityCapacity, batch->lineCount + lines, sizeof(int)) ||
+        !growArray((void**)&batch->lineOnHand, &onHandCapacity, batch->lineCount + lines, sizeof(int))) {
+        return false;
+    }
+    batch->lineCapacity = partCapacity;
+
+    FulfillmentOrder* item = &batch->orders[batch->count++];
+    item->order = orderPosition;
+    item->customer = customerPosition;
+    item->firstLine = batch->lineCount;
+    item->lines = lines;
+    item->balance = 0.0f;
+
+    for (int j = 0; j < lines; j++) {
+        const OrderItem* line = orderLine(order, j);
+        batch->linePart[batch->lineCount] = findPart(parts, line->PartID);
+        batch->lineQuantity[batch->lineCount] = line->NumberOfParts;
+        batch->lineCount++;
+    }
+    return true;
+}
+
+//
+// FUNCTION    : fulfillOrder
+// DESCRIPTION : Checks one order against its customer's credit limit and
+//               the stock of its parts, and fulfills it if both allow.
+//               Records the balance and quantities it saw so the caller
+//               can log the outcome afterwards.
+// PARAMETERS  :
+//      FulfillmentBatch* batch : Batch holding the order
+//      FulfillmentOrder* item  : Order to process
+//      RecordStore* orders     : Order store
+//      RecordStore* customers  : Customer store
+//      RecordStore* parts      : Part store
+// RETURNS     : void
+//
+static void fulfillOrder(FulfillmentBatch* batch, FulfillmentOrder* item, RecordStore* orders,
+    RecordStore* customers, RecordStore* parts) {
+    Order* order = orderAt(orders, item->order);
+    Customer* customer = customerAt(customers, item->customer);
+    const int* linePart = batch->linePart + item->firstLine;
+    const int* lineQuantity = batch->lineQuantity + item->firstLine;
+    int* lineOnHand = batch->lineOnHand + item->firstLine;
+
+    // Check credit limit
+    item->balance = customer->accountBalance;
+    if (customer->accountBalance + order->OrderTotal > customer->creditLimit) {
+        order->OrderStatus = STATUS_CREDIT_LIMIT_EXCEEDED;
+        return;
+    }
+
+    // Reserve the stock of every line, or none of it
+    if (!inventoryReserve(parts, linePart, lineQuantity, item->lines, NULL)) {
+        for (int j = 0; j < item->lines; j++) {
+            lineOnHand[j] = linePart[j] != -1 ? inventoryMarkShort(parts, linePart[j], lineQuantity[j]) : 0;
+        }
+        order->OrderStatus = STATUS_INSUFFICIENT_PARTS;
+        return;
+    }
+
+    // Fulfill order
+    inventoryCommit(parts, linePart, item->lines);
+
+    // Update customer balance
+    customer->accountBalance += order->OrderTotal;
+    order->OrderStatus = STATUS_FULFILLED;
+}
+
+//
+// FUNCTION    : buildPlan
+// DESCRIPTION : Splits a batch into levels. An order's level is one more
+//               than the highest level of any earlier order that uses its
+//               customer or one of its parts, so orders within a level
+//               share no record and may run at the same time. Levels of at
+//               least EOD_LEVEL_MIN_ORDERS orders become parallel steps;
+//               runs of smaller levels are joined into one serial step.
+// PARAMETERS  :
+//      const FulfillmentBatch* batch : Batch in priority order
+//      int customerCount             : Records in the customer store
+//      int partCount                 : Records in the part store
+//      int threadCount               : Threads that will run the plan
+//      FulfillmentPlan* plan         : Receives the plan
+// RETURNS     : bool - false if out of memory
+//
+static bool buildPlan(const FulfillmentBatch* batch, int customerCount, int partCount,
+    int threadCount, FulfillmentPlan* plan) {
+    int count = batch->count;
+    int* lastLevel = (int*)calloc((size_t)customerCount + (size_t)partCount, sizeof(int));
+    int* level = (int*)malloc(sizeof(int) * (size_t)count);
+    int* levelStart = (int*)calloc((size_t)count + 2, sizeof(int));
+    plan->members = (int*)malloc(sizeof(int) * (size_t)count);
+    plan->stepStart = (int*)malloc(sizeof(int) * ((size_t)count + 1));
+    plan->stepChunk = (int*)malloc(sizeof(int) * (size_t)count);
+
+    if (lastLevel == NULL || level == NULL || levelStart == NULL || plan->members == NULL ||
+        plan->stepStart == NULL || plan->stepChunk == NULL) {
+        free(lastLevel);
+        free(level);
+        free(levelStart);
+        free(plan->members);
+        free(plan->stepStart);
+        free(plan->stepChunk);
+        return false;
+    }
+
+    // Level of each order (customers are nodes 0..customerCount-1, parts follow)
+    int levelCount = 0;
+    for (int i = 0; i < count; i++) {
+        const FulfillmentOrder* item = &batch->orders[i];
+        const int* linePart = batch->linePart + item->firstLine;
+
+        int highest = lastLevel[item->customer];
+        for (int j = 0; j < item->lines; j++) {
+            if (linePart[j] != -1 && lastLevel[customerCount + linePart[j]] > highest) {
+                highest = lastLevel[customerCount + linePart[j]];
+            }
+        }
+
+        level[i] = highest + 1;
+        lastLevel[item->customer] = level[i];
+        for (int j = 0; j < item->lines; j++) {
+            if (linePart[j] != -1) lastLevel[customerCount + linePart[j]] = level[i];
+        }
+        if (level[i] > levelCount) levelCount = level[i];
+        levelStart[level[i] + 1]++;
+    }
+
+    // Order the members by level, keeping priority order within a level
+    for (int l = 1; l <= levelCount + 1; l++) levelStart[l] += levelStart[l - 1];
+    for (int i = 0; i < count; i++) {
+        plan->members[levelStart[level[i]]++] = i;
+    }
+    for (int l = levelCount; l >= 1; l--) levelStart[l] = levelStart[l - 1];
+    levelStart[0] = 0;
+
+    // Parallel steps for big levels, serial steps for runs of small ones
+    plan->stepCount = 0;
+    for (int l = 1; l <= levelCount; l++) {
+        int size = levelStart[l + 1] - levelStart[l];
+        bool parallel = size >= EOD_LEVEL_MIN_ORDERS;
+
+        if (!parallel && plan->stepCount > 0 && plan->stepChunk[plan->stepCount - 1] == 0) {
+            continue;           // Joins the serial step already open
+        }
+        plan->stepStart[plan->stepCount] = levelStart[l];
+        if (parallel) {
+            int chunk = size / (threadCount * EOD_CHUNKS_PER_THREAD);
+            plan->stepChunk[plan->stepCount] = chunk > 0 ? chunk : 1;
+        }
+        else {
+            plan->stepChunk[plan->stepCount] = 0;   // Whole step, set below
+        }
+        plan->stepCount++;
+    }
+    plan->stepStart[plan->stepCount] = count;
+    for (int s = 0; s < plan->stepCount; s++) {
+        if (plan->stepChunk[s] == 0) plan->stepChunk[s] = plan->stepStart[s + 1] - plan->stepStart[s];
+    }
+
+    free(lastLevel);
+    free(level);
+    free(levelStart);
+    return true;
+}
+
+//
+// FUNCTION    : fulfillStep
+// DESCRIPTION : Worker loop. Takes chunks of the current step until none
+//               are left.
+// PARAMETERS  :
+//      void* arg : FulfillmentJob of the step
+// RETURNS     : void
+//
+static void fulfillStep(void* arg) {
+    FulfillmentJob* job = (FulfillmentJob*)arg;
+    const FulfillmentPlan* plan = job->plan;
+    int start = plan->stepStart[job->step];
+    int size = plan->stepStart[job->step + 1] - start;
+    int chunk = plan->stepChunk[job->step];
+    int first;
+
+    while ((first = job->nextMember.fetch_add(chunk)) < size) {
+        int last = first + chunk < size ? first + chunk : size;
+        for (int m = first; m < last; m++) {
+            fulfillOrder(job->batch, &job->batch->orders[plan->members[start + m]],
+                job->orders, job->customers, job->parts);
+        }
+    }
+}
+
+//
+// FUNCTION    : runFulfillment
+// DESCRIPTION : Checks and fulfills every order of a batch. Large batches
+//               are planned into levels that run on eodThreads pool
+//               threads, each step waiting for the one before it;
+//               small batches run on the calling thread. Either way each
+//               record ends up as a single pass in batch order would leave
+//               it.
+// PARAMETERS  :
+//      FulfillmentBatch* batch : Orders in priority order
+//      RecordStore* orders     : Order store
+//      RecordStore* customers  : Customer store
+//      RecordStore* parts      : Part store
+// RETURNS     : void
+//
+void runFulfillment(FulfillmentBatch* batch, RecordStore* orders, RecordStore* customers, RecordStore* parts) {
+    int threadCount = 1;
+    FulfillmentPlan plan;
+
+    if (batch->count >= EOD_PARALLEL_MIN_ORDERS) {
+        threadCount = eodThreads > 0 ? eodThreads : taskPoolThreads();
+    }
+    if (threadCount <= 1 ||
+        !buildPlan(batch, customers->count, parts->count, threadCount, &plan)) {
+        for (int i = 0; i < batch->count; i++) {
+            fulfillOrder(batch, &batch->orders[i], orders, customers, parts);
+        }
+        return;
+    }
+
+    FulfillmentJob job;
+    job.batch = batch;
+    job.plan = &plan;
+    job.orders = orders;
+    job.customers = customers;
+    job.parts = parts;
+
+    for (int s = 0; s < plan.stepCount; s++) {
+        int size = plan.stepStart[s + 1] - plan.stepStart[s];
+        int chunks = (size + plan.stepChunk[s] - 1) / plan.stepChunk[s];
+        TaskGroup group;
+
+        taskGroupInit(&group);
+        job.step = s;
+        job.nextMember = 0;
+        taskRunShared(&group, chunks < threadCount ? chunks : threadCount, fulfillStep, &job);
+    }
+
+    free(plan.members);
+    free(plan.stepStart);
+    free(plan.stepChunk);
+}
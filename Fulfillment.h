@@ -0,0 +1,53 @@
+/*
+* FILE          : Fulfillment.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for the end-of-day fulfillment engine including:
+*      - Batch of placed orders with their resolved customers and parts
+*      - Thread and level size settings for parallel runs
+*      - Function prototypes for running a batch on the task pool
+*/
+
+#ifndef FULFILLMENT_H
+#define FULFILLMENT_H
+
+#include "Order.h"
+
+#define EOD_PARALLEL_MIN_ORDERS 4096    // Smaller batches run on the calling thread
+#define EOD_LEVEL_MIN_ORDERS 256        // Smaller levels run on one thread
+#define EOD_CHUNKS_PER_THREAD 4         // Pieces each thread takes of a parallel level
+
+// One placed order in an end-of-day batch
+typedef struct {
+    int order;                  // Position in the order store
+    int customer;               // Position in the customer store
+    int firstLine;              // First entry of the order's lines in the batch line arrays
+    int lines;                  // Number of lines
+    float balance;              // Customer balance when the order was checked (output)
+} FulfillmentOrder;
+
+// Orders to fulfill, in priority order
+typedef struct {
+    FulfillmentOrder* orders;   // Orders in the batch
+    int count;                  // Orders used
+    int capacity;               // Orders allocated
+    int* linePart;              // Part store position of each order line, -1 if unknown
+    int* lineQuantity;          // Units wanted on each order line
+    int* lineOnHand;            // Quantity on hand when each line was checked (output)
+    int lineCount;              // Lines used
+    int lineCapacity;           // Lines allocated
+} FulfillmentBatch;
+
+extern int eodThreads;          // Pool threads end of day uses (0 = the whole pool)
+
+// Function prototypes
+void fulfillmentInit(FulfillmentBatch* batch);                           // Prepare an empty batch
+void fulfillmentFree(FulfillmentBatch* batch);                           // Release batch memory
+bool fulfillmentAdd(FulfillmentBatch* batch, RecordStore* orders, int orderPosition,
+    int customerPosition, RecordStore* parts);                           // Add an order, resolving its parts
+void runFulfillment(FulfillmentBatch* batch, RecordStore* orders,
+    RecordStore* customers, RecordStore* parts);                         // Check and fulfill every order
+
+#endif
@@ -0,0 +1,412 @@
+/*
+* FILE          : IdIndex.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of the record ID index including:
+*      - Linear-probing hash table over 64-bit IDs
+*      - Table growth that keeps the load factor at or below one half
+*      - Saving the table to an index file and mapping it back
+*        copy-on-write, checked in the background (Warmup.h)
+*/
+
+#include "IdIndex.h"
+#include "FileIo.h"
+#include "Snapshot.h"
+#include "Warmup.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(IdIndexFileHeader) <= IDINDEX_DATA_OFFSET, "index header must fit before the slots");
+
+//
+// FUNCTION    : hashID
+// DESCRIPTION : Mixes an ID so sequential IDs spread across the table
+// PARAMETERS  :
+//      long long id : ID to hash
+// RETURNS     : unsigned long long - Hash value
+//
+static unsigned long long hashID(long long id) {
+    unsigned long long x = (unsigned long long)id;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+//
+// FUNCTION    : clearSlots
+// DESCRIPTION : Marks every slot of a table empty. Whole slots are zeroed
+//               first, padding included, so a saved index file holds the
+//               same bytes for the same IDs.
+// PARAMETERS  :
+//      IdIndexSlot* slots : Slot table
+//      int capacity       : Number of slots
+// RETURNS     : void
+//
+static void clearSlots(IdIndexSlot* slots, int capacity) {
+    memset(slots, 0, sizeof(IdIndexSlot) * (size_t)capacity);
+    for (int i = 0; i < capacity; i++) {
+        slots[i].position = IDINDEX_EMPTY;
+    }
+}
+
+//
+// FUNCTION    : allocateSlots
+// DESCRIPTION : Allocates a slot table with every slot marked empty
+// PARAMETERS  :
+//      int capacity : Number of slots (power of two)
+// RETURNS     : IdIndexSlot* - New table, NULL if out of memory
+//
+static IdIndexSlot* allocateSlots(int capacity) {
+    IdIndexSlot* slots = (IdIndexSlot*)malloc(sizeof(IdIndexSlot) * (size_t)capacity);
+    if (slots == NULL) return NULL;
+
+    clearSlots(slots, capacity);
+    return slots;
+}
+
+//
+// FUNCTION    : placeSlot
+// DESCRIPTION : Stores an ID in the first free slot of its probe sequence
+// PARAMETERS  :
+//      IdIndexSlot* slots : Slot table
+//      int capacity       : Number of slots
+//      long long id       : ID to store
+//      int position       : Array position of the record
+// RETURNS     : bool - false if the ID was already present
+//
+static bool placeSlot(IdIndexSlot* slots, int capacity, long long id, int position) {
+    unsigned long long mask = (unsigned long long)capacity - 1;
+    unsigned long long i = hashID(id) & mask;
+
+    while (slots[i].position != IDINDEX_EMPTY) {
+        if (slots[i].id == id) return false;
+        i = (i + 1) & mask;
+    }
+
+    slots[i].id = id;
+    slots[i].position = position;
+    return true;
+}
+
+//
+// FUNCTION    : releaseSlots
+// DESCRIPTION : Frees an index's slot table, or unmaps the index file it
+//               lies in
+// PARAMETERS  :
+//      IdIndex* index : Index whose table is released
+// RETURNS     : void
+//
+static void releaseSlots(IdIndex* index) {
+#ifndef _WIN32
+    if (index->mapping != NULL) {
+        munmap(index->mapping, index->mappingBytes);
+        index->mapping = NULL;
+        index->mappingBytes = 0;
+        index->slots = NULL;
+        return;
+    }
+#endif
+    free(index->slots);
+    index->slots = NULL;
+}
+
+//
+// FUNCTION    : growIndex
+// DESCRIPTION : Doubles the slot table and re-inserts every stored ID
+// PARAMETERS  :
+//      IdIndex* index : Index to grow
+// RETURNS     : bool - true on success, false if out of memory
+//
+static bool growIndex(IdIndex* index) {
+    int newCapacity = index->capacity > 0 ? index->capacity * 2 : IDINDEX_MIN_SLOTS;
+    IdIndexSlot* newSlots = allocateSlots(newCapacity);
+    if (newSlots == NULL) return false;
+
+    for (int i = 0; i < index->capacity; i++) {
+        if (index->slots[i].position != IDINDEX_EMPTY) {
+            placeSlot(newSlots, newCapacity, index->slots[i].id, index->slots[i].position);
+        }
+    }
+
+    releaseSlots(index);
+    index->slots = newSlots;
+    index->capacity = newCapacity;
+    return true;
+}
+
+//
+// FUNCTION    : idIndexReset
+// DESCRIPTION : Empties the index and binds it to a record array, sizing the
+//               table up front for the expected number of records
+// PARAMETERS  :
+//      IdIndex* index      : Index to reset
+//      const void* base    : Record array the positions will refer to
+//      int expectedRecords : Number of records about to be inserted
+// RETURNS     : void
+//
+void idIndexReset(IdIndex* index, const void* base, int expectedRecords) {
+    int wanted = IDINDEX_MIN_SLOTS;
+    while (wanted / 2 < expectedRecords) {
+        wanted *= 2;
+    }
+
+    if (index->capacity != wanted) {
+        IdIndexSlot* slots = allocateSlots(wanted);
+        if (slots != NULL) {
+            releaseSlots(index);
+            index->slots = slots;
+            index->capacity = wanted;
+        }
+        else if (index->slots != NULL) {
+            // Keep the old table if a bigger one cannot be allocated
+            clearSlots(index->slots, index->capacity);
+        }
+    }
+    else {
+        clearSlots(index->slots, index->capacity);
+    }
+
+    index->used = 0;
+    index->base = base;
+    index->indexedRecords = 0;
+}
+
+//
+// FUNCTION    : idIndexFree
+// DESCRIPTION : Releases the slot table and unbinds the index. A table
+//               inside a mapped index file is released by unmapping it.
+// PARAMETERS  :
+//      IdIndex* index : Index to free
+// RETURNS     : void
+//
+void idIndexFree(IdIndex* index) {
+    releaseSlots(index);
+    memset(index, 0, sizeof(*index));
+}
+
+//
+// FUNCTION    : idIndexInsert
+// DESCRIPTION : Adds an ID to the index. If the ID is already present the
+//               earlier position is kept, matching a first-match linear scan.
+// PARAMETERS  :
+//      IdIndex* index : Index to update
+//      long long id   : Record ID
+//      int position   : Array position of the record
+// RETURNS     : bool - true if inserted, false if duplicate or out of memory
+//
+bool idIndexInsert(IdIndex* index, long long id, int position) {
+    if ((index->used + 1) * 2 > index->capacity && !growIndex(index)) {
+        return false;
+    }
+
+    if (!placeSlot(index->slots, index->capacity, id, position)) {
+        return false;
+    }
+    index->used++;
+    return true;
+}
+
+//
+// FUNCTION    : idIndexFind
+// DESCRIPTION : Looks up the array position stored for an ID. At most
+//               every slot is probed once, so a table with no empty slot
+//               cannot make the search loop.
+// PARAMETERS  :
+//      const IdIndex* index : Index to search
+//      long long id         : Record ID to find
+// RETURNS     : int - Array position, -1 if not indexed
+//
+int idIndexFind(const IdIndex* index, long long id) {
+    if (index->capacity == 0) return -1;
+
+    unsigned long long mask = (unsigned long long)index->capacity - 1;
+    unsigned long long i = hashID(id) & mask;
+
+    for (int probes = 0; probes < index->capacity && index->slots[i].position != IDINDEX_EMPTY; probes++) {
+        if (index->slots[i].id == id) return index->slots[i].position;
+        i = (i + 1) & mask;
+    }
+    return -1;
+}
+
+//
+// FUNCTION    : fileHeaderChecksum
+// DESCRIPTION : Checksum of an index file header with its own checksum
+//               field zeroed
+// PARAMETERS  :
+//      const IdIndexFileHeader* header : Header to check
+// RETURNS     : unsigned long long - Checksum
+//
+static unsigned long long fileHeaderChecksum(const IdIndexFileHeader* header) {
+    IdIndexFileHeader copy = *header;
+    copy.headerChecksum = 0;
+    return checksumBlock(&copy, sizeof(copy));
+}
+
+//
+// FUNCTION    : fileHeaderValid
+// DESCRIPTION : Checks an index file header against the size of its file
+// PARAMETERS  :
+//      const IdIndexFileHeader* header : Header read from the file
+//      unsigned long long fileSize     : Size of the index file
+// RETURNS     : bool - true if the header is intact and the file holds
+//               exactly its slot table
+//
+static bool fileHeaderValid(const IdIndexFileHeader* header, unsigned long long fileSize) {
+    if (memcmp(header->magic, IDINDEX_MAGIC, sizeof(IDINDEX_MAGIC)) != 0) return false;
+    if (header->headerChecksum != fileHeaderChecksum(header)) return false;
+    if (header->version != IDINDEX_VERSION || header->slotSize != sizeof(IdIndexSlot)) return false;
+    if (header->capacity < IDINDEX_MIN_SLOTS || (header->capacity & (header->capacity - 1)) != 0) return false;
+    if (header->used < 0 || header->used * 2 > header->capacity) return false;
+    return fileSize == IDINDEX_DATA_OFFSET + (unsigned long long)header->capacity * sizeof(IdIndexSlot);
+}
+
+//
+// FUNCTION    : checkIndexFile
+// DESCRIPTION : Warm-up check of a mapped index file: the header, the
+//               checksum of the whole slot table, and that the table holds
+//               exactly the slots the header counts, each pointing inside
+//               the store
+// PARAMETERS  :
+//      const char* data  : Contents of the file
+//      size_t size       : Size of the file
+//      long long records : Records in the store the index is for
+// RETURNS     : bool - true if the file is intact
+//
+static bool checkIndexFile(const char* data, size_t size, long long records) {
+    if (size < IDINDEX_DATA_OFFSET) return false;
+
+    IdIndexFileHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (!fileHeaderValid(&header, size)) return false;
+    if (checksumBlock(data + IDINDEX_DATA_OFFSET, size - IDINDEX_DATA_OFFSET) != header.slotChecksum) return false;
+
+    const IdIndexSlot* slots = (const IdIndexSlot*)(data + IDINDEX_DATA_OFFSET);
+    int used = 0;
+    for (int i = 0; i < header.capacity; i++) {
+        if (slots[i].position == IDINDEX_EMPTY) continue;
+        if (slots[i].position < 0 || slots[i].position >= records) return false;
+        used++;
+    }
+    return used == header.used;
+}
+
+//
+// FUNCTION    : idIndexSave
+// DESCRIPTION : Writes an index's slot table to an index file for the
+//               snapshot it was built from. Like a snapshot, the file is
+//               written to a temporary name, synced and moved into place.
+// PARAMETERS  :
+//      const IdIndex* index           : Index to save (built for the snapshot)
+//      const char* filename           : Index file to write
+//      unsigned long long snapshotTag : snapshotTag of the snapshot
+// RETURNS     : bool - true on success
+//
+bool idIndexSave(const IdIndex* index, const char* filename, unsigned long long snapshotTag) {
+    if (index->capacity == 0) return false;
+
+    char tempName[FILENAME_MAX];
+    if (sprintf_s(tempName, sizeof(tempName), "%s%s", filename, SNAPSHOT_TEMP_SUFFIX) < 0) return false;
+
+    IdIndexFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IDINDEX_MAGIC, sizeof(IDINDEX_MAGIC));
+    header.version = IDINDEX_VERSION;
+    header.slotSize = (unsigned int)sizeof(IdIndexSlot);
+    header.snapshotTag = snapshotTag;
+    header.capacity = index->capacity;
+    header.used = index->used;
+    for (int i = 0; i < index->capacity; i++) {
+        if (index->slots[i].position != IDINDEX_EMPTY && index->slots[i].id > header.largestId) {
+            header.largestId = index->slots[i].id;
+        }
+    }
+    size_t slotBytes = sizeof(IdIndexSlot) * (size_t)index->capacity;
+    header.slotChecksum = checksumBlock(index->slots, slotBytes);
+    header.headerChecksum = fileHeaderChecksum(&header);
+
+    unsigned char headerBlock[IDINDEX_DATA_OFFSET];
+    memset(headerBlock, 0, sizeof(headerBlock));
+    memcpy(headerBlock, &header, sizeof(header));
+
+    IoFile file;
+    if (!ioOpenWrite(&file, tempName)) return false;
+    ioWrite(&file, index->slots, slotBytes, IDINDEX_DATA_OFFSET);
+    ioWrite(&file, headerBlock, sizeof(headerBlock), 0);
+
+    bool written = ioClose(&file);
+    written = written && replaceFile(tempName, filename);
+    if (!written) remove(tempName);
+    return written;
+}
+
+//
+// FUNCTION    : idIndexMap
+// DESCRIPTION : Replaces an index's table with a copy-on-write mapping of
+//               an index file, so nothing is read until a lookup needs it.
+//               Only the header is checked here; the whole table is
+//               checked by the warm-up thread, and if it is damaged the
+//               owner rebuilds the index when warmupRebuildNeeded says so.
+//               Until then lookups probe each slot at most once and the
+//               owner checks each position it gets. Not available on
+//               Windows.
+// PARAMETERS  :
+//      IdIndex* index                 : Index to fill
+//      const char* filename           : Index file to map
+//      unsigned long long snapshotTag : snapshotTag of the loaded snapshot
+//      const void* base               : Record store the positions refer to
+//      int records                    : Records in the store
+//      long long* largestId           : Receives the largest ID indexed
+// RETURNS     : bool - false if the file is missing, damaged or was built
+//               from another snapshot (the index is then unchanged)
+//
+bool idIndexMap(IdIndex* index, const char* filename, unsigned long long snapshotTag,
+    const void* base, int records, long long* largestId) {
+#ifdef _WIN32
+    (void)index; (void)filename; (void)snapshotTag; (void)base; (void)records; (void)largestId;
+    return false;
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    IdIndexFileHeader header;
+    bool usable = fstat(fd, &info) == 0 &&
+        pread(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+        fileHeaderValid(&header, (unsigned long long)info.st_size) &&
+        header.snapshotTag == snapshotTag && header.used <= records;
+    void* data = MAP_FAILED;
+    if (usable) data = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    if (!warmupAdd(filename, data, (size_t)info.st_size, checkIndexFile, records, true)) {
+        munmap(data, (size_t)info.st_size);
+        return false;
+    }
+
+    releaseSlots(index);
+    index->slots = (IdIndexSlot*)((char*)data + IDINDEX_DATA_OFFSET);
+    index->capacity = header.capacity;
+    index->used = header.used;
+    index->base = base;
+    index->indexedRecords = records;
+    index->mapping = data;
+    index->mappingBytes = (size_t)info.st_size;
+    *largestId = header.largestId;
+    return true;
+#endif
+}
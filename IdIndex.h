@@ -0,0 +1,66 @@
+/*
+* FILE          : IdIndex.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for the record ID index including:
+*      - Open-addressing hash table mapping IDs to array positions
+*      - Index files saved beside a snapshot and mapped at lazy start-up
+*      - Function prototypes for index maintenance and lookup
+*/
+
+#ifndef IDINDEX_H
+#define IDINDEX_H
+
+#include <stddef.h>
+
+#define IDINDEX_EMPTY -1        // Position stored in an unused slot
+#define IDINDEX_MIN_SLOTS 64    // Smallest table allocated
+#define IDINDEX_MAGIC "PWHIDX"  // First 8 bytes of every index file (with terminator)
+#define IDINDEX_VERSION 1       // Bumped whenever the index file layout changes
+#define IDINDEX_DATA_OFFSET 64  // Slots start here, after the padded header
+
+// One hash table slot
+typedef struct {
+    long long id;               // Record ID stored in this slot
+    int position;               // Array position of the record, IDINDEX_EMPTY if unused
+} IdIndexSlot;
+
+// ID index bound to one record array
+typedef struct {
+    IdIndexSlot* slots;         // Slot table (capacity is a power of two)
+    int capacity;               // Number of slots
+    int used;                   // Number of occupied slots
+    const void* base;           // Record array the positions refer to
+    int indexedRecords;         // Records of base[] already inserted
+    void* mapping;              // Mapped index file holding slots, NULL if slots were allocated
+    size_t mappingBytes;        // Length of that mapping
+} IdIndex;
+
+// Index file header. The slot table follows at IDINDEX_DATA_OFFSET exactly
+// as it is in memory. snapshotTag ties the file to the snapshot it was
+// built from, so an index left over from an older snapshot is ignored.
+typedef struct {
+    char magic[8];                  // IDINDEX_MAGIC
+    unsigned int version;           // IDINDEX_VERSION
+    unsigned int slotSize;          // sizeof(IdIndexSlot)
+    unsigned long long snapshotTag; // snapshotTag of the snapshot indexed
+    long long largestId;            // Largest ID in the table (0 if empty)
+    int capacity;                   // Slots in the table
+    int used;                       // Occupied slots
+    unsigned long long slotChecksum; // Checksum of the slot table
+    unsigned long long headerChecksum; // Checksum of this header with this field zero
+} IdIndexFileHeader;
+
+// Function prototypes
+void idIndexReset(IdIndex* index, const void* base, int expectedRecords);  // Empty index and bind it to an array
+void idIndexFree(IdIndex* index);                                          // Release index memory
+bool idIndexInsert(IdIndex* index, long long id, int position);            // Add ID (first position wins)
+int idIndexFind(const IdIndex* index, long long id);                       // Look up position, -1 if absent
+bool idIndexSave(const IdIndex* index, const char* filename,
+    unsigned long long snapshotTag);                                        // Write the table to an index file
+bool idIndexMap(IdIndex* index, const char* filename, unsigned long long snapshotTag,
+    const void* base, int records, long long* largestId);                   // Map an index file saved for a snapshot
+
+#endif
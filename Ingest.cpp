@@ -0,0 +1,550 @@
+/*
+* FILE          : Ingest.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of bulk order ingestion including:
+*      - Reader thread that cuts the feed into line-aligned blocks
+*      - Validation threads that parse, check customers and parts, and
+*        price the orders of a block
+*      - Commit stage on the calling thread that assigns order IDs, adds
+*        the orders to the store and reports rejected lines, block by
+*        block in feed order
+*      The three stages run at the same time on different blocks. A ring
+*      of blocks bounds the memory used however long the feed is.
+*/
+
+#include "Ingest.h"
+#include "OrderId.h"
+#include "DbReader.h"
+#include "System.h"
+#include "Wal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// One feed line after validation
+typedef struct {
+    Order order;                // Checked order without ID or date; FirstLine indexes the block's lines
+    int line;                   // Line number in the feed
+    int reason;                 // IngestReason
+    size_t textStart;           // Offset of the line in the block text
+    size_t textLength;          // Length of the line without its line ending
+} IngestRecord;
+
+// A run of whole feed lines and the orders validated from them
+typedef struct {
+    char* text;                 // Feed text
+    size_t length;              // Bytes of text used
+    size_t capacity;            // Bytes of text allocated
+    int firstLine;              // Feed line number of the first line
+    IngestRecord* records;      // One entry per non-blank line
+    int recordCount;            // Records used
+    int recordCapacity;         // Records allocated
+    OrderItem* lines;           // Lines of the accepted orders, back to back
+    int lineCount;              // Lines used
+    int lineCapacity;           // Lines allocated
+    bool checked;               // Validated and ready to commit
+    bool outOfMemory;           // Validation stopped for lack of memory
+} IngestBlock;
+
+// State shared by the pipeline stages. Blocks are numbered in feed order
+// and block n lives in ring slot n % window; all counters are guarded by
+// lock.
+typedef struct {
+    FILE* feed;
+    RecordStore* customers;
+    RecordStore* parts;
+    IngestBlock* ring;          // Blocks in flight
+    int window;                 // Ring slots
+    int readBlocks;             // Blocks the reader has filled
+    int nextToCheck;            // Next block for validation
+    int committedBlocks;        // Blocks the commit stage has finished
+    bool readDone;              // Reader reached the end of the feed
+    bool stopping;              // Commit stage gave up; the reader stops early
+    bool readFailed;            // Reader could not read or allocate
+    std::mutex lock;
+    std::condition_variable changed;
+} IngestPipeline;
+
+static const char* const reasonText[INGEST_REASON_COUNT] = {
+    "accepted",
+    "invalid customer ID",
+    "customer not found",
+    "invalid number of parts",
+    "missing or invalid part",
+    "part not found",
+    "invalid quantity",
+    "no order ID available",
+    "not enough memory"
+};
+
+int ingestThreads = 0;
+
+//
+// FUNCTION    : growText
+// DESCRIPTION : Makes room for more text in a block
+// PARAMETERS  :
+//      IngestBlock* block : Block to grow
+//      size_t needed      : Bytes of text the block must hold
+// RETURNS     : bool - false if out of memory
+//
+static bool growText(IngestBlock* block, size_t needed) {
+    if (needed <= block->capacity) return true;
+
+    size_t capacity = block->capacity > 0 ? block->capacity : INGEST_BLOCK_BYTES;
+    while (capacity < needed) capacity *= 2;
+
+    char* text = (char*)realloc(block->text, capacity);
+    if (text == NULL) return false;
+    block->text = text;
+    block->capacity = capacity;
+    return true;
+}
+
+//
+// FUNCTION    : fillBlock
+// DESCRIPTION : Reads the next run of whole lines into a block. The part
+//               line left after the last newline is moved to the carry
+//               buffer for the next block; a line longer than a block
+//               makes the block grow until the line is complete.
+// PARAMETERS  :
+//      FILE* feed             : Feed to read
+//      IngestBlock* block     : Block to fill
+//      char** carry           : Partial line left by the previous block (updated)
+//      size_t* carryLength    : Bytes in carry (updated)
+//      size_t* carryCapacity  : Bytes allocated for carry (updated)
+// RETURNS     : int - 1 if text was read, 0 at the end of the feed, -1 on error
+//
+static int fillBlock(FILE* feed, IngestBlock* block, char** carry, size_t* carryLength,
+    size_t* carryCapacity) {
+    if (!growText(block, *carryLength > INGEST_BLOCK_BYTES ? *carryLength : INGEST_BLOCK_BYTES)) return -1;
+    memcpy(block->text, *carry, *carryLength);
+    block->length = *carryLength;
+    *carryLength = 0;
+
+    size_t lineEnd = 0;
+    for (;;) {
+        if (block->length == block->capacity && !growText(block, block->capacity * 2)) return -1;
+
+        size_t got = fread(block->text + block->length, 1, block->capacity - block->length, feed);
+        size_t searched = block->length;
+        block->length += got;
+        if (got == 0) {
+            if (ferror(feed)) return -1;
+            lineEnd = block->length;
+            break;
+        }
+
+        // Cut after the last newline; keep reading if the block has none yet
+        const char* text = block->text;
+        for (size_t i = block->length; i > searched; i--) {
+            if (text[i - 1] == '\n') {
+                lineEnd = i;
+                break;
+            }
+        }
+        if (lineEnd > 0) break;
+    }
+
+    size_t tail = block->length - lineEnd;
+    if (tail > *carryCapacity) {
+        char* grown = (char*)realloc(*carry, tail);
+        if (grown == NULL) return -1;
+        *carry = grown;
+        *carryCapacity = tail;
+    }
+    memcpy(*carry, block->text + lineEnd, tail);
+    *carryLength = tail;
+    block->length = lineEnd;
+    return block->length > 0 ? 1 : 0;
+}
+
+//
+// FUNCTION    : readFeed
+// DESCRIPTION : Reader stage. Fills ring slots with feed blocks as the
+//               commit stage frees them, until the feed ends.
+// PARAMETERS  :
+//      IngestPipeline* pipeline : Shared pipeline
+// RETURNS     : void
+//
+static void readFeed(IngestPipeline* pipeline) {
+    char* carry = NULL;
+    size_t carryLength = 0, carryCapacity = 0;
+    int lineNumber = 1;
+    bool failed = false;
+
+    for (;;) {
+        int sequence;
+        {
+            std::unique_lock<std::mutex> guard(pipeline->lock);
+            pipeline->changed.wait(guard, [pipeline] {
+                return pipeline->stopping || pipeline->readBlocks - pipeline->committedBlocks < pipeline->window;
+            });
+            if (pipeline->stopping) break;
+            sequence = pipeline->readBlocks;
+        }
+
+        IngestBlock* block = &pipeline->ring[sequence % pipeline->window];
+        int filled = fillBlock(pipeline->feed, block, &carry, &carryLength, &carryCapacity);
+        if (filled <= 0) {
+            failed = filled < 0;
+            break;
+        }
+
+        block->firstLine = lineNumber;
+        block->checked = false;
+        const char* end = block->text + block->length;
+        for (const char* p = block->text; (p = (const char*)memchr(p, '\n', (size_t)(end - p))) != NULL; p++) {
+            lineNumber++;
+        }
+
+        std::lock_guard<std::mutex> guard(pipeline->lock);
+        pipeline->readBlocks++;
+        pipeline->changed.notify_all();
+    }
+
+    free(carry);
+    std::lock_guard<std::mutex> guard(pipeline->lock);
+    pipeline->readDone = true;
+    pipeline->readFailed = failed;
+    pipeline->changed.notify_all();
+}
+
+//
+// FUNCTION    : checkLine
+// DESCRIPTION : Parses one feed line, looks up its customer and parts and
+//               prices it, with the same rules as createNewOrder. The
+//               lines of an accepted order are appended to the block.
+// PARAMETERS  :
+//      IngestPipeline* pipeline        : Shared pipeline (stores)
+//      IngestBlock* block              : Block receiving the order lines
+//      const std::string_view fields[] : Fields of the line
+//      int fieldCount                  : Number of fields
+//      Order* order                    : Receives the checked order
+// RETURNS     : int - IngestReason
+//
+static int checkLine(IngestPipeline* pipeline, IngestBlock* block, const std::string_view fields[],
+    int fieldCount, Order* order) {
+    if (!parseIntField(fields[0], &order->CustomerID) || order->CustomerID <= 0) return INGEST_BAD_CUSTOMER;
+    if (findCustomer(pipeline->customers, order->CustomerID) == -1) return INGEST_UNKNOWN_CUSTOMER;
+
+    if (fieldCount < 2 || !parseIntField(fields[1], &order->DistinctParts) ||
+        order->DistinctParts < 1 || order->DistinctParts > MAX_PARTS_PER_ORDER) {
+        return INGEST_BAD_PART_COUNT;
+    }
+
+    if (block->lineCount + order->DistinctParts > block->lineCapacity) {
+        int capacity = block->lineCapacity > 0 ? block->lineCapacity * 2 : MAX_PARTS_PER_ORDER;
+        while (capacity < block->lineCount + order->DistinctParts) capacity *= 2;
+        OrderItem* lines = (OrderItem*)realloc(block->lines, sizeof(OrderItem) * (size_t)capacity);
+        if (lines == NULL) return INGEST_NO_MEMORY;
+        block->lines = lines;
+        block->lineCapacity = capacity;
+    }
+
+    OrderItem* items = block->lines + block->lineCount;
+    order->OrderTotal = 0.0f;
+    order->TotalParts = 0;
+    for (int i = 0; i < order->DistinctParts; i++) {
+        int field = 2 + i * 2;
+        if (field + 1 >= fieldCount || !parseIntField(fields[field], &items[i].PartID) ||
+            items[i].PartID <= 0) {
+            return INGEST_BAD_PART_LINE;
+        }
+
+        int part = findPart(pipeline->parts, items[i].PartID);
+        if (part == -1) return INGEST_UNKNOWN_PART;
+
+        if (!parseIntField(fields[field + 1], &items[i].NumberOfParts) || items[i].NumberOfParts < 1) {
+            return INGEST_BAD_QUANTITY;
+        }
+
+        order->OrderTotal += partAt(pipeline->parts, part)->PartCost * items[i].NumberOfParts;
+        order->TotalParts += items[i].NumberOfParts;
+    }
+
+    order->OrderStatus = STATUS_PLACED;
+    order->FirstLine = block->lineCount;
+    block->lineCount += order->DistinctParts;
+    return INGEST_ACCEPTED;
+}
+
+//
+// FUNCTION    : checkBlock
+// DESCRIPTION : Validation stage for one block. Every non-blank line gets
+//               a record, accepted or not, so rejects keep their place.
+// PARAMETERS  :
+//      IngestPipeline* pipeline : Shared pipeline
+//      IngestBlock* block       : Block to check
+//      std::string_view* fields : Field buffer of INGEST_MAX_FIELDS entries
+// RETURNS     : void
+//
+static void checkBlock(IngestPipeline* pipeline, IngestBlock* block, std::string_view* fields) {
+    MappedFile view = { block->text, block->length, NULL, NULL, NULL };
+    size_t offset = 0;
+    int line = block->firstLine;
+    int fieldCount;
+
+    block->recordCount = 0;
+    block->lineCount = 0;
+    block->outOfMemory = false;
+
+    for (size_t start = 0;
+        (fieldCount = nextDbRecord(&view, &offset, DB_TRIM_CRLF, fields, INGEST_MAX_FIELDS)) >= 0;
+        start = offset, line++) {
+        if (fieldCount == 0) continue;
+
+        if (block->recordCount == block->recordCapacity) {
+            int capacity = block->recordCapacity > 0 ? block->recordCapacity * 2 : 1024;
+            IngestRecord* records = (IngestRecord*)realloc(block->records, sizeof(IngestRecord) * (size_t)capacity);
+            if (records == NULL) {
+                block->outOfMemory = true;
+                return;
+            }
+            block->records = records;
+            block->recordCapacity = capacity;
+        }
+
+        IngestRecord* record = &block->records[block->recordCount++];
+        size_t end = offset;
+        while (end > start && (block->text[end - 1] == '\n' || block->text[end - 1] == '\r')) end--;
+        record->line = line;
+        record->textStart = start;
+        record->textLength = end - start;
+        record->reason = checkLine(pipeline, block, fields, fieldCount, &record->order);
+    }
+}
+
+//
+// FUNCTION    : takeBlockToCheck
+// DESCRIPTION : Claims the next block waiting for validation. Called with
+//               the pipeline lock held.
+// PARAMETERS  :
+//      IngestPipeline* pipeline : Shared pipeline
+// RETURNS     : IngestBlock* - Block to check, NULL if none is waiting
+//
+static IngestBlock* takeBlockToCheck(IngestPipeline* pipeline) {
+    if (pipeline->nextToCheck >= pipeline->readBlocks) return NULL;
+    return &pipeline->ring[pipeline->nextToCheck++ % pipeline->window];
+}
+
+//
+// FUNCTION    : checkFeed
+// DESCRIPTION : Validation stage worker loop. Checks blocks in any order
+//               until the reader is done and no block is left.
+// PARAMETERS  :
+//      IngestPipeline* pipeline : Shared pipeline
+// RETURNS     : void
+//
+static void checkFeed(IngestPipeline* pipeline) {
+    std::string_view* fields = new std::string_view[INGEST_MAX_FIELDS];
+
+    for (;;) {
+        IngestBlock* block;
+        {
+            std::unique_lock<std::mutex> guard(pipeline->lock);
+            pipeline->changed.wait(guard, [pipeline] {
+                return pipeline->nextToCheck < pipeline->readBlocks || pipeline->readDone;
+            });
+            block = takeBlockToCheck(pipeline);
+            if (block == NULL) break;
+        }
+
+        checkBlock(pipeline, block, fields);
+
+        std::lock_guard<std::mutex> guard(pipeline->lock);
+        block->checked = true;
+        pipeline->changed.notify_all();
+    }
+
+    delete[] fields;
+}
+
+//
+// FUNCTION    : commitBlock
+// DESCRIPTION : Commit stage for one block. Accepted orders get an ID and
+//               the current date and are added to the store in feed
+//               order; rejected lines are written to the reject file.
+// PARAMETERS  :
+//      IngestBlock* block   : Checked block
+//      RecordStore* orders  : Order store
+//      FILE* rejects        : Reject file (may be NULL)
+//      IngestResult* result : Counts (updated)
+// RETURNS     : bool - false if the store ran out of memory
+//
+static bool commitBlock(IngestBlock* block, RecordStore* orders, FILE* rejects, IngestResult* result) {
+    char date[LENGTH_OF_DATE];
+    getCurrentDate(date);
+
+    for (int i = 0; i < block->recordCount; i++) {
+        IngestRecord* record = &block->records[i];
+
+        if (record->reason == INGEST_ACCEPTED) {
+            Order order = record->order;
+            order.OrderID = generateOrderID();
+            memcpy(order.OrderDate, date, sizeof(order.OrderDate));
+
+            Order* slot = NULL;
+            if (order.OrderID == ORDER_ID_NONE) {
+                record->reason = INGEST_NO_ORDER_ID;
+            }
+            else if (!appendOrderLines(&order, block->lines + record->order.FirstLine, order.DistinctParts)) {
+                record->reason = INGEST_NO_MEMORY;
+            }
+            else if ((slot = (Order*)storeAppend(orders)) == NULL) {
+                storeResize(&orderLines, order.FirstLine);
+                record->reason = INGEST_NO_MEMORY;
+            }
+            else {
+                *slot = order;
+                walLogOrder(slot);
+                result->accepted++;
+                logEvent(LOG_ORDER_CREATED, order.OrderID, order.CustomerID, order.OrderTotal);
+                continue;
+            }
+        }
+
+        result->rejected++;
+        if (rejects != NULL) {
+            fprintf(rejects, "line %d: %s: %.*s\n", record->line, reasonText[record->reason],
+                (int)record->textLength, block->text + record->textStart);
+        }
+        if (record->reason == INGEST_NO_MEMORY) return false;
+    }
+    return !block->outOfMemory;
+}
+
+//
+// FUNCTION    : ingestOrders
+// DESCRIPTION : Adds every valid line of an order feed to the order store
+//               as a placed order. Reading, validation and committing run
+//               as pipelined stages: a reader thread, ingestThreads - 1
+//               validation threads, and the calling thread, which commits
+//               blocks in feed order and validates blocks itself while it
+//               waits. The orders are appended in feed order with
+//               ascending IDs, whatever the thread count.
+// PARAMETERS  :
+//      FILE* feed             : Feed to read to its end
+//      const char* rejectFile : File receiving the rejected lines (NULL for none)
+//      RecordStore* orders    : Order store
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      IngestResult* result   : Receives the counts
+// RETURNS     : bool - false if the feed could not be read completely or
+//               memory ran out; the orders committed so far are kept
+//
+bool ingestOrders(FILE* feed, const char* rejectFile, RecordStore* orders,
+    RecordStore* customers, RecordStore* parts, IngestResult* result) {
+    result->accepted = 0;
+    result->rejected = 0;
+
+    // Bring the lookup indexes up to date so the validation threads only read them
+    findCustomer(customers, 0);
+    findPart(parts, 0);
+
+    int threadCount = ingestThreads > 0 ? ingestThreads : (int)std::thread::hardware_concurrency();
+    if (threadCount < 1) threadCount = 1;
+
+    IngestPipeline* pipeline = new IngestPipeline();
+    pipeline->feed = feed;
+    pipeline->customers = customers;
+    pipeline->parts = parts;
+    pipeline->window = threadCount * INGEST_BLOCKS_PER_THREAD + 1;
+    pipeline->ring = (IngestBlock*)calloc((size_t)pipeline->window, sizeof(IngestBlock));
+    pipeline->readBlocks = 0;
+    pipeline->nextToCheck = 0;
+    pipeline->committedBlocks = 0;
+    pipeline->readDone = false;
+    pipeline->stopping = false;
+    pipeline->readFailed = false;
+
+    std::string_view* fields = new std::string_view[INGEST_MAX_FIELDS];
+    std::thread* checkers = new std::thread[threadCount];
+    std::thread reader;
+    int started = 0;
+    bool readerStarted = false;
+
+    if (pipeline->ring != NULL) {
+        try {
+            reader = std::thread(readFeed, pipeline);
+            readerStarted = true;
+            for (; started < threadCount - 1; started++) {
+                checkers[started] = std::thread(checkFeed, pipeline);
+            }
+        }
+        catch (...) {
+        }
+    }
+
+    FILE* rejects = NULL;
+    if (rejectFile != NULL && fopen_s(&rejects, rejectFile, "w") != 0) rejects = NULL;
+
+    bool complete = readerStarted;
+    while (readerStarted) {
+        IngestBlock* block;
+        IngestBlock* help = NULL;
+        {
+            std::unique_lock<std::mutex> guard(pipeline->lock);
+            pipeline->changed.wait(guard, [pipeline] {
+                return pipeline->committedBlocks < pipeline->readBlocks || pipeline->readDone;
+            });
+            if (pipeline->committedBlocks == pipeline->readBlocks) break;
+
+            block = &pipeline->ring[pipeline->committedBlocks % pipeline->window];
+            if (!block->checked) {
+                help = takeBlockToCheck(pipeline);
+                if (help == NULL) {
+                    pipeline->changed.wait(guard, [block] { return block->checked; });
+                }
+            }
+        }
+
+        if (help != NULL) {
+            checkBlock(pipeline, help, fields);
+            std::lock_guard<std::mutex> guard(pipeline->lock);
+            help->checked = true;
+            pipeline->changed.notify_all();
+            continue;
+        }
+
+        bool committed = commitBlock(block, orders, rejects, result);
+
+        std::lock_guard<std::mutex> guard(pipeline->lock);
+        pipeline->committedBlocks++;
+        if (!committed) {
+            pipeline->stopping = true;
+            complete = false;
+        }
+        pipeline->changed.notify_all();
+        if (!committed) break;
+    }
+
+    if (readerStarted) reader.join();
+    {
+        // Let the validation threads finish once the reader has stopped
+        std::lock_guard<std::mutex> guard(pipeline->lock);
+        pipeline->readDone = true;
+        pipeline->nextToCheck = pipeline->readBlocks;
+        pipeline->changed.notify_all();
+    }
+    for (int i = 0; i < started; i++) {
+        checkers[i].join();
+    }
+    if (pipeline->readFailed) complete = false;
+
+    if (rejects != NULL) fclose(rejects);
+    for (int i = 0; pipeline->ring != NULL && i < pipeline->window; i++) {
+        free(pipeline->ring[i].text);
+        free(pipeline->ring[i].records);
+        free(pipeline->ring[i].lines);
+    }
+    free(pipeline->ring);
+    delete[] checkers;
+    delete[] fields;
+    delete pipeline;
+    return complete;
+}
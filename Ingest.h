@@ -0,0 +1,54 @@
+/*
+* FILE          : Ingest.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for bulk order ingestion including:
+*      - Order feed line format and reject reasons
+*      - Pipeline block, window and thread settings
+*      - Function prototype for ingesting a feed into the order store
+*      A feed line is CustomerID|DistinctParts|PartID|Quantity|... with one
+*      part/quantity pair per distinct part, the same fields that follow the
+*      total in orders.db. Orders get the current date, STATUS_PLACED and an
+*      ID from generateOrderID, in feed order.
+*/
+
+#ifndef INGEST_H
+#define INGEST_H
+
+#include "Order.h"
+#include <stdio.h>
+
+#define INGEST_REJECT_FILE "ingest_rejects.txt" // Rejected lines of the last ingest
+#define INGEST_BLOCK_BYTES (1 << 20)            // Feed text read per pipeline block
+#define INGEST_BLOCKS_PER_THREAD 2              // Blocks in flight per validation thread
+#define INGEST_MAX_FIELDS (2 + MAX_PARTS_PER_ORDER * 2) // Header fields plus part/quantity pairs
+
+// Why a feed line was not turned into an order
+typedef enum {
+    INGEST_ACCEPTED = 0,
+    INGEST_BAD_CUSTOMER,        // Customer ID missing or not a number
+    INGEST_UNKNOWN_CUSTOMER,    // No customer with that ID
+    INGEST_BAD_PART_COUNT,      // Distinct parts missing or not 1-MAX_PARTS_PER_ORDER
+    INGEST_BAD_PART_LINE,       // Fewer part/quantity pairs than distinct parts, or a bad part ID
+    INGEST_UNKNOWN_PART,        // No part with that ID
+    INGEST_BAD_QUANTITY,        // Quantity missing or below 1
+    INGEST_NO_ORDER_ID,         // No order ID could be allocated
+    INGEST_NO_MEMORY,           // Store could not grow
+    INGEST_REASON_COUNT
+} IngestReason;
+
+// Outcome of one ingest
+typedef struct {
+    int accepted;               // Orders added to the store
+    int rejected;               // Lines written to the reject file
+} IngestResult;
+
+extern int ingestThreads;       // Validation threads for ingest (0 = one per core)
+
+// Function prototypes
+bool ingestOrders(FILE* feed, const char* rejectFile, RecordStore* orders,
+    RecordStore* customers, RecordStore* parts, IngestResult* result); // Add every valid feed line as an order
+
+#endif
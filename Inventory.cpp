@@ -0,0 +1,197 @@
+/*
+* FILE          : Inventory.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of inventory reservations including:
+*      - Compare-and-swap decrements of a part's quantity on hand
+*      - Rollback of earlier lines when a later line cannot be reserved
+*      - Part status upkeep after stock changes
+*      A reservation takes its quantity out of QuantityOnHand at once, so
+*      the quantity always shows what is still free to reserve.
+*/
+
+#include "Inventory.h"
+#include <atomic>
+
+// The counters are the plain int fields of Parts, used in place as atomics
+static_assert(sizeof(std::atomic<int>) == sizeof(int) && alignof(std::atomic<int>) == alignof(int),
+    "std::atomic<int> must have the layout of int");
+static_assert(std::atomic<int>::is_always_lock_free, "std::atomic<int> must be lock-free");
+
+//
+// FUNCTION    : counterOf
+// DESCRIPTION : Views an int field of a part record as an atomic counter
+// PARAMETERS  :
+//      int* field : Field to access
+// RETURNS     : std::atomic<int>* - The same storage as an atomic
+//
+static inline std::atomic<int>* counterOf(int* field) {
+    return reinterpret_cast<std::atomic<int>*>(field);
+}
+
+//
+// FUNCTION    : statusFor
+// DESCRIPTION : Part status for a quantity on hand
+// PARAMETERS  :
+//      int quantity : Quantity on hand
+// RETURNS     : int - 0 = plenty, 99 = low, otherwise minus the units missing
+//
+static inline int statusFor(int quantity) {
+    if (quantity > 100) return 0;
+    if (quantity > 0) return 99;
+    return -quantity;
+}
+
+//
+// FUNCTION    : refreshStatus
+// DESCRIPTION : Sets a part's status from its quantity, retrying until the
+//               quantity did not change while the status was written
+// PARAMETERS  :
+//      Parts* part : Part to update
+// RETURNS     : void
+//
+static void refreshStatus(Parts* part) {
+    std::atomic<int>* stock = counterOf(&part->QuantityOnHand);
+    std::atomic<int>* status = counterOf(&part->PartStatus);
+    int quantity = stock->load(std::memory_order_acquire);
+
+    for (;;) {
+        status->store(statusFor(quantity), std::memory_order_relaxed);
+        int now = stock->load(std::memory_order_acquire);
+        if (now == quantity) break;
+        quantity = now;
+    }
+}
+
+//
+// FUNCTION    : takeStock
+// DESCRIPTION : Removes a quantity from a part if enough is on hand
+// PARAMETERS  :
+//      Parts* part  : Part to take from
+//      int quantity : Units to take
+// RETURNS     : bool - false if fewer units are on hand
+//
+static bool takeStock(Parts* part, int quantity) {
+    std::atomic<int>* stock = counterOf(&part->QuantityOnHand);
+    int onHand = stock->load(std::memory_order_acquire);
+
+    while (onHand >= quantity) {
+        if (stock->compare_exchange_weak(onHand, onHand - quantity, std::memory_order_acq_rel,
+            std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//
+// FUNCTION    : inventoryReserve
+// DESCRIPTION : Reserves the quantity of every line of an order. Lines are
+//               taken in turn; if one cannot be covered the lines already
+//               taken are returned, so either all stock is reserved or none.
+// PARAMETERS  :
+//      RecordStore* parts      : Part store
+//      const int* linePart     : Part position of each line, -1 if unknown
+//      const int* lineQuantity : Units wanted on each line
+//      int lines               : Number of lines
+//      int* failedLine         : Receives the first line that could not be
+//                                reserved (may be NULL)
+// RETURNS     : bool - true if every line was reserved
+//
+bool inventoryReserve(RecordStore* parts, const int* linePart, const int* lineQuantity,
+    int lines, int* failedLine) {
+    for (int j = 0; j < lines; j++) {
+        if (linePart[j] == -1 || !takeStock(partAt(parts, linePart[j]), lineQuantity[j])) {
+            inventoryRelease(parts, linePart, lineQuantity, j);
+            if (failedLine) *failedLine = j;
+            return false;
+        }
+    }
+    return true;
+}
+
+//
+// FUNCTION    : inventoryCommit
+// DESCRIPTION : Finalizes a reservation once the order is fulfilled. The
+//               stock is already out of the quantity on hand; this brings
+//               each part's status up to date.
+// PARAMETERS  :
+//      RecordStore* parts  : Part store
+//      const int* linePart : Part position of each reserved line
+//      int lines           : Number of lines
+// RETURNS     : void
+//
+void inventoryCommit(RecordStore* parts, const int* linePart, int lines) {
+    for (int j = 0; j < lines; j++) {
+        refreshStatus(partAt(parts, linePart[j]));
+    }
+}
+
+//
+// FUNCTION    : inventoryRelease
+// DESCRIPTION : Returns the stock of a reservation that will not be used
+// PARAMETERS  :
+//      RecordStore* parts      : Part store
+//      const int* linePart     : Part position of each reserved line
+//      const int* lineQuantity : Units reserved on each line
+//      int lines               : Number of lines
+// RETURNS     : void
+//
+void inventoryRelease(RecordStore* parts, const int* linePart, const int* lineQuantity, int lines) {
+    for (int j = 0; j < lines; j++) {
+        counterOf(&partAt(parts, linePart[j])->QuantityOnHand)->fetch_add(lineQuantity[j],
+            std::memory_order_acq_rel);
+    }
+}
+
+//
+// FUNCTION    : inventoryOnHand
+// DESCRIPTION : Reads the quantity of a part that is free to reserve
+// PARAMETERS  :
+//      RecordStore* parts : Part store
+//      int position       : Part position
+// RETURNS     : int - Units on hand
+//
+int inventoryOnHand(RecordStore* parts, int position) {
+    return counterOf(&partAt(parts, position)->QuantityOnHand)->load(std::memory_order_acquire);
+}
+
+//
+// FUNCTION    : inventoryMarkShort
+// DESCRIPTION : Marks a part as backordered if it cannot cover a quantity
+// PARAMETERS  :
+//      RecordStore* parts : Part store
+//      int position       : Part position
+//      int quantity       : Units wanted
+// RETURNS     : int - Units on hand when checked
+//
+int inventoryMarkShort(RecordStore* parts, int position, int quantity) {
+    Parts* part = partAt(parts, position);
+    int onHand = counterOf(&part->QuantityOnHand)->load(std::memory_order_acquire);
+
+    if (onHand < quantity) {
+        counterOf(&part->PartStatus)->store(-(quantity - onHand), std::memory_order_relaxed);
+    }
+    return onHand;
+}
+
+//
+// FUNCTION    : inventoryRestock
+// DESCRIPTION : Adds units to a part's quantity on hand (or removes them
+//               when a count comes up short) and updates its status. The
+//               units are added to whatever is on hand by then, so stock
+//               reserved in the meantime stays reserved.
+// PARAMETERS  :
+//      RecordStore* parts : Part store
+//      int position       : Part position
+//      int units          : Units to add, negative to remove
+// RETURNS     : int - Quantity on hand after the change
+//
+int inventoryRestock(RecordStore* parts, int position, int units) {
+    Parts* part = partAt(parts, position);
+    int onHand = counterOf(&part->QuantityOnHand)->fetch_add(units, std::memory_order_acq_rel) + units;
+    refreshStatus(part);
+    return onHand;
+}
@@ -0,0 +1,32 @@
+/*
+* FILE          : Inventory.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for inventory reservations including:
+*      - All-or-nothing reservation of an order's part lines
+*      - Commit and release of a reservation
+*      - Stock updates that are safe alongside reservations
+*      Quantities live in Parts::QuantityOnHand and are changed with atomic
+*      operations, so several threads may reserve, commit, release and
+*      restock at once without a lock and without taking more stock than
+*      there is.
+*/
+
+#ifndef INVENTORY_H
+#define INVENTORY_H
+
+#include "Part.h"
+
+// Function prototypes
+bool inventoryReserve(RecordStore* parts, const int* linePart, const int* lineQuantity,
+    int lines, int* failedLine);                                          // Take stock for every line or none
+void inventoryCommit(RecordStore* parts, const int* linePart, int lines); // Finalize a reservation
+void inventoryRelease(RecordStore* parts, const int* linePart, const int* lineQuantity,
+    int lines);                                                           // Return reserved stock
+int inventoryOnHand(RecordStore* parts, int position);                    // Current unreserved quantity
+int inventoryMarkShort(RecordStore* parts, int position, int quantity);   // Flag a part that cannot cover a line
+int inventoryRestock(RecordStore* parts, int position, int units);        // Add (or remove) units on hand
+
+#endif
@@ -0,0 +1,269 @@
+/*
+* FILE          : LogEvents.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of structured log events including:
+*      - Message format of every log event
+*      - Packing of printf-style arguments as raw values
+*      - Formatting of packed arguments back into message text
+*      Shared by the logger and the offline log decoder so both read the
+*      same catalog.
+*/
+
+#include "LogEvents.h"
+#include <stdio.h>
+#include <string.h>
+
+// Kind of value a format conversion takes
+typedef enum {
+    LOG_ARG_NONE,               // Not a supported conversion
+    LOG_ARG_INT,                // int (%d, %c ...)
+    LOG_ARG_LONG,               // long (%ld ...)
+    LOG_ARG_LONG_LONG,          // long long (%lld ...)
+    LOG_ARG_DOUBLE,             // double (%f ...), float arguments are promoted
+    LOG_ARG_STRING              // const char* (%s)
+} LogArgKind;
+
+#define LOG_SPEC_LENGTH 32      // Longest single conversion specification
+
+// Format of each event, indexed by LogEventId. These are the messages the
+// program logged before events existed, so text logs read the same.
+static const char* const eventFormats[LOG_EVENT_COUNT] = {
+    "%s",
+    "New order created: ID %lld, Customer %d, Total $%.2f",
+    "Order %lld status updated to %d",
+    "Order %lld: Credit limit exceeded (Customer %d: Balance $%.2f + Order $%.2f > Limit $%.2f)",
+    "Insufficient inventory - Part %d: Need %d, Have %d (Deficit %d)",
+    "Order %lld: Insufficient parts",
+    "Order %lld fulfilled - Customer %d, Total $%.2f",
+    "New part added: ID %d, Name %s",
+    "Part %d inventory updated to %d"
+};
+
+//
+// FUNCTION    : logEventFormat
+// DESCRIPTION : Looks up the message format of a log event
+// PARAMETERS  :
+//      int eventId : LogEventId to look up
+// RETURNS     : const char* - printf format, or NULL for an unknown event
+//
+const char* logEventFormat(int eventId) {
+    if (eventId < 0 || eventId >= LOG_EVENT_COUNT) return NULL;
+    return eventFormats[eventId];
+}
+
+//
+// FUNCTION    : nextConversion
+// DESCRIPTION : Finds the next conversion in a format string, skipping "%%"
+// PARAMETERS  :
+//      const char* format : Format text to search
+//      const char** end   : Set to just past the conversion character
+//      LogArgKind* kind   : Set to the kind of value the conversion takes
+// RETURNS     : const char* - The conversion's '%', or NULL if there are no more
+//
+static const char* nextConversion(const char* format, const char** end, LogArgKind* kind) {
+    for (;;) {
+        format = strchr(format, '%');
+        if (format == NULL) return NULL;
+        if (format[1] == '%') {
+            format += 2;
+            continue;
+        }
+
+        const char* p = format + 1;
+        p += strspn(p, "-+ #0123456789.");
+        int longs = 0;
+        while (*p == 'l') {
+            longs++;
+            p++;
+        }
+        while (*p == 'h') p++;
+        if (*p == '\0') return NULL;
+
+        switch (*p) {
+        case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+            *kind = longs == 0 ? LOG_ARG_INT : longs == 1 ? LOG_ARG_LONG : LOG_ARG_LONG_LONG;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            *kind = LOG_ARG_DOUBLE;
+            break;
+        case 's':
+            *kind = LOG_ARG_STRING;
+            break;
+        default:
+            *kind = LOG_ARG_NONE;
+            break;
+        }
+        *end = p + 1;
+        return format;
+    }
+}
+
+//
+// FUNCTION    : packLogArguments
+// DESCRIPTION : Copies the arguments of a log event into a payload without
+//               formatting them. Integers and doubles take 8 bytes each;
+//               strings take a 2-byte length and their characters, cut to
+//               what is left of the payload.
+// PARAMETERS  :
+//      int eventId             : LogEventId the arguments belong to
+//      va_list arguments       : Arguments, as they would be passed to printf
+//      unsigned char* payload  : Buffer of LOG_PAYLOAD_BYTES
+// RETURNS     : int - Bytes of payload used
+//
+int packLogArguments(int eventId, va_list arguments, unsigned char* payload) {
+    const char* format = logEventFormat(eventId);
+    if (format == NULL) return 0;
+
+    int length = 0;
+    const char* end;
+    LogArgKind kind;
+
+    while ((format = nextConversion(format, &end, &kind)) != NULL) {
+        format = end;
+        if (kind == LOG_ARG_NONE) continue;
+
+        if (kind == LOG_ARG_STRING) {
+            const char* text = va_arg(arguments, const char*);
+            if (text == NULL) text = "(null)";
+            if (length + 2 > LOG_PAYLOAD_BYTES) break;
+            size_t room = (size_t)(LOG_PAYLOAD_BYTES - length - 2);
+            size_t textLength = strlen(text);
+            if (textLength > room) textLength = room;
+
+            unsigned short stored = (unsigned short)textLength;
+            memcpy(payload + length, &stored, sizeof(stored));
+            memcpy(payload + length + 2, text, textLength);
+            length += 2 + (int)textLength;
+            continue;
+        }
+
+        if (length + 8 > LOG_PAYLOAD_BYTES) break;
+        if (kind == LOG_ARG_DOUBLE) {
+            double value = va_arg(arguments, double);
+            memcpy(payload + length, &value, sizeof(value));
+        }
+        else {
+            long long value;
+            if (kind == LOG_ARG_INT) value = va_arg(arguments, int);
+            else if (kind == LOG_ARG_LONG) value = va_arg(arguments, long);
+            else value = va_arg(arguments, long long);
+            memcpy(payload + length, &value, sizeof(value));
+        }
+        length += 8;
+    }
+
+    return length;
+}
+
+//
+// FUNCTION    : appendLiteral
+// DESCRIPTION : Copies format text that has no conversions, turning "%%"
+//               into '%'
+// PARAMETERS  :
+//      const char* start : First character to copy
+//      const char* end   : One past the last character
+//      char* text        : Output buffer
+//      size_t textSize   : Size of the output buffer
+//      size_t* used      : Characters already in the output, advanced
+// RETURNS     : void
+//
+static void appendLiteral(const char* start, const char* end, char* text, size_t textSize, size_t* used) {
+    while (start < end && *used + 1 < textSize) {
+        text[(*used)++] = *start;
+        start += (start[0] == '%' && start + 1 < end && start[1] == '%') ? 2 : 1;
+    }
+    text[*used] = '\0';
+}
+
+//
+// FUNCTION    : formatLogEvent
+// DESCRIPTION : Formats a packed log event exactly as printf would have
+//               formatted the original arguments. Each conversion is
+//               printed on its own, as written, with its stored value
+//               narrowed back to the type the conversion takes.
+// PARAMETERS  :
+//      int eventId                  : LogEventId of the event
+//      const unsigned char* payload : Arguments packed by packLogArguments
+//      int payloadLength            : Bytes of payload
+//      char* text                   : Buffer for the message
+//      size_t textSize              : Size of the buffer (cut to fit)
+// RETURNS     : bool - false if the event is unknown or the payload does
+//               not match its format
+//
+bool formatLogEvent(int eventId, const unsigned char* payload, int payloadLength,
+    char* text, size_t textSize) {
+    const char* format = logEventFormat(eventId);
+    if (format == NULL || textSize == 0) return false;
+
+    size_t used = 0;
+    int offset = 0;
+    const char* conversion;
+    const char* end;
+    LogArgKind kind;
+
+    text[0] = '\0';
+    while ((conversion = nextConversion(format, &end, &kind)) != NULL) {
+        appendLiteral(format, conversion, text, textSize, &used);
+        format = end;
+        if (kind == LOG_ARG_NONE) continue;
+
+        // Print the conversion as written, with the value cast back to the
+        // width and signedness its length modifier and letter give it
+        char spec[LOG_SPEC_LENGTH];
+        size_t specLength = (size_t)(end - conversion);
+        if (specLength >= sizeof(spec)) return false;
+        memcpy(spec, conversion, specLength);
+        spec[specLength] = '\0';
+        bool isUnsigned = strchr("uxXo", end[-1]) != NULL;
+
+        int written;
+        if (kind == LOG_ARG_STRING) {
+            unsigned short stored;
+            if (offset + 2 > payloadLength) return false;
+            memcpy(&stored, payload + offset, sizeof(stored));
+            if (offset + 2 + stored > payloadLength) return false;
+
+            char value[LOG_PAYLOAD_BYTES + 1];
+            memcpy(value, payload + offset + 2, stored);
+            value[stored] = '\0';
+            written = snprintf(text + used, textSize - used, spec, value);
+            offset += 2 + stored;
+        }
+        else {
+            if (offset + 8 > payloadLength) return false;
+            if (kind == LOG_ARG_DOUBLE) {
+                double value;
+                memcpy(&value, payload + offset, sizeof(value));
+                written = snprintf(text + used, textSize - used, spec, value);
+            }
+            else {
+                long long value;
+                memcpy(&value, payload + offset, sizeof(value));
+                if (kind == LOG_ARG_INT) {
+                    if (isUnsigned) written = snprintf(text + used, textSize - used, spec, (unsigned int)value);
+                    else written = snprintf(text + used, textSize - used, spec, (int)value);
+                }
+                else if (kind == LOG_ARG_LONG) {
+                    if (isUnsigned) written = snprintf(text + used, textSize - used, spec, (unsigned long)value);
+                    else written = snprintf(text + used, textSize - used, spec, (long)value);
+                }
+                else if (isUnsigned) {
+                    written = snprintf(text + used, textSize - used, spec, (unsigned long long)value);
+                }
+                else {
+                    written = snprintf(text + used, textSize - used, spec, value);
+                }
+            }
+            offset += 8;
+        }
+
+        if (written > 0) used += (size_t)written;
+        if (used >= textSize) return true;
+    }
+
+    appendLiteral(format, format + strlen(format), text, textSize, &used);
+    return offset == payloadLength;
+}
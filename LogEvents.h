@@ -0,0 +1,60 @@
+/*
+* FILE          : LogEvents.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for structured log events including:
+*      - Catalog of log event IDs and their message formats
+*      - Binary log file layout
+*      - Packing of raw arguments and deferred formatting
+*/
+
+#ifndef LOGEVENTS_H
+#define LOGEVENTS_H
+
+#include <stdarg.h>
+#include <stddef.h>
+
+#define LOG_BINARY_MAGIC "PWHBLOG"      // First 8 bytes of a binary log (with terminator)
+#define LOG_CATALOG_VERSION 2           // Bumped whenever an event's format changes
+#define LOG_PAYLOAD_BYTES 232           // Largest packed argument list
+#define LOG_TEXT_LENGTH 512             // Longest formatted message
+
+// Log events. Each ID is written to binary logs, so existing values must
+// never be renumbered; add new events at the end.
+typedef enum {
+    LOG_EVENT_TEXT = 0,                 // Preformatted message
+    LOG_ORDER_CREATED = 1,
+    LOG_ORDER_STATUS_UPDATED = 2,
+    LOG_ORDER_CREDIT_EXCEEDED = 3,
+    LOG_PART_SHORTAGE = 4,
+    LOG_ORDER_PARTS_SHORT = 5,
+    LOG_ORDER_FULFILLED = 6,
+    LOG_PART_ADDED = 7,
+    LOG_PART_INVENTORY_UPDATED = 8,
+    LOG_EVENT_COUNT
+} LogEventId;
+
+// Binary log file header, followed by LogRecordHeader + payload records
+typedef struct {
+    char magic[8];                      // LOG_BINARY_MAGIC
+    unsigned int catalogVersion;        // LOG_CATALOG_VERSION of the writer
+    unsigned int reserved;              // Zero
+} LogFileHeader;
+
+// Header of one binary log record
+typedef struct {
+    long long time;                     // time_t when the event was logged
+    unsigned short eventId;             // LogEventId
+    unsigned short payloadLength;       // Bytes of packed arguments that follow
+    unsigned int reserved;              // Zero
+} LogRecordHeader;
+
+// Function prototypes
+const char* logEventFormat(int eventId);                                   // printf format of an event, NULL if unknown
+int packLogArguments(int eventId, va_list arguments, unsigned char* payload); // Store raw arguments, returns bytes used
+bool formatLogEvent(int eventId, const unsigned char* payload, int payloadLength,
+    char* text, size_t textSize);                                           // Format packed arguments as text
+
+#endif
@@ -0,0 +1,470 @@
+/*
+* FILE          : Logger.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of the asynchronous system logger including:
+*      - Bounded lock-free ring buffer (sequence-numbered slots)
+*      - Writer thread that formats and writes messages in batches
+*      - Cached timestamp formatting (one ctime_s call per second)
+*      - Binary output of event IDs and raw arguments
+*      - Synchronous fallback before start-up and after shutdown
+*/
+
+#include "Logger.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define LOG_RING_MASK (LOG_RING_SLOTS - 1)
+#define LOG_TIMESTAMP_LENGTH 26     // ctime_s output, including newline and terminator
+
+#define LOG_RECORD_BYTES (sizeof(LogRecordHeader) + LOG_PAYLOAD_BYTES)
+
+// One ring slot. The sequence number says whose turn the slot is: equal to
+// a ring position, it is free for the producer claiming that position; one
+// past it, it holds that position's event for the writer. Events carry
+// their raw arguments; formatting is left to the writer or the decoder.
+typedef struct {
+    std::atomic<unsigned long long> sequence;
+    time_t time;                    // When the event was posted
+    unsigned short eventId;         // LogEventId
+    unsigned short payloadLength;   // Bytes of payload used
+    unsigned char payload[LOG_PAYLOAD_BYTES]; // Packed arguments
+} LogSlot;
+
+LogFullPolicy logFullPolicy = LOG_FULL_WAIT;
+LogOutput logOutput = LOG_DEFAULT_OUTPUT;
+
+static LogSlot ring[LOG_RING_SLOTS];
+static std::atomic<unsigned long long> enqueuePosition(0);  // Next position producers claim
+static std::atomic<unsigned long long> writtenPosition(0);  // Positions below this are in the file
+static std::atomic<unsigned long long> droppedMessages(0);  // Messages lost to a full ring
+static std::atomic<bool> writerRunning(false);              // Writer thread is accepting messages
+static std::atomic<bool> writerStopping(false);             // Shutdown requested
+static std::atomic<bool> writerIdle(false);                 // Writer is (about to be) asleep
+static std::once_flag startFlag;
+static std::mutex wakeMutex;
+static std::condition_variable wakeWriter;
+static std::thread writerThread;
+
+// Writer thread state (touched only by the writer)
+static FILE* logFile = NULL;
+static LogOutput writerOutput = LOG_DEFAULT_OUTPUT;
+static char batch[LOG_BATCH_BYTES];
+static size_t batchLength = 0;
+static time_t cachedTime = (time_t)-1;
+static char cachedStamp[LOG_TIMESTAMP_LENGTH];
+
+//
+// FUNCTION    : formatTimestamp
+// DESCRIPTION : Returns the ctime text for a time without its newline.
+//               Messages posted in the same second share one conversion.
+// PARAMETERS  :
+//      time_t when : Time to format
+// RETURNS     : const char* - Cached timestamp text
+//
+static const char* formatTimestamp(time_t when) {
+    if (when != cachedTime) {
+        ctime_s(cachedStamp, sizeof(cachedStamp), &when);
+        cachedStamp[strcspn(cachedStamp, "\n")] = '\0';
+        cachedTime = when;
+    }
+    return cachedStamp;
+}
+
+//
+// FUNCTION    : packEvent
+// DESCRIPTION : Packs the arguments of a log event given directly
+// PARAMETERS  :
+//      unsigned char* payload : Buffer of LOG_PAYLOAD_BYTES
+//      int eventId            : LogEventId
+//      ...                    : Arguments of the event's format
+// RETURNS     : int - Bytes of payload used
+//
+static int packEvent(unsigned char* payload, int eventId, ...) {
+    va_list arguments;
+    va_start(arguments, eventId);
+    int length = packLogArguments(eventId, arguments, payload);
+    va_end(arguments);
+    return length;
+}
+
+//
+// FUNCTION    : openBinaryLog
+// DESCRIPTION : Opens the binary log for appending, writing its header when
+//               the file is new. A file written with another event catalog
+//               is moved aside to LOG_BINARY_FILE ".old" so its records are
+//               never decoded with the wrong formats.
+// PARAMETERS  : None
+// RETURNS     : FILE* - Open file, or NULL on error
+//
+static FILE* openBinaryLog() {
+    FILE* file = NULL;
+    LogFileHeader header;
+
+    if (fopen_s(&file, LOG_BINARY_FILE, "rb") == 0 && file != NULL) {
+        bool usable = fread(&header, sizeof(header), 1, file) == 1 &&
+            memcmp(header.magic, LOG_BINARY_MAGIC, sizeof(header.magic)) == 0 &&
+            header.catalogVersion == LOG_CATALOG_VERSION;
+        bool empty = !usable && fseek(file, 0, SEEK_END) == 0 && ftell(file) == 0;
+        fclose(file);
+        if (!usable && !empty) {
+            remove(LOG_BINARY_FILE ".old");
+            rename(LOG_BINARY_FILE, LOG_BINARY_FILE ".old");
+        }
+    }
+
+    if (fopen_s(&file, LOG_BINARY_FILE, "ab") != 0 || file == NULL) return NULL;
+    if (fseek(file, 0, SEEK_END) == 0 && ftell(file) == 0) {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, LOG_BINARY_MAGIC, sizeof(header.magic));
+        header.catalogVersion = LOG_CATALOG_VERSION;
+        fwrite(&header, sizeof(header), 1, file);
+    }
+    return file;
+}
+
+//
+// FUNCTION    : openLog
+// DESCRIPTION : Opens the log file for the chosen output format
+// PARAMETERS  :
+//      LogOutput output : Output format
+// RETURNS     : FILE* - Open file, or NULL on error
+//
+static FILE* openLog(LogOutput output) {
+    if (output == LOG_OUTPUT_BINARY) return openBinaryLog();
+
+    FILE* file = NULL;
+    errno_t err = fopen_s(&file, LOG_FILE, "a");
+    return err == 0 ? file : NULL;
+}
+
+//
+// FUNCTION    : flushBatch
+// DESCRIPTION : Writes the gathered output to the log file in one call.
+//               The file is opened on first use and kept open; output is
+//               discarded if it cannot be opened, as before.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+static void flushBatch() {
+    if (batchLength == 0) return;
+
+    if (logFile == NULL) logFile = openLog(writerOutput);
+    if (logFile != NULL) {
+        fwrite(batch, 1, batchLength, logFile);
+        fflush(logFile);
+    }
+    batchLength = 0;
+}
+
+//
+// FUNCTION    : appendLine
+// DESCRIPTION : Adds one "[timestamp] message" line to the batch, writing
+//               the batch out first if the line would not fit
+// PARAMETERS  :
+//      time_t when      : Time the message was posted
+//      const char* text : Message text
+// RETURNS     : void
+//
+static void appendLine(time_t when, const char* text) {
+    if (LOG_BATCH_BYTES - batchLength < LOG_TIMESTAMP_LENGTH + LOG_TEXT_LENGTH + 4) {
+        flushBatch();
+    }
+
+    int length = snprintf(batch + batchLength, LOG_BATCH_BYTES - batchLength, "[%s] %s\n",
+        formatTimestamp(when), text);
+    if (length > 0) batchLength += (size_t)length;
+}
+
+//
+// FUNCTION    : appendEvent
+// DESCRIPTION : Adds one event to the batch: formatted as a text line, or
+//               as a binary record holding its ID and packed arguments
+// PARAMETERS  :
+//      time_t when                  : Time the event was posted
+//      int eventId                  : LogEventId
+//      const unsigned char* payload : Packed arguments
+//      int payloadLength            : Bytes of payload
+// RETURNS     : void
+//
+static void appendEvent(time_t when, int eventId, const unsigned char* payload, int payloadLength) {
+    if (writerOutput == LOG_OUTPUT_TEXT) {
+        char text[LOG_TEXT_LENGTH];
+        formatLogEvent(eventId, payload, payloadLength, text, sizeof(text));
+        appendLine(when, text);
+        return;
+    }
+
+    if (LOG_BATCH_BYTES - batchLength < LOG_RECORD_BYTES) flushBatch();
+
+    LogRecordHeader record;
+    memset(&record, 0, sizeof(record));
+    record.time = (long long)when;
+    record.eventId = (unsigned short)eventId;
+    record.payloadLength = (unsigned short)payloadLength;
+    memcpy(batch + batchLength, &record, sizeof(record));
+    memcpy(batch + batchLength + sizeof(record), payload, (size_t)payloadLength);
+    batchLength += sizeof(record) + (size_t)payloadLength;
+}
+
+//
+// FUNCTION    : drainRing
+// DESCRIPTION : Moves every published event from the ring into the log
+//               file, then records how many messages were dropped
+// PARAMETERS  :
+//      unsigned long long* position : Writer's ring position, advanced
+// RETURNS     : bool - true if anything was written
+//
+static bool drainRing(unsigned long long* position) {
+    bool wrote = false;
+
+    for (;;) {
+        LogSlot* slot = &ring[*position & LOG_RING_MASK];
+        if (slot->sequence.load(std::memory_order_acquire) != *position + 1) break;
+
+        appendEvent(slot->time, slot->eventId, slot->payload, slot->payloadLength);
+        slot->sequence.store(*position + LOG_RING_SLOTS, std::memory_order_release);
+        (*position)++;
+        wrote = true;
+    }
+
+    unsigned long long dropped = droppedMessages.exchange(0);
+    if (dropped > 0) {
+        char notice[LOG_TEXT_LENGTH];
+        unsigned char payload[LOG_PAYLOAD_BYTES];
+        snprintf(notice, sizeof(notice), "%llu log messages dropped (log buffer full)", dropped);
+        appendEvent(time(NULL), LOG_EVENT_TEXT, payload, packEvent(payload, LOG_EVENT_TEXT, notice));
+        wrote = true;
+    }
+
+    flushBatch();
+    writtenPosition.store(*position, std::memory_order_release);
+    return wrote;
+}
+
+//
+// FUNCTION    : writerLoop
+// DESCRIPTION : Writer thread body. Drains the ring until shutdown, sleeping
+//               while there is nothing to write. At shutdown it waits for
+//               every claimed position to be published before it stops.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+static void writerLoop() {
+    unsigned long long position = 0;
+
+    for (;;) {
+        if (drainRing(&position)) continue;
+        if (writerStopping.load()) break;
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writerIdle.store(true);
+        LogSlot* next = &ring[position & LOG_RING_MASK];
+        wakeWriter.wait_for(lock, std::chrono::milliseconds(LOG_IDLE_WAIT_MS), [&] {
+            return writerStopping.load() ||
+                next->sequence.load(std::memory_order_acquire) == position + 1;
+        });
+        writerIdle.store(false);
+    }
+
+    // A producer may have claimed a position and not yet published it;
+    // wait for every claimed message so none is lost at exit
+    drainRing(&position);
+    while (position < enqueuePosition.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+        drainRing(&position);
+    }
+    if (logFile != NULL) {
+        fclose(logFile);
+        logFile = NULL;
+    }
+}
+
+//
+// FUNCTION    : wake
+// DESCRIPTION : Wakes the writer if it is sleeping
+// PARAMETERS  : None
+// RETURNS     : void
+//
+static void wake() {
+    if (writerIdle.load()) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeWriter.notify_one();
+    }
+}
+
+//
+// FUNCTION    : startWriter
+// DESCRIPTION : Prepares the ring and starts the writer thread on first
+//               use. Registers loggerShutdown to run at exit so queued
+//               messages are always written.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+static void startWriter() {
+    writerOutput = logOutput;
+    for (unsigned long long i = 0; i < LOG_RING_SLOTS; i++) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    try {
+        writerThread = std::thread(writerLoop);
+    }
+    catch (...) {
+        return;
+    }
+
+    writerRunning.store(true);
+    atexit(loggerShutdown);
+}
+
+//
+// FUNCTION    : writeDirect
+// DESCRIPTION : Appends one event straight to the log file. Used when the
+//               writer thread is not running (it could not be started or
+//               has been shut down).
+// PARAMETERS  :
+//      int eventId       : LogEventId
+//      va_list arguments : Arguments of the event's format
+// RETURNS     : void
+//
+static void writeDirect(int eventId, va_list arguments) {
+    static std::mutex directMutex;
+    std::lock_guard<std::mutex> lock(directMutex);
+
+    unsigned char payload[LOG_PAYLOAD_BYTES];
+    int payloadLength = packLogArguments(eventId, arguments, payload);
+    time_t now;
+    time(&now);
+
+    FILE* file = openLog(writerOutput);
+    if (file == NULL) return;
+
+    if (writerOutput == LOG_OUTPUT_BINARY) {
+        LogRecordHeader record;
+        memset(&record, 0, sizeof(record));
+        record.time = (long long)now;
+        record.eventId = (unsigned short)eventId;
+        record.payloadLength = (unsigned short)payloadLength;
+        fwrite(&record, sizeof(record), 1, file);
+        fwrite(payload, 1, (size_t)payloadLength, file);
+    }
+    else {
+        char timestamp[LOG_TIMESTAMP_LENGTH];
+        char text[LOG_TEXT_LENGTH];
+        ctime_s(timestamp, sizeof(timestamp), &now);
+        timestamp[strcspn(timestamp, "\n")] = '\0';
+        formatLogEvent(eventId, payload, payloadLength, text, sizeof(text));
+
+        fprintf(file, "[%s] %s\n", timestamp, text);
+    }
+    fclose(file);
+}
+
+//
+// FUNCTION    : loggerPost
+// DESCRIPTION : Queues an event for the writer thread. Producers claim a
+//               ring position with one compare-and-swap and never take a
+//               lock, then copy the raw arguments into the slot; nothing is
+//               formatted on the caller's thread. When the ring is full the
+//               event is dropped or the caller yields, depending on
+//               logFullPolicy.
+// PARAMETERS  :
+//      int eventId       : LogEventId
+//      va_list arguments : Arguments of the event's format (strings are
+//                          cut to fit LOG_PAYLOAD_BYTES)
+// RETURNS     : void
+//
+void loggerPost(int eventId, va_list arguments) {
+    std::call_once(startFlag, startWriter);
+    if (!writerRunning.load()) {
+        writeDirect(eventId, arguments);
+        return;
+    }
+
+    unsigned long long position = enqueuePosition.load(std::memory_order_relaxed);
+    LogSlot* slot;
+
+    for (;;) {
+        slot = &ring[position & LOG_RING_MASK];
+        unsigned long long sequence = slot->sequence.load(std::memory_order_acquire);
+        long long distance = (long long)(sequence - position);
+
+        if (distance == 0) {
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        }
+        else if (distance < 0) {
+            if (!writerRunning.load()) {
+                writeDirect(eventId, arguments);
+                return;
+            }
+            if (logFullPolicy == LOG_FULL_DROP) {
+                droppedMessages.fetch_add(1);
+                wake();
+                return;
+            }
+            wake();
+            std::this_thread::yield();
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+        else {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->time = time(NULL);
+    slot->eventId = (unsigned short)eventId;
+    slot->payloadLength = (unsigned short)packLogArguments(eventId, arguments, slot->payload);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    wake();
+}
+
+//
+// FUNCTION    : loggerFlush
+// DESCRIPTION : Waits until every message queued before the call has been
+//               written to the log file
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void loggerFlush() {
+    if (!writerRunning.load()) return;
+
+    unsigned long long target = enqueuePosition.load();
+    while (writtenPosition.load(std::memory_order_acquire) < target && writerRunning.load()) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            wakeWriter.notify_one();
+        }
+        std::this_thread::yield();
+    }
+}
+
+//
+// FUNCTION    : loggerShutdown
+// DESCRIPTION : Writes every queued message, including those still being
+//               copied in by their producers, and stops the writer thread.
+//               Safe to call more than once; later messages are written
+//               synchronously.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void loggerShutdown() {
+    if (!writerRunning.exchange(false)) return;
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        writerStopping.store(true);
+        wakeWriter.notify_one();
+    }
+    writerThread.join();
+}
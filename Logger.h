@@ -0,0 +1,52 @@
+/*
+* FILE          : Logger.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for the asynchronous system logger including:
+*      - Lock-free multi-producer ring buffer of log messages
+*      - Background writer thread with batched file output
+*      - Full-buffer policy selection and shutdown flush
+*      - Text or binary (deferred formatting) log output
+*/
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include "LogEvents.h"
+
+#define LOG_FILE "system.log"       // Text log the writer appends to
+#define LOG_BINARY_FILE "system.binlog" // Binary log, read with LogDecode
+#define LOG_RING_SLOTS 4096         // Messages the ring holds (power of two)
+#define LOG_BATCH_BYTES (64 << 10)  // Output gathered before each fwrite
+#define LOG_IDLE_WAIT_MS 50         // Longest the writer sleeps between checks
+
+// What a caller does when the ring is full
+typedef enum {
+    LOG_FULL_DROP,              // Discard the message; the writer logs how many were lost
+    LOG_FULL_WAIT               // Yield until the writer frees a slot
+} LogFullPolicy;
+
+// How the writer stores events
+typedef enum {
+    LOG_OUTPUT_TEXT,            // Formatted "[timestamp] message" lines in LOG_FILE
+    LOG_OUTPUT_BINARY           // Event IDs and raw arguments in LOG_BINARY_FILE
+} LogOutput;
+
+// Build with LOG_BINARY_OUTPUT defined to log in binary by default
+#ifdef LOG_BINARY_OUTPUT
+#define LOG_DEFAULT_OUTPUT LOG_OUTPUT_BINARY
+#else
+#define LOG_DEFAULT_OUTPUT LOG_OUTPUT_TEXT
+#endif
+
+extern LogFullPolicy logFullPolicy; // Policy used by loggerPost (default LOG_FULL_WAIT)
+extern LogOutput logOutput;         // Output format, read when the first event is logged
+
+// Function prototypes
+void loggerPost(int eventId, va_list arguments); // Queue an event for the writer thread
+void loggerFlush();                    // Wait until every queued message is written
+void loggerShutdown();                 // Write everything queued and stop the writer
+
+#endif
@@ -7,8 +7,11 @@
 *      Main program entry point with:
 *      - System initialization
 *      - Main program loop
-*      - Data loading/saving
+*      - Data loading/saving (binary snapshots, text import/export,
+*        write-ahead log of changes between saves, background
+*        checkpoints)
 *      - Menu navigation
+*      - Headless command mode when options are given (see Command.h)
 */
 
 #include <stdio.h>
@@ -18,31 +21,54 @@
 #include "Part.h"
 #include "Order.h"
 #include "System.h"
+#include "Logger.h"
+#include "Command.h"
+#include "TaskPool.h"
+#include "Wal.h"
+#include "Checkpoint.h"
+#include "Warmup.h"
 
 //
 // FUNCTION    : main
-// DESCRIPTION : Program entry point, manages main system loop
-// PARAMETERS  : void
+// DESCRIPTION : Program entry point, manages main system loop. With
+//               command-line options the commands are run instead of the
+//               menus (-u and -l alone only change how data is loaded).
+// PARAMETERS  :
+//      int argc     : Argument count
+//      char* argv[] : Headless options (-c, -f, -t, -u, -l)
 // RETURNS     : int - Program exit status
 //
-int main(void) {
+int main(int argc, char* argv[]) {
     // Initialize data structures
-    Customer customers[MAX_CUSTOMERS];
-    Parts parts[MAXPARTSIZE];
-    Order orders[MAX_ORDERS];
+    RecordStore customers, parts, orders;
+    storeInit(&customers, sizeof(Customer));
+    storeInit(&parts, sizeof(Parts));
+    storeInit(&orders, sizeof(Order));
 
-    // Load initial data
-    int customerCount = loadCustomers(customers, MAX_CUSTOMERS);
-    int partsCount = 0;
-    loadfromfile("parts.db", parts, &partsCount);
-    int orderCount = 0;
-    loadOrderFromFile(orders, &orderCount);
+    // Load initial data from the binary snapshots, importing the text
+    // databases for any store whose snapshot is missing or out of date
+    bool headless = applyStartupOptions(argc, argv);
+    loadAllData(&customers, &parts, &orders);
+
+    if (headless) {
+        int status = runHeadless(argc, argv, &customers, &parts, &orders);
+        warmupStop();
+        checkpointStop();
+        walClose();
+        taskPoolStop();
+        loggerShutdown();
+        storeFree(&orders);
+        storeFree(&parts);
+        storeFree(&customers);
+        return status;
+    }
 
     int choice;
     char buffer[100];
 
     // Main program loop
     do {
+        repairIndexes(&customers, &parts, &orders);
         mainMenu();
 
         if (!fgets(buffer, sizeof(buffer), stdin)) continue;
@@ -53,14 +79,14 @@ int main(void) {
 
         // Handle menu selection
         switch (choice) {
-        case 1: handlePartsMenu(parts, &partsCount); break;
-        case 2: customersMenu(customers, &customerCount); break;
-        case 3: handleOrdersMenu(orders, &orderCount, customers, customerCount, parts, partsCount); break;
+        case 1: handlePartsMenu(&parts, &orders, &customers); break;
+        case 2: customersMenu(&customers); break;
+        case 3: handleOrdersMenu(&orders, &customers, &parts); break;
         case 4:
+            // Text databases are only rewritten if a snapshot cannot be
+            // saved; they are exported from the submenus
             printf("\nSaving data...\n");
-            saveCustomers(customers, customerCount);
-            SaveToFile("parts.db", parts, &partsCount);
-            saveOrderToFile(orders, orderCount);
+            saveAllData(&customers, &parts, &orders);
             printf("Data saved. Goodbye!\n");
             break;
         default:
@@ -68,5 +94,13 @@ int main(void) {
         }
     } while (choice != 4);
 
+    warmupStop();
+    checkpointStop();
+    walClose();
+    taskPoolStop();
+    loggerShutdown();
+    storeFree(&orders);
+    storeFree(&parts);
+    storeFree(&customers);
     return 0;
 }
\ No newline at end of file
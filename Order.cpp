@@ -12,13 +12,41 @@
 */
 
 #include "Order.h"
+#include "OrderId.h"
 #include "System.h"
+#include "IdIndex.h"
+#include "OrderQueue.h"
+#include "Fulfillment.h"
+#include "Inventory.h"
+#include "Backorder.h"
+#include "Ingest.h"
+#include "DbReader.h"
+#include "Snapshot.h"
+#include "TaskPool.h"
+#include "Wal.h"
+#include "Checkpoint.h"
+#include "Warmup.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include <limits.h>
+#include <math.h>
+
+RecordStore orderLines = { NULL, 0, 0, sizeof(OrderItem), 0, NULL, NULL, 0, NULL, 0 };
+
+static IdIndex orderIndex;      // Order ID -> position in the order store
+static OrderQueue placedQueue;  // STATUS_PLACED orders in end-of-day order
+static BackorderIndex backorders;   // STATUS_INSUFFICIENT_PARTS orders by the part they wait on
+
+// Priority keys of the placed orders, computed on the task pool
+typedef struct {
+    RecordStore* orders;
+    RecordStore* customers;
+    long long* keys;            // One per order (set for placed orders only)
+} OrderKeyJob;
 
 //
 // FUNCTION    : getCurrentDate
@@ -35,49 +63,374 @@ void getCurrentDate(char* dateStr) {
 }
 
 //
-// FUNCTION    : generateOrderID
-// DESCRIPTION : Generates unique order ID based on date and sequence
-// PARAMETERS  : None
-// RETURNS     : long - Generated order ID
+// FUNCTION    : indexOrders
+// DESCRIPTION : Rebuilds the order ID index from the order store and
+//               keeps new order IDs clear of the indexed ones
+// PARAMETERS  :
+//      RecordStore* orders : Order store
+// RETURNS     : void
+//
+void indexOrders(RecordStore* orders) {
+    idIndexReset(&orderIndex, orders, orders->count);
+    for (int i = 0; i < orders->count; i++) {
+        long long orderID = orderAt(orders, i)->OrderID;
+        idIndexInsert(&orderIndex, orderID, i);
+        orderIdObserve(orderID);
+    }
+    orderIndex.indexedRecords = orders->count;
+}
+
+//
+// FUNCTION    : repairOrderIndex
+// DESCRIPTION : Rebuilds the order ID index if the warm-up thread found
+//               the mapped orders.idx damaged. Service threads call it
+//               only while holding the order store exclusively.
+// PARAMETERS  :
+//      RecordStore* orders : Order store
+// RETURNS     : void
 //
-long generateOrderID() {
-    char currentDate[LENGTH_OF_DATE];
-    getCurrentDate(currentDate);
-    static int dailySequence = 0;
-    static char lastDate[LENGTH_OF_DATE] = "";
+void repairOrderIndex(RecordStore* orders) {
+    if (warmupRebuildNeeded(ORDER_INDEX_FILE)) indexOrders(orders);
+}
 
-    if (strcmp(currentDate, lastDate) != 0) {
-        dailySequence = 0;
-        strcpy_s(lastDate, sizeof(lastDate), currentDate);
+//
+// FUNCTION    : syncOrderIndex
+// DESCRIPTION : Brings the order ID index up to date with the store. Orders
+//               appended since the last call are inserted; a different store
+//               or a shrunken count triggers a full rebuild.
+// PARAMETERS  :
+//      RecordStore* orders : Order store
+// RETURNS     : void
+//
+static void syncOrderIndex(RecordStore* orders) {
+    if (orderIndex.base != orders || orderIndex.indexedRecords > orders->count) {
+        indexOrders(orders);
+        return;
     }
+    while (orderIndex.indexedRecords < orders->count) {
+        int i = orderIndex.indexedRecords++;
+        idIndexInsert(&orderIndex, orderAt(orders, i)->OrderID, i);
+    }
+}
 
-    dailySequence++;
+//
+// FUNCTION    : findOrder
+// DESCRIPTION : Finds an order by ID through the order ID index. A
+//               position outside the store or holding another ID means
+//               the index does not match the store; it is then rebuilt.
+// PARAMETERS  :
+//      RecordStore* orders : Order store
+//      long long orderID   : Order ID to find
+// RETURNS     : int - Store position of the order, -1 if not found
+//
+int findOrder(RecordStore* orders, long long orderID) {
+    syncOrderIndex(orders);
+    int position = idIndexFind(&orderIndex, orderID);
+    if (position == -1) return -1;
+    if (position >= 0 && position < orders->count && orderAt(orders, position)->OrderID == orderID) {
+        return position;
+    }
+
+    indexOrders(orders);
+    return idIndexFind(&orderIndex, orderID);
+}
+
+//
+// FUNCTION    : packDateKey
+// DESCRIPTION : Packs a YYYY-MM-DD date string into an integer that sorts
+//               the same way as the string (YYYYMMDD). Well-formed dates are
+//               converted directly; anything else goes through sscanf_s.
+// PARAMETERS  :
+//      const char* date : Date string to pack
+// RETURNS     : int - Packed date, INT_MAX if the date cannot be read
+//
+static int packDateKey(const char* date) {
+    if (validateDate(std::string_view(date, strnlen(date, LENGTH_OF_DATE)))) {
+        return ((date[0] - '0') * 1000 + (date[1] - '0') * 100 + (date[2] - '0') * 10 + (date[3] - '0')) * 10000 +
+            ((date[5] - '0') * 10 + (date[6] - '0')) * 100 + (date[8] - '0') * 10 + (date[9] - '0');
+    }
 
     int year, month, day;
-    sscanf_s(currentDate, "%d-%d-%d", &year, &month, &day);
+    if (sscanf_s(date, "%d-%d-%d", &year, &month, &day) != 3) return INT_MAX;
+    return year * 10000 + month * 100 + day;
+}
+
+//
+// FUNCTION    : orderPriorityKey
+// DESCRIPTION : Computes an order's end-of-day priority under the policy
+//               selected by ORDER_PRIORITY. Lower keys are fulfilled first;
+//               equal keys go in store order.
+// PARAMETERS  :
+//      const Order* order     : Order to rank
+//      RecordStore* customers : Customer store
+// RETURNS     : long long - Priority key
+//
+static long long orderPriorityKey(const Order* order, RecordStore* customers) {
+#if ORDER_PRIORITY == ORDER_PRIORITY_JOIN_DATE
+    // Orders for unknown customers are skipped during processing
+    int c = findCustomer(customers, order->CustomerID);
+    return c != -1 ? packDateKey(customerAt(customers, c)->joinDate) : INT_MAX;
+#elif ORDER_PRIORITY == ORDER_PRIORITY_VALUE
+    (void)customers;
+    return -llround((double)order->OrderTotal * 100.0);
+#else
+    (void)order;
+    (void)customers;
+    return 0;
+#endif
+}
+
+//
+// FUNCTION    : orderKeyVersion
+// DESCRIPTION : Returns the version of the data priority keys are computed
+//               from. Only the join-date policy reads customer records.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+// RETURNS     : unsigned int - Current version
+//
+static unsigned int orderKeyVersion(RecordStore* customers) {
+#if ORDER_PRIORITY == ORDER_PRIORITY_JOIN_DATE
+    return customerStoreVersion(customers);
+#else
+    (void)customers;
+    return 0;
+#endif
+}
+
+//
+// FUNCTION    : computeOrderKeys
+// DESCRIPTION : Computes the priority keys of the placed orders of one
+//               piece of the order store
+// PARAMETERS  :
+//      void* arg : OrderKeyJob
+//      int first : First order of the piece
+//      int last  : One past the last order
+// RETURNS     : void
+//
+static void computeOrderKeys(void* arg, int first, int last) {
+    OrderKeyJob* job = (OrderKeyJob*)arg;
+    for (int i = first; i < last; i++) {
+        const Order* order = orderAt(job->orders, i);
+        if (order->OrderStatus == STATUS_PLACED) job->keys[i] = orderPriorityKey(order, job->customers);
+    }
+}
+
+//
+// FUNCTION    : queuePlacedOrders
+// DESCRIPTION : Rebuilds the placed-order queue from the whole order store.
+//               Called when orders are loaded; afterwards the queue is kept
+//               up to date as orders are added and processed. The keys,
+//               which look up each order's customer, are computed on the
+//               task pool (inline with a single pool thread or a small
+//               store) and the queue is filled in store order.
+// PARAMETERS  :
+//      RecordStore* orders    : Order store
+//      RecordStore* customers : Customer store
+// RETURNS     : bool - false if out of memory (the queue is then unbound
+//               and rebuilt on next use)
+//
+static bool queuePlacedOrders(RecordStore* orders, RecordStore* customers) {
+    orderQueueReset(&placedQueue, orders);
+
+    // Brings the customer index up to date, so the pieces only read it
+    unsigned int version = orderKeyVersion(customers);
+
+    OrderKeyJob job;
+    job.orders = orders;
+    job.customers = customers;
+    job.keys = NULL;
+    if (taskPoolThreads() > 1 && orders->count > STORE_CHUNK_RECORDS) {
+        job.keys = (long long*)malloc(sizeof(long long) * (size_t)orders->count);
+    }
+    if (job.keys != NULL) {
+        taskParallelFor(orders->count, STORE_CHUNK_RECORDS, 0, computeOrderKeys, &job);
+    }
+
+    for (int i = 0; i < orders->count; i++) {
+        const Order* order = orderAt(orders, i);
+        if (order->OrderStatus != STATUS_PLACED) continue;
+
+        long long key = job.keys != NULL ? job.keys[i] : orderPriorityKey(order, customers);
+        if (!orderQueueAppend(&placedQueue, key, i)) {
+            free(job.keys);
+            orderQueueReset(&placedQueue, NULL);
+            return false;
+        }
+    }
+    free(job.keys);
+
+    orderQueueHeapify(&placedQueue);
+    placedQueue.queuedRecords = orders->count;
+    placedQueue.keyVersion = version;
+    return true;
+}
+
+//
+// FUNCTION    : queueOrders
+// DESCRIPTION : Builds the placed-order queue for orders loaded without
+//               their customers. This is the cross-reference step of the
+//               start-up load, run once the stores have loaded side by side.
+// PARAMETERS  :
+//      RecordStore* orders    : Order store
+//      RecordStore* customers : Customer store
+// RETURNS     : void
+//
+void queueOrders(RecordStore* orders, RecordStore* customers) {
+    if (!queuePlacedOrders(orders, customers)) {
+        printf("Not enough memory to queue the orders; they will be queued at end of day.\n");
+    }
+}
+
+//
+// FUNCTION    : syncPlacedQueue
+// DESCRIPTION : Brings the placed-order queue up to date with the store.
+//               Placed orders appended since the last call are pushed, and
+//               keys are recomputed if the customers they were computed
+//               from changed; a different store or a shrunken count
+//               triggers a full rebuild.
+// PARAMETERS  :
+//      RecordStore* orders    : Order store
+//      RecordStore* customers : Customer store
+// RETURNS     : bool - false if out of memory
+//
+static bool syncPlacedQueue(RecordStore* orders, RecordStore* customers) {
+    if (placedQueue.base != orders || placedQueue.queuedRecords > orders->count) {
+        return queuePlacedOrders(orders, customers);
+    }
+
+    unsigned int version = orderKeyVersion(customers);
+    if (!placedQueue.keysCurrent || placedQueue.keyVersion != version) {
+        for (int i = 0; i < placedQueue.count; i++) {
+            OrderQueueEntry* entry = &placedQueue.entries[i];
+            entry->key = orderPriorityKey(orderAt(orders, entry->position), customers);
+        }
+        orderQueueHeapify(&placedQueue);
+        placedQueue.keysCurrent = true;
+        placedQueue.keyVersion = version;
+    }
+
+    while (placedQueue.queuedRecords < orders->count) {
+        int i = placedQueue.queuedRecords;
+        const Order* order = orderAt(orders, i);
+
+        if (order->OrderStatus == STATUS_PLACED &&
+            !orderQueuePush(&placedQueue, orderPriorityKey(order, customers), i)) {
+            orderQueueReset(&placedQueue, NULL);
+            return false;
+        }
+        placedQueue.queuedRecords++;
+    }
+    return true;
+}
+
+//
+// FUNCTION    : waitForStock
+// DESCRIPTION : Makes a backordered order wait on the first part it is
+//               still short of (or its first part if the lines only fall
+//               short together)
+// PARAMETERS  :
+//      RecordStore* orders : Order store
+//      int position        : Position of the order
+//      RecordStore* parts  : Part store
+// RETURNS     : bool - false if out of memory
+//
+static bool waitForStock(RecordStore* orders, int position, RecordStore* parts) {
+    const Order* order = orderAt(orders, position);
+    if (order->DistinctParts < 1) return true;
+
+    int line = 0;
+    for (int j = 0; j < order->DistinctParts; j++) {
+        const OrderItem* item = orderLine(order, j);
+        int k = findPart(parts, item->PartID);
+        if (k == -1 || inventoryOnHand(parts, k) < item->NumberOfParts) {
+            line = j;
+            break;
+        }
+    }
+    return backorderAdd(&backorders, orderLine(order, line)->PartID, position);
+}
+
+//
+// FUNCTION    : syncBackorders
+// DESCRIPTION : Builds the backorder index from the order store if it is
+//               not bound to it, e.g. after orders were loaded. Once built
+//               it is kept up to date as orders are processed.
+// PARAMETERS  :
+//      RecordStore* orders : Order store
+//      RecordStore* parts  : Part store
+// RETURNS     : bool - false if out of memory (the index is then unbound
+//               and rebuilt on next use)
+//
+static bool syncBackorders(RecordStore* orders, RecordStore* parts) {
+    if (backorders.base == orders) return true;
+
+    backorderReset(&backorders, orders);
+    for (int i = 0; i < orders->count; i++) {
+        if (orderAt(orders, i)->OrderStatus == STATUS_INSUFFICIENT_PARTS &&
+            !waitForStock(orders, i, parts)) {
+            backorderReset(&backorders, NULL);
+            return false;
+        }
+    }
+    return true;
+}
 
-    return (long)year * 1000000 + month * 10000 + day * 100 + dailySequence;
+//
+// FUNCTION    : appendOrderLines
+// DESCRIPTION : Copies an order's lines to the end of the line arena and
+//               points the order at them
+// PARAMETERS  :
+//      Order* order           : Order receiving the lines
+//      const OrderItem* items : Lines to store
+//      int count              : Number of lines
+// RETURNS     : bool - false if out of memory (the arena is unchanged)
+//
+bool appendOrderLines(Order* order, const OrderItem* items, int count) {
+    int first = orderLines.count;
+    if (!storeResize(&orderLines, first + count)) {
+        storeResize(&orderLines, first);
+        return false;
+    }
+
+    for (int j = 0; j < count; j++) {
+        *(OrderItem*)storeAt(&orderLines, first + j) = items[j];
+    }
+    order->FirstLine = first;
+    order->DistinctParts = count;
+    return true;
+}
+
+//
+// FUNCTION    : generateOrderID
+// DESCRIPTION : Generates unique order ID based on date and sequence.
+//               Safe to call from several threads.
+// PARAMETERS  : None
+// RETURNS     : long long - Generated order ID, ORDER_ID_NONE on failure
+//
+long long generateOrderID() {
+    return orderIdNext();
 }
 
 //
 // FUNCTION    : validateDate
 // DESCRIPTION : Validates date string format (YYYY-MM-DD)
 // PARAMETERS  :
-//      const char* date : Date string to validate
+//      std::string_view date : Date string to validate
 // RETURNS     : bool - true if valid, false otherwise
 //
-bool validateDate(const char* date) {
-    if (strlen(date) != 10) return false;
+bool validateDate(std::string_view date) {
+    if (date.size() != 10) return false;
     if (date[4] != '-' || date[7] != '-') return false;
 
     for (int i = 0; i < 10; i++) {
         if (i == 4 || i == 7) continue;
-        if (!isdigit(date[i])) return false;
+        if (!isdigit((unsigned char)date[i])) return false;
     }
 
-    int year, month, day;
-    if (sscanf_s(date, "%d-%d-%d", &year, &month, &day) != 3)
-        return false;
+    // Every digit position is checked above, so the parts convert directly
+    int year = (date[0] - '0') * 1000 + (date[1] - '0') * 100 + (date[2] - '0') * 10 + (date[3] - '0');
+    int month = (date[5] - '0') * 10 + (date[6] - '0');
+    int day = (date[8] - '0') * 10 + (date[9] - '0');
 
     if (year < 2000 || year > 2100) return false;
     if (month < 1 || month > 12) return false;
@@ -90,187 +443,229 @@ bool validateDate(const char* date) {
 // FUNCTION    : validateCustomer
 // DESCRIPTION : Validates that customer ID exists in system
 // PARAMETERS  :
-//      int customerID      : Customer ID to validate
-//      Customer customers[]: Array of customer records
-//      int customerCount   : Number of customers
+//      int customerID         : Customer ID to validate
+//      RecordStore* customers : Customer store
 // RETURNS     : bool - true if valid, false otherwise
 //
-bool validateCustomer(int customerID, Customer customers[], int customerCount) {
-    for (int i = 0; i < customerCount; i++) {
-        if (customers[i].customerID == customerID) {
-            return true;
-        }
-    }
-    return false;
+bool validateCustomer(int customerID, RecordStore* customers) {
+    return findCustomer(customers, customerID) != -1;
 }
 
 //
 // FUNCTION    : validatePart
 // DESCRIPTION : Validates that part ID exists in inventory
 // PARAMETERS  :
-//      int partID      : Part ID to validate
-//      Parts parts[]   : Array of part records
-//      int partsCount  : Number of parts in inventory
+//      int partID          : Part ID to validate
+//      RecordStore* parts  : Part store
 // RETURNS     : bool - true if valid, false otherwise
 //
-bool validatePart(int partID, Parts parts[], int partsCount) {
-    for (int i = 0; i < partsCount; i++) {
-        if (parts[i].PartID == partID) {
-            return true;
-        }
-    }
-    return false;
+bool validatePart(int partID, RecordStore* parts) {
+    return findPart(parts, partID) != -1;
 }
 
 //
 // FUNCTION    : getPartPrice
 // DESCRIPTION : Retrieves price for specified part ID
 // PARAMETERS  :
-//      int partID      : Part ID to look up
-//      Parts parts[]   : Array of part records
-//      int partsCount  : Number of parts in inventory
+//      int partID          : Part ID to look up
+//      RecordStore* parts  : Part store
 // RETURNS     : float - Price of part, 0.0 if not found
 //
-float getPartPrice(int partID, Parts parts[], int partsCount) {
-    for (int i = 0; i < partsCount; i++) {
-        if (parts[i].PartID == partID) {
-            return parts[i].PartCost;
-        }
-    }
-    return 0.0f;
+float getPartPrice(int partID, RecordStore* parts) {
+    int i = findPart(parts, partID);
+    return i != -1 ? partAt(parts, i)->PartCost : 0.0f;
 }
 
 //
 // FUNCTION    : createNewOrder
 // DESCRIPTION : Creates new order with user input and validation
 // PARAMETERS  :
-//      Order orders[]      : Array of order records
-//      int* orderCount     : Pointer to current order count
-//      Customer customers[]: Array of customer records
-//      int customerCount   : Number of customers
-//      Parts parts[]       : Array of part records
-//      int partsCount      : Number of parts in inventory
+//      RecordStore* orders    : Order store
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
 // RETURNS     : void
 //
-void createNewOrder(Order orders[], int* orderCount, Customer customers[], int customerCount, Parts parts[], int partsCount) {
-    if (*orderCount >= MAX_ORDERS) {
-        printf("Maximum order capacity reached.\n");
-        return;
-    }
-
-    Order newOrder;
-    newOrder.OrderID = generateOrderID();
-    getCurrentDate(newOrder.OrderDate);
-    newOrder.OrderStatus = STATUS_PLACED;
+void createNewOrder(RecordStore* orders, RecordStore* customers, RecordStore* parts) {
+    OrderItem items[MAX_PARTS_PER_ORDER];
+    int customerID;
+    int distinctParts;
 
     printf("Enter Customer ID: ");
-    if (scanf_s("%d", &newOrder.CustomerID) != 1) {
+    if (scanf_s("%d", &customerID) != 1) {
         printf("Invalid customer ID.\n");
         while (getchar() != '\n');
         return;
     }
     while (getchar() != '\n');
 
-    if (!validateCustomer(newOrder.CustomerID, customers, customerCount)) {
+    if (!validateCustomer(customerID, customers)) {
         printf("Customer not found.\n");
         return;
     }
 
     printf("Enter number of distinct parts (1-%d): ", MAX_PARTS_PER_ORDER);
-    if (scanf_s("%d", &newOrder.DistinctParts) != 1 ||
-        newOrder.DistinctParts < 1 || newOrder.DistinctParts > MAX_PARTS_PER_ORDER) {
+    if (scanf_s("%d", &distinctParts) != 1 ||
+        distinctParts < 1 || distinctParts > MAX_PARTS_PER_ORDER) {
         printf("Invalid number of parts.\n");
         while (getchar() != '\n');
         return;
     }
     while (getchar() != '\n');
 
-    newOrder.OrderTotal = 0.0f;
-    newOrder.TotalParts = 0;
-
-    for (int i = 0; i < newOrder.DistinctParts; i++) {
+    for (int i = 0; i < distinctParts; i++) {
         printf("\nPart #%d:\n", i + 1);
 
         printf("Enter Part ID: ");
-        if (scanf_s("%d", &newOrder.Items[i].PartID) != 1) {
+        if (scanf_s("%d", &items[i].PartID) != 1) {
             printf("Invalid part ID.\n");
             while (getchar() != '\n');
             return;
         }
         while (getchar() != '\n');
 
-        if (!validatePart(newOrder.Items[i].PartID, parts, partsCount)) {
+        if (!validatePart(items[i].PartID, parts)) {
             printf("Part not found.\n");
             return;
         }
 
         printf("Enter Quantity: ");
-        if (scanf_s("%d", &newOrder.Items[i].NumberOfParts) != 1 ||
-            newOrder.Items[i].NumberOfParts < 1) {
+        if (scanf_s("%d", &items[i].NumberOfParts) != 1 ||
+            items[i].NumberOfParts < 1) {
             printf("Invalid quantity.\n");
             while (getchar() != '\n');
             return;
         }
         while (getchar() != '\n');
+    }
 
-        float partPrice = getPartPrice(newOrder.Items[i].PartID, parts, partsCount);
-        newOrder.OrderTotal += partPrice * newOrder.Items[i].NumberOfParts;
-        newOrder.TotalParts += newOrder.Items[i].NumberOfParts;
+    printPlaceResult(placeOrder(orders, customers, parts, customerID, items, distinctParts), orders);
+}
+
+//
+// FUNCTION    : placeOrder
+// DESCRIPTION : Validates and prices a new order, gives it an ID and the
+//               current date, and adds it to the store and the end-of-day
+//               queue. Prints nothing; the caller reports the outcome
+//               (printPlaceResult, or a service reply).
+// PARAMETERS  :
+//      RecordStore* orders     : Order store
+//      RecordStore* customers  : Customer store
+//      RecordStore* parts      : Part store
+//      int customerID          : Ordering customer
+//      const OrderItem* items  : Order lines
+//      int count               : Number of lines (1 to MAX_PARTS_PER_ORDER)
+// RETURNS     : PlaceResult - PLACE_OK if the order was created (it is the
+//               last order in the store), otherwise why it was not
+//
+PlaceResult placeOrder(RecordStore* orders, RecordStore* customers, RecordStore* parts,
+    int customerID, const OrderItem* items, int count) {
+    Order newOrder;
+    newOrder.CustomerID = customerID;
+    newOrder.OrderStatus = STATUS_PLACED;
+    newOrder.OrderTotal = 0.0f;
+    newOrder.TotalParts = 0;
+    getCurrentDate(newOrder.OrderDate);
+
+    if (!validateCustomer(customerID, customers)) return PLACE_NO_CUSTOMER;
+    if (count < 1 || count > MAX_PARTS_PER_ORDER) return PLACE_BAD_COUNT;
+
+    for (int i = 0; i < count; i++) {
+        if (!validatePart(items[i].PartID, parts)) return PLACE_NO_PART;
+        if (items[i].NumberOfParts < 1) return PLACE_BAD_QUANTITY;
+
+        float partPrice = getPartPrice(items[i].PartID, parts);
+        newOrder.OrderTotal += partPrice * items[i].NumberOfParts;
+        newOrder.TotalParts += items[i].NumberOfParts;
     }
 
-    orders[*orderCount] = newOrder;
-    (*orderCount)++;
-    printf("\nOrder created successfully!\n");
-    printf("Order ID: %ld\n", newOrder.OrderID);
-    printf("Order Total: $%.2f\n", newOrder.OrderTotal);
+    newOrder.OrderID = generateOrderID();
+    if (newOrder.OrderID == ORDER_ID_NONE) return PLACE_NO_ORDER_ID;
+
+    if (!appendOrderLines(&newOrder, items, count)) return PLACE_NO_MEMORY;
+
+    Order* slot = (Order*)storeAppend(orders);
+    if (slot == NULL) {
+        storeResize(&orderLines, newOrder.FirstLine);
+        return PLACE_NO_MEMORY;
+    }
+    *slot = newOrder;
+    walLogOrder(slot);
+    syncOrderIndex(orders);
+    if (!syncPlacedQueue(orders, customers)) {
+        statusPrintf("Not enough memory to queue the order; it will be queued at end of day.\n");
+    }
 
-    char logMsg[256];
-    sprintf_s(logMsg, sizeof(logMsg), "New order created: ID %ld, Customer %d, Total $%.2f",
-        newOrder.OrderID, newOrder.CustomerID, newOrder.OrderTotal);
-    logMessage(logMsg);
+    logEvent(LOG_ORDER_CREATED, newOrder.OrderID, newOrder.CustomerID, newOrder.OrderTotal);
+    return PLACE_OK;
+}
+
+//
+// FUNCTION    : printPlaceResult
+// DESCRIPTION : Prints the outcome of placeOrder for the menus and
+//               commands: the new order's ID and total, or why it was
+//               turned down
+// PARAMETERS  :
+//      PlaceResult result  : Value placeOrder returned
+//      RecordStore* orders : Order store
+// RETURNS     : void
+//
+void printPlaceResult(PlaceResult result, RecordStore* orders) {
+    switch (result) {
+    case PLACE_OK: {
+        const Order* order = orderAt(orders, orders->count - 1);
+        printf("\nOrder created successfully!\n");
+        printf("Order ID: %lld\n", order->OrderID);
+        printf("Order Total: $%.2f\n", order->OrderTotal);
+        break;
+    }
+    case PLACE_NO_CUSTOMER: printf("Customer not found.\n"); break;
+    case PLACE_BAD_COUNT: printf("Invalid number of parts.\n"); break;
+    case PLACE_NO_PART: printf("Part not found.\n"); break;
+    case PLACE_BAD_QUANTITY: printf("Invalid quantity.\n"); break;
+    case PLACE_NO_ORDER_ID: printf("Could not reserve an order ID.\n"); break;
+    default: printf("Not enough memory to create order.\n");
+    }
 }
 
 //
 // FUNCTION    : displayOrderDetails
 // DESCRIPTION : Displays detailed information for specific order
 // PARAMETERS  :
-//      long orderID    : ID of order to display
-//      Order orders[]  : Array of order records
-//      int orderCount  : Number of orders
+//      long long orderID   : ID of order to display
+//      RecordStore* orders : Order store
 // RETURNS     : void
 //
-void displayOrderDetails(long orderID, Order orders[], int orderCount) {
-    for (int i = 0; i < orderCount; i++) {
-        if (orders[i].OrderID == orderID) {
-            printf("\nOrder Details\n");
-            printf("----------------------------\n");
-            printf("Order ID: %ld\n", orders[i].OrderID);
-            printf("Date: %s\n", orders[i].OrderDate);
-
-            printf("Status: ");
-            switch (orders[i].OrderStatus) {
-            case STATUS_PLACED: printf("Placed"); break;
-            case STATUS_FULFILLED: printf("Fulfilled"); break;
-            case STATUS_INSUFFICIENT_PARTS: printf("Insufficient Parts"); break;
-            case STATUS_CREDIT_LIMIT_EXCEEDED: printf("Credit Limit Exceeded"); break;
-            default: printf("Unknown");
-            }
-            printf("\n");
-
-            printf("Customer ID: %d\n", orders[i].CustomerID);
-            printf("Total Parts: %d\n", orders[i].TotalParts);
-            printf("Distinct Parts: %d\n", orders[i].DistinctParts);
-            printf("Order Total: $%.2f\n", orders[i].OrderTotal);
-
-            printf("\nOrder Items:\n");
-            for (int j = 0; j < orders[i].DistinctParts; j++) {
-                printf("  Part ID: %d, Quantity: %d\n",
-                    orders[i].Items[j].PartID,
-                    orders[i].Items[j].NumberOfParts);
-            }
+void displayOrderDetails(long long orderID, RecordStore* orders) {
+    int i = findOrder(orders, orderID);
+    if (i != -1) {
+        const Order* order = orderAt(orders, i);
+        printf("\nOrder Details\n");
+        printf("----------------------------\n");
+        printf("Order ID: %lld\n", order->OrderID);
+        printf("Date: %s\n", order->OrderDate);
 
-            return;
+        printf("Status: ");
+        switch (order->OrderStatus) {
+        case STATUS_PLACED: printf("Placed"); break;
+        case STATUS_FULFILLED: printf("Fulfilled"); break;
+        case STATUS_INSUFFICIENT_PARTS: printf("Insufficient Parts"); break;
+        case STATUS_CREDIT_LIMIT_EXCEEDED: printf("Credit Limit Exceeded"); break;
+        default: printf("Unknown");
+        }
+        printf("\n");
+
+        printf("Customer ID: %d\n", order->CustomerID);
+        printf("Total Parts: %d\n", order->TotalParts);
+        printf("Distinct Parts: %d\n", order->DistinctParts);
+        printf("Order Total: $%.2f\n", order->OrderTotal);
+
+        printf("\nOrder Items:\n");
+        for (int j = 0; j < order->DistinctParts; j++) {
+            const OrderItem* item = orderLine(order, j);
+            printf("  Part ID: %d, Quantity: %d\n", item->PartID, item->NumberOfParts);
         }
+
+        return;
     }
 
     printf("Order not found.\n");
@@ -280,24 +675,37 @@ void displayOrderDetails(long orderID, Order orders[], int orderCount) {
 // FUNCTION    : updateOrderStatus
 // DESCRIPTION : Updates status of specified order
 // PARAMETERS  :
-//      long orderID    : ID of order to update
-//      int newStatus   : New status code
-//      Order orders[]  : Array of order records
-//      int orderCount  : Number of orders
+//      long long orderID   : ID of order to update
+//      int newStatus       : New status code
+//      RecordStore* orders : Order store
 // RETURNS     : void
 //
-void updateOrderStatus(long orderID, int newStatus, Order orders[], int orderCount) {
-    for (int i = 0; i < orderCount; i++) {
-        if (orders[i].OrderID == orderID) {
-            orders[i].OrderStatus = newStatus;
-            printf("Order status updated.\n");
-
-            char logMsg[256];
-            sprintf_s(logMsg, sizeof(logMsg), "Order %ld status updated to %d", orderID, newStatus);
-            logMessage(logMsg);
+void updateOrderStatus(long long orderID, int newStatus, RecordStore* orders) {
+    int i = findOrder(orders, orderID);
+    if (i != -1) {
+        Order* order = orderAt(orders, i);
+        bool requeue = order->OrderStatus != STATUS_PLACED && newStatus == STATUS_PLACED;
+        bool backordered = newStatus == STATUS_INSUFFICIENT_PARTS;
+        order->OrderStatus = newStatus;
+        storeMarkDirty(orders, i);
+        walLogOrderStatus(order);
+        printf("Order status updated.\n");
+
+        // Placed again: queue it now, keyed at the next end-of-day run
+        if (requeue && placedQueue.base == orders && i < placedQueue.queuedRecords) {
+            if (orderQueuePush(&placedQueue, 0, i)) placedQueue.keysCurrent = false;
+            else orderQueueReset(&placedQueue, NULL);
+        }
 
-            return;
+        // Backordered by hand: the index works out the part on next use
+        if (backorders.base == orders) {
+            if (backordered) backorders.base = NULL;
+            else backorderRemove(&backorders, i);
         }
+
+        logEvent(LOG_ORDER_STATUS_UPDATED, orderID, newStatus);
+
+        return;
     }
 
     printf("Order not found.\n");
@@ -307,12 +715,11 @@ void updateOrderStatus(long orderID, int newStatus, Order orders[], int orderCou
 // FUNCTION    : listAllOrders
 // DESCRIPTION : Lists all orders in system with basic information
 // PARAMETERS  :
-//      Order orders[]  : Array of order records
-//      int orderCount  : Number of orders
+//      RecordStore* orders : Order store
 // RETURNS     : void
 //
-void listAllOrders(Order orders[], int orderCount) {
-    if (orderCount == 0) {
+void listAllOrders(RecordStore* orders) {
+    if (orders->count == 0) {
         printf("No orders in system.\n");
         return;
     }
@@ -320,13 +727,14 @@ void listAllOrders(Order orders[], int orderCount) {
     printf("\nAll Orders\n");
     printf("----------------------------\n");
 
-    for (int i = 0; i < orderCount; i++) {
-        printf("Order ID: %ld\n", orders[i].OrderID);
-        printf("Date: %s\n", orders[i].OrderDate);
-        printf("Customer ID: %d\n", orders[i].CustomerID);
+    for (int i = 0; i < orders->count; i++) {
+        const Order* order = orderAt(orders, i);
+        printf("Order ID: %lld\n", order->OrderID);
+        printf("Date: %s\n", order->OrderDate);
+        printf("Customer ID: %d\n", order->CustomerID);
 
         printf("Status: ");
-        switch (orders[i].OrderStatus) {
+        switch (order->OrderStatus) {
         case STATUS_PLACED: printf("Placed"); break;
         case STATUS_FULFILLED: printf("Fulfilled"); break;
         case STATUS_INSUFFICIENT_PARTS: printf("Insufficient Parts"); break;
@@ -335,223 +743,577 @@ void listAllOrders(Order orders[], int orderCount) {
         }
         printf("\n");
 
-        printf("Total: $%.2f\n", orders[i].OrderTotal);
+        printf("Total: $%.2f\n", order->OrderTotal);
         printf("----------------------------\n");
     }
 }
 
+//
+// FUNCTION    : logFulfillment
+// DESCRIPTION : Logs the outcome of one processed order with the balance
+//               and stock levels it was checked against, producing the same
+//               messages as checking it on the calling thread would
+// PARAMETERS  :
+//      const FulfillmentBatch* batch : Processed batch
+//      const FulfillmentOrder* item  : Order to log
+//      RecordStore* orders           : Order store
+//      RecordStore* customers        : Customer store
+// RETURNS     : bool - true if the order was fulfilled
+//
+static bool logFulfillment(const FulfillmentBatch* batch, const FulfillmentOrder* item,
+    RecordStore* orders, RecordStore* customers) {
+    const Order* order = orderAt(orders, item->order);
+    const Customer* customer = customerAt(customers, item->customer);
+
+    switch (order->OrderStatus) {
+    case STATUS_CREDIT_LIMIT_EXCEEDED:
+        logEvent(LOG_ORDER_CREDIT_EXCEEDED, order->OrderID, customer->customerID,
+            item->balance, order->OrderTotal, customer->creditLimit);
+        return false;
+
+    case STATUS_INSUFFICIENT_PARTS:
+        for (int j = 0; j < order->DistinctParts; j++) {
+            int onHand = batch->lineOnHand[item->firstLine + j];
+            const OrderItem* line = orderLine(order, j);
+            int needed = line->NumberOfParts;
+
+            if (batch->linePart[item->firstLine + j] != -1 && onHand < needed) {
+                logEvent(LOG_PART_SHORTAGE, line->PartID, needed, onHand, needed - onHand);
+            }
+        }
+        logEvent(LOG_ORDER_PARTS_SHORT, order->OrderID);
+        return false;
+
+    default:
+        logEvent(LOG_ORDER_FULFILLED, order->OrderID, customer->customerID, order->OrderTotal);
+        return true;
+    }
+}
+
+//
+// FUNCTION    : recordBatchChanges
+// DESCRIPTION : Writes what a processed batch changed to the write-ahead
+//               log as one group: every order's status, then the final
+//               balance of each customer and the stock of each part the
+//               batch touched, each once. The changed records are also
+//               flagged for the next checkpoint.
+// PARAMETERS  :
+//      const FulfillmentBatch* batch : Processed batch
+//      RecordStore* orders           : Order store
+//      RecordStore* customers        : Customer store
+//      RecordStore* parts            : Part store
+// RETURNS     : void
+//
+static void recordBatchChanges(const FulfillmentBatch* batch, RecordStore* orders, RecordStore* customers,
+    RecordStore* parts) {
+    if (batch->count == 0) return;
+
+    // Marks keep a customer or part from being logged twice; without them
+    // they are logged once per order, which replays the same
+    unsigned char* customerLogged = (unsigned char*)calloc((size_t)customers->count + 1, 1);
+    unsigned char* partLogged = (unsigned char*)calloc((size_t)parts->count + 1, 1);
+    bool marked = customerLogged != NULL && partLogged != NULL;
+
+    walGroupBegin();
+    for (int i = 0; i < batch->count; i++) {
+        const FulfillmentOrder* item = &batch->orders[i];
+        walLogOrderStatus(orderAt(orders, item->order));
+        storeMarkDirty(orders, item->order);
+        storeMarkDirty(customers, item->customer);
+
+        if (!marked || !customerLogged[item->customer]) {
+            walLogCustomerBalance(customerAt(customers, item->customer));
+            if (marked) customerLogged[item->customer] = 1;
+        }
+        for (int j = 0; j < item->lines; j++) {
+            int part = batch->linePart[item->firstLine + j];
+            if (part == -1 || (marked && partLogged[part])) continue;
+            walLogPartStock(partAt(parts, part));
+            storeMarkDirty(parts, part);
+            if (marked) partLogged[part] = 1;
+        }
+    }
+    walGroupEnd();
+
+    free(customerLogged);
+    free(partLogged);
+}
+
+//
+// FUNCTION    : waitForBatch
+// DESCRIPTION : Adds the orders of a processed batch that were short of
+//               stock to the backorder index. If the index is not built
+//               yet it will find them when it is.
+// PARAMETERS  :
+//      const FulfillmentBatch* batch : Processed batch
+//      RecordStore* orders           : Order store
+//      RecordStore* parts            : Part store
+// RETURNS     : void
+//
+static void waitForBatch(const FulfillmentBatch* batch, RecordStore* orders, RecordStore* parts) {
+    if (backorders.base != orders) return;
+
+    for (int i = 0; i < batch->count; i++) {
+        int position = batch->orders[i].order;
+        if (orderAt(orders, position)->OrderStatus == STATUS_INSUFFICIENT_PARTS &&
+            !waitForStock(orders, position, parts)) {
+            backorders.base = NULL;
+            return;
+        }
+    }
+}
+
 //
 // FUNCTION    : processEndOfDayOrders
-// DESCRIPTION : Processes all pending orders with validation checks
-// PARAMETERS  :
-//      Order orders[]      : Array of order records
-//      int* orderCount     : Pointer to current order count
-//      Customer customers[]: Array of customer records
-//      int customerCount   : Number of customers
-//      Parts parts[]       : Array of part records
-//      int partsCount      : Number of parts in inventory
+// DESCRIPTION : Processes all pending orders with validation checks. The
+//               placed orders are taken from the queue in priority order
+//               and handed to the fulfillment engine, which may spread
+//               them over several threads; outcomes are then logged in
+//               priority order.
+// PARAMETERS  :
+//      RecordStore* orders    : Order store
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
 // RETURNS     : void
 //
-void processEndOfDayOrders(Order orders[], int* orderCount, Customer customers[], int customerCount, Parts parts[], int partsCount) {
-    if (*orderCount == 0) {
-        printf("No orders to process.\n");
+void processEndOfDayOrders(RecordStore* orders, RecordStore* customers, RecordStore* parts) {
+    if (orders->count == 0) {
+        statusPrintf("No orders to process.\n");
         return;
     }
 
-    printf("\nProcessing orders...\n");
+    statusPrintf("\nProcessing orders...\n");
     int processed = 0;
-    char logMsg[256];
-
-    // Sort orders by customer join date (oldest customers first)
-    for (int i = 0; i < *orderCount - 1; i++) {
-        for (int j = 0; j < *orderCount - i - 1; j++) {
-            Customer c1, c2;
-            for (int k = 0; k < customerCount; k++) {
-                if (customers[k].customerID == orders[j].CustomerID) c1 = customers[k];
-                if (customers[k].customerID == orders[j + 1].CustomerID) c2 = customers[k];
-            }
 
-            if (strcmp(c1.joinDate, c2.joinDate) > 0) {
-                Order temp = orders[j];
-                orders[j] = orders[j + 1];
-                orders[j + 1] = temp;
-            }
-        }
+    // Only placed orders are queued; they come out in ORDER_PRIORITY order
+    // (oldest customers first by default)
+    if (!syncPlacedQueue(orders, customers)) {
+        statusPrintf("Not enough memory to process orders.\n");
+        return;
     }
 
-    // Process each order
-    for (int i = 0; i < *orderCount; i++) {
-        if (orders[i].OrderStatus != STATUS_PLACED) continue;
+    OrderQueue waiting;     // Placed orders that stay queued for a later run
+    orderQueueInit(&waiting);
+    FulfillmentBatch batch;
+    fulfillmentInit(&batch);
+    OrderQueueEntry entry;
+    int lastPosition = -1;
 
-        Customer* customer = NULL;
-        for (int j = 0; j < customerCount; j++) {
-            if (customers[j].customerID == orders[i].CustomerID) {
-                customer = &customers[j];
-                break;
-            }
-        }
-        if (!customer) continue;
-
-        // Check credit limit
-        if (customer->accountBalance + orders[i].OrderTotal > customer->creditLimit) {
-            orders[i].OrderStatus = STATUS_CREDIT_LIMIT_EXCEEDED;
-            sprintf_s(logMsg, sizeof(logMsg),
-                "Order %ld: Credit limit exceeded (Customer %d: Balance $%.2f + Order $%.2f > Limit $%.2f)",
-                orders[i].OrderID, customer->customerID,
-                customer->accountBalance, orders[i].OrderTotal, customer->creditLimit);
-            logMessage(logMsg);
+    // Collect the pending orders
+    while (orderQueuePop(&placedQueue, &entry)) {
+        if (entry.position == lastPosition) continue;   // Placed again after being queued
+        lastPosition = entry.position;
+
+        Order* order = orderAt(orders, entry.position);
+        if (order->OrderStatus != STATUS_PLACED) continue;
+
+        int c = findCustomer(customers, order->CustomerID);
+        if (c == -1) {
+            if (!orderQueueAppend(&waiting, entry.key, entry.position)) placedQueue.base = NULL;
             continue;
         }
 
-        // Check inventory availability
-        bool canFulfill = true;
-        for (int j = 0; j < orders[i].DistinctParts; j++) {
-            OrderItem item = orders[i].Items[j];
-            Parts* part = NULL;
-
-            for (int k = 0; k < partsCount; k++) {
-                if (parts[k].PartID == item.PartID) {
-                    part = &parts[k];
-                    break;
-                }
-            }
+        if (!fulfillmentAdd(&batch, orders, entry.position, c, parts)) {
+            // Leave the rest for the next run
+            statusPrintf("Not enough memory to process all orders.\n");
+            if (!orderQueuePush(&placedQueue, entry.key, entry.position)) placedQueue.base = NULL;
+            break;
+        }
+    }
 
-            if (!part || part->QuantityOnHand < item.NumberOfParts) {
-                canFulfill = false;
-                if (part) {
-                    int deficit = item.NumberOfParts - part->QuantityOnHand;
-                    part->PartStatus = -deficit;
-
-                    sprintf_s(logMsg, sizeof(logMsg),
-                        "Insufficient inventory - Part %d: Need %d, Have %d (Deficit %d)",
-                        item.PartID, item.NumberOfParts, part->QuantityOnHand, deficit);
-                    logMessage(logMsg);
-                }
-            }
+    runFulfillment(&batch, orders, customers, parts);
+    recordBatchChanges(&batch, orders, customers, parts);
+
+    for (int i = 0; i < batch.count; i++) {
+        if (logFulfillment(&batch, &batch.orders[i], orders, customers)) processed++;
+    }
+    waitForBatch(&batch, orders, parts);
+    fulfillmentFree(&batch);
+
+    for (int i = 0; i < waiting.count; i++) {
+        if (!orderQueuePush(&placedQueue, waiting.entries[i].key, waiting.entries[i].position)) {
+            placedQueue.base = NULL;
         }
+    }
+    orderQueueFree(&waiting);
 
-        if (!canFulfill) {
-            orders[i].OrderStatus = STATUS_INSUFFICIENT_PARTS;
-            sprintf_s(logMsg, sizeof(logMsg),
-                "Order %ld: Insufficient parts", orders[i].OrderID);
-            logMessage(logMsg);
-            continue;
+    statusPrintf("\nProcessing complete. %d orders processed.\n", processed);
+}
+
+//
+// FUNCTION    : queueBackorders
+// DESCRIPTION : Appends the orders of a detached backorder list to a queue
+//               with their priority keys
+// PARAMETERS  :
+//      OrderQueue* ready      : Queue to fill
+//      int first              : First order of the list
+//      RecordStore* orders    : Order store
+//      RecordStore* customers : Customer store
+// RETURNS     : bool - false if out of memory
+//
+static bool queueBackorders(OrderQueue* ready, int first, RecordStore* orders, RecordStore* customers) {
+    for (int i = first; i != BACKORDER_NONE; i = backorderNext(&backorders, i)) {
+        const Order* order = orderAt(orders, i);
+        if (!orderQueueAppend(ready, orderPriorityKey(order, customers), i)) return false;
+    }
+    return true;
+}
+
+//
+// FUNCTION    : ordersWaitOn
+// DESCRIPTION : Tells whether fulfillBackorders has anything to do after a
+//               part is restocked. Changes nothing, so it can run while
+//               other threads read the orders.
+// PARAMETERS  :
+//      RecordStore* orders : Order store
+//      int partID          : Restocked part
+// RETURNS     : bool - true if orders wait on the part, or the backorders
+//               of this store are not listed yet
+//
+bool ordersWaitOn(RecordStore* orders, int partID) {
+    return backorders.base != orders || backorderWaiting(&backorders, partID);
+}
+
+//
+// FUNCTION    : fulfillBackorders
+// DESCRIPTION : Checks the backordered orders waiting on a restocked part
+//               again, in priority order, and fulfills those that now
+//               can be. Orders still short wait on their next missing part.
+//               Only the waiting orders are visited, not the whole store.
+// PARAMETERS  :
+//      RecordStore* orders    : Order store
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      int partID             : Restocked part, BACKORDER_ALL_PARTS after a
+//                               bulk restock
+// RETURNS     : void
+//
+void fulfillBackorders(RecordStore* orders, RecordStore* customers, RecordStore* parts, int partID) {
+    if (!syncBackorders(orders, parts)) {
+        statusPrintf("Not enough memory to check backorders.\n");
+        return;
+    }
+    if (backorders.waiting == 0) return;
+
+    // Take the waiting orders off their lists and rank them
+    OrderQueue ready;
+    orderQueueInit(&ready);
+    bool queued = true;
+
+    if (partID == BACKORDER_ALL_PARTS) {
+        for (int list = 0; list < backorders.listCount && queued; list++) {
+            queued = queueBackorders(&ready, backorderTakeList(&backorders, list), orders, customers);
         }
+    }
+    else {
+        queued = queueBackorders(&ready, backorderTake(&backorders, partID), orders, customers);
+    }
 
-        // Fulfill order
-        for (int j = 0; j < orders[i].DistinctParts; j++) {
-            OrderItem item = orders[i].Items[j];
-            for (int k = 0; k < partsCount; k++) {
-                if (parts[k].PartID == item.PartID) {
-                    parts[k].QuantityOnHand -= item.NumberOfParts;
-
-                    // Update part status based on new quantity
-                    if (parts[k].QuantityOnHand > 100) {
-                        parts[k].PartStatus = 0;
-                    }
-                    else if (parts[k].QuantityOnHand > 0) {
-                        parts[k].PartStatus = 99;
-                    }
-                    else {
-                        parts[k].PartStatus = -parts[k].QuantityOnHand;
-                    }
-                    break;
-                }
-            }
+    if (!queued) {
+        // Orders taken off the lists are found again by a rebuild
+        statusPrintf("Not enough memory to check backorders.\n");
+        backorders.base = NULL;
+        orderQueueFree(&ready);
+        return;
+    }
+    orderQueueHeapify(&ready);
+
+    FulfillmentBatch batch;
+    fulfillmentInit(&batch);
+    OrderQueueEntry entry;
+
+    while (orderQueuePop(&ready, &entry)) {
+        int c = findCustomer(customers, orderAt(orders, entry.position)->CustomerID);
+
+        if (c == -1 || !fulfillmentAdd(&batch, orders, entry.position, c, parts)) {
+            if (!waitForStock(orders, entry.position, parts)) backorders.base = NULL;
         }
+    }
+    orderQueueFree(&ready);
 
-        // Update customer balance
-        customer->accountBalance += orders[i].OrderTotal;
-        orders[i].OrderStatus = STATUS_FULFILLED;
-        processed++;
+    runFulfillment(&batch, orders, customers, parts);
+    recordBatchChanges(&batch, orders, customers, parts);
 
-        sprintf_s(logMsg, sizeof(logMsg),
-            "Order %ld fulfilled - Customer %d, Total $%.2f",
-            orders[i].OrderID, customer->customerID, orders[i].OrderTotal);
-        logMessage(logMsg);
+    int fulfilled = 0;
+    for (int i = 0; i < batch.count; i++) {
+        if (logFulfillment(&batch, &batch.orders[i], orders, customers)) fulfilled++;
     }
+    waitForBatch(&batch, orders, parts);
 
-    printf("\nProcessing complete. %d orders processed.\n", processed);
+    if (batch.count > 0) {
+        statusPrintf("%d of %d backordered orders fulfilled.\n", fulfilled, batch.count);
+    }
+    fulfillmentFree(&batch);
 }
 
 //
-// FUNCTION    : loadOrderFromFile
-// DESCRIPTION : Loads orders from file with validation
+// FUNCTION    : parseOrderRecord
+// DESCRIPTION : Validates the fields of one orders.db line and fills an
+//               order record. Shared by both loader modes; the mapped
+//               loader calls it from several threads, so it touches no
+//               shared state.
+// PARAMETERS  :
+//      const std::string_view fields[] : Fields of the line
+//      int fieldCount                  : Number of fields
+//      void* record                    : Receives the order (Order)
+//      RecordStore* extra              : Line store receiving the order's
+//                                        lines (OrderItem)
+// RETURNS     : bool - true if the line holds a valid order
+//
+static bool parseOrderRecord(const std::string_view fields[], int fieldCount, void* record,
+    RecordStore* extra) {
+    Order* o = (Order*)record;
+    if (fieldCount < 6) return false;
+
+    if (!parseLongLongField(fields[0], &o->OrderID)) return false;
+
+    if (fields[1].size() != 10 || !validateDate(fields[1])) return false;
+
+    if (!parseIntField(fields[2], &o->OrderStatus)) return false;
+    if (!parseIntField(fields[3], &o->CustomerID) || o->CustomerID <= 0) return false;
+    if (!parseFloatField(fields[4], &o->OrderTotal) || o->OrderTotal <= 0.0f) return false;
+    if (!parseIntField(fields[5], &o->DistinctParts) || o->DistinctParts < 1) return false;
+
+    o->TotalParts = 0;
+    o->FirstLine = extra->count;
+    int itemIndex = 0;
+    for (int i = 6; i + 1 < fieldCount && itemIndex < o->DistinctParts; i += 2) {
+        OrderItem item;
+        if (!parseIntField(fields[i], &item.PartID) || item.PartID <= 0) break;
+        if (!parseIntField(fields[i + 1], &item.NumberOfParts) || item.NumberOfParts < 1) break;
+
+        OrderItem* slot = (OrderItem*)storeAppend(extra);
+        if (slot == NULL) break;
+        *slot = item;
+
+        o->TotalParts += item.NumberOfParts;
+        itemIndex++;
+    }
+
+    if (itemIndex != o->DistinctParts) {
+        storeResize(extra, o->FirstLine);
+        return false;
+    }
+
+    memcpy(o->OrderDate, fields[1].data(), 10);
+    o->OrderDate[10] = '\0';
+    return true;
+}
+
+//
+// FUNCTION    : appendOrder
+// DESCRIPTION : Adds a loaded order to the end of the store
+// PARAMETERS  :
+//      RecordStore* orders : Order store
+//      const Order* o      : Order to add
+// RETURNS     : bool - true on success, false if out of memory
+//
+static bool appendOrder(RecordStore* orders, const Order* o) {
+    Order* slot = (Order*)storeAppend(orders);
+    if (slot == NULL) {
+        statusPrintf("Not enough memory to load all orders.\n");
+        return false;
+    }
+    *slot = *o;
+    return true;
+}
+
+//
+// FUNCTION    : rebaseOrderLines
+// DESCRIPTION : Moves an order's line position when a piece of a parallel
+//               load is merged into the line arena
+// PARAMETERS  :
+//      void* record : Order to update (Order)
+//      int offset   : Position of the piece's first line in the arena
+// RETURNS     : void
+//
+static void rebaseOrderLines(void* record, int offset) {
+    ((Order*)record)->FirstLine += offset;
+}
+
+//
+// FUNCTION    : ingestOrderFeed
+// DESCRIPTION : Adds the orders of a feed file through the ingest pipeline
+//               and queues them for end of day. Rejected lines are listed
+//               in INGEST_REJECT_FILE.
 // PARAMETERS  :
-//      Order orders[]  : Array to store loaded orders
-//      int* orderCount : Pointer to current order count
+//      const char* filename   : Feed file, "-" for standard input
+//      RecordStore* orders    : Order store
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
 // RETURNS     : void
 //
-void loadOrderFromFile(Order orders[], int* orderCount) {
+void ingestOrderFeed(const char* filename, RecordStore* orders, RecordStore* customers,
+    RecordStore* parts) {
+    FILE* feed = stdin;
+    if (strcmp(filename, "-") != 0 && (fopen_s(&feed, filename, "rb") != 0 || feed == NULL)) {
+        printf("Error opening feed %s\n", filename);
+        return;
+    }
+
+    IngestResult result;
+    bool complete = ingestOrders(feed, INGEST_REJECT_FILE, orders, customers, parts, &result);
+    if (feed != stdin) fclose(feed);
+
+    syncOrderIndex(orders);
+    if (!syncPlacedQueue(orders, customers)) {
+        printf("Not enough memory to queue the orders; they will be queued at end of day.\n");
+    }
+    if (!complete) printf("Feed was not ingested completely.\n");
+    printf("%d orders ingested, %d lines rejected.\n", result.accepted, result.rejected);
+    if (result.rejected > 0) printf("Rejected lines are listed in %s\n", INGEST_REJECT_FILE);
+    logMessage("Order feed ingested");
+}
+
+//
+// FUNCTION    : readOrderLine
+// DESCRIPTION : Reads one whole line with fgets, growing the buffer until
+//               the newline fits. An order with MAX_PARTS_PER_ORDER lines
+//               is saved as one line of many kilobytes.
+// PARAMETERS  :
+//      FILE* file        : File to read
+//      char** line       : Line buffer (malloc'd), replaced when grown and
+//                          freed and set to NULL if it cannot grow
+//      size_t* capacity  : Size of the buffer, updated when grown
+// RETURNS     : bool - false at the end of the file or if out of memory
+//
+static bool readOrderLine(FILE* file, char** line, size_t* capacity) {
+    size_t length = 0;
+
+    for (;;) {
+        if (fgets(*line + length, (int)(*capacity - length), file) == NULL) return length > 0;
+        length += strlen(*line + length);
+        if (length > 0 && (*line)[length - 1] == '\n') return true;
+        if (length + 1 < *capacity) return true;     // Last line without a newline
+
+        char* grown = (char*)realloc(*line, *capacity * 2);
+        if (grown == NULL) {
+            free(*line);
+            *line = NULL;
+            return false;
+        }
+        *line = grown;
+        *capacity *= 2;
+    }
+}
+
+//
+// FUNCTION    : loadOrdersStdio
+// DESCRIPTION : Reads orders.db line by line with fgets and strtok_s.
+//               Lines have no length limit, so every order the program
+//               saved reloads.
+// PARAMETERS  :
+//      RecordStore* orders : Order store to fill
+// RETURNS     : bool - false if the file could not be opened
+//
+static bool loadOrdersStdio(RecordStore* orders) {
     FILE* file;
     errno_t err = fopen_s(&file, "orders.db", "r");
     if (err != 0 || file == NULL) {
-        printf("Error loading orders\n");
-        return;
+        return false;
     }
 
-    char line[512];
-    *orderCount = 0;
+    size_t capacity = ORDER_LINE_BYTES;
+    char* line = (char*)malloc(capacity);
+    std::string_view* fields = new std::string_view[ORDER_MAX_FIELDS];
+    storeClear(orders);
+    storeClear(&orderLines);
+    storeReserveForFile(orders, "orders.db", ORDER_MIN_LINE);
 
-    while (fgets(line, sizeof(line), file) != NULL && *orderCount < MAX_ORDERS) {
+    while (line != NULL && readOrderLine(file, &line, &capacity)) {
         line[strcspn(line, "\r\n")] = '\0';
 
         Order o;
         char* context = NULL;
-        char* fields[6 + MAX_PARTS_PER_ORDER * 2] = { NULL };
         int fieldCount = 0;
 
         char* token = strtok_s(line, "|", &context);
-        while (token && fieldCount < 6 + MAX_PARTS_PER_ORDER * 2) {
+        while (token && fieldCount < ORDER_MAX_FIELDS) {
             fields[fieldCount++] = token;
             token = strtok_s(NULL, "|", &context);
         }
 
-        if (fieldCount < 6) continue;
-
-        if (sscanf_s(fields[0], "%ld", &o.OrderID) != 1) continue;
-
-        if (strlen(fields[1]) != 10 || !validateDate(fields[1])) continue;
-        strcpy_s(o.OrderDate, sizeof(o.OrderDate), fields[1]);
-
-        if (sscanf_s(fields[2], "%d", &o.OrderStatus) != 1) continue;
-
-        if (sscanf_s(fields[3], "%d", &o.CustomerID) != 1 || o.CustomerID <= 0) continue;
+        if (!parseOrderRecord(fields, fieldCount, &o, &orderLines)) continue;
+        if (!appendOrder(orders, &o)) {
+            storeResize(&orderLines, o.FirstLine);
+            break;
+        }
+    }
 
-        if (sscanf_s(fields[4], "%f", &o.OrderTotal) != 1 || o.OrderTotal <= 0.0f) continue;
+    if (line == NULL) statusPrintf("Not enough memory to load all orders.\n");
+    delete[] fields;
+    free(line);
+    fclose(file);
+    return true;
+}
 
-        if (sscanf_s(fields[5], "%d", &o.DistinctParts) != 1 || o.DistinctParts < 1) continue;
+//
+// FUNCTION    : loadOrdersMapped
+// DESCRIPTION : Reads orders.db through a read-only memory mapping. Fields
+//               are validated in place; large files are parsed on several
+//               threads and merged back in file order.
+// PARAMETERS  :
+//      RecordStore* orders : Order store to fill
+// RETURNS     : bool - false if the file could not be mapped
+//
+static bool loadOrdersMapped(RecordStore* orders) {
+    MappedFile file;
+    if (!mapDbFile(&file, "orders.db")) {
+        return false;
+    }
 
-        o.TotalParts = 0;
-        int itemIndex = 0;
-        for (int i = 6; i < fieldCount && itemIndex < o.DistinctParts; i += 2) {
-            if (sscanf_s(fields[i], "%d", &o.Items[itemIndex].PartID) != 1 || o.Items[itemIndex].PartID <= 0) break;
-            if (sscanf_s(fields[i + 1], "%d", &o.Items[itemIndex].NumberOfParts) != 1 || o.Items[itemIndex].NumberOfParts < 1) break;
+    storeClear(orders);
+    storeClear(&orderLines);
+    storeReserveForFile(orders, "orders.db", ORDER_MIN_LINE);
 
-            o.TotalParts += o.Items[itemIndex].NumberOfParts;
-            itemIndex++;
-        }
+    DbExtraData lines = { &orderLines, rebaseOrderLines };
+    if (!loadDbRecords(&file, DB_CUT_AT_CR, ORDER_MAX_FIELDS, parseOrderRecord, orders, &lines)) {
+        statusPrintf("Not enough memory to load all orders.\n");
+    }
 
-        if (itemIndex != o.DistinctParts) continue;
+    unmapDbFile(&file);
+    return true;
+}
 
-        orders[*orderCount] = o;
-        (*orderCount)++;
+//
+// FUNCTION    : loadOrderFromFile
+// DESCRIPTION : Loads orders from file with validation, replacing the
+//               contents of the store, and queues the placed orders for
+//               end of day. Uses the reader set by dbLoadMode and falls
+//               back to stdio if the file cannot be mapped.
+// PARAMETERS  :
+//      RecordStore* orders    : Order store to fill
+//      RecordStore* customers : Customer store (for order priorities), NULL
+//                               to queue the orders later (queueOrders)
+// RETURNS     : void
+//
+void loadOrderFromFile(RecordStore* orders, RecordStore* customers) {
+    bool loaded = dbLoadMode == DB_LOAD_MAPPED && loadOrdersMapped(orders);
+    if (!loaded && !loadOrdersStdio(orders)) {
+        statusPrintf("Error loading orders\n");
+        return;
     }
 
-    fclose(file);
-    printf("Loaded %d orders from orders.db\n", *orderCount);
+    indexOrders(orders);
+    if (customers != NULL) queuePlacedOrders(orders, customers);
+    else orderQueueReset(&placedQueue, NULL);
+    backorderReset(&backorders, NULL);
+    walLogReload(SNAPSHOT_ORDERS);
+    statusPrintf("Loaded %d orders from orders.db\n", orders->count);
     logMessage("Order database loaded");
 }
 
 //
 // FUNCTION    : saveOrderToFile
-// DESCRIPTION : Saves all orders to file in pipe-delimited format
+// DESCRIPTION : Saves all orders to file in pipe-delimited format. With
+//               lazy start it first waits for the mapped snapshots to be
+//               checked.
 // PARAMETERS  :
-//      Order orders[]  : Array of order records to save
-//      int orderCount  : Number of orders to save
+//      RecordStore* orders : Order store to save
 // RETURNS     : void
 //
-void saveOrderToFile(Order orders[], int orderCount) {
+void saveOrderToFile(RecordStore* orders) {
+    warmupWait();
     FILE* file;
     errno_t err = fopen_s(&file, "orders.db", "w");
     if (err != 0 || file == NULL) {
@@ -559,42 +1321,241 @@ void saveOrderToFile(Order orders[], int orderCount) {
         return;
     }
 
-    for (int i = 0; i < orderCount; i++) {
-        fprintf(file, "%ld|%s|%d|%d|%.2f|%d",
-            orders[i].OrderID,
-            orders[i].OrderDate,
-            orders[i].OrderStatus,
-            orders[i].CustomerID,
-            orders[i].OrderTotal,
-            orders[i].DistinctParts);
-
-        for (int j = 0; j < orders[i].DistinctParts; j++) {
-            fprintf(file, "|%d|%d",
-                orders[i].Items[j].PartID,
-                orders[i].Items[j].NumberOfParts);
+    for (int i = 0; i < orders->count; i++) {
+        const Order* order = orderAt(orders, i);
+        fprintf(file, "%lld|%s|%d|%d|%.2f|%d",
+            order->OrderID,
+            order->OrderDate,
+            order->OrderStatus,
+            order->CustomerID,
+            order->OrderTotal,
+            order->DistinctParts);
+
+        for (int j = 0; j < order->DistinctParts; j++) {
+            const OrderItem* item = orderLine(order, j);
+            fprintf(file, "|%d|%d", item->PartID, item->NumberOfParts);
         }
 
         fprintf(file, "\n");
     }
 
     fclose(file);
-    printf("Saved %d orders records to orders.db.\n", orderCount);
+    printf("Saved %d orders records to orders.db.\n", orders->count);
     logMessage("Order database saved");
 }
 
+//
+// FUNCTION    : checkOrderLines
+// DESCRIPTION : Warm-up check of a mapped orders.snap: every order's lines
+//               must be in the line snapshot, as loadOrderSnapshot checks
+//               when it reads the file
+// PARAMETERS  :
+//      const char* data  : Contents of orders.snap
+//      size_t size       : Size of the file
+//      long long context : Records in orderlines.snap
+// RETURNS     : bool - true if every order's lines are in range
+//
+static bool checkOrderLines(const char* data, size_t size, long long context) {
+    if (size < SNAPSHOT_DATA_OFFSET) return false;
+
+    size_t count = (size - SNAPSHOT_DATA_OFFSET) / sizeof(Order);
+    for (size_t i = 0; i < count; i++) {
+        Order order;
+        memcpy(&order, data + SNAPSHOT_DATA_OFFSET + i * sizeof(Order), sizeof(order));
+        if (order.FirstLine < 0 || order.DistinctParts < 0 ||
+            order.DistinctParts > context - order.FirstLine) return false;
+    }
+    return true;
+}
+
+//
+// FUNCTION    : mapOrderSnapshot
+// DESCRIPTION : Lazy start-up (pwh -l): maps orders.snap, orderlines.snap
+//               and the order ID index saved with them instead of reading
+//               them. The placed-order queue and the backorder index are
+//               left unbound, so they are built when first needed. An ID
+//               index that is missing, damaged or from another snapshot
+//               is rebuilt and saved for the next start.
+// PARAMETERS  :
+//      RecordStore* orders : Empty order store to fill
+// RETURNS     : bool - false if the snapshots could not be mapped
+//
+static bool mapOrderSnapshot(RecordStore* orders) {
+    unsigned long long tag;
+    if (!mapSnapshot(ORDER_SNAPSHOT_FILE, SNAPSHOT_ORDERS, orders, &tag, true) ||
+        !mapSnapshot(ORDER_LINES_SNAPSHOT_FILE, SNAPSHOT_ORDER_LINES, &orderLines, NULL, true) ||
+        !warmupAdd(ORDER_SNAPSHOT_FILE, NULL, 0, checkOrderLines, orderLines.count, false)) {
+        storeFree(orders);
+        storeFree(&orderLines);
+        return false;
+    }
+
+    long long largestId;
+    if (idIndexMap(&orderIndex, ORDER_INDEX_FILE, tag, orders, orders->count, &largestId)) {
+        orderIdObserve(largestId);
+    }
+    else {
+        indexOrders(orders);
+        idIndexSave(&orderIndex, ORDER_INDEX_FILE, tag);
+    }
+    orderQueueReset(&placedQueue, NULL);
+    backorderReset(&backorders, NULL);
+
+    statusPrintf("Mapped %d orders from orders.snap\n", orders->count);
+    logMessage("Order snapshot mapped");
+    return true;
+}
+
+//
+// FUNCTION    : loadOrderSnapshot
+// DESCRIPTION : Loads orders from orders.snap and their lines from
+//               orderlines.snap when both are at least as new as orders.db,
+//               replacing the contents of the store, and queues the placed
+//               orders for end of day. With lazy start the snapshots are
+//               mapped instead.
+// PARAMETERS  :
+//      RecordStore* orders    : Order store to fill
+//      RecordStore* customers : Customer store (for order priorities), NULL
+//                               to queue the orders later (queueOrders)
+// RETURNS     : bool - false if there is no usable snapshot, in which case
+//               orders.db should be imported instead
+//
+bool loadOrderSnapshot(RecordStore* orders, RecordStore* customers) {
+    if (!snapshotIsCurrent(ORDER_SNAPSHOT_FILE, "orders.db") ||
+        !snapshotIsCurrent(ORDER_LINES_SNAPSHOT_FILE, "orders.db")) return false;
+    if (lazyStart && mapOrderSnapshot(orders)) return true;
+
+    if (!loadSnapshot(ORDER_SNAPSHOT_FILE, SNAPSHOT_ORDERS, orders) ||
+        !loadSnapshot(ORDER_LINES_SNAPSHOT_FILE, SNAPSHOT_ORDER_LINES, &orderLines)) {
+        statusPrintf("Ignoring unusable orders.snap, importing orders.db\n");
+        return false;
+    }
+
+    // Every order's lines must be in the line snapshot
+    for (int i = 0; i < orders->count; i++) {
+        const Order* order = orderAt(orders, i);
+        if (order->FirstLine < 0 || order->DistinctParts < 0 ||
+            order->DistinctParts > orderLines.count - order->FirstLine) {
+            statusPrintf("Ignoring unusable orders.snap, importing orders.db\n");
+            return false;
+        }
+    }
+
+    indexOrders(orders);
+    if (customers != NULL) queuePlacedOrders(orders, customers);
+    else orderQueueReset(&placedQueue, NULL);
+    backorderReset(&backorders, NULL);
+    statusPrintf("Loaded %d orders from orders.snap\n", orders->count);
+    logMessage("Order snapshot loaded");
+    return true;
+}
+
+//
+// FUNCTION    : saveOrderSnapshot
+// DESCRIPTION : Saves all orders to orders.snap and their lines to
+//               orderlines.snap (and the order ID index with lazy start).
+//               The lines are written first; a failed write removes its
+//               file, so a later start imports orders.db.
+// PARAMETERS  :
+//      RecordStore* orders : Order store to save
+// RETURNS     : bool - true on success
+//
+bool saveOrderSnapshot(RecordStore* orders) {
+    if (!saveSnapshot(ORDER_LINES_SNAPSHOT_FILE, SNAPSHOT_ORDER_LINES, &orderLines) ||
+        !saveSnapshot(ORDER_SNAPSHOT_FILE, SNAPSHOT_ORDERS, orders)) {
+        printf("Error saving orders.snap.\n");
+        return false;
+    }
+    saveOrderIndex(orders);
+
+    printf("Saved %d orders to orders.snap\n", orders->count);
+    logMessage("Order snapshot saved");
+    return true;
+}
+
+//
+// FUNCTION    : saveOrderIndex
+// DESCRIPTION : With lazy start, builds the ID index of an order store
+//               just saved to orders.snap and saves it beside it. Does
+//               nothing otherwise.
+// PARAMETERS  :
+//      const RecordStore* orders : Store as saved to the snapshot
+// RETURNS     : void
+//
+void saveOrderIndex(const RecordStore* orders) {
+    unsigned long long tag;
+    if (!lazyStart || !snapshotTag(ORDER_SNAPSHOT_FILE, &tag)) return;
+
+    IdIndex index;
+    memset(&index, 0, sizeof(index));
+    idIndexReset(&index, orders, orders->count);
+    for (int i = 0; i < orders->count; i++) {
+        idIndexInsert(&index, orderAt(orders, i)->OrderID, i);
+    }
+    idIndexSave(&index, ORDER_INDEX_FILE, tag);
+    idIndexFree(&index);
+}
+
+//
+// FUNCTION    : replayOrder
+// DESCRIPTION : Applies a new order from the write-ahead log. An order
+//               that is already in the store only takes the logged status.
+// PARAMETERS  :
+//      RecordStore* orders    : Order store
+//      const Order* order     : Logged order
+//      const OrderItem* items : Its DistinctParts lines
+// RETURNS     : bool - false if out of memory
+//
+bool replayOrder(RecordStore* orders, const Order* order, const OrderItem* items) {
+    if (findOrder(orders, order->OrderID) != -1) {
+        return replayOrderStatus(orders, order->OrderID, order->OrderStatus);
+    }
+
+    Order copy = *order;
+    if (!appendOrderLines(&copy, items, order->DistinctParts)) return false;
+
+    Order* slot = (Order*)storeAppend(orders);
+    if (slot == NULL) {
+        storeResize(&orderLines, copy.FirstLine);
+        return false;
+    }
+    *slot = copy;
+    orderIdObserve(copy.OrderID);
+    syncOrderIndex(orders);
+    return true;
+}
+
+//
+// FUNCTION    : replayOrderStatus
+// DESCRIPTION : Applies an order status from the write-ahead log. The
+//               placed queue and backorder index are rebuilt on next use.
+// PARAMETERS  :
+//      RecordStore* orders : Order store
+//      long long orderID   : Order to update
+//      int status          : Logged status
+// RETURNS     : bool - true (an unknown order is skipped)
+//
+bool replayOrderStatus(RecordStore* orders, long long orderID, int status) {
+    int i = findOrder(orders, orderID);
+    if (i == -1 || orderAt(orders, i)->OrderStatus == status) return true;
+
+    orderAt(orders, i)->OrderStatus = status;
+    storeMarkDirty(orders, i);
+    placedQueue.base = NULL;
+    backorders.base = NULL;
+    return true;
+}
+
 //
 // FUNCTION    : handleOrdersMenu
 // DESCRIPTION : Main order management menu interface
 // PARAMETERS  :
-//      Order orders[]      : Array of order records
-//      int* orderCount     : Pointer to current order count
-//      Customer customers[]: Array of customer records
-//      int customerCount   : Number of customers
-//      Parts parts[]       : Array of part records
-//      int partsCount      : Number of parts in inventory
+//      RecordStore* orders    : Order store
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
 // RETURNS     : void
 //
-void handleOrdersMenu(Order orders[], int* orderCount, Customer customers[], int customerCount, Parts parts[], int partsCount) {
+void handleOrdersMenu(RecordStore* orders, RecordStore* customers, RecordStore* parts) {
     int choice;
     char buffer[100];
 
@@ -608,22 +1569,36 @@ void handleOrdersMenu(Order orders[], int* orderCount, Customer customers[], int
         }
 
         switch (choice) {
-        case 1: listAllOrders(orders, *orderCount); break;
+        case 1: listAllOrders(orders); break;
         case 2: {
-            long orderID;
+            long long orderID;
             printf("Enter Order ID: ");
-            if (scanf_s("%ld", &orderID) == 1) {
-                displayOrderDetails(orderID, orders, *orderCount);
+            if (scanf_s("%lld", &orderID) == 1) {
+                displayOrderDetails(orderID, orders);
             }
             while (getchar() != '\n');
             break;
         }
-        case 3: createNewOrder(orders, orderCount, customers, customerCount, parts, partsCount); break;
-        case 4: processEndOfDayOrders(orders, orderCount, customers, customerCount, parts, partsCount); break;
-        case 5: loadOrderFromFile(orders, orderCount); break;
-        case 6: saveOrderToFile(orders, *orderCount); break;
+        case 3: createNewOrder(orders, customers, parts); break;
+        case 4: processEndOfDayOrders(orders, customers, parts); break;
+        case 5: loadOrderFromFile(orders, customers); break;
+        case 6: saveOrderToFile(orders); break;
         case 7: return;
+        case 8: {
+            char filename[260];
+            printf("Enter feed file name: ");
+            if (fgets(filename, sizeof(filename), stdin) != NULL) {
+                filename[strcspn(filename, "\r\n")] = '\0';
+                ingestOrderFeed(filename, orders, customers, parts);
+            }
+            break;
+        }
         default: printf("Invalid option.\n");
         }
+        walCommit();
+        checkpointPoll();
+        repairCustomerIndex(customers);
+        repairPartIndex(parts);
+        repairOrderIndex(orders);
     } while (1);
 }
\ No newline at end of file
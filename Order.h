@@ -6,6 +6,7 @@
 * DESCRIPTION   :
 *      Header file for order management functionality including:
 *      - Order data structures
+*      - Shared arena holding the lines of every order
 *      - Order status constants
 *      - Function prototypes for order operations
 */
@@ -16,9 +17,14 @@
 #include "Customer.h"
 #include "Part.h"
 
-#define MAX_PARTS_PER_ORDER 50  // Maximum distinct parts per order
-#define MAX_ORDERS 100          // Maximum orders in system
+#define MAX_PARTS_PER_ORDER 1000 // Maximum distinct parts per order
 #define LENGTH_OF_DATE 11       // Length of date string (YYYY-MM-DD + null)
+#define ORDER_MIN_LINE 24       // Shortest valid orders.db line (for store sizing)
+#define ORDER_LINE_BYTES 512    // Starting line buffer of the stdio loader (grows to fit)
+#define ORDER_MAX_FIELDS (6 + MAX_PARTS_PER_ORDER * 2) // Header fields plus part/quantity pairs
+#define ORDER_SNAPSHOT_FILE "orders.snap" // Binary snapshot of the order store
+#define ORDER_LINES_SNAPSHOT_FILE "orderlines.snap" // Binary snapshot of the order lines
+#define ORDER_INDEX_FILE "orders.idx" // Order ID index saved with the snapshot (lazy start)
 
 // Order status constants
 #define STATUS_PLACED 0                     // Order placed but not processed
@@ -26,6 +32,19 @@
 #define STATUS_INSUFFICIENT_PARTS 99        // Order failed - not enough inventory
 #define STATUS_CREDIT_LIMIT_EXCEEDED 500    // Order failed - credit limit exceeded
 
+#define BACKORDER_ALL_PARTS -1              // fulfillBackorders after a bulk restock
+
+// Outcome of placeOrder
+typedef enum {
+    PLACE_OK,                   // Order created
+    PLACE_NO_CUSTOMER,          // Customer not found
+    PLACE_BAD_COUNT,            // Line count outside 1 to MAX_PARTS_PER_ORDER
+    PLACE_NO_PART,              // A part was not found
+    PLACE_BAD_QUANTITY,         // A quantity was below 1
+    PLACE_NO_ORDER_ID,          // No order ID left for today
+    PLACE_NO_MEMORY             // Not enough memory for the order
+} PlaceResult;
+
 // Structure for order line items
 typedef struct {
     int PartID;             // ID of ordered part
@@ -34,26 +53,74 @@ typedef struct {
 
 // Main order structure
 typedef struct {
-    long OrderID;                       // Unique order identifier
+    long long OrderID;                  // Unique order identifier (YYYYMMDD + sequence)
     char OrderDate[LENGTH_OF_DATE];     // Date order was placed
     int OrderStatus;                    // Current status of order
     int CustomerID;                     // ID of ordering customer
     float OrderTotal;                   // Total value of order
-    int DistinctParts;                  // Number of different parts in order
+    int DistinctParts;                  // Number of different parts in order (lines)
     int TotalParts;                     // Total quantity of all parts
-    OrderItem Items[MAX_PARTS_PER_ORDER]; // Array of order items
+    int FirstLine;                      // Position of the first line in orderLines
 } Order;
 
+// Lines of every order (OrderItem records), stored back to back in the
+// order the orders were added. An order's lines are the DistinctParts
+// entries from its FirstLine.
+extern RecordStore orderLines;
+
+//
+// FUNCTION    : orderAt
+// DESCRIPTION : Returns the order stored at a position
+// PARAMETERS  :
+//      const RecordStore* orders : Order store
+//      int index                : Record position
+// RETURNS     : Order* - Address of the order
+//
+inline Order* orderAt(const RecordStore* orders, int index) {
+    return (Order*)storeAt(orders, index);
+}
+
+//
+// FUNCTION    : orderLine
+// DESCRIPTION : Returns one line of an order
+// PARAMETERS  :
+//      const Order* order : Order
+//      int line           : Line number (0 to DistinctParts-1)
+// RETURNS     : OrderItem* - Address of the line
+//
+inline OrderItem* orderLine(const Order* order, int line) {
+    return (OrderItem*)storeAt(&orderLines, order->FirstLine + line);
+}
+
 // Function prototypes
-long generateOrderID();     // Generate unique order ID
-bool validateDate(const char* date);    // Validate date format
-void createNewOrder(Order orders[], int* orderCount, Customer customers[], int customerCount, Parts parts[], int partsCount);
-void displayOrderDetails(long orderID, Order orders[], int orderCount);
-void updateOrderStatus(long orderID, int newStatus, Order orders[], int orderCount);
-void listAllOrders(Order orders[], int orderCount);
-void processEndOfDayOrders(Order orders[], int* orderCount, Customer customers[], int customerCount, Parts parts[], int partsCount);
-void loadOrderFromFile(Order orders[], int* orderCount);
-void saveOrderToFile(Order orders[], int orderCount);
-void handleOrdersMenu(Order orders[], int* orderCount, Customer customers[], int customerCount, Parts parts[], int partsCount);
+void getCurrentDate(char* dateStr);     // Current date as YYYY-MM-DD
+long long generateOrderID();    // Generate unique order ID
+bool appendOrderLines(Order* order, const OrderItem* items, int count); // Store an order's lines
+bool validateDate(std::string_view date);   // Validate date format
+void createNewOrder(RecordStore* orders, RecordStore* customers, RecordStore* parts);
+PlaceResult placeOrder(RecordStore* orders, RecordStore* customers, RecordStore* parts,
+    int customerID, const OrderItem* items, int count); // Create an order without prompting
+void printPlaceResult(PlaceResult result, RecordStore* orders); // Report the outcome of placeOrder
+void displayOrderDetails(long long orderID, RecordStore* orders);
+void updateOrderStatus(long long orderID, int newStatus, RecordStore* orders);
+void listAllOrders(RecordStore* orders);
+void indexOrders(RecordStore* orders);                  // Rebuild order ID index
+void repairOrderIndex(RecordStore* orders);             // Rebuild the index if the warm-up check failed it
+int findOrder(RecordStore* orders, long long orderID);  // Find order position by ID
+void processEndOfDayOrders(RecordStore* orders, RecordStore* customers, RecordStore* parts);
+void fulfillBackorders(RecordStore* orders, RecordStore* customers, RecordStore* parts,
+    int partID);                                        // Retry orders waiting on a restocked part
+bool ordersWaitOn(RecordStore* orders, int partID);     // Some order waits on a part
+void ingestOrderFeed(const char* filename, RecordStore* orders, RecordStore* customers,
+    RecordStore* parts);                                // Add the orders of a feed file ("-" = stdin)
+void loadOrderFromFile(RecordStore* orders, RecordStore* customers);
+void saveOrderToFile(RecordStore* orders);
+bool loadOrderSnapshot(RecordStore* orders, RecordStore* customers); // Load orders from snapshot
+bool saveOrderSnapshot(RecordStore* orders);            // Save orders to snapshot
+void saveOrderIndex(const RecordStore* orders);         // Save the ID index for a saved snapshot
+void queueOrders(RecordStore* orders, RecordStore* customers); // Queue orders loaded without customers
+bool replayOrder(RecordStore* orders, const Order* order, const OrderItem* items); // Apply a logged new order
+bool replayOrderStatus(RecordStore* orders, long long orderID, int status);        // Apply a logged status
+void handleOrdersMenu(RecordStore* orders, RecordStore* customers, RecordStore* parts);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,212 @@
+/*
+* FILE          : OrderId.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of the order ID allocator including:
+*      - One atomic increment per ID on the fast path
+*      - Block reservation written to ORDER_ID_FILE before use
+*      - Seeding of each date's sequence from loaded orders and the mark
+*      An ID is YYYYMMDD * ORDER_ID_SEQUENCE_SPAN + sequence, with the
+*      sequence starting at 1 each day. Only the slow path (a new day or an
+*      exhausted block) takes a lock.
+*/
+
+#include "OrderId.h"
+#include "Snapshot.h"
+#include <stdio.h>
+#include <time.h>
+#include <atomic>
+#include <mutex>
+
+#define ORDER_ID_TEMP_FILE ORDER_ID_FILE ".tmp"    // Mark being written
+
+static std::atomic<long long> nextID(0);       // Next ID of the current day
+static std::atomic<long long> reservedEnd(0);  // IDs below this are covered by the mark
+static std::atomic<long long> dayBase(0);      // Current date * ORDER_ID_SEQUENCE_SPAN
+static std::atomic<long long> dayEnds(0);      // time_t the current day ends, 0 before first use
+static std::atomic<long long> highestSeen(0);  // Highest ID passed to orderIdObserve
+static std::mutex reserveMutex;                // Serializes new days and reservations
+static long long savedMark = -1;               // Mark in ORDER_ID_FILE, -1 until read (under reserveMutex)
+
+//
+// FUNCTION    : raiseTo
+// DESCRIPTION : Raises an atomic value to at least a floor
+// PARAMETERS  :
+//      std::atomic<long long>* value : Value to raise
+//      long long floor               : Smallest value wanted
+// RETURNS     : void
+//
+static void raiseTo(std::atomic<long long>* value, long long floor) {
+    long long current = value->load();
+    while (current < floor && !value->compare_exchange_weak(current, floor)) {
+    }
+}
+
+//
+// FUNCTION    : readMarkFile
+// DESCRIPTION : Reads the mark stored in one file
+// PARAMETERS  :
+//      const char* filename : File to read
+// RETURNS     : long long - Stored mark, 0 if the file is missing or damaged
+//
+static long long readMarkFile(const char* filename) {
+    FILE* file;
+    if (fopen_s(&file, filename, "r") != 0 || file == NULL) return 0;
+
+    char line[64];
+    long long mark = 0;
+    if (fgets(line, sizeof(line), file) == NULL || sscanf_s(line, "%lld", &mark) != 1 || mark < 0) {
+        mark = 0;
+    }
+    fclose(file);
+    return mark;
+}
+
+//
+// FUNCTION    : readMark
+// DESCRIPTION : Reads the persisted high-water mark. A temporary file left
+//               by an interrupted write is also checked.
+// PARAMETERS  : None
+// RETURNS     : long long - Highest mark found, 0 if none
+//
+static long long readMark() {
+    long long mark = readMarkFile(ORDER_ID_FILE);
+    long long pending = readMarkFile(ORDER_ID_TEMP_FILE);
+    return pending > mark ? pending : mark;
+}
+
+//
+// FUNCTION    : writeMark
+// DESCRIPTION : Persists a high-water mark. The mark is written to a
+//               temporary file, synced, and moved over ORDER_ID_FILE, so
+//               even after a power loss one of the two files holds a
+//               complete mark.
+// PARAMETERS  :
+//      long long mark : IDs below this may be handed out
+// RETURNS     : bool - false if the mark could not be written
+//
+static bool writeMark(long long mark) {
+    FILE* file;
+    if (fopen_s(&file, ORDER_ID_TEMP_FILE, "w") != 0 || file == NULL) return false;
+
+    bool written = fprintf(file, "%lld\n", mark) > 0 && syncFile(file);
+    written = fclose(file) == 0 && written;
+    if (!written) {
+        remove(ORDER_ID_TEMP_FILE);
+        return false;
+    }
+
+    return replaceFile(ORDER_ID_TEMP_FILE, ORDER_ID_FILE);
+}
+
+//
+// FUNCTION    : startDay
+// DESCRIPTION : Points the allocator at the date of a time. The sequence
+//               continues after the persisted mark and the highest
+//               observed ID when they fall on that date. Nothing is
+//               reserved yet. Called with reserveMutex held.
+// PARAMETERS  :
+//      time_t now : Current time
+// RETURNS     : void
+//
+static void startDay(time_t now) {
+    struct tm tm;
+    localtime_s(&tm, &now);
+    long long base = ((tm.tm_year + 1900) * 10000LL + (tm.tm_mon + 1) * 100 + tm.tm_mday) * ORDER_ID_SEQUENCE_SPAN;
+    long long last = base + ORDER_ID_SEQUENCE_SPAN - 1;
+
+    tm.tm_mday++;
+    tm.tm_hour = 0;
+    tm.tm_min = 0;
+    tm.tm_sec = 0;
+    tm.tm_isdst = -1;
+    time_t ends = mktime(&tm);
+
+    // Close the fast path while the counters move to the new date
+    reservedEnd.store(0);
+    dayBase.store(base);
+
+    if (savedMark < 0) savedMark = readMark();
+    long long start = base + 1;
+    if (savedMark > start && savedMark <= last) start = savedMark;
+    long long seen = highestSeen.load();
+    if (seen >= start && seen <= last) start = seen + 1;
+
+    // An ID observed for this date meanwhile may already have raised the counter
+    long long current = nextID.load();
+    while (!(current >= start && current <= last + 1) && !nextID.compare_exchange_weak(current, start)) {
+    }
+
+    dayEnds.store((long long)ends);
+}
+
+//
+// FUNCTION    : reserveBlock
+// DESCRIPTION : Persists a new mark ORDER_ID_BLOCK past the counter unless
+//               another thread already did. Called with reserveMutex held.
+// PARAMETERS  : None
+// RETURNS     : bool - false if the day's sequence is used up or the mark
+//               could not be written
+//
+static bool reserveBlock() {
+    long long next = nextID.load();
+    if (next < reservedEnd.load()) return true;
+
+    long long dayEnd = dayBase.load() + ORDER_ID_SEQUENCE_SPAN;
+    if (next >= dayEnd) return false;
+
+    long long mark = next + ORDER_ID_BLOCK;
+    if (mark > dayEnd) mark = dayEnd;
+    if (!writeMark(mark)) return false;
+
+    savedMark = mark;
+    reservedEnd.store(mark);
+    return true;
+}
+
+//
+// FUNCTION    : orderIdNext
+// DESCRIPTION : Allocates a new order ID. Safe to call from any thread; an
+//               ID inside the reserved block costs one atomic increment.
+// PARAMETERS  : None
+// RETURNS     : long long - New order ID, ORDER_ID_NONE if the day's
+//               sequence is used up or the mark could not be saved
+//
+long long orderIdNext() {
+    for (;;) {
+        // The counter is checked first so IDs are not burnt while no block is reserved
+        if ((long long)time(NULL) < dayEnds.load() && nextID.load() < reservedEnd.load()) {
+            long long id = nextID.fetch_add(1);
+            if (id < reservedEnd.load() && id > dayBase.load()) return id;
+        }
+
+        std::lock_guard<std::mutex> lock(reserveMutex);
+        time_t now = time(NULL);
+        if ((long long)now >= dayEnds.load()) startDay(now);
+        if (!reserveBlock()) return ORDER_ID_NONE;
+    }
+}
+
+//
+// FUNCTION    : orderIdObserve
+// DESCRIPTION : Notes the ID of an order that already exists. IDs of the
+//               current date move the sequence past them; the highest ID
+//               seen is kept for when a new date starts.
+// PARAMETERS  :
+//      long long orderID : Existing order ID
+// RETURNS     : void
+//
+void orderIdObserve(long long orderID) {
+    if (orderID <= 0) return;
+    raiseTo(&highestSeen, orderID);
+
+    if (dayEnds.load() == 0) {
+        std::lock_guard<std::mutex> lock(reserveMutex);
+        if (dayEnds.load() == 0) startDay(time(NULL));
+    }
+
+    long long base = dayBase.load();
+    if (orderID > base && orderID < base + ORDER_ID_SEQUENCE_SPAN) raiseTo(&nextID, orderID + 1);
+}
@@ -0,0 +1,28 @@
+/*
+* FILE          : OrderId.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for the order ID allocator including:
+*      - Date-based 64-bit order ID layout (YYYYMMDD then a daily sequence)
+*      - Lock-free allocation with a reserved, persisted high-water mark
+*      - Function prototypes for allocating IDs and seeding from loaded orders
+*      IDs are reserved in blocks of ORDER_ID_BLOCK. The end of the current
+*      block is written to ORDER_ID_FILE before any ID of the block is
+*      handed out, so a restart (even after a crash) never reuses an ID.
+*/
+
+#ifndef ORDERID_H
+#define ORDERID_H
+
+#define ORDER_ID_FILE "orderid.dat"         // Persisted high-water mark
+#define ORDER_ID_SEQUENCE_SPAN 1000000LL    // Daily sequence numbers per date (6 digits)
+#define ORDER_ID_BLOCK 1000                 // IDs reserved per write of ORDER_ID_FILE
+#define ORDER_ID_NONE 0LL                   // No ID could be allocated
+
+// Function prototypes
+long long orderIdNext();                    // Allocate the next order ID, ORDER_ID_NONE on failure
+void orderIdObserve(long long orderID);     // Note an existing ID so it is never handed out
+
+#endif
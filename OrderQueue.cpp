@@ -0,0 +1,190 @@
+/*
+* FILE          : OrderQueue.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of the pending order queue including:
+*      - Binary min-heap ordered by key, then store position
+*      - Linear-time heap construction for bulk loads
+*/
+
+#include "OrderQueue.h"
+#include <stdlib.h>
+
+//
+// FUNCTION    : entryBefore
+// DESCRIPTION : Heap order: lower key first, then lower store position, so
+//               equal keys keep the order of the store
+// PARAMETERS  :
+//      const OrderQueueEntry* a : First entry
+//      const OrderQueueEntry* b : Second entry
+// RETURNS     : bool - true if a comes out before b
+//
+static inline bool entryBefore(const OrderQueueEntry* a, const OrderQueueEntry* b) {
+    if (a->key != b->key) return a->key < b->key;
+    return a->position < b->position;
+}
+
+//
+// FUNCTION    : siftDown
+// DESCRIPTION : Moves an entry down until neither child comes before it
+// PARAMETERS  :
+//      OrderQueue* queue : Queue to fix
+//      int i             : Entry to move
+// RETURNS     : void
+//
+static void siftDown(OrderQueue* queue, int i) {
+    OrderQueueEntry* entries = queue->entries;
+    OrderQueueEntry moving = entries[i];
+
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= queue->count) break;
+        if (child + 1 < queue->count && entryBefore(&entries[child + 1], &entries[child])) child++;
+        if (!entryBefore(&entries[child], &moving)) break;
+
+        entries[i] = entries[child];
+        i = child;
+    }
+    entries[i] = moving;
+}
+
+//
+// FUNCTION    : siftUp
+// DESCRIPTION : Moves an entry up until its parent comes before it
+// PARAMETERS  :
+//      OrderQueue* queue : Queue to fix
+//      int i             : Entry to move
+// RETURNS     : void
+//
+static void siftUp(OrderQueue* queue, int i) {
+    OrderQueueEntry* entries = queue->entries;
+    OrderQueueEntry moving = entries[i];
+
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!entryBefore(&moving, &entries[parent])) break;
+
+        entries[i] = entries[parent];
+        i = parent;
+    }
+    entries[i] = moving;
+}
+
+//
+// FUNCTION    : orderQueueInit
+// DESCRIPTION : Prepares an empty queue that is not bound to a store
+// PARAMETERS  :
+//      OrderQueue* queue : Queue to initialize
+// RETURNS     : void
+//
+void orderQueueInit(OrderQueue* queue) {
+    queue->entries = NULL;
+    queue->capacity = 0;
+    orderQueueReset(queue, NULL);
+}
+
+//
+// FUNCTION    : orderQueueReset
+// DESCRIPTION : Empties a queue and binds it to an order store. Memory is
+//               kept for reuse.
+// PARAMETERS  :
+//      OrderQueue* queue : Queue to reset
+//      const void* base  : Order store the positions will refer to
+// RETURNS     : void
+//
+void orderQueueReset(OrderQueue* queue, const void* base) {
+    queue->count = 0;
+    queue->base = base;
+    queue->queuedRecords = 0;
+    queue->keysCurrent = true;
+    queue->keyVersion = 0;
+}
+
+//
+// FUNCTION    : orderQueueFree
+// DESCRIPTION : Releases queue memory and leaves the queue empty and unbound
+// PARAMETERS  :
+//      OrderQueue* queue : Queue to free
+// RETURNS     : void
+//
+void orderQueueFree(OrderQueue* queue) {
+    free(queue->entries);
+    orderQueueInit(queue);
+}
+
+//
+// FUNCTION    : orderQueueAppend
+// DESCRIPTION : Adds an entry at the end of the heap array without
+//               restoring heap order. Call orderQueueHeapify after a run of
+//               appends; this is cheaper than pushing each entry.
+// PARAMETERS  :
+//      OrderQueue* queue : Queue to add to
+//      long long key     : Priority key
+//      int position      : Store position of the order
+// RETURNS     : bool - false if out of memory
+//
+bool orderQueueAppend(OrderQueue* queue, long long key, int position) {
+    if (queue->count == queue->capacity) {
+        int capacity = queue->capacity > 0 ? queue->capacity * 2 : ORDERQUEUE_MIN_ENTRIES;
+        OrderQueueEntry* entries = (OrderQueueEntry*)realloc(queue->entries, sizeof(OrderQueueEntry) * (size_t)capacity);
+        if (entries == NULL) return false;
+
+        queue->entries = entries;
+        queue->capacity = capacity;
+    }
+
+    queue->entries[queue->count].key = key;
+    queue->entries[queue->count].position = position;
+    queue->count++;
+    return true;
+}
+
+//
+// FUNCTION    : orderQueueHeapify
+// DESCRIPTION : Rebuilds heap order over every entry in linear time
+// PARAMETERS  :
+//      OrderQueue* queue : Queue to order
+// RETURNS     : void
+//
+void orderQueueHeapify(OrderQueue* queue) {
+    for (int i = queue->count / 2 - 1; i >= 0; i--) {
+        siftDown(queue, i);
+    }
+}
+
+//
+// FUNCTION    : orderQueuePush
+// DESCRIPTION : Adds an entry and keeps heap order
+// PARAMETERS  :
+//      OrderQueue* queue : Queue to add to
+//      long long key     : Priority key
+//      int position      : Store position of the order
+// RETURNS     : bool - false if out of memory
+//
+bool orderQueuePush(OrderQueue* queue, long long key, int position) {
+    if (!orderQueueAppend(queue, key, position)) return false;
+    siftUp(queue, queue->count - 1);
+    return true;
+}
+
+//
+// FUNCTION    : orderQueuePop
+// DESCRIPTION : Removes the entry that comes out first
+// PARAMETERS  :
+//      OrderQueue* queue      : Queue to take from
+//      OrderQueueEntry* entry : Receives the removed entry
+// RETURNS     : bool - false if the queue is empty
+//
+bool orderQueuePop(OrderQueue* queue, OrderQueueEntry* entry) {
+    if (queue->count == 0) return false;
+
+    *entry = queue->entries[0];
+    queue->count--;
+    if (queue->count > 0) {
+        queue->entries[0] = queue->entries[queue->count];
+        siftDown(queue, 0);
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+/*
+* FILE          : OrderQueue.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for the pending order queue including:
+*      - Compile-time selection of the end-of-day priority policy
+*      - Binary min-heap of (priority key, store position) entries
+*      - Function prototypes for queue maintenance
+*/
+
+#ifndef ORDERQUEUE_H
+#define ORDERQUEUE_H
+
+#define ORDERQUEUE_MIN_ENTRIES 64       // Smallest entry array allocated
+
+// End-of-day priority policies. Build with ORDER_PRIORITY set to one of
+// these to change which placed orders are fulfilled first.
+#define ORDER_PRIORITY_JOIN_DATE 1      // Oldest customers first (default)
+#define ORDER_PRIORITY_FIFO 2           // Order they were placed in
+#define ORDER_PRIORITY_VALUE 3          // Largest order total first
+
+#ifndef ORDER_PRIORITY
+#define ORDER_PRIORITY ORDER_PRIORITY_JOIN_DATE
+#endif
+
+#if ORDER_PRIORITY != ORDER_PRIORITY_JOIN_DATE && ORDER_PRIORITY != ORDER_PRIORITY_FIFO && \
+    ORDER_PRIORITY != ORDER_PRIORITY_VALUE
+#error "ORDER_PRIORITY must be ORDER_PRIORITY_JOIN_DATE, ORDER_PRIORITY_FIFO or ORDER_PRIORITY_VALUE"
+#endif
+
+// One queued order. Lower keys come out first; equal keys come out in
+// store order.
+typedef struct {
+    long long key;              // Priority key from the selected policy
+    int position;               // Position of the order in the order store
+} OrderQueueEntry;
+
+// Queue of placed orders bound to one order store
+typedef struct {
+    OrderQueueEntry* entries;   // Heap array
+    int count;                  // Entries in the heap
+    int capacity;               // Entries allocated
+    const void* base;           // Order store the positions refer to
+    int queuedRecords;          // Orders of base already considered for the queue
+    bool keysCurrent;           // Keys match the data they were computed from
+    unsigned int keyVersion;    // Version of the data the keys were computed from
+} OrderQueue;
+
+// Function prototypes
+void orderQueueInit(OrderQueue* queue);                                    // Prepare an empty, unbound queue
+void orderQueueReset(OrderQueue* queue, const void* base);                 // Empty queue and bind it to a store
+void orderQueueFree(OrderQueue* queue);                                    // Release queue memory
+bool orderQueueAppend(OrderQueue* queue, long long key, int position);     // Add entry without ordering
+void orderQueueHeapify(OrderQueue* queue);                                 // Restore order after appends or key changes
+bool orderQueuePush(OrderQueue* queue, long long key, int position);       // Add entry in order
+bool orderQueuePop(OrderQueue* queue, OrderQueueEntry* entry);             // Remove the first entry
+
+#endif
@@ -12,36 +12,125 @@
 */
 
 #include "Part.h"
+#include "Order.h"
 #include "System.h"
+#include "IdIndex.h"
+#include "Inventory.h"
+#include "DbReader.h"
+#include "Snapshot.h"
+#include "Wal.h"
+#include "Checkpoint.h"
+#include "Warmup.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
+static IdIndex partIndex;   // Part ID -> position in the part store
+
+//
+// FUNCTION    : indexParts
+// DESCRIPTION : Rebuilds the part ID index from the part store
+// PARAMETERS  :
+//      RecordStore* parts : Part store
+// RETURNS     : void
+//
+void indexParts(RecordStore* parts) {
+    idIndexReset(&partIndex, parts, parts->count);
+    for (int i = 0; i < parts->count; i++) {
+        idIndexInsert(&partIndex, partAt(parts, i)->PartID, i);
+    }
+    partIndex.indexedRecords = parts->count;
+}
+
+//
+// FUNCTION    : repairPartIndex
+// DESCRIPTION : Rebuilds the part ID index if the warm-up thread found
+//               the mapped parts.idx damaged. Called between commands.
+// PARAMETERS  :
+//      RecordStore* parts : Part store
+// RETURNS     : void
+//
+void repairPartIndex(RecordStore* parts) {
+    if (warmupRebuildNeeded(PART_INDEX_FILE)) indexParts(parts);
+}
+
+//
+// FUNCTION    : syncPartIndex
+// DESCRIPTION : Brings the part ID index up to date with the store. Parts
+//               appended since the last call are inserted; a different store
+//               or a shrunken count triggers a full rebuild.
+// PARAMETERS  :
+//      RecordStore* parts : Part store
+// RETURNS     : void
+//
+static void syncPartIndex(RecordStore* parts) {
+    if (partIndex.base != parts || partIndex.indexedRecords > parts->count) {
+        indexParts(parts);
+        return;
+    }
+    while (partIndex.indexedRecords < parts->count) {
+        int i = partIndex.indexedRecords++;
+        idIndexInsert(&partIndex, partAt(parts, i)->PartID, i);
+    }
+}
+
+//
+// FUNCTION    : findPart
+// DESCRIPTION : Finds a part by ID through the part ID index. A position
+//               outside the store or holding another ID means the index
+//               does not match the store; it is then rebuilt.
+// PARAMETERS  :
+//      RecordStore* parts : Part store
+//      int partID         : Part ID to find
+// RETURNS     : int - Store position of the part, -1 if not found
+//
+int findPart(RecordStore* parts, int partID) {
+    syncPartIndex(parts);
+    int position = idIndexFind(&partIndex, partID);
+    if (position == -1) return -1;
+    if (position >= 0 && position < parts->count && partAt(parts, position)->PartID == partID) {
+        return position;
+    }
+
+    indexParts(parts);
+    return idIndexFind(&partIndex, partID);
+}
+
+//
+// FUNCTION    : DisplayPart
+// DESCRIPTION : Displays full details of one part
+// PARAMETERS  :
+//      const Parts* part : Part record to display
+// RETURNS     : void
+//
+void DisplayPart(const Parts* part) {
+    printf("-------------------------------------\n");
+    printf("Part ID: %d\n", part->PartID);
+    printf("Name: %s\n", part->PartName);
+    printf("Number: %s\n", part->PartNumber);
+    printf("Location: %s\n", part->PartLocate);
+    printf("Cost: $%.2f\n", part->PartCost);
+    printf("Quantity: %d\n", part->QuantityOnHand);
+    printf("Status: %d\n", part->PartStatus);
+    printf("-------------------------------------\n");
+}
+
 //
 // FUNCTION    : ListallParts
 // DESCRIPTION : Lists all parts in inventory with full details
 // PARAMETERS  :
-//      Parts* part : Array of part records
-//      int* size   : Pointer to current inventory count
+//      RecordStore* parts : Part store
 // RETURNS     : void
 //
-void ListallParts(Parts* part, int* size) {
-    if (*size == 0) {
+void ListallParts(RecordStore* parts) {
+    if (parts->count == 0) {
         printf("No parts in inventory.\n");
         return;
     }
 
-    for (int i = 0; i < *size; i++) {
-        printf("-------------------------------------\n");
-        printf("Part ID: %d\n", part[i].PartID);
-        printf("Name: %s\n", part[i].PartName);
-        printf("Number: %s\n", part[i].PartNumber);
-        printf("Location: %s\n", part[i].PartLocate);
-        printf("Cost: $%.2f\n", part[i].PartCost);
-        printf("Quantity: %d\n", part[i].QuantityOnHand);
-        printf("Status: %d\n", part[i].PartStatus);
-        printf("-------------------------------------\n");
+    for (int i = 0; i < parts->count; i++) {
+        DisplayPart(partAt(parts, i));
     }
 }
 
@@ -49,12 +138,11 @@ void ListallParts(Parts* part, int* size) {
 // FUNCTION    : SearchforPart
 // DESCRIPTION : Searches for part by ID and displays details
 // PARAMETERS  :
-//      Parts* part : Array of part records
-//      int* size   : Pointer to current inventory count
+//      RecordStore* parts : Part store
 // RETURNS     : void
 //
-void SearchforPart(Parts* part, int* size) {
-    if (*size == 0) {
+void SearchforPart(RecordStore* parts) {
+    if (parts->count == 0) {
         printf("No parts in inventory.\n");
         return;
     }
@@ -73,41 +161,82 @@ void SearchforPart(Parts* part, int* size) {
         return;
     }
 
-    for (int i = 0; i < *size; i++) {
-        if (part[i].PartID == id) {
-            printf("-------------------------------------\n");
-            printf("Part ID: %d\n", part[i].PartID);
-            printf("Name: %s\n", part[i].PartName);
-            printf("Number: %s\n", part[i].PartNumber);
-            printf("Location: %s\n", part[i].PartLocate);
-            printf("Cost: $%.2f\n", part[i].PartCost);
-            printf("Quantity: %d\n", part[i].QuantityOnHand);
-            printf("Status: %d\n", part[i].PartStatus);
-            printf("-------------------------------------\n");
-            return;
-        }
+    int i = findPart(parts, id);
+    if (i != -1) {
+        DisplayPart(partAt(parts, i));
+        return;
     }
 
     printf("Part with ID %d not found.\n", id);
 }
 
+//
+// FUNCTION    : isValidPartLocation
+// DESCRIPTION : Checks a warehouse location has the A###-S###-L###-B### shape
+// PARAMETERS  :
+//      const char* location : Location text
+// RETURNS     : bool - true if the location has four dash-separated parts
+//
+bool isValidPartLocation(const char* location) {
+    char aisle[LOCATELINE], shelf[LOCATELINE], level[LOCATELINE], bin[LOCATELINE];
+    int parsed = sscanf_s(location, "%9[^-]-%9[^-]-%9[^-]-%9s",
+        aisle, LOCATELINE,
+        shelf, LOCATELINE,
+        level, LOCATELINE,
+        bin, LOCATELINE);
+    return parsed == 4;
+}
+
+//
+// FUNCTION    : addPartRecord
+// DESCRIPTION : Adds a new part to inventory. The status is set from the
+//               quantity on hand; a part whose ID is taken is refused.
+// PARAMETERS  :
+//      RecordStore* parts : Part store
+//      const Parts* part  : Part to add (its PartStatus is ignored)
+// RETURNS     : bool - true if the part was added
+//
+bool addPartRecord(RecordStore* parts, const Parts* part) {
+    // Check for duplicate ID
+    if (findPart(parts, part->PartID) != -1) {
+        printf("Part with ID %d already exists.\n", part->PartID);
+        return false;
+    }
+
+    // Add new part to inventory
+    Parts* slot = (Parts*)storeAppend(parts);
+    if (slot == NULL) {
+        printf("Not enough memory to add part.\n");
+        return false;
+    }
+    *slot = *part;
+
+    // Set status based on quantity
+    if (slot->QuantityOnHand > 100) {
+        slot->PartStatus = 0;
+    }
+    else {
+        slot->PartStatus = 99;
+    }
+    walLogPart(slot);
+
+    syncPartIndex(parts);
+    printf("Part added successfully with ID %d\n", slot->PartID);
+
+    logEvent(LOG_PART_ADDED, slot->PartID, slot->PartName);
+    return true;
+}
+
 //
 // FUNCTION    : AddPart
 // DESCRIPTION : Adds new part to inventory with validated input
 // PARAMETERS  :
-//      Parts* parts : Array of part records
-//      int* size    : Pointer to current inventory count
+//      RecordStore* parts : Part store
 // RETURNS     : int - Updated inventory count
 //
-int AddPart(Parts* parts, int* size) {
-    if (*size >= MAXPARTSIZE) {
-        printf("Inventory full.\n");
-        return *size;
-    }
-
+int AddPart(RecordStore* parts) {
     Parts newPart;
     char buffer[MAXIMUMLENGTH];
-    char aisle[LOCATELINE], shelf[LOCATELINE], level[LOCATELINE], bin[LOCATELINE];
 
     // Get part name
     printf("Enter Part Name: ");
@@ -115,7 +244,7 @@ int AddPart(Parts* parts, int* size) {
     buffer[strcspn(buffer, "\n")] = '\0';
     if (strlen(buffer) == 0 || strlen(buffer) > 50) {
         printf("Invalid part name.\n");
-        return *size;
+        return parts->count;
     }
     strcpy_s(newPart.PartName, sizeof(newPart.PartName), buffer);
 
@@ -125,7 +254,7 @@ int AddPart(Parts* parts, int* size) {
     buffer[strcspn(buffer, "\n")] = '\0';
     if (strlen(buffer) == 0 || strlen(buffer) > 50) {
         printf("Invalid part number.\n");
-        return *size;
+        return parts->count;
     }
     strcpy_s(newPart.PartNumber, sizeof(newPart.PartNumber), buffer);
 
@@ -135,13 +264,7 @@ int AddPart(Parts* parts, int* size) {
         fgets(buffer, MAXIMUMLENGTH, stdin);
         buffer[strcspn(buffer, "\n")] = '\0';
 
-        int parsed = sscanf_s(buffer, "%9[^-]-%9[^-]-%9[^-]-%9s",
-            aisle, LOCATELINE,
-            shelf, LOCATELINE,
-            level, LOCATELINE,
-            bin, LOCATELINE);
-
-        if (parsed == 4) {
+        if (isValidPartLocation(buffer)) {
             strcpy_s(newPart.PartLocate, sizeof(newPart.PartLocate), buffer);
             break;
         }
@@ -153,7 +276,7 @@ int AddPart(Parts* parts, int* size) {
     if (scanf_s("%f", &newPart.PartCost) != 1 || newPart.PartCost <= 0.0f) {
         printf("Invalid cost.\n");
         while (getchar() != '\n');
-        return *size;
+        return parts->count;
     }
     while (getchar() != '\n');
 
@@ -162,59 +285,34 @@ int AddPart(Parts* parts, int* size) {
     if (scanf_s("%d", &newPart.QuantityOnHand) != 1 || newPart.QuantityOnHand < 0) {
         printf("Invalid quantity.\n");
         while (getchar() != '\n');
-        return *size;
+        return parts->count;
     }
     while (getchar() != '\n');
 
-    // Set status based on quantity
-    if (newPart.QuantityOnHand > 100) {
-        newPart.PartStatus = 0;
-    }
-    else {
-        newPart.PartStatus = 99;
-    }
-
     // Get part ID
     printf("Enter Part ID: ");
     if (scanf_s("%d", &newPart.PartID) != 1 || newPart.PartID <= 0) {
         printf("Invalid ID.\n");
         while (getchar() != '\n');
-        return *size;
+        return parts->count;
     }
     while (getchar() != '\n');
 
-    // Check for duplicate ID
-    for (int i = 0; i < *size; i++) {
-        if (parts[i].PartID == newPart.PartID) {
-            printf("Part with ID %d already exists.\n", newPart.PartID);
-            return *size;
-        }
-    }
-
-    // Add new part to inventory
-    parts[*size] = newPart;
-    (*size)++;
-    printf("Part added successfully with ID %d\n", newPart.PartID);
-
-    char logMsg[256];
-    sprintf_s(logMsg, sizeof(logMsg), "New part added: ID %d, Name %s", newPart.PartID, newPart.PartName);
-    logMessage(logMsg);
-
-    return *size;
+    addPartRecord(parts, &newPart);
+    return parts->count;
 }
 
 //
 // FUNCTION    : UpdateInventoryforPart
 // DESCRIPTION : Updates inventory quantity for specified part
 // PARAMETERS  :
-//      Parts part[] : Array of part records
-//      int* size    : Pointer to current inventory count
-// RETURNS     : void
+//      RecordStore* parts : Part store
+// RETURNS     : int - ID of the part if its quantity went up, -1 otherwise
 //
-void UpdateInventoryforPart(Parts part[], int* size) {
-    if (*size == 0) {
+int UpdateInventoryforPart(RecordStore* parts) {
+    if (parts->count == 0) {
         printf("No parts in inventory.\n");
-        return;
+        return -1;
     }
 
     int id;
@@ -223,76 +321,80 @@ void UpdateInventoryforPart(Parts part[], int* size) {
     printf("Enter Part ID to update: ");
     if (!fgets(buffer, sizeof(buffer), stdin)) {
         printf("Error reading input.\n");
-        return;
+        return -1;
     }
 
     if (sscanf_s(buffer, "%d", &id) != 1) {
         printf("Invalid Part ID.\n");
-        return;
-    }
-
-    int found = -1;
-    for (int i = 0; i < *size; i++) {
-        if (part[i].PartID == id) {
-            found = i;
-            break;
-        }
+        return -1;
     }
 
+    int found = findPart(parts, id);
     if (found == -1) {
         printf("Part with ID %d not found.\n", id);
-        return;
+        return -1;
     }
 
-    printf("Current quantity: %d\n", part[found].QuantityOnHand);
+    printf("Current quantity: %d\n", inventoryOnHand(parts, found));
     printf("Enter new quantity (blank to skip): ");
 
     if (!fgets(buffer, sizeof(buffer), stdin)) {
         printf("Error reading input.\n");
-        return;
+        return -1;
     }
 
     if (buffer[0] == '\n') {
         printf("Update skipped.\n");
-        return;
+        return -1;
     }
 
     int quantity;
     if (sscanf_s(buffer, "%d", &quantity) != 1 || quantity < 0) {
         printf("Invalid quantity. Must be 0 or greater.\n");
-        return;
+        return -1;
     }
 
-    part[found].QuantityOnHand = quantity;
+    return setPartQuantity(parts, found, quantity);
+}
 
-    // Update status based on new quantity
-    if (quantity > 100) {
-        part[found].PartStatus = 0;
-    }
-    else if (quantity > 0) {
-        part[found].PartStatus = 99;
-    }
-    else {
-        part[found].PartStatus = -quantity;
-    }
+//
+// FUNCTION    : setPartQuantity
+// DESCRIPTION : Brings the quantity on hand of a part to a stock count
+//               and updates its status to match. The difference from the
+//               quantity read here is added rather than the count stored,
+//               so stock reserved at the same time is not handed out again.
+// PARAMETERS  :
+//      RecordStore* parts : Part store
+//      int position       : Store position of the part
+//      int quantity       : Counted quantity (0 or greater)
+// RETURNS     : int - ID of the part if its quantity went up, -1 otherwise
+//
+int setPartQuantity(RecordStore* parts, int position, int quantity) {
+    int current = inventoryOnHand(parts, position);
+    int id = partAt(parts, position)->PartID;
+
+    int onHand = inventoryRestock(parts, position, quantity - current);
+    storeMarkDirty(parts, position);
+    walLogPartStock(partAt(parts, position));
 
-    printf("Inventory updated successfully.\n");
+    statusPrintf("Inventory updated successfully.\n");
 
-    char logMsg[256];
-    sprintf_s(logMsg, sizeof(logMsg), "Part %d inventory updated to %d", id, quantity);
-    logMessage(logMsg);
+    logEvent(LOG_PART_INVENTORY_UPDATED, id, onHand);
+    return quantity > current ? id : -1;
 }
 
 //
 // FUNCTION    : SaveToFile
-// DESCRIPTION : Saves all parts to file in pipe-delimited format
+// DESCRIPTION : Saves all parts to file in pipe-delimited format. With
+//               lazy start it first waits for the mapped snapshots to be
+//               checked.
 // PARAMETERS  :
 //      const char* filename : Name of file to save to
-//      Parts part[]         : Array of part records
-//      int* size            : Pointer to current inventory count
+//      RecordStore* parts   : Part store
 // RETURNS     : void
 //
-void SaveToFile(const char* filename, Parts part[], int* size) {
+void SaveToFile(const char* filename, RecordStore* parts) {
+    warmupWait();
     FILE* file;
     errno_t err = fopen_s(&file, filename, "w");
     if (err != 0 || file == NULL) {
@@ -300,48 +402,113 @@ void SaveToFile(const char* filename, Parts part[], int* size) {
         return;
     }
 
-    for (int i = 0; i < *size; i++) {
+    for (int i = 0; i < parts->count; i++) {
+        const Parts* part = partAt(parts, i);
         fprintf(file, "%s|%s|%s|%.2f|%d|%d|%d\n",
-            part[i].PartName,
-            part[i].PartNumber,
-            part[i].PartLocate,
-            part[i].PartCost,
-            part[i].QuantityOnHand,
-            part[i].PartStatus,
-            part[i].PartID);
+            part->PartName,
+            part->PartNumber,
+            part->PartLocate,
+            part->PartCost,
+            part->QuantityOnHand,
+            part->PartStatus,
+            part->PartID);
     }
 
     fclose(file);
-    printf("Saved %d parts to %s\n", *size, filename);
+    printf("Saved %d parts to %s\n", parts->count, filename);
     logMessage("Parts database saved");
 }
 
 //
-// FUNCTION    : loadfromfile
-// DESCRIPTION : Loads parts from file with validation
+// FUNCTION    : copyPartField
+// DESCRIPTION : Copies a validated field into a fixed part buffer
 // PARAMETERS  :
-//      const char* filename : Name of file to load from
-//      Parts part[]         : Array to store loaded parts
-//      int* size            : Pointer to current inventory count
+//      char* dest             : Destination buffer (MAXIMUMLENGTH bytes)
+//      std::string_view field : Field text (at most 50 characters)
 // RETURNS     : void
 //
-void loadfromfile(const char* filename, Parts part[], int* size) {
+static void copyPartField(char* dest, std::string_view field) {
+    memcpy(dest, field.data(), field.size());
+    dest[field.size()] = '\0';
+}
+
+//
+// FUNCTION    : parsePartRecord
+// DESCRIPTION : Validates the fields of one parts.db line and fills a part
+//               record. Shared by both loader modes; the mapped loader
+//               calls it from several threads, so it touches no shared
+//               state.
+// PARAMETERS  :
+//      const std::string_view fields[] : Fields of the line
+//      int fieldCount                  : Number of fields
+//      void* record                    : Receives the part (Parts)
+//      RecordStore* extra              : Unused (no extra data)
+// RETURNS     : bool - true if the line holds a valid part
+//
+static bool parsePartRecord(const std::string_view fields[], int fieldCount, void* record,
+    RecordStore* extra) {
+    (void)extra;
+    Parts* p = (Parts*)record;
+    if (fieldCount != 7) return false;
+
+    if (fields[0].size() == 0 || fields[0].size() > 50) return false;
+    if (fields[1].size() == 0 || fields[1].size() > 50) return false;
+    if (fields[2].size() == 0 || fields[2].size() > 50) return false;
+
+    if (!parseFloatField(fields[3], &p->PartCost) || p->PartCost <= 0.0f) return false;
+    if (!parseIntField(fields[4], &p->QuantityOnHand) || p->QuantityOnHand < 0) return false;
+    if (!parseIntField(fields[5], &p->PartStatus)) return false;
+    if (!parseIntField(fields[6], &p->PartID) || p->PartID <= 0) return false;
+
+    copyPartField(p->PartName, fields[0]);
+    copyPartField(p->PartNumber, fields[1]);
+    copyPartField(p->PartLocate, fields[2]);
+    return true;
+}
+
+//
+// FUNCTION    : appendPart
+// DESCRIPTION : Adds a loaded part to the end of the store
+// PARAMETERS  :
+//      RecordStore* parts : Part store
+//      const Parts* p     : Part to add
+// RETURNS     : bool - true on success, false if out of memory
+//
+static bool appendPart(RecordStore* parts, const Parts* p) {
+    Parts* slot = (Parts*)storeAppend(parts);
+    if (slot == NULL) {
+        statusPrintf("Not enough memory to load all parts.\n");
+        return false;
+    }
+    *slot = *p;
+    return true;
+}
+
+//
+// FUNCTION    : loadPartsStdio
+// DESCRIPTION : Reads a parts file line by line with fgets and strtok_s
+// PARAMETERS  :
+//      const char* filename : Name of file to load from
+//      RecordStore* parts   : Part store to fill
+// RETURNS     : bool - false if the file could not be opened
+//
+static bool loadPartsStdio(const char* filename, RecordStore* parts) {
     FILE* file;
     errno_t err = fopen_s(&file, filename, "r");
     if (err != 0 || file == NULL) {
-        printf("Error loading parts\n");
-        return;
+        return false;
     }
 
     char line[MAXLINE];
-    *size = 0;
+    storeClear(parts);
+    storeReserveForFile(parts, filename, PART_MIN_LINE);
 
-    while (fgets(line, MAXLINE, file) != NULL && *size < MAXPARTSIZE) {
+    while (fgets(line, MAXLINE, file) != NULL) {
         line[strcspn(line, "\n")] = '\0';
 
         Parts p;
         char* context = NULL;
-        char* fields[7] = { NULL };
+        std::string_view fields[7];
         int fieldCount = 0;
 
         char* token = strtok_s(line, "|", &context);
@@ -350,44 +517,170 @@ void loadfromfile(const char* filename, Parts part[], int* size) {
             token = strtok_s(NULL, "|", &context);
         }
 
-        if (fieldCount != 7) continue;
+        if (!parsePartRecord(fields, fieldCount, &p, NULL)) continue;
+        if (!appendPart(parts, &p)) break;
+    }
+
+    fclose(file);
+    return true;
+}
+
+//
+// FUNCTION    : loadPartsMapped
+// DESCRIPTION : Reads a parts file through a read-only memory mapping.
+//               Fields are validated in place; large files are parsed on
+//               several threads and merged back in file order.
+// PARAMETERS  :
+//      const char* filename : Name of file to load from
+//      RecordStore* parts   : Part store to fill
+// RETURNS     : bool - false if the file could not be mapped
+//
+static bool loadPartsMapped(const char* filename, RecordStore* parts) {
+    MappedFile file;
+    if (!mapDbFile(&file, filename)) {
+        return false;
+    }
+
+    storeClear(parts);
+    storeReserveForFile(parts, filename, PART_MIN_LINE);
 
-        if (strlen(fields[0]) == 0 || strlen(fields[0]) > 50) continue;
-        strcpy_s(p.PartName, sizeof(p.PartName), fields[0]);
+    if (!loadDbRecords(&file, DB_TRIM_CRLF, 7, parsePartRecord, parts, NULL)) {
+        statusPrintf("Not enough memory to load all parts.\n");
+    }
 
-        if (strlen(fields[1]) == 0 || strlen(fields[1]) > 50) continue;
-        strcpy_s(p.PartNumber, sizeof(p.PartNumber), fields[1]);
+    unmapDbFile(&file);
+    return true;
+}
 
-        if (strlen(fields[2]) == 0 || strlen(fields[2]) > 50) continue;
-        strcpy_s(p.PartLocate, sizeof(p.PartLocate), fields[2]);
+//
+// FUNCTION    : loadfromfile
+// DESCRIPTION : Loads parts from file with validation, replacing the
+//               contents of the store. Uses the reader set by dbLoadMode and
+//               falls back to stdio if the file cannot be mapped.
+// PARAMETERS  :
+//      const char* filename : Name of file to load from
+//      RecordStore* parts   : Part store to fill
+// RETURNS     : void
+//
+void loadfromfile(const char* filename, RecordStore* parts) {
+    bool loaded = dbLoadMode == DB_LOAD_MAPPED && loadPartsMapped(filename, parts);
+    if (!loaded && !loadPartsStdio(filename, parts)) {
+        statusPrintf("Error loading parts\n");
+        return;
+    }
+
+    indexParts(parts);
+    walLogReload(SNAPSHOT_PARTS);
+    statusPrintf("Loaded %d parts from %s\n", parts->count, filename);
+    logMessage("Parts database loaded");
+}
+
+//
+// FUNCTION    : mapPartSnapshot
+// DESCRIPTION : Lazy start-up (pwh -l): maps parts.snap and the ID index
+//               saved with it instead of reading them. An index that is
+//               missing, damaged or from another snapshot is rebuilt and
+//               saved for the next start.
+// PARAMETERS  :
+//      RecordStore* parts : Empty part store to fill
+// RETURNS     : bool - false if the snapshot could not be mapped
+//
+static bool mapPartSnapshot(RecordStore* parts) {
+    unsigned long long tag;
+    if (!mapSnapshot(PART_SNAPSHOT_FILE, SNAPSHOT_PARTS, parts, &tag, true)) return false;
+
+    long long largestId;
+    if (!idIndexMap(&partIndex, PART_INDEX_FILE, tag, parts, parts->count, &largestId)) {
+        indexParts(parts);
+        idIndexSave(&partIndex, PART_INDEX_FILE, tag);
+    }
 
-        if (sscanf_s(fields[3], "%f", &p.PartCost) != 1 || p.PartCost <= 0.0f) continue;
+    statusPrintf("Mapped %d parts from parts.snap\n", parts->count);
+    logMessage("Parts snapshot mapped");
+    return true;
+}
 
-        if (sscanf_s(fields[4], "%d", &p.QuantityOnHand) != 1 || p.QuantityOnHand < 0) continue;
+//
+// FUNCTION    : loadPartSnapshot
+// DESCRIPTION : Loads parts from parts.snap when it is at least as new
+//               as parts.db, replacing the contents of the store. With
+//               lazy start the snapshot is mapped instead.
+// PARAMETERS  :
+//      RecordStore* parts : Part store to fill
+// RETURNS     : bool - false if there is no usable snapshot, in which case
+//               parts.db should be imported instead
+//
+bool loadPartSnapshot(RecordStore* parts) {
+    if (!snapshotIsCurrent(PART_SNAPSHOT_FILE, "parts.db")) return false;
+    if (lazyStart && mapPartSnapshot(parts)) return true;
 
-        if (sscanf_s(fields[5], "%d", &p.PartStatus) != 1) continue;
+    if (!loadSnapshot(PART_SNAPSHOT_FILE, SNAPSHOT_PARTS, parts)) {
+        statusPrintf("Ignoring unusable parts.snap, importing parts.db\n");
+        return false;
+    }
 
-        if (sscanf_s(fields[6], "%d", &p.PartID) != 1 || p.PartID <= 0) continue;
+    indexParts(parts);
+    statusPrintf("Loaded %d parts from parts.snap\n", parts->count);
+    logMessage("Parts snapshot loaded");
+    return true;
+}
 
-        part[*size] = p;
-        (*size)++;
+//
+// FUNCTION    : savePartSnapshot
+// DESCRIPTION : Saves all parts to parts.snap (and their ID index with
+//               lazy start)
+// PARAMETERS  :
+//      RecordStore* parts : Part store to save
+// RETURNS     : bool - true on success
+//
+bool savePartSnapshot(RecordStore* parts) {
+    if (!saveSnapshot(PART_SNAPSHOT_FILE, SNAPSHOT_PARTS, parts)) {
+        printf("Error saving parts.snap.\n");
+        return false;
     }
+    savePartIndex(parts);
 
-    fclose(file);
-    printf("Loaded %d parts from %s\n", *size, filename);
-    logMessage("Parts database loaded");
+    printf("Saved %d parts to parts.snap\n", parts->count);
+    logMessage("Parts snapshot saved");
+    return true;
+}
+
+//
+// FUNCTION    : savePartIndex
+// DESCRIPTION : With lazy start, builds the ID index of a part store just
+//               saved to parts.snap and saves it beside it. Does nothing
+//               otherwise.
+// PARAMETERS  :
+//      const RecordStore* parts : Store as saved to the snapshot
+// RETURNS     : void
+//
+void savePartIndex(const RecordStore* parts) {
+    unsigned long long tag;
+    if (!lazyStart || !snapshotTag(PART_SNAPSHOT_FILE, &tag)) return;
+
+    IdIndex index;
+    memset(&index, 0, sizeof(index));
+    idIndexReset(&index, parts, parts->count);
+    for (int i = 0; i < parts->count; i++) {
+        idIndexInsert(&index, partAt(parts, i)->PartID, i);
+    }
+    idIndexSave(&index, PART_INDEX_FILE, tag);
+    idIndexFree(&index);
 }
 
 //
 // FUNCTION    : handlePartsMenu
-// DESCRIPTION : Main parts management menu interface
+// DESCRIPTION : Main parts management menu interface. Orders waiting on a
+//               part are checked again as soon as it is restocked.
 // PARAMETERS  :
-//      Parts parts[]    : Array of part records
-//      int* partsCount  : Pointer to current inventory count
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+//      RecordStore* customers : Customer store
 // RETURNS     : void
 //
-void handlePartsMenu(Parts parts[], int* partsCount) {
+void handlePartsMenu(RecordStore* parts, RecordStore* orders, RecordStore* customers) {
     int choice;
+    int restocked;
     char buffer[100];
 
     do {
@@ -404,14 +697,30 @@ void handlePartsMenu(Parts parts[], int* partsCount) {
         }
 
         switch (choice) {
-        case 1: ListallParts(parts, partsCount); break;
-        case 2: SearchforPart(parts, partsCount); break;
-        case 3: AddPart(parts, partsCount); break;
-        case 4: UpdateInventoryforPart(parts, partsCount); break;
-        case 5: loadfromfile("parts.db", parts, partsCount); break;
-        case 6: SaveToFile("parts.db", parts, partsCount); break;
+        case 1: ListallParts(parts); break;
+        case 2: SearchforPart(parts); break;
+        case 3:
+            restocked = parts->count;
+            if (AddPart(parts) > restocked) {
+                fulfillBackorders(orders, customers, parts, partAt(parts, restocked)->PartID);
+            }
+            break;
+        case 4:
+            restocked = UpdateInventoryforPart(parts);
+            if (restocked != -1) fulfillBackorders(orders, customers, parts, restocked);
+            break;
+        case 5:
+            loadfromfile("parts.db", parts);
+            fulfillBackorders(orders, customers, parts, BACKORDER_ALL_PARTS);
+            break;
+        case 6: SaveToFile("parts.db", parts); break;
         case 7: return;
         default: printf("Invalid option. Try again.\n");
         }
+        walCommit();
+        checkpointPoll();
+        repairCustomerIndex(customers);
+        repairPartIndex(parts);
+        repairOrderIndex(orders);
     } while (1);
 }
\ No newline at end of file
@@ -13,10 +13,14 @@
 #ifndef PART_H
 #define PART_H
 
+#include "RecordStore.h"
+
 #define MAXIMUMLENGTH 51    // Maximum length for part name/number/location
-#define MAXPARTSIZE 100     // Maximum parts in inventory
 #define MAXLINE 100         // Maximum line length for file input
 #define LOCATELINE 10       // Length for location components
+#define PART_MIN_LINE 16    // Shortest valid parts.db line (for store sizing)
+#define PART_SNAPSHOT_FILE "parts.snap" // Binary snapshot of the part store
+#define PART_INDEX_FILE "parts.idx" // Part ID index saved with the snapshot (lazy start)
 
 // Part inventory structure
 typedef struct {
@@ -29,13 +33,35 @@ typedef struct {
     int PartID;                     // Unique part identifier
 } Parts;
 
+//
+// FUNCTION    : partAt
+// DESCRIPTION : Returns the part stored at a position
+// PARAMETERS  :
+//      const RecordStore* parts : Part store
+//      int index               : Record position
+// RETURNS     : Parts* - Address of the part
+//
+inline Parts* partAt(const RecordStore* parts, int index) {
+    return (Parts*)storeAt(parts, index);
+}
+
 // Function prototypes
-void ListallParts(Parts* part, int* size);             // List all parts in inventory
-void SearchforPart(Parts* part, int* size);            // Search for specific part
-int AddPart(Parts* part, int* size);                   // Add new part to inventory
-void UpdateInventoryforPart(Parts part[], int* size);  // Update part quantity
-void SaveToFile(const char* filename, Parts part[], int* size); // Save parts to file
-void loadfromfile(const char* filename, Parts part[], int* size); // Load parts from file
-void handlePartsMenu(Parts parts[], int* partsCount);  // Main parts menu
+void ListallParts(RecordStore* parts);                 // List all parts in inventory
+void SearchforPart(RecordStore* parts);                // Search for specific part
+void DisplayPart(const Parts* part);                   // Show one part's details
+int AddPart(RecordStore* parts);                       // Add new part to inventory
+int UpdateInventoryforPart(RecordStore* parts);        // Update part quantity
+bool addPartRecord(RecordStore* parts, const Parts* part); // Add a part without prompting
+int setPartQuantity(RecordStore* parts, int position, int quantity); // Bring a part's quantity to a count
+bool isValidPartLocation(const char* location);        // Validate A###-S###-L###-B### location
+void SaveToFile(const char* filename, RecordStore* parts); // Save parts to file
+void loadfromfile(const char* filename, RecordStore* parts); // Load parts from file
+bool loadPartSnapshot(RecordStore* parts);             // Load parts from snapshot
+bool savePartSnapshot(RecordStore* parts);             // Save parts to snapshot
+void savePartIndex(const RecordStore* parts);          // Save the ID index for a saved snapshot
+void handlePartsMenu(RecordStore* parts, RecordStore* orders, RecordStore* customers); // Main parts menu
+void indexParts(RecordStore* parts);                   // Rebuild part ID index
+void repairPartIndex(RecordStore* parts);              // Rebuild the index if the warm-up check failed it
+int findPart(RecordStore* parts, int partID);          // Find part position by ID
 
 #endif
\ No newline at end of file
@@ -0,0 +1,271 @@
+/*
+* FILE          : RecordStore.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of the growable record store including:
+*      - Chunk allocation on demand
+*      - Chunk directory sizing from database file size
+*      - Bulk resizing and copying for merged loads
+*      - Change flags set by every function that writes records, except
+*        the raw copy used by parallel merges
+*/
+
+#include "RecordStore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+//
+// FUNCTION    : storeMarkRange
+// DESCRIPTION : Flags every chunk holding a record of a run as changed.
+//               Not safe to call from several threads at once on one store:
+//               neighbouring runs can share a chunk's flag.
+// PARAMETERS  :
+//      RecordStore* store : Store written
+//      int first          : First record of the run
+//      int records        : Records in the run
+// RETURNS     : void
+//
+void storeMarkRange(RecordStore* store, int first, int records) {
+    if (records <= 0) return;
+
+    int lastChunk = (first + records - 1) >> STORE_CHUNK_SHIFT;
+    for (int chunk = first >> STORE_CHUNK_SHIFT; chunk <= lastChunk; chunk++) {
+        store->dirty[chunk] = 1;
+        store->viewDirty[chunk] = 1;
+    }
+}
+
+//
+// FUNCTION    : storeInit
+// DESCRIPTION : Prepares an empty store for records of the given size
+// PARAMETERS  :
+//      RecordStore* store : Store to initialize
+//      size_t recordSize  : Size of one record in bytes
+// RETURNS     : void
+//
+void storeInit(RecordStore* store, size_t recordSize) {
+    store->chunks = NULL;
+    store->chunkCapacity = 0;
+    store->chunkCount = 0;
+    store->recordSize = recordSize;
+    store->count = 0;
+    store->dirty = NULL;
+    store->viewDirty = NULL;
+    store->mappedChunks = 0;
+    store->mapping = NULL;
+    store->mappingBytes = 0;
+}
+
+//
+// FUNCTION    : storeFree
+// DESCRIPTION : Releases every chunk and the chunk directory. Chunks inside
+//               a file mapping are released by unmapping it.
+// PARAMETERS  :
+//      RecordStore* store : Store to free
+// RETURNS     : void
+//
+void storeFree(RecordStore* store) {
+    for (int i = store->mappedChunks; i < store->chunkCount; i++) {
+        free(store->chunks[i]);
+    }
+    free(store->chunks);
+    free(store->dirty);
+    free(store->viewDirty);
+#ifndef _WIN32
+    if (store->mapping != NULL) munmap(store->mapping, store->mappingBytes);
+#endif
+    storeInit(store, store->recordSize);
+}
+
+//
+// FUNCTION    : storeClear
+// DESCRIPTION : Drops all records but keeps allocated chunks for reuse
+// PARAMETERS  :
+//      RecordStore* store : Store to clear
+// RETURNS     : void
+//
+void storeClear(RecordStore* store) {
+    storeMarkRange(store, 0, store->count);
+    store->count = 0;
+}
+
+//
+// FUNCTION    : storeReserve
+// DESCRIPTION : Makes sure the chunk directory can address the given number
+//               of records. Chunks themselves are allocated as they fill.
+// PARAMETERS  :
+//      RecordStore* store : Store to size
+//      int records        : Number of records to plan for
+// RETURNS     : bool - true on success, false if out of memory
+//
+bool storeReserve(RecordStore* store, int records) {
+    int wanted = (records + STORE_CHUNK_MASK) >> STORE_CHUNK_SHIFT;
+    if (wanted <= store->chunkCapacity) return true;
+
+    unsigned char** chunks = (unsigned char**)realloc(store->chunks, sizeof(unsigned char*) * (size_t)wanted);
+    if (chunks == NULL) return false;
+
+    store->chunks = chunks;
+
+    unsigned char* dirty = (unsigned char*)realloc(store->dirty, (size_t)wanted);
+    if (dirty == NULL) return false;
+
+    memset(dirty + store->chunkCapacity, 0, (size_t)(wanted - store->chunkCapacity));
+    store->dirty = dirty;
+
+    unsigned char* viewDirty = (unsigned char*)realloc(store->viewDirty, (size_t)wanted);
+    if (viewDirty == NULL) return false;
+
+    memset(viewDirty + store->chunkCapacity, 0, (size_t)(wanted - store->chunkCapacity));
+    store->viewDirty = viewDirty;
+    store->chunkCapacity = wanted;
+    return true;
+}
+
+//
+// FUNCTION    : storeReserveForFile
+// DESCRIPTION : Sizes the store for a database file before loading it. The
+//               record count is bounded by file size / shortest valid line,
+//               so a whole file loads without touching the directory again.
+// PARAMETERS  :
+//      RecordStore* store  : Store to size
+//      const char* filename: Database file about to be loaded
+//      int minLineBytes    : Shortest possible valid line, including newline
+// RETURNS     : bool - true on success, false if out of memory
+//
+bool storeReserveForFile(RecordStore* store, const char* filename, int minLineBytes) {
+    struct stat info;
+    if (stat(filename, &info) != 0) return true;
+
+    long long estimate = (long long)info.st_size / minLineBytes + 1;
+    if (estimate > 0x7fffffff - STORE_CHUNK_RECORDS) estimate = 0x7fffffff - STORE_CHUNK_RECORDS;
+    return storeReserve(store, (int)estimate);
+}
+
+//
+// FUNCTION    : storeAppend
+// DESCRIPTION : Adds a record slot at the end of the store, allocating a new
+//               chunk when the last one is full
+// PARAMETERS  :
+//      RecordStore* store : Store to grow
+// RETURNS     : void* - Address of the new (uninitialized) record, NULL if out of memory
+//
+void* storeAppend(RecordStore* store) {
+    int chunk = store->count >> STORE_CHUNK_SHIFT;
+
+    if (chunk >= store->chunkCount) {
+        if (chunk >= store->chunkCapacity) {
+            int grow = store->chunkCapacity > 0 ? store->chunkCapacity * 2 : 1;
+            if (!storeReserve(store, grow * STORE_CHUNK_RECORDS)) return NULL;
+        }
+
+        unsigned char* block = (unsigned char*)malloc(store->recordSize * STORE_CHUNK_RECORDS);
+        if (block == NULL) return NULL;
+
+        store->chunks[store->chunkCount++] = block;
+    }
+
+    store->dirty[chunk] = 1;
+    store->viewDirty[chunk] = 1;
+    return storeAt(store, store->count++);
+}
+
+//
+// FUNCTION    : storeResize
+// DESCRIPTION : Sets the number of records in the store. Growing allocates
+//               every chunk needed up front (new records are uninitialized);
+//               shrinking keeps the chunks for reuse.
+// PARAMETERS  :
+//      RecordStore* store : Store to resize
+//      int records        : New record count
+// RETURNS     : bool - true on success, false if out of memory (the store
+//               then holds as many records as its chunks could fit)
+//
+bool storeResize(RecordStore* store, int records) {
+    if (records <= store->count) {
+        storeMarkRange(store, records, store->count - records);
+        store->count = records;
+        return true;
+    }
+
+    int wanted = (records + STORE_CHUNK_MASK) >> STORE_CHUNK_SHIFT;
+    bool reserved = storeReserve(store, records);
+
+    while (reserved && store->chunkCount < wanted) {
+        unsigned char* block = (unsigned char*)malloc(store->recordSize * STORE_CHUNK_RECORDS);
+        if (block == NULL) break;
+        store->chunks[store->chunkCount++] = block;
+    }
+
+    if (store->chunkCount < wanted) {
+        int fit = store->chunkCount << STORE_CHUNK_SHIFT;
+        if (fit > store->count) {
+            storeMarkRange(store, store->count, fit - store->count);
+            store->count = fit;
+        }
+        return false;
+    }
+
+    storeMarkRange(store, store->count, records - store->count);
+    store->count = records;
+    return true;
+}
+
+//
+// FUNCTION    : storeCopyRecords
+// DESCRIPTION : Copies a run of records from one store to another with the
+//               same record size, one contiguous piece of a chunk at a time.
+//               No change flags are set, so several threads may copy
+//               separate runs into one store; the caller flags the
+//               destination afterwards (storeMarkRange).
+// PARAMETERS  :
+//      RecordStore* destination : Store receiving the records
+//      int destinationIndex     : First position written (must exist)
+//      const RecordStore* source: Store holding the records
+//      int sourceIndex          : First position read
+//      int records              : Number of records to copy
+// RETURNS     : void
+//
+void storeCopyRecords(RecordStore* destination, int destinationIndex,
+    const RecordStore* source, int sourceIndex, int records) {
+    while (records > 0) {
+        int sourceRoom = STORE_CHUNK_RECORDS - (sourceIndex & STORE_CHUNK_MASK);
+        int destinationRoom = STORE_CHUNK_RECORDS - (destinationIndex & STORE_CHUNK_MASK);
+        int run = records;
+        if (run > sourceRoom) run = sourceRoom;
+        if (run > destinationRoom) run = destinationRoom;
+
+        memcpy(storeAt(destination, destinationIndex), storeAt(source, sourceIndex),
+            (size_t)run * source->recordSize);
+
+        destinationIndex += run;
+        sourceIndex += run;
+        records -= run;
+    }
+}
+
+//
+// FUNCTION    : storeCopy
+// DESCRIPTION : Copies a run of records from one store to another with the
+//               same record size and flags the destination chunks as changed
+// PARAMETERS  :
+//      RecordStore* destination : Store receiving the records
+//      int destinationIndex     : First position written (must exist)
+//      const RecordStore* source: Store holding the records
+//      int sourceIndex          : First position read
+//      int records              : Number of records to copy
+// RETURNS     : void
+//
+void storeCopy(RecordStore* destination, int destinationIndex,
+    const RecordStore* source, int sourceIndex, int records) {
+    storeMarkRange(destination, destinationIndex, records);
+    storeCopyRecords(destination, destinationIndex, source, sourceIndex, records);
+}
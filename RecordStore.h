@@ -0,0 +1,88 @@
+/*
+* FILE          : RecordStore.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for the growable record store including:
+*      - Chunked record storage with stable record addresses
+*      - Capacity planning from database file size
+*      - Per-chunk change flags for incremental checkpoints and read views
+*      - Chunks borrowed from a mapped snapshot (lazy start)
+*      - Function prototypes for store operations
+*/
+
+#ifndef RECORDSTORE_H
+#define RECORDSTORE_H
+
+#include <stddef.h>
+
+#define STORE_CHUNK_SHIFT 10                        // log2 of records per chunk
+#define STORE_CHUNK_RECORDS (1 << STORE_CHUNK_SHIFT) // Records held by one chunk
+#define STORE_CHUNK_MASK (STORE_CHUNK_RECORDS - 1)   // Offset of a record inside its chunk
+
+// Growable record store. Records live in fixed-size chunks that are never
+// moved, so a record's address stays valid while the store grows. Only the
+// chunk directory (one pointer per chunk) is ever reallocated. Each chunk
+// has two change flags; the store functions set them (storeCopyRecords
+// leaves them to its caller), code that edits a record in place calls
+// storeMarkDirty, the checkpoint clears dirty and publishing a read view
+// (viewPublish) clears viewDirty. A store
+// mapped from a snapshot (mapSnapshot) points its leading chunks into the
+// copy-on-write mapping; they are used like any other chunk, and storeFree
+// unmaps the mapping instead of freeing them.
+typedef struct {
+    unsigned char** chunks;     // Chunk directory
+    int chunkCapacity;          // Slots in the chunk directory
+    int chunkCount;             // Chunks allocated so far
+    size_t recordSize;          // Size of one record in bytes
+    int count;                  // Records currently stored
+    unsigned char* dirty;       // One flag per directory slot, set when the chunk changes
+    unsigned char* viewDirty;   // Same, cleared when a read view is published
+    int mappedChunks;           // Leading chunks inside a file mapping (not freed by storeFree)
+    void* mapping;              // Start of that mapping, NULL if none
+    size_t mappingBytes;        // Length of that mapping
+} RecordStore;
+
+// Function prototypes
+void storeInit(RecordStore* store, size_t recordSize);       // Prepare an empty store
+void storeFree(RecordStore* store);                          // Release all chunks
+void storeClear(RecordStore* store);                         // Drop all records, keep memory
+bool storeReserve(RecordStore* store, int records);          // Size chunk directory for a record count
+bool storeReserveForFile(RecordStore* store, const char* filename, int minLineBytes); // Size from database file
+void* storeAppend(RecordStore* store);                       // Add a record slot at the end
+bool storeResize(RecordStore* store, int records);           // Grow or truncate to a record count
+void storeCopy(RecordStore* destination, int destinationIndex,
+    const RecordStore* source, int sourceIndex, int records); // Copy a run of records between stores
+void storeCopyRecords(RecordStore* destination, int destinationIndex,
+    const RecordStore* source, int sourceIndex, int records); // Same without setting change flags
+void storeMarkRange(RecordStore* store, int first, int records); // Flag the chunks of a run as changed
+
+//
+// FUNCTION    : storeAt
+// DESCRIPTION : Returns the address of a record
+// PARAMETERS  :
+//      const RecordStore* store : Store to read
+//      int index               : Record position (0 to count-1)
+// RETURNS     : void* - Address of the record
+//
+inline void* storeAt(const RecordStore* store, int index) {
+    return store->chunks[index >> STORE_CHUNK_SHIFT] + (size_t)(index & STORE_CHUNK_MASK) * store->recordSize;
+}
+
+//
+// FUNCTION    : storeMarkDirty
+// DESCRIPTION : Flags the chunk holding a record as changed since the last
+//               checkpoint and the last published read view. Call after
+//               editing a record in place.
+// PARAMETERS  :
+//      RecordStore* store : Store holding the record
+//      int index          : Record position (0 to count-1)
+// RETURNS     : void
+//
+inline void storeMarkDirty(RecordStore* store, int index) {
+    store->dirty[index >> STORE_CHUNK_SHIFT] = 1;
+    store->viewDirty[index >> STORE_CHUNK_SHIFT] = 1;
+}
+
+#endif
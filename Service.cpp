@@ -0,0 +1,779 @@
+/*
+* FILE          : Service.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of the local service mode including:
+*      - UNIX domain socket listener shared by a pool of worker threads
+*      - Per-worker poll loop over its own connections, with pipelining
+*      - Request handlers calling the same functions as the menus
+*      - Reader/writer locks on the customer, part and order stores
+*      - Lock-free reads of customers and parts from published views
+*      Every worker polls the listening socket along with its connections
+*      and accepts whatever arrives, so connections spread over the pool
+*      without a dispatcher. Locks are always taken in the order
+*      customers, parts, orders. Customer and part reads do not lock; a
+*      writer that changes either store publishes a new view when done.
+*      A worker that finds a checkpoint due copies the changes under the
+*      shared locks, which only holds writers back for the copy.
+*/
+
+#include "Service.h"
+#include "Order.h"
+#include "DbReader.h"
+#include "StoreView.h"
+#include "System.h"
+#include "TaskPool.h"
+#include "Wal.h"
+#include "Checkpoint.h"
+#include "Warmup.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET ServiceSocket;
+#define SERVICE_NO_SOCKET INVALID_SOCKET
+#define SERVICE_SEND_FLAGS 0
+#define closeSocket closesocket
+#define pollSockets WSAPoll
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+typedef int ServiceSocket;
+#define SERVICE_NO_SOCKET (-1)
+#define SERVICE_SEND_FLAGS MSG_NOSIGNAL
+#define closeSocket close
+#define pollSockets poll
+#endif
+
+#define SERVICE_OUTPUT_BYTES (2 * SERVICE_MAX_REPLY)   // Replies gathered before a send
+
+// Stores served and the socket accepting connections
+typedef struct {
+    RecordStore* customers;
+    RecordStore* parts;
+    RecordStore* orders;
+    ServiceSocket listener;
+} ServiceContext;
+
+// One connection and its unfinished request text
+typedef struct {
+    ServiceSocket socket;
+    char* input;                // SERVICE_MAX_REQUEST bytes
+    int inputLength;            // Bytes received but not yet handled
+} ServiceClient;
+
+// Buffers owned by one worker thread
+typedef struct {
+    char* output;               // Replies not yet sent (SERVICE_OUTPUT_BYTES)
+    int outputLength;
+    std::string_view* fields;   // Fields of a PLACE request
+    OrderItem* items;           // Lines of a PLACE request
+} ServiceWorker;
+
+// Totals of one piece of a REPORT
+typedef struct {
+    long long units;            // Units on hand
+    double value;               // Stock value
+    int backordered;            // Parts waiting for stock
+    double balance;             // Customer balances
+} ReportTotals;
+
+// REPORT shared by the pool tasks summing its pieces
+typedef struct {
+    const DataView* view;
+    ReportTotals* partTotals;       // One entry per STORE_CHUNK_RECORDS parts
+    ReportTotals* customerTotals;   // One entry per STORE_CHUNK_RECORDS customers
+} ReportJob;
+
+int serviceThreads = 0;
+
+static std::shared_mutex customerLock;     // Guards the live customer store (writers and PLACE)
+static std::shared_mutex partLock;         // Guards the live part store (writers and PLACE)
+static std::shared_mutex orderLock;        // Guards the order store and its lines
+static std::mutex stockLock;               // Restocks under the shared part lock, and checkpoints
+static std::atomic<bool> serviceStopping(false);
+static std::atomic<unsigned long long> serviceRequests(0);
+
+//
+// FUNCTION    : setBlocking
+// DESCRIPTION : Switches a socket between blocking and non-blocking mode
+// PARAMETERS  :
+//      ServiceSocket socket : Socket
+//      bool blocking        : true for blocking calls
+// RETURNS     : void
+//
+static void setBlocking(ServiceSocket socket, bool blocking) {
+#ifdef _WIN32
+    u_long nonBlocking = blocking ? 0 : 1;
+    ioctlsocket(socket, FIONBIO, &nonBlocking);
+#else
+    int flags = fcntl(socket, F_GETFL, 0);
+    fcntl(socket, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK));
+#endif
+}
+
+//
+// FUNCTION    : addReply
+// DESCRIPTION : Appends text to the worker's pending replies, as printf
+// PARAMETERS  :
+//      ServiceWorker* worker : Worker
+//      const char* format    : printf format
+//      ...                   : Format arguments
+// RETURNS     : void
+//
+static void addReply(ServiceWorker* worker, const char* format, ...) {
+    int space = SERVICE_OUTPUT_BYTES - worker->outputLength;
+    va_list arguments;
+    va_start(arguments, format);
+    int written = vsnprintf(worker->output + worker->outputLength, (size_t)space, format, arguments);
+    va_end(arguments);
+    if (written > 0) worker->outputLength += written < space ? written : space - 1;
+}
+
+//
+// FUNCTION    : sendReplies
+// DESCRIPTION : Sends the worker's pending replies to a client, once the
+//               changes they report are on disk in the write-ahead log.
+//               Workers replying at the same time share one log write.
+// PARAMETERS  :
+//      ServiceWorker* worker : Worker
+//      ServiceSocket socket  : Client connection
+// RETURNS     : bool - false if the connection failed
+//
+static bool sendReplies(ServiceWorker* worker, ServiceSocket socket) {
+    walCommit();
+
+    int sent = 0;
+    while (sent < worker->outputLength) {
+        int written = (int)send(socket, worker->output + sent, worker->outputLength - sent, SERVICE_SEND_FLAGS);
+        if (written <= 0) return false;
+        sent += written;
+    }
+    worker->outputLength = 0;
+    return true;
+}
+
+//
+// FUNCTION    : publishView
+// DESCRIPTION : Publishes the live customer and part stores for readers.
+//               Called by writers holding the customer and part locks, or
+//               by a restock holding stockLock.
+// PARAMETERS  :
+//      ServiceContext* context : Stores
+// RETURNS     : void
+//
+static void publishView(ServiceContext* context) {
+    if (!viewPublish(context->customers, context->parts)) {
+        printf("Not enough memory to publish the read view; readers see older data.\n");
+    }
+}
+
+//
+// FUNCTION    : partRequest
+// DESCRIPTION : PART <id>, read from the published view
+// PARAMETERS  :
+//      const char* argument  : Part ID
+//      ServiceWorker* worker : Receives the reply
+// RETURNS     : void
+//
+static void partRequest(const char* argument, ServiceWorker* worker) {
+    int id;
+    if (!parseIntField(argument, &id)) {
+        addReply(worker, "ERR bad part ID\n");
+        return;
+    }
+
+    const DataView* view = viewReadBegin();
+    const Parts* part = (const Parts*)viewFind(&view->parts, id);
+    if (part == NULL) addReply(worker, "ERR part not found\n");
+    else {
+        addReply(worker, "OK %s|%s|%s|%.2f|%d|%d|%d\n", part->PartName, part->PartNumber, part->PartLocate,
+            part->PartCost, part->QuantityOnHand, part->PartStatus, part->PartID);
+    }
+    viewReadEnd();
+}
+
+//
+// FUNCTION    : customerRequest
+// DESCRIPTION : CUSTOMER <id>, read from the published view
+// PARAMETERS  :
+//      const char* argument  : Customer ID
+//      ServiceWorker* worker : Receives the reply
+// RETURNS     : void
+//
+static void customerRequest(const char* argument, ServiceWorker* worker) {
+    int id;
+    if (!parseIntField(argument, &id)) {
+        addReply(worker, "ERR bad customer ID\n");
+        return;
+    }
+
+    const DataView* view = viewReadBegin();
+    const Customer* c = (const Customer*)viewFind(&view->customers, id);
+    if (c == NULL) addReply(worker, "ERR customer not found\n");
+    else {
+        addReply(worker, "OK %s|%s|%s|%s|%s|%s|%s|%d|%.2f|%.2f|%s|%s|\n", c->name, c->address, c->city,
+            c->province, c->postalCode, c->phone, c->email, c->customerID, c->creditLimit,
+            c->accountBalance, c->joinDate, c->lastPayment);
+    }
+    viewReadEnd();
+}
+
+//
+// FUNCTION    : sumParts
+// DESCRIPTION : Totals one piece of the parts of a REPORT
+// PARAMETERS  :
+//      void* arg : ReportJob
+//      int first : First part of the piece
+//      int last  : One past the last part
+// RETURNS     : void
+//
+static void sumParts(void* arg, int first, int last) {
+    ReportJob* job = (ReportJob*)arg;
+    ReportTotals* totals = &job->partTotals[first >> STORE_CHUNK_SHIFT];
+
+    for (int i = first; i < last; i++) {
+        const Parts* part = (const Parts*)viewAt(&job->view->parts, i);
+        totals->units += part->QuantityOnHand;
+        totals->value += (double)part->PartCost * part->QuantityOnHand;
+        if (part->PartStatus < 0) totals->backordered++;
+    }
+}
+
+//
+// FUNCTION    : sumCustomers
+// DESCRIPTION : Totals one piece of the customers of a REPORT
+// PARAMETERS  :
+//      void* arg : ReportJob
+//      int first : First customer of the piece
+//      int last  : One past the last customer
+// RETURNS     : void
+//
+static void sumCustomers(void* arg, int first, int last) {
+    ReportJob* job = (ReportJob*)arg;
+    ReportTotals* totals = &job->customerTotals[first >> STORE_CHUNK_SHIFT];
+
+    for (int i = first; i < last; i++) {
+        totals->balance += ((const Customer*)viewAt(&job->view->customers, i))->accountBalance;
+    }
+}
+
+//
+// FUNCTION    : reportRequest
+// DESCRIPTION : REPORT. Totals over one published view:
+//               OK parts|units on hand|stock value|backordered parts|
+//               customers|total balance|view version
+//               Each chunk of records is summed by a pool task and the
+//               chunk totals are added in order, so the reply does not
+//               depend on the number of threads.
+// PARAMETERS  :
+//      ServiceWorker* worker : Receives the reply
+// RETURNS     : void
+//
+static void reportRequest(ServiceWorker* worker) {
+    ReportTotals total = { 0, 0.0, 0, 0.0 };
+    ReportJob job;
+
+    job.view = viewReadBegin();
+    int partPieces = job.view->parts.chunkCount;
+    int customerPieces = job.view->customers.chunkCount;
+    job.partTotals = (ReportTotals*)calloc((size_t)partPieces + 1, sizeof(ReportTotals));
+    job.customerTotals = (ReportTotals*)calloc((size_t)customerPieces + 1, sizeof(ReportTotals));
+
+    if (job.partTotals == NULL || job.customerTotals == NULL) {
+        addReply(worker, "ERR out of memory\n");
+    }
+    else {
+        taskParallelFor(job.view->parts.count, STORE_CHUNK_RECORDS, 0, sumParts, &job);
+        taskParallelFor(job.view->customers.count, STORE_CHUNK_RECORDS, 0, sumCustomers, &job);
+
+        for (int i = 0; i < partPieces; i++) {
+            total.units += job.partTotals[i].units;
+            total.value += job.partTotals[i].value;
+            total.backordered += job.partTotals[i].backordered;
+        }
+        for (int i = 0; i < customerPieces; i++) {
+            total.balance += job.customerTotals[i].balance;
+        }
+        addReply(worker, "OK %d|%lld|%.2f|%d|%d|%.2f|%llu\n", job.view->parts.count, total.units, total.value,
+            total.backordered, job.view->customers.count, total.balance, job.view->version);
+    }
+
+    free(job.partTotals);
+    free(job.customerTotals);
+    viewReadEnd();
+}
+
+//
+// FUNCTION    : orderRequest
+// DESCRIPTION : ORDER <id>
+// PARAMETERS  :
+//      const char* argument    : Order ID
+//      ServiceContext* context : Stores
+//      ServiceWorker* worker   : Receives the reply
+// RETURNS     : void
+//
+static void orderRequest(const char* argument, ServiceContext* context, ServiceWorker* worker) {
+    long long id;
+    if (!parseLongLongField(argument, &id)) {
+        addReply(worker, "ERR bad order ID\n");
+        return;
+    }
+
+    std::shared_lock<std::shared_mutex> orders(orderLock);
+    int index = findOrder(context->orders, id);
+    if (index == -1) {
+        addReply(worker, "ERR order not found\n");
+        return;
+    }
+    const Order* order = orderAt(context->orders, index);
+    addReply(worker, "OK %lld|%s|%d|%d|%.2f|%d", order->OrderID, order->OrderDate, order->OrderStatus,
+        order->CustomerID, order->OrderTotal, order->DistinctParts);
+    for (int j = 0; j < order->DistinctParts; j++) {
+        const OrderItem* item = orderLine(order, j);
+        addReply(worker, "|%d|%d", item->PartID, item->NumberOfParts);
+    }
+    addReply(worker, "\n");
+}
+
+//
+// FUNCTION    : placeRequest
+// DESCRIPTION : PLACE CustomerID|PartID|Quantity|PartID|Quantity...
+//               A rejected order is answered with the reason.
+// PARAMETERS  :
+//      const char* argument    : Order fields
+//      ServiceContext* context : Stores
+//      ServiceWorker* worker   : Receives the reply
+// RETURNS     : void
+//
+static void placeRequest(const char* argument, ServiceContext* context, ServiceWorker* worker) {
+    MappedFile view = { argument, strlen(argument), NULL, NULL, NULL };
+    size_t offset = 0;
+    int fieldCount = nextDbRecord(&view, &offset, DB_TRIM_CRLF, worker->fields, ORDER_MAX_FIELDS);
+    int customerID;
+    int count = (fieldCount - 1) / 2;
+    bool valid = fieldCount >= 3 && fieldCount % 2 == 1 && count <= MAX_PARTS_PER_ORDER
+        && parseIntField(worker->fields[0], &customerID);
+
+    for (int i = 0; valid && i < count; i++) {
+        valid = parseIntField(worker->fields[1 + i * 2], &worker->items[i].PartID)
+            && parseIntField(worker->fields[2 + i * 2], &worker->items[i].NumberOfParts);
+    }
+    if (!valid) {
+        addReply(worker, "ERR bad order line\n");
+        return;
+    }
+
+    std::shared_lock<std::shared_mutex> customers(customerLock);
+    std::shared_lock<std::shared_mutex> parts(partLock);
+    std::unique_lock<std::shared_mutex> orders(orderLock);
+    switch (placeOrder(context->orders, context->customers, context->parts, customerID, worker->items, count)) {
+    case PLACE_OK:
+        addReply(worker, "OK %lld\n", orderAt(context->orders, context->orders->count - 1)->OrderID);
+        break;
+    case PLACE_NO_CUSTOMER: addReply(worker, "ERR customer not found\n"); break;
+    case PLACE_BAD_COUNT: addReply(worker, "ERR bad order line\n"); break;
+    case PLACE_NO_PART: addReply(worker, "ERR part not found\n"); break;
+    case PLACE_BAD_QUANTITY: addReply(worker, "ERR bad quantity\n"); break;
+    case PLACE_NO_ORDER_ID: addReply(worker, "ERR no order ID left today\n"); break;
+    default: addReply(worker, "ERR out of memory\n");
+    }
+}
+
+//
+// FUNCTION    : stockRequest
+// DESCRIPTION : STOCK <part id> <quantity>. The quantity on hand changes
+//               atomically (Inventory.h), so the restock runs under shared
+//               locks alongside PLACE and ORDER; stockLock keeps it apart
+//               from other restocks and from checkpoints, which also read
+//               the part's change flags. Only if orders wait on the part
+//               are all stores locked for writing to retry them.
+// PARAMETERS  :
+//      char* argument          : Part ID and quantity
+//      ServiceContext* context : Stores
+//      ServiceWorker* worker   : Receives the reply
+// RETURNS     : void
+//
+static void stockRequest(char* argument, ServiceContext* context, ServiceWorker* worker) {
+    int id, quantity;
+    char* quantityText = argument + strcspn(argument, " ");
+    if (*quantityText != '\0') *quantityText++ = '\0';
+    if (!parseIntField(argument, &id) || !parseIntField(quantityText, &quantity) || quantity < 0) {
+        addReply(worker, "ERR bad stock request\n");
+        return;
+    }
+
+    int restocked;
+    {
+        std::shared_lock<std::shared_mutex> customers(customerLock);
+        std::shared_lock<std::shared_mutex> parts(partLock);
+        std::shared_lock<std::shared_mutex> orders(orderLock);
+        std::lock_guard<std::mutex> stock(stockLock);
+        int index = findPart(context->parts, id);
+        if (index == -1) {
+            addReply(worker, "ERR part not found\n");
+            return;
+        }
+        restocked = setPartQuantity(context->parts, index, quantity);
+        if (restocked != -1 && !ordersWaitOn(context->orders, restocked)) restocked = -1;
+        if (restocked == -1) publishView(context);
+    }
+
+    if (restocked != -1) {
+        std::unique_lock<std::shared_mutex> customers(customerLock);
+        std::unique_lock<std::shared_mutex> parts(partLock);
+        std::unique_lock<std::shared_mutex> orders(orderLock);
+        fulfillBackorders(context->orders, context->customers, context->parts, restocked);
+        publishView(context);
+    }
+    addReply(worker, "OK\n");
+}
+
+//
+// FUNCTION    : eodRequest
+// DESCRIPTION : EOD. Runs end-of-day processing with every store locked
+//               for writing. Customer and part reads carry on from the
+//               published view and see the result once it is published.
+// PARAMETERS  :
+//      ServiceContext* context : Stores
+//      ServiceWorker* worker   : Receives the reply
+// RETURNS     : void
+//
+static void eodRequest(ServiceContext* context, ServiceWorker* worker) {
+    std::unique_lock<std::shared_mutex> customers(customerLock);
+    std::unique_lock<std::shared_mutex> parts(partLock);
+    std::unique_lock<std::shared_mutex> orders(orderLock);
+    processEndOfDayOrders(context->orders, context->customers, context->parts);
+    publishView(context);
+    addReply(worker, "OK\n");
+}
+
+//
+// FUNCTION    : handleRequest
+// DESCRIPTION : Runs one request line and appends its reply
+// PARAMETERS  :
+//      char* line              : Request (modified while parsed)
+//      ServiceContext* context : Stores
+//      ServiceWorker* worker   : Receives the reply
+// RETURNS     : void
+//
+static void handleRequest(char* line, ServiceContext* context, ServiceWorker* worker) {
+    char* argument = line + strcspn(line, " ");
+    if (*argument != '\0') *argument++ = '\0';
+    serviceRequests++;
+
+    if (strcmp(line, "PART") == 0) partRequest(argument, worker);
+    else if (strcmp(line, "CUSTOMER") == 0) customerRequest(argument, worker);
+    else if (strcmp(line, "ORDER") == 0) orderRequest(argument, context, worker);
+    else if (strcmp(line, "PLACE") == 0) placeRequest(argument, context, worker);
+    else if (strcmp(line, "STOCK") == 0) stockRequest(argument, context, worker);
+    else if (strcmp(line, "EOD") == 0) eodRequest(context, worker);
+    else if (strcmp(line, "REPORT") == 0) reportRequest(worker);
+    else if (strcmp(line, "PING") == 0) addReply(worker, "OK\n");
+    else if (strcmp(line, "SHUTDOWN") == 0) {
+        serviceStopping.store(true);
+        addReply(worker, "OK\n");
+    }
+    else addReply(worker, "ERR unknown request\n");
+}
+
+//
+// FUNCTION    : readRequests
+// DESCRIPTION : Receives what a client has sent and answers every complete
+//               request in it
+// PARAMETERS  :
+//      ServiceClient* client   : Readable connection
+//      ServiceContext* context : Stores
+//      ServiceWorker* worker   : Worker buffers
+// RETURNS     : bool - false if the connection should be closed
+//
+static bool readRequests(ServiceClient* client, ServiceContext* context, ServiceWorker* worker) {
+    int received = (int)recv(client->socket, client->input + client->inputLength,
+        SERVICE_MAX_REQUEST - client->inputLength, 0);
+    if (received <= 0) return false;
+    client->inputLength += received;
+
+    char* line = client->input;
+    char* end = client->input + client->inputLength;
+    char* newline;
+    while ((newline = (char*)memchr(line, '\n', (size_t)(end - line))) != NULL) {
+        *newline = '\0';
+        if (newline > line && newline[-1] == '\r') newline[-1] = '\0';
+        handleRequest(line, context, worker);
+        line = newline + 1;
+
+        if (worker->outputLength > SERVICE_OUTPUT_BYTES - SERVICE_MAX_REPLY && !sendReplies(worker, client->socket)) {
+            return false;
+        }
+    }
+
+    client->inputLength = (int)(end - line);
+    memmove(client->input, line, (size_t)client->inputLength);
+    if (client->inputLength == SERVICE_MAX_REQUEST) {
+        addReply(worker, "ERR request too long\n");
+        sendReplies(worker, client->socket);
+        return false;
+    }
+    return sendReplies(worker, client->socket);
+}
+
+//
+// FUNCTION    : acceptClient
+// DESCRIPTION : Accepts a waiting connection, if another worker did not
+//               take it first
+// PARAMETERS  :
+//      ServiceSocket listener : Listening socket (non-blocking)
+//      ServiceClient* client  : Receives the connection
+// RETURNS     : bool - true if a connection was accepted
+//
+static bool acceptClient(ServiceSocket listener, ServiceClient* client) {
+    ServiceSocket socket = accept(listener, NULL, NULL);
+    if (socket == SERVICE_NO_SOCKET) return false;
+
+    client->input = (char*)malloc(SERVICE_MAX_REQUEST);
+    if (client->input == NULL) {
+        closeSocket(socket);
+        return false;
+    }
+    setBlocking(socket, true);
+    client->socket = socket;
+    client->inputLength = 0;
+    return true;
+}
+
+//
+// FUNCTION    : takeCheckpoint
+// DESCRIPTION : Takes a background checkpoint (Checkpoint.h). Shared locks
+//               on every store and stockLock keep writers out while the
+//               changes are copied; readers carry on and the saving is
+//               done by the checkpoint thread.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+static void takeCheckpoint() {
+    std::shared_lock<std::shared_mutex> customers(customerLock);
+    std::shared_lock<std::shared_mutex> parts(partLock);
+    std::shared_lock<std::shared_mutex> orders(orderLock);
+    std::lock_guard<std::mutex> stock(stockLock);
+    checkpointTake();
+}
+
+//
+// FUNCTION    : repairIndexes
+// DESCRIPTION : Rebuilds any ID index the warm-up thread found damaged
+//               (lazy start). Lookups run under shared locks, so the
+//               rebuild waits for every store to be free.
+// PARAMETERS  :
+//      ServiceContext* context : Stores
+// RETURNS     : void
+//
+static void repairIndexes(ServiceContext* context) {
+    std::unique_lock<std::shared_mutex> customers(customerLock);
+    std::unique_lock<std::shared_mutex> parts(partLock);
+    std::unique_lock<std::shared_mutex> orders(orderLock);
+    repairCustomerIndex(context->customers);
+    repairPartIndex(context->parts);
+    repairOrderIndex(context->orders);
+}
+
+//
+// FUNCTION    : serveClients
+// DESCRIPTION : Worker loop. Polls the worker's connections and the
+//               listening socket, answers requests and takes new
+//               connections while it has room, until SHUTDOWN. Takes
+//               checkpoints as they fall due and repairs damaged
+//               indexes. Status messages of the functions it calls are
+//               dropped; clients get replies.
+// PARAMETERS  :
+//      ServiceContext* context : Stores and listening socket
+// RETURNS     : void
+//
+static void serveClients(ServiceContext* context) {
+    bool wasQuiet = quietStatus(true);
+    ServiceWorker worker;
+    worker.output = (char*)malloc(SERVICE_OUTPUT_BYTES);
+    worker.outputLength = 0;
+    worker.fields = new std::string_view[ORDER_MAX_FIELDS];
+    worker.items = (OrderItem*)malloc(sizeof(OrderItem) * MAX_PARTS_PER_ORDER);
+    ServiceClient* clients = (ServiceClient*)malloc(sizeof(ServiceClient) * SERVICE_CLIENTS_PER_THREAD);
+    struct pollfd* polled = (struct pollfd*)malloc(sizeof(struct pollfd) * (SERVICE_CLIENTS_PER_THREAD + 1));
+    int clientCount = 0;
+
+    while (worker.output != NULL && worker.items != NULL && clients != NULL && polled != NULL
+        && !serviceStopping.load()) {
+        if (warmupRebuildPending()) repairIndexes(context);
+        if (checkpointDue()) takeCheckpoint();
+
+        for (int i = 0; i < clientCount; i++) {
+            polled[i].fd = clients[i].socket;
+            polled[i].events = POLLIN;
+            polled[i].revents = 0;
+        }
+        bool listening = clientCount < SERVICE_CLIENTS_PER_THREAD;
+        if (listening) {
+            polled[clientCount].fd = context->listener;
+            polled[clientCount].events = POLLIN;
+            polled[clientCount].revents = 0;
+        }
+
+        int polledCount = clientCount + (listening ? 1 : 0);
+        if (pollSockets(polled, (unsigned long)polledCount, SERVICE_POLL_MS) <= 0) continue;
+
+        // Closed connections are replaced by the last one, which was already handled
+        bool accepting = listening && (polled[clientCount].revents & POLLIN) != 0;
+        for (int i = clientCount - 1; i >= 0; i--) {
+            if (polled[i].revents == 0) continue;
+            if ((polled[i].revents & POLLIN) == 0 || !readRequests(&clients[i], context, &worker)) {
+                closeSocket(clients[i].socket);
+                free(clients[i].input);
+                clients[i] = clients[--clientCount];
+                worker.outputLength = 0;
+            }
+        }
+        if (accepting && acceptClient(context->listener, &clients[clientCount])) clientCount++;
+    }
+
+    for (int i = 0; clients != NULL && i < clientCount; i++) {
+        closeSocket(clients[i].socket);
+        free(clients[i].input);
+    }
+    free(polled);
+    free(clients);
+    free(worker.items);
+    delete[] worker.fields;
+    free(worker.output);
+    quietStatus(wasQuiet);
+}
+
+//
+// FUNCTION    : openListener
+// DESCRIPTION : Creates the listening UNIX domain socket, replacing a
+//               socket file left by an earlier run
+// PARAMETERS  :
+//      const char* socketPath : Socket file
+// RETURNS     : ServiceSocket - Non-blocking listening socket, or
+//               SERVICE_NO_SOCKET on failure
+//
+static ServiceSocket openListener(const char* socketPath) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        printf("Socket path too long: %s\n", socketPath);
+        return SERVICE_NO_SOCKET;
+    }
+    strcpy_s(address.sun_path, sizeof(address.sun_path), socketPath);
+
+    ServiceSocket listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener == SERVICE_NO_SOCKET) {
+        printf("Could not create service socket.\n");
+        return SERVICE_NO_SOCKET;
+    }
+
+    remove(socketPath);
+    if (bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+        printf("Could not listen on %s\n", socketPath);
+        closeSocket(listener);
+        return SERVICE_NO_SOCKET;
+    }
+    setBlocking(listener, false);
+    return listener;
+}
+
+//
+// FUNCTION    : runService
+// DESCRIPTION : Serves requests for the stores on a UNIX domain socket
+//               with a pool of worker threads, the calling thread being
+//               one of them, until a client sends SHUTDOWN
+// PARAMETERS  :
+//      const char* socketPath : Socket file
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : bool - false if the socket or the read view could not be set up
+//
+bool runService(const char* socketPath, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders) {
+#ifdef _WIN32
+    WSADATA winsock;
+    if (WSAStartup(MAKEWORD(2, 2), &winsock) != 0) {
+        printf("Could not start Winsock.\n");
+        return false;
+    }
+#endif
+
+    ServiceContext context;
+    context.customers = customers;
+    context.parts = parts;
+    context.orders = orders;
+    context.listener = openListener(socketPath);
+    if (context.listener == SERVICE_NO_SOCKET) {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    // Bring the lookup indexes up to date so readers only read them
+    findCustomer(customers, 0);
+    findPart(parts, 0);
+    findOrder(orders, 0);
+    if (!viewPublish(customers, parts)) {
+        printf("Not enough memory for the read view.\n");
+        closeSocket(context.listener);
+        remove(socketPath);
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    int threadCount = serviceThreads > 0 ? serviceThreads : (int)std::thread::hardware_concurrency();
+    if (threadCount < 1) threadCount = 1;
+
+    serviceStopping.store(false);
+    serviceRequests.store(0);
+    printf("Serving on %s with %d threads.\n", socketPath, threadCount);
+    fflush(stdout);
+    logMessage("Service started");
+
+    std::thread* workers = new std::thread[threadCount - 1];
+    int started = 0;
+    try {
+        for (; started < threadCount - 1; started++) {
+            workers[started] = std::thread(serveClients, &context);
+        }
+    }
+    catch (...) {
+    }
+    serveClients(&context);
+    for (int i = 0; i < started; i++) {
+        workers[i].join();
+    }
+    delete[] workers;
+
+    closeSocket(context.listener);
+    remove(socketPath);
+    viewFree();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+
+    printf("Service stopped after %llu requests.\n", serviceRequests.load());
+    logMessage("Service stopped");
+    return true;
+}
@@ -0,0 +1,52 @@
+/*
+* FILE          : Service.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for the local service mode including:
+*      - UNIX domain socket request protocol
+*      - Worker thread and connection limits
+*      - Function prototype for serving the in-memory stores
+*      A request is one line; the reply is one line starting with OK or
+*      ERR. Record replies are the record's line as stored in its .db
+*      file. Requests may be pipelined.
+*          PING                             OK
+*          PART <id>                        OK <parts.db line>
+*          CUSTOMER <id>                    OK <customers.db line>
+*          ORDER <id>                       OK <orders.db line>
+*          PLACE CustomerID|PartID|Quantity|...   OK <order ID>, or ERR and why
+*                                              the order was turned down
+*          STOCK <part id> <quantity>       OK (restocking retries backorders)
+*          EOD                              OK after end-of-day processing
+*          REPORT                           OK parts|units|stock value|backordered|
+*                                              customers|total balance|view version
+*          SHUTDOWN                         OK, then the service stops
+*      Replies to PLACE, STOCK and EOD are sent once the change is in the
+*      write-ahead log (Wal.h); requests answered together share a sync.
+*      Customer and part reads (PART, CUSTOMER, REPORT) use the published
+*      view (StoreView.h): they never wait, even during EOD, and each sees
+*      one consistent version. Order reads run concurrently with each
+*      other; writes to a store are serialized and wait for its readers.
+*      Workers print nothing per request; what the menus would print is
+*      dropped (quietStatus) and the reply carries the outcome.
+*/
+
+#ifndef SERVICE_H
+#define SERVICE_H
+
+#include "RecordStore.h"
+
+#define SERVICE_DEFAULT_SOCKET "pwh.sock"   // Socket path used when none is given
+#define SERVICE_MAX_REQUEST 32768           // Longest request line
+#define SERVICE_MAX_REPLY 32768             // Longest reply line
+#define SERVICE_CLIENTS_PER_THREAD 256      // Connections one worker serves at once
+#define SERVICE_POLL_MS 200                 // How often idle workers check for shutdown
+
+extern int serviceThreads;      // Worker threads for the service (0 = one per core)
+
+// Function prototypes
+bool runService(const char* socketPath, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders);       // Serve requests until SHUTDOWN, false if the socket failed
+
+#endif
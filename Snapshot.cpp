@@ -0,0 +1,545 @@
+/*
+* FILE          : Snapshot.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of binary store snapshots including:
+*      - Chunk-at-a-time writing of raw records to a temporary file that
+*        is flushed to disk and moved over the old snapshot (batched
+*        writes with the io_uring backend)
+*      - Header and checksum validation of a mapped snapshot
+*      - Bulk copying of mapped records into a store, or reading them
+*        straight into it with the io_uring backend
+*      - Copy-on-write mapping of a snapshot as a store's chunks, checked
+*        in the background (lazy start-up, Warmup.h)
+*/
+
+#include "Snapshot.h"
+#include "DbReader.h"
+#include "FileIo.h"
+#include "Warmup.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define CHECKSUM_PRIME1 0x9E3779B185EBCA87ULL
+#define CHECKSUM_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define CHECKSUM_PRIME3 0x165667B19E3779F9ULL
+
+static_assert(sizeof(SnapshotHeader) <= SNAPSHOT_DATA_OFFSET, "snapshot header must fit before the records");
+
+//
+// FUNCTION    : rotateLeft
+// DESCRIPTION : Rotates a 64-bit value left
+// PARAMETERS  :
+//      unsigned long long value : Value to rotate
+//      int bits                 : Bits to rotate by (1-63)
+// RETURNS     : unsigned long long - Rotated value
+//
+static inline unsigned long long rotateLeft(unsigned long long value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+//
+// FUNCTION    : checksumRound
+// DESCRIPTION : Folds one 64-bit word into a checksum lane
+// PARAMETERS  :
+//      unsigned long long lane : Current lane value
+//      const unsigned char* p  : Next 8 bytes (any alignment)
+// RETURNS     : unsigned long long - New lane value
+//
+static inline unsigned long long checksumRound(unsigned long long lane, const unsigned char* p) {
+    unsigned long long word;
+    memcpy(&word, p, sizeof(word));
+    lane += word * CHECKSUM_PRIME2;
+    lane = rotateLeft(lane, 31);
+    return lane * CHECKSUM_PRIME1;
+}
+
+//
+// FUNCTION    : checksumBlock
+// DESCRIPTION : 64-bit checksum of a block of bytes. Four independent lanes
+//               take 32 bytes per step so the multiplies overlap; the
+//               result is mixed so every input bit affects every output bit.
+// PARAMETERS  :
+//      const void* data : Bytes to check
+//      size_t length    : Number of bytes
+// RETURNS     : unsigned long long - Checksum
+//
+unsigned long long checksumBlock(const void* data, size_t length) {
+    const unsigned char* p = (const unsigned char*)data;
+    const unsigned char* end = p + length;
+    unsigned long long lane1 = CHECKSUM_PRIME1 + CHECKSUM_PRIME2;
+    unsigned long long lane2 = CHECKSUM_PRIME2;
+    unsigned long long lane3 = 0;
+    unsigned long long lane4 = 0 - CHECKSUM_PRIME1;
+
+    while (end - p >= 32) {
+        lane1 = checksumRound(lane1, p);
+        lane2 = checksumRound(lane2, p + 8);
+        lane3 = checksumRound(lane3, p + 16);
+        lane4 = checksumRound(lane4, p + 24);
+        p += 32;
+    }
+
+    unsigned long long hash = rotateLeft(lane1, 1) + rotateLeft(lane2, 7) +
+        rotateLeft(lane3, 12) + rotateLeft(lane4, 18) + (unsigned long long)length;
+
+    while (end - p >= 8) {
+        hash ^= checksumRound(0, p);
+        hash = rotateLeft(hash, 27) * CHECKSUM_PRIME1 + CHECKSUM_PRIME3;
+        p += 8;
+    }
+    while (p < end) {
+        hash ^= *p * CHECKSUM_PRIME3;
+        hash = rotateLeft(hash, 11) * CHECKSUM_PRIME1;
+        p++;
+    }
+
+    hash ^= hash >> 33;
+    hash *= CHECKSUM_PRIME2;
+    hash ^= hash >> 29;
+    hash *= CHECKSUM_PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+//
+// FUNCTION    : combineChecksum
+// DESCRIPTION : Chains the checksum of one chunk of records onto the
+//               checksum of the chunks before it, so order matters
+// PARAMETERS  :
+//      unsigned long long total : Checksum so far
+//      unsigned long long chunk : Checksum of the next chunk
+// RETURNS     : unsigned long long - Combined checksum
+//
+static unsigned long long combineChecksum(unsigned long long total, unsigned long long chunk) {
+    return rotateLeft(total ^ chunk, 27) * CHECKSUM_PRIME1 + CHECKSUM_PRIME2;
+}
+
+//
+// FUNCTION    : headerChecksum
+// DESCRIPTION : Checksum of a header with its own checksum field zeroed
+// PARAMETERS  :
+//      const SnapshotHeader* header : Header to check
+// RETURNS     : unsigned long long - Checksum
+//
+static unsigned long long headerChecksum(const SnapshotHeader* header) {
+    SnapshotHeader copy = *header;
+    copy.headerChecksum = 0;
+    return checksumBlock(&copy, sizeof(copy));
+}
+
+//
+// FUNCTION    : snapshotIsCurrent
+// DESCRIPTION : Checks that a snapshot exists and that its text database has
+//               not been changed since (a missing text file counts as
+//               unchanged). A newer text file means it was edited or
+//               exported after the snapshot and must be imported instead.
+// PARAMETERS  :
+//      const char* filename     : Snapshot file
+//      const char* textFilename : Pipe-delimited database it stands in for
+// RETURNS     : bool - true if the snapshot should be loaded
+//
+bool snapshotIsCurrent(const char* filename, const char* textFilename) {
+    struct stat snapshotInfo;
+    struct stat textInfo;
+
+    if (stat(filename, &snapshotInfo) != 0) return false;
+    if (stat(textFilename, &textInfo) != 0) return true;
+    return snapshotInfo.st_mtime >= textInfo.st_mtime;
+}
+
+//
+// FUNCTION    : syncFile
+// DESCRIPTION : Flushes a file's buffered writes and waits until the
+//               operating system has put them on disk
+// PARAMETERS  :
+//      FILE* fp : Open file
+// RETURNS     : bool - true if everything written so far is on disk
+//
+bool syncFile(FILE* fp) {
+    if (fflush(fp) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(fp)) == 0;
+#else
+    return fsync(fileno(fp)) == 0;
+#endif
+}
+
+//
+// FUNCTION    : replaceFile
+// DESCRIPTION : Renames a file over another in one step, so a reader or a
+//               crash sees either the old target or the new one. The
+//               rename itself is flushed to disk before returning.
+// PARAMETERS  :
+//      const char* source : File to move (already synced)
+//      const char* target : File to replace
+// RETURNS     : bool - true on success
+//
+bool replaceFile(const char* source, const char* target) {
+#ifdef _WIN32
+    return MoveFileExA(source, target, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    if (rename(source, target) != 0) return false;
+
+    // The rename is a change to the directory, which has to be synced too
+    char directory[FILENAME_MAX];
+    const char* slash = strrchr(target, '/');
+    if (slash == NULL) {
+        strcpy_s(directory, sizeof(directory), ".");
+    }
+    else {
+        size_t length = slash == target ? 1 : (size_t)(slash - target);
+        if (length >= sizeof(directory)) return true;
+        memcpy(directory, target, length);
+        directory[length] = '\0';
+    }
+
+    int fd = open(directory, O_RDONLY);
+    if (fd < 0) return true;
+    fsync(fd);
+    close(fd);
+    return true;
+#endif
+}
+
+//
+// FUNCTION    : saveSnapshot
+// DESCRIPTION : Writes a store to a snapshot file, one chunk of records per
+//               write, through the file I/O backend (io_uring submits the
+//               chunk writes in batches). The records go to a temporary
+//               file that is synced and then moved over the old snapshot,
+//               so the old snapshot stays valid until the new one is
+//               complete on disk. The header is queued after the records,
+//               so it only carries their checksum once they are all
+//               written. A failed write removes the temporary file.
+// PARAMETERS  :
+//      const char* filename     : Snapshot file to write
+//      SnapshotKind kind        : Store being written
+//      const RecordStore* store : Records to save
+// RETURNS     : bool - true on success
+//
+bool saveSnapshot(const char* filename, SnapshotKind kind, const RecordStore* store) {
+    char tempName[FILENAME_MAX];
+    if (sprintf_s(tempName, sizeof(tempName), "%s%s", filename, SNAPSHOT_TEMP_SUFFIX) < 0) return false;
+
+    IoFile file;
+    if (!ioOpenWrite(&file, tempName)) return false;
+
+    unsigned long long checksum = 0;
+    unsigned long long offset = SNAPSHOT_DATA_OFFSET;
+    for (int first = 0; first < store->count; first += STORE_CHUNK_RECORDS) {
+        int records = store->count - first < STORE_CHUNK_RECORDS ? store->count - first : STORE_CHUNK_RECORDS;
+        size_t bytes = (size_t)records * store->recordSize;
+        const void* chunk = storeAt(store, first);
+
+        checksum = combineChecksum(checksum, checksumBlock(chunk, bytes));
+        ioWrite(&file, chunk, bytes, offset);
+        offset += bytes;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.kind = (unsigned int)kind;
+    header.recordSize = (unsigned int)store->recordSize;
+    header.count = (unsigned long long)store->count;
+    header.dataChecksum = checksum;
+    header.headerChecksum = headerChecksum(&header);
+
+    unsigned char headerBlock[SNAPSHOT_DATA_OFFSET];
+    memset(headerBlock, 0, sizeof(headerBlock));
+    memcpy(headerBlock, &header, sizeof(header));
+    ioWrite(&file, headerBlock, sizeof(headerBlock), 0);
+
+    bool written = ioClose(&file);
+    written = written && replaceFile(tempName, filename);
+    if (!written) remove(tempName);
+    return written;
+}
+
+//
+// FUNCTION    : headerMatches
+// DESCRIPTION : Checks a snapshot header against the store it is loaded
+//               into and the size of its file
+// PARAMETERS  :
+//      const SnapshotHeader* header : Header read from the file
+//      unsigned long long fileSize  : Size of the snapshot file
+//      SnapshotKind kind            : Store expected in the file
+//      const RecordStore* store     : Store to fill
+// RETURNS     : bool - true if the header is intact and the file holds
+//               exactly header->count records of this store
+//
+static bool headerMatches(const SnapshotHeader* header, unsigned long long fileSize, SnapshotKind kind,
+    const RecordStore* store) {
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) return false;
+    if (header->headerChecksum != headerChecksum(header)) return false;
+    if (header->version != SNAPSHOT_VERSION || header->kind != (unsigned int)kind) return false;
+    if (header->recordSize != store->recordSize || header->count > INT_MAX) return false;
+    if ((fileSize - SNAPSHOT_DATA_OFFSET) / store->recordSize != header->count ||
+        (fileSize - SNAPSHOT_DATA_OFFSET) % store->recordSize != 0) return false;
+    return true;
+}
+
+//
+// FUNCTION    : readSnapshot
+// DESCRIPTION : Validates a mapped snapshot and copies its records into a
+//               store a chunk at a time, checking each chunk as it goes
+// PARAMETERS  :
+//      const MappedFile* file : Mapped snapshot
+//      SnapshotKind kind      : Store expected in the file
+//      RecordStore* store     : Store to fill (emptied first)
+// RETURNS     : bool - true if the snapshot was valid and fully loaded
+//
+static bool readSnapshot(const MappedFile* file, SnapshotKind kind, RecordStore* store) {
+    if (file->size < SNAPSHOT_DATA_OFFSET) return false;
+
+    SnapshotHeader header;
+    memcpy(&header, file->data, sizeof(header));
+    if (!headerMatches(&header, file->size, kind, store)) return false;
+
+    int count = (int)header.count;
+    storeClear(store);
+    if (!storeResize(store, count)) {
+        storeClear(store);
+        return false;
+    }
+
+    const char* data = file->data + SNAPSHOT_DATA_OFFSET;
+    unsigned long long checksum = 0;
+    for (int first = 0; first < count; first += STORE_CHUNK_RECORDS) {
+        int records = count - first < STORE_CHUNK_RECORDS ? count - first : STORE_CHUNK_RECORDS;
+        size_t bytes = (size_t)records * store->recordSize;
+        const char* chunk = data + (size_t)first * store->recordSize;
+
+        checksum = combineChecksum(checksum, checksumBlock(chunk, bytes));
+        memcpy(storeAt(store, first), chunk, bytes);
+    }
+
+    if (checksum != header.dataChecksum) {
+        storeClear(store);
+        return false;
+    }
+    return true;
+}
+
+//
+// FUNCTION    : readSnapshotDirect
+// DESCRIPTION : Loads a snapshot with the io_uring backend. After the
+//               header is checked, every chunk of records is read straight
+//               into its place in the store, IO_QUEUE_DEPTH reads at a
+//               time, and the chunks are checked once all have arrived.
+//               Nothing is mapped and nothing is copied twice.
+// PARAMETERS  :
+//      const char* filename : Snapshot file to read
+//      SnapshotKind kind    : Store expected in the file
+//      RecordStore* store   : Store to fill (emptied first)
+// RETURNS     : bool - true if the snapshot was valid and fully loaded
+//
+static bool readSnapshotDirect(const char* filename, SnapshotKind kind, RecordStore* store) {
+    IoFile file;
+    unsigned long long size;
+    if (!ioOpenRead(&file, filename, &size)) return false;
+
+    SnapshotHeader header;
+    ioRead(&file, &header, sizeof(header), 0);
+    if (size < SNAPSHOT_DATA_OFFSET || !ioWait(&file) || !headerMatches(&header, size, kind, store)) {
+        ioClose(&file);
+        return false;
+    }
+
+    int count = (int)header.count;
+    storeClear(store);
+    if (!storeResize(store, count)) {
+        ioClose(&file);
+        storeClear(store);
+        return false;
+    }
+
+    for (int first = 0; first < count; first += STORE_CHUNK_RECORDS) {
+        int records = count - first < STORE_CHUNK_RECORDS ? count - first : STORE_CHUNK_RECORDS;
+        ioRead(&file, storeAt(store, first), (size_t)records * store->recordSize,
+            SNAPSHOT_DATA_OFFSET + (unsigned long long)first * store->recordSize);
+    }
+    bool loaded = ioClose(&file);
+
+    unsigned long long checksum = 0;
+    for (int first = 0; loaded && first < count; first += STORE_CHUNK_RECORDS) {
+        int records = count - first < STORE_CHUNK_RECORDS ? count - first : STORE_CHUNK_RECORDS;
+        checksum = combineChecksum(checksum, checksumBlock(storeAt(store, first), (size_t)records * store->recordSize));
+    }
+
+    if (!loaded || checksum != header.dataChecksum) {
+        storeClear(store);
+        return false;
+    }
+    return true;
+}
+
+//
+// FUNCTION    : loadSnapshot
+// DESCRIPTION : Replaces the contents of a store with a snapshot file. The
+//               file is memory-mapped and its records are copied in whole
+//               chunks (with io_uring they are read straight into the
+//               store); nothing is parsed.
+// PARAMETERS  :
+//      const char* filename : Snapshot file to read
+//      SnapshotKind kind    : Store expected in the file
+//      RecordStore* store   : Store to fill
+// RETURNS     : bool - false if the file is missing, damaged, from another
+//               version or build, or does not fit in memory (the store is
+//               then empty)
+//
+bool loadSnapshot(const char* filename, SnapshotKind kind, RecordStore* store) {
+    if (fileIoMode == FILE_IO_URING && fileIoAvailable()) return readSnapshotDirect(filename, kind, store);
+
+    MappedFile file;
+    if (!mapDbFile(&file, filename)) return false;
+
+    bool loaded = readSnapshot(&file, kind, store);
+    unmapDbFile(&file);
+    return loaded;
+}
+
+//
+// FUNCTION    : checkSnapshotFile
+// DESCRIPTION : Warm-up check of a mapped snapshot: the header and the
+//               checksum of every chunk of records
+// PARAMETERS  :
+//      const char* data  : Contents of the file
+//      size_t size       : Size of the file
+//      long long context : SnapshotKind expected in the file
+// RETURNS     : bool - true if the file is intact
+//
+static bool checkSnapshotFile(const char* data, size_t size, long long context) {
+    if (size < SNAPSHOT_DATA_OFFSET) return false;
+
+    SnapshotHeader header;
+    memcpy(&header, data, sizeof(header));
+    RecordStore shape;
+    storeInit(&shape, header.recordSize);
+    if (header.recordSize == 0 || !headerMatches(&header, size, (SnapshotKind)context, &shape)) return false;
+
+    const char* records = data + SNAPSHOT_DATA_OFFSET;
+    int count = (int)header.count;
+    unsigned long long checksum = 0;
+    for (int first = 0; first < count; first += STORE_CHUNK_RECORDS) {
+        int chunkRecords = count - first < STORE_CHUNK_RECORDS ? count - first : STORE_CHUNK_RECORDS;
+        checksum = combineChecksum(checksum,
+            checksumBlock(records + (size_t)first * header.recordSize, (size_t)chunkRecords * header.recordSize));
+    }
+    return checksum == header.dataChecksum;
+}
+
+//
+// FUNCTION    : mapSnapshot
+// DESCRIPTION : Fills an empty store from a snapshot without reading its
+//               records. The file is mapped copy-on-write and each full
+//               chunk of records becomes one of the store's chunks in
+//               place; only the last partial chunk is copied, so the store
+//               can grow. Records are read from disk when first used and
+//               changes stay in memory until the next save. Only the header
+//               is checked here: when warm is set the file is queued for the
+//               warm-up thread, which faults it in and checks the records.
+//               Not available on Windows.
+// PARAMETERS  :
+//      const char* filename     : Snapshot file to map
+//      SnapshotKind kind        : Store expected in the file
+//      RecordStore* store       : Empty store to fill
+//      unsigned long long* tag  : Receives the snapshotTag (NULL if unused)
+//      bool warm                : Queue the file for warming and checking
+// RETURNS     : bool - false if the file is missing or its header is
+//               damaged or from another version or build (the store is
+//               then unchanged)
+//
+bool mapSnapshot(const char* filename, SnapshotKind kind, RecordStore* store, unsigned long long* tag, bool warm) {
+#ifdef _WIN32
+    (void)filename; (void)kind; (void)store; (void)tag; (void)warm;
+    return false;
+#else
+    if (store->chunkCount > 0) return false;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    SnapshotHeader header;
+    bool usable = fstat(fd, &info) == 0 && info.st_size >= SNAPSHOT_DATA_OFFSET &&
+        pread(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+        headerMatches(&header, (unsigned long long)info.st_size, kind, store);
+    void* data = MAP_FAILED;
+    if (usable) data = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    int count = (int)header.count;
+    int fullChunks = count >> STORE_CHUNK_SHIFT;
+    int tailRecords = count & STORE_CHUNK_MASK;
+    size_t chunkBytes = store->recordSize * STORE_CHUNK_RECORDS;
+    unsigned char* records = (unsigned char*)data + SNAPSHOT_DATA_OFFSET;
+
+    unsigned char* tail = NULL;
+    if (tailRecords > 0) tail = (unsigned char*)malloc(chunkBytes);
+    bool mapped = (tailRecords == 0 || tail != NULL) && storeReserve(store, count) &&
+        (!warm || warmupAdd(filename, data, (size_t)info.st_size, checkSnapshotFile, kind, false));
+    if (!mapped) {
+        free(tail);
+        munmap(data, (size_t)info.st_size);
+        return false;
+    }
+
+    for (int c = 0; c < fullChunks; c++) {
+        store->chunks[c] = records + (size_t)c * chunkBytes;
+    }
+    if (tail != NULL) {
+        memcpy(tail, records + (size_t)fullChunks * chunkBytes, (size_t)tailRecords * store->recordSize);
+        store->chunks[fullChunks] = tail;
+    }
+    store->chunkCount = fullChunks + (tail != NULL ? 1 : 0);
+    store->mappedChunks = fullChunks;
+    store->mapping = data;
+    store->mappingBytes = (size_t)info.st_size;
+    store->count = count;
+    if (tag != NULL) *tag = header.headerChecksum;
+    return true;
+#endif
+}
+
+//
+// FUNCTION    : snapshotTag
+// DESCRIPTION : Reads the tag that identifies one saved version of a
+//               snapshot (its header checksum, which covers the record
+//               count and checksum). Index files record it so they are
+//               only used with the snapshot they were built from.
+// PARAMETERS  :
+//      const char* filename    : Snapshot file
+//      unsigned long long* tag : Receives the tag
+// RETURNS     : bool - false if the file is missing or its header is damaged
+//
+bool snapshotTag(const char* filename, unsigned long long* tag) {
+    FILE* fp;
+    if (fopen_s(&fp, filename, "rb") != 0 || fp == NULL) return false;
+
+    SnapshotHeader header;
+    bool read = fread(&header, sizeof(header), 1, fp) == 1;
+    fclose(fp);
+    if (!read || memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.headerChecksum != headerChecksum(&header)) return false;
+
+    *tag = header.headerChecksum;
+    return true;
+}
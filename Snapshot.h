@@ -0,0 +1,64 @@
+/*
+* FILE          : Snapshot.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for binary store snapshots including:
+*      - Versioned, checksummed snapshot file layout
+*      - Snapshot freshness check against the text database
+*      - Function prototypes for saving and loading snapshots
+*      - Copy-on-write mapping of a snapshot for lazy start-up
+*      - Checksum, flush-to-disk and atomic replace helpers shared with
+*        the write-ahead log (Wal.h)
+*      A snapshot is written to a temporary file, flushed to disk and then
+*      moved over the old one, so a crash leaves either the old or the new
+*      snapshot and never a partial one.
+*/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "RecordStore.h"
+#include <stdio.h>
+
+#define SNAPSHOT_MAGIC "PWHSNAP"    // First 8 bytes of every snapshot (with terminator)
+#define SNAPSHOT_VERSION 3          // Bumped whenever the layout or a record struct changes
+#define SNAPSHOT_DATA_OFFSET 64     // Records start here, after the padded header
+#define SNAPSHOT_TEMP_SUFFIX ".tmp" // Added to a snapshot's name while it is written
+
+// Which store a snapshot holds
+typedef enum {
+    SNAPSHOT_CUSTOMERS = 1,
+    SNAPSHOT_PARTS = 2,
+    SNAPSHOT_ORDERS = 3,
+    SNAPSHOT_ORDER_LINES = 4
+} SnapshotKind;
+
+// Snapshot file header. The records follow at SNAPSHOT_DATA_OFFSET as raw
+// structs in store order, so the file is only valid on the platform and
+// build that wrote it; recordSize and the version guard against reading a
+// snapshot from a different layout.
+typedef struct {
+    char magic[8];                  // SNAPSHOT_MAGIC
+    unsigned int version;           // SNAPSHOT_VERSION
+    unsigned int kind;              // SnapshotKind
+    unsigned int recordSize;        // sizeof the record struct
+    unsigned int reserved;          // Zero
+    unsigned long long count;       // Records in the file
+    unsigned long long dataChecksum; // Checksum of the record bytes
+    unsigned long long headerChecksum; // Checksum of this header with this field zero
+} SnapshotHeader;
+
+// Function prototypes
+bool snapshotIsCurrent(const char* filename, const char* textFilename);    // Snapshot exists and is not older than the text file
+bool saveSnapshot(const char* filename, SnapshotKind kind, const RecordStore* store); // Write a store to a snapshot
+bool loadSnapshot(const char* filename, SnapshotKind kind, RecordStore* store);       // Replace a store from a snapshot
+bool mapSnapshot(const char* filename, SnapshotKind kind, RecordStore* store,
+    unsigned long long* tag, bool warm);                                  // Fill an empty store from a mapped snapshot
+bool snapshotTag(const char* filename, unsigned long long* tag);          // Tag identifying a saved snapshot
+unsigned long long checksumBlock(const void* data, size_t length);        // 64-bit checksum of a block of bytes
+bool syncFile(FILE* fp);                                                  // Flush a file's writes to disk
+bool replaceFile(const char* source, const char* target);                // Move a file over another in one step
+
+#endif
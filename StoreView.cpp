@@ -0,0 +1,483 @@
+/*
+* FILE          : StoreView.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of published read views including:
+*      - Copy-on-write versions built from the chunks flagged since the last one
+*      - ID indexes shared between versions, with appended IDs kept apart
+*      - Reader epoch slots claimed once per thread
+*      - Deferred freeing of replaced chunks, indexes and directories
+*      A read section stores the global epoch in its thread's slot before
+*      loading the current version. Publishing swaps the version and then
+*      advances the epoch, so memory retired at epoch R is only reachable
+*      from sections whose slot holds R or less. It is freed once every
+*      slot is idle or newer.
+*/
+
+#include "StoreView.h"
+#include "Customer.h"
+#include "Part.h"
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+
+#define VIEW_NO_SLOT -1         // Thread has not claimed a reader slot
+#define VIEW_LOCKED_SLOT -2     // Thread read under publishMutex (no slot was free)
+
+// Memory of an old version waiting for its readers to finish
+typedef struct {
+    unsigned long long epoch;   // Epoch at which it was replaced
+    void* memory;               // Block to free
+    bool isIndex;               // memory is an IdIndex to release first
+} RetiredBlock;
+
+// Reader slot of one thread, given back when the thread ends
+struct ReaderSlot {
+    int slot = VIEW_NO_SLOT;
+    ~ReaderSlot();
+};
+
+static std::atomic<DataView*> published(nullptr);                  // Current version
+static std::atomic<unsigned long long> globalEpoch(1);              // Advanced by every publish
+static std::atomic<unsigned long long> readerEpochs[VIEW_MAX_READERS]; // Epoch of each active section, 0 if idle
+static std::atomic<bool> slotTaken[VIEW_MAX_READERS];              // Slot belongs to a thread
+static std::mutex publishMutex;                                     // Serializes publishers and the retired list
+static RecordStore retired;                                         // RetiredBlock records (under publishMutex)
+static bool retiredReady = false;
+static thread_local ReaderSlot readerSlot;
+
+//
+// FUNCTION    : ~ReaderSlot
+// DESCRIPTION : Frees the thread's reader slot for another thread
+//
+ReaderSlot::~ReaderSlot() {
+    if (slot >= 0) {
+        readerEpochs[slot].store(0);
+        slotTaken[slot].store(false);
+    }
+}
+
+//
+// FUNCTION    : customerKey
+// DESCRIPTION : Returns the ID of a customer record
+// PARAMETERS  :
+//      const void* record : Customer
+// RETURNS     : long long - Customer ID
+//
+static long long customerKey(const void* record) {
+    return ((const Customer*)record)->customerID;
+}
+
+//
+// FUNCTION    : partKey
+// DESCRIPTION : Returns the ID of a part record
+// PARAMETERS  :
+//      const void* record : Part
+// RETURNS     : long long - Part ID
+//
+static long long partKey(const void* record) {
+    return ((const Parts*)record)->PartID;
+}
+
+//
+// FUNCTION    : chunkRecords
+// DESCRIPTION : Number of records held by one chunk of a store
+// PARAMETERS  :
+//      int count : Records in the store
+//      int chunk : Chunk number
+// RETURNS     : int - Records in the chunk
+//
+static int chunkRecords(int count, int chunk) {
+    int left = count - (chunk << STORE_CHUNK_SHIFT);
+    return left < STORE_CHUNK_RECORDS ? left : STORE_CHUNK_RECORDS;
+}
+
+//
+// FUNCTION    : retire
+// DESCRIPTION : Queues memory of a replaced version for freeing. Called
+//               with publishMutex held.
+// PARAMETERS  :
+//      void* memory                : Block to free (NULL is ignored)
+//      bool isIndex                : memory is an IdIndex
+//      unsigned long long epoch    : Epoch at which it was replaced
+// RETURNS     : bool - false if the block could not be queued (it is then
+//               leaked rather than freed under a reader)
+//
+static bool retire(void* memory, bool isIndex, unsigned long long epoch) {
+    if (memory == NULL) return true;
+    RetiredBlock* block = (RetiredBlock*)storeAppend(&retired);
+    if (block == NULL) return false;
+    block->epoch = epoch;
+    block->memory = memory;
+    block->isIndex = isIndex;
+    return true;
+}
+
+//
+// FUNCTION    : releaseBlock
+// DESCRIPTION : Frees one retired block
+// PARAMETERS  :
+//      const RetiredBlock* block : Block to free
+// RETURNS     : void
+//
+static void releaseBlock(const RetiredBlock* block) {
+    if (block->isIndex) idIndexFree((IdIndex*)block->memory);
+    free(block->memory);
+}
+
+//
+// FUNCTION    : reclaim
+// DESCRIPTION : Frees the retired blocks no read section can still reach.
+//               Called with publishMutex held.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+static void reclaim() {
+    unsigned long long oldest = ~0ULL;
+    for (int i = 0; i < VIEW_MAX_READERS; i++) {
+        unsigned long long reading = readerEpochs[i].load();
+        if (reading != 0 && reading < oldest) oldest = reading;
+    }
+
+    int kept = 0;
+    for (int i = 0; i < retired.count; i++) {
+        RetiredBlock* block = (RetiredBlock*)storeAt(&retired, i);
+        if (block->epoch < oldest) releaseBlock(block);
+        else *(RetiredBlock*)storeAt(&retired, kept++) = *block;
+    }
+    storeResize(&retired, kept);
+}
+
+//
+// FUNCTION    : freeNewChunks
+// DESCRIPTION : Frees the chunks of a half-built version that were copied
+//               for it, leaving the ones shared with the previous version
+// PARAMETERS  :
+//      StoreView* view           : Half-built version
+//      const StoreView* previous : Version it was built from (may be NULL)
+//      int built                 : Chunks filled in so far
+// RETURNS     : void
+//
+static void freeNewChunks(StoreView* view, const StoreView* previous, int built) {
+    for (int c = 0; c < built; c++) {
+        if (previous == NULL || c >= previous->chunkCount || view->chunks[c] != previous->chunks[c]) {
+            free(view->chunks[c]);
+        }
+    }
+    free(view->chunks);
+    view->chunks = NULL;
+}
+
+//
+// FUNCTION    : freeIndex
+// DESCRIPTION : Frees an index built for a version
+// PARAMETERS  :
+//      IdIndex* index : Index to free (NULL is ignored)
+// RETURNS     : void
+//
+static void freeIndex(IdIndex* index) {
+    if (index == NULL) return;
+    idIndexFree(index);
+    free(index);
+}
+
+//
+// FUNCTION    : indexRecords
+// DESCRIPTION : Builds an ID index over the records of a version from a
+//               given position to the end
+// PARAMETERS  :
+//      const StoreView* view           : Version holding the records
+//      int first                       : First record indexed
+//      long long (*key)(const void*)   : Returns the ID of a record
+// RETURNS     : IdIndex* - New index, NULL if out of memory
+//
+static IdIndex* indexRecords(const StoreView* view, int first, long long (*key)(const void*)) {
+    IdIndex* index = (IdIndex*)calloc(1, sizeof(IdIndex));
+    if (index == NULL) return NULL;
+
+    idIndexReset(index, view, view->count - first);
+    if (index->capacity == 0) {
+        free(index);
+        return NULL;
+    }
+    for (int i = first; i < view->count; i++) {
+        idIndexInsert(index, key(viewAt(view, i)), i);
+    }
+    index->indexedRecords = view->count;
+    return index;
+}
+
+//
+// FUNCTION    : buildView
+// DESCRIPTION : Builds a version of a live store. Chunks the writers have
+//               not flagged since the previous version are shared with it;
+//               the flagged ones are copied. The previous ID index is kept
+//               unless one of its IDs changed or too many records were
+//               appended since it was built; appended records get a small
+//               index of their own.
+// PARAMETERS  :
+//      StoreView* view                 : Receives the version
+//      const StoreView* previous       : Current version (NULL for none)
+//      const RecordStore* live         : Live store
+//      long long (*key)(const void*)   : Returns the ID of a record
+// RETURNS     : bool - false if out of memory (nothing is allocated)
+//
+static bool buildView(StoreView* view, const StoreView* previous, const RecordStore* live,
+    long long (*key)(const void*)) {
+    view->recordSize = live->recordSize;
+    view->count = live->count;
+    view->chunkCount = (live->count + STORE_CHUNK_MASK) >> STORE_CHUNK_SHIFT;
+    view->chunks = (unsigned char**)malloc(sizeof(unsigned char*) * (size_t)(view->chunkCount > 0 ? view->chunkCount : 1));
+    view->index = NULL;
+    view->indexedCount = 0;
+    view->recent = NULL;
+    if (view->chunks == NULL) return false;
+
+    bool indexChanged = previous == NULL || live->count < previous->indexedCount;
+    bool recentChanged = previous == NULL || live->count != previous->count;
+    for (int c = 0; c < view->chunkCount; c++) {
+        int records = chunkRecords(live->count, c);
+        size_t bytes = (size_t)records * live->recordSize;
+        const unsigned char* source = live->chunks[c];
+        bool hadChunk = previous != NULL && c < previous->chunkCount;
+
+        if (hadChunk && !live->viewDirty[c] && chunkRecords(previous->count, c) == records) {
+            view->chunks[c] = previous->chunks[c];
+            continue;
+        }
+
+        view->chunks[c] = (unsigned char*)malloc(bytes);
+        if (view->chunks[c] == NULL) {
+            freeNewChunks(view, previous, c);
+            return false;
+        }
+        memcpy(view->chunks[c], source, bytes);
+        if (!hadChunk) continue;
+
+        // A changed ID means the index holding it no longer fits
+        int compared = chunkRecords(previous->count, c);
+        if (compared > records) compared = records;
+        for (int r = 0; !indexChanged && r < compared; r++) {
+            size_t offset = (size_t)r * live->recordSize;
+            if (key(previous->chunks[c] + offset) == key(source + offset)) continue;
+            if ((c << STORE_CHUNK_SHIFT) + r < previous->indexedCount) indexChanged = true;
+            else recentChanged = true;
+        }
+    }
+
+    bool indexed = true;
+    if (indexChanged || live->count - previous->indexedCount > VIEW_MAX_RECENT) {
+        view->index = indexRecords(view, 0, key);
+        view->indexedCount = view->count;
+        indexed = view->index != NULL;
+    }
+    else {
+        view->index = previous->index;
+        view->indexedCount = previous->indexedCount;
+        if (!recentChanged) view->recent = previous->recent;
+        else if (view->count > view->indexedCount) {
+            view->recent = indexRecords(view, view->indexedCount, key);
+            indexed = view->recent != NULL;
+        }
+    }
+
+    if (!indexed) {
+        freeNewChunks(view, previous, view->chunkCount);
+        return false;
+    }
+    return true;
+}
+
+//
+// FUNCTION    : discardView
+// DESCRIPTION : Frees what a version that was never published does not
+//               share with the previous one
+// PARAMETERS  :
+//      StoreView* view           : Unpublished version
+//      const StoreView* previous : Version it was built from (may be NULL)
+// RETURNS     : void
+//
+static void discardView(StoreView* view, const StoreView* previous) {
+    if (previous == NULL || view->index != previous->index) freeIndex(view->index);
+    if (previous == NULL || view->recent != previous->recent) freeIndex(view->recent);
+    freeNewChunks(view, previous, view->chunkCount);
+}
+
+//
+// FUNCTION    : retireView
+// DESCRIPTION : Queues the parts of a replaced version that the new
+//               version does not share. Called with publishMutex held.
+// PARAMETERS  :
+//      StoreView* old             : Replaced version
+//      const StoreView* current   : Version replacing it
+//      unsigned long long epoch   : Epoch at which it was replaced
+// RETURNS     : void
+//
+static void retireView(StoreView* old, const StoreView* current, unsigned long long epoch) {
+    for (int c = 0; c < old->chunkCount; c++) {
+        if (c >= current->chunkCount || current->chunks[c] != old->chunks[c]) retire(old->chunks[c], false, epoch);
+    }
+    retire(old->chunks, false, epoch);
+    if (old->index != current->index) retire(old->index, true, epoch);
+    if (old->recent != current->recent) retire(old->recent, true, epoch);
+}
+
+//
+// FUNCTION    : freeView
+// DESCRIPTION : Frees every part of a version (no other version shares it)
+// PARAMETERS  :
+//      StoreView* view : Version to free
+// RETURNS     : void
+//
+static void freeView(StoreView* view) {
+    for (int c = 0; c < view->chunkCount; c++) {
+        free(view->chunks[c]);
+    }
+    free(view->chunks);
+    freeIndex(view->index);
+    freeIndex(view->recent);
+}
+
+//
+// FUNCTION    : viewPublish
+// DESCRIPTION : Publishes the current contents of the live customer and
+//               part stores as the version new read sections see. The
+//               caller must keep other writers off the live stores until
+//               it returns. Only the chunks flagged in viewDirty since the
+//               last publish are copied, and the flags are then cleared.
+//               Sections already running keep their version.
+// PARAMETERS  :
+//      RecordStore* customers : Live customer store
+//      RecordStore* parts     : Live part store
+// RETURNS     : bool - false if out of memory; the previous version stays
+//               current
+//
+bool viewPublish(RecordStore* customers, RecordStore* parts) {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    if (!retiredReady) {
+        storeInit(&retired, sizeof(RetiredBlock));
+        retiredReady = true;
+    }
+
+    DataView* old = published.load();
+    DataView* view = (DataView*)malloc(sizeof(DataView));
+    if (view == NULL) return false;
+    if (!buildView(&view->customers, old != NULL ? &old->customers : NULL, customers, customerKey)) {
+        free(view);
+        return false;
+    }
+    if (!buildView(&view->parts, old != NULL ? &old->parts : NULL, parts, partKey)) {
+        discardView(&view->customers, old != NULL ? &old->customers : NULL);
+        free(view);
+        return false;
+    }
+    view->version = old != NULL ? old->version + 1 : 1;
+
+    // Sections that see an epoch after this increment load the new version
+    published.store(view);
+    unsigned long long epoch = globalEpoch.fetch_add(1);
+
+    // The new version holds every change flagged so far
+    if (customers->chunkCapacity > 0) memset(customers->viewDirty, 0, (size_t)customers->chunkCapacity);
+    if (parts->chunkCapacity > 0) memset(parts->viewDirty, 0, (size_t)parts->chunkCapacity);
+
+    if (old != NULL) {
+        retireView(&old->customers, &view->customers, epoch);
+        retireView(&old->parts, &view->parts, epoch);
+        retire(old, false, epoch);
+    }
+    reclaim();
+    return true;
+}
+
+//
+// FUNCTION    : claimSlot
+// DESCRIPTION : Gives the calling thread a reader slot of its own
+// PARAMETERS  : None
+// RETURNS     : bool - false if every slot is in use
+//
+static bool claimSlot() {
+    for (int i = 0; i < VIEW_MAX_READERS; i++) {
+        bool expected = false;
+        if (!slotTaken[i].load() && slotTaken[i].compare_exchange_strong(expected, true)) {
+            readerSlot.slot = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+//
+// FUNCTION    : viewReadBegin
+// DESCRIPTION : Starts a read section and returns the current version. The
+//               version stays valid until viewReadEnd. Sections do not
+//               nest. A thread that finds no free slot reads under the
+//               publish lock instead.
+// PARAMETERS  : None
+// RETURNS     : const DataView* - Current version, NULL if none was published
+//
+const DataView* viewReadBegin() {
+    if (readerSlot.slot < 0 && !claimSlot()) {
+        publishMutex.lock();
+        readerSlot.slot = VIEW_LOCKED_SLOT;
+        return published.load();
+    }
+    readerEpochs[readerSlot.slot].store(globalEpoch.load());
+    return published.load();
+}
+
+//
+// FUNCTION    : viewReadEnd
+// DESCRIPTION : Ends the calling thread's read section
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void viewReadEnd() {
+    if (readerSlot.slot == VIEW_LOCKED_SLOT) {
+        readerSlot.slot = VIEW_NO_SLOT;
+        publishMutex.unlock();
+        return;
+    }
+    readerEpochs[readerSlot.slot].store(0);
+}
+
+//
+// FUNCTION    : viewFind
+// DESCRIPTION : Finds a record of a version by ID
+// PARAMETERS  :
+//      const StoreView* view : Version to search
+//      long long id          : Record ID
+// RETURNS     : const void* - Address of the record, NULL if not found
+//
+const void* viewFind(const StoreView* view, long long id) {
+    if (view->index == NULL) return NULL;
+    int position = idIndexFind(view->index, id);
+    if (position == IDINDEX_EMPTY && view->recent != NULL) position = idIndexFind(view->recent, id);
+    return position == IDINDEX_EMPTY ? NULL : viewAt(view, position);
+}
+
+//
+// FUNCTION    : viewFree
+// DESCRIPTION : Frees the current version and everything retired. Only
+//               called when no thread is inside a read section.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void viewFree() {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    DataView* view = published.exchange(nullptr);
+    if (view != NULL) {
+        freeView(&view->customers);
+        freeView(&view->parts);
+        free(view);
+    }
+    if (retiredReady) {
+        for (int i = 0; i < retired.count; i++) {
+            releaseBlock((const RetiredBlock*)storeAt(&retired, i));
+        }
+        storeClear(&retired);
+    }
+}
@@ -0,0 +1,68 @@
+/*
+* FILE          : StoreView.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for published read views of the customer and part
+*      stores including:
+*      - Read-only versions of both stores, published together
+*      - Epoch-based read sections that never take a lock
+*      - Function prototypes for publishing, reading and looking up records
+*      A writer changes the live stores as before and then publishes a new
+*      version. Only the chunks the writers flagged since the last publish
+*      are copied; the rest, and the ID index, are shared with the previous
+*      version, and appended IDs go into a small index of their own until
+*      there are enough of them to rebuild the main one. A reader sees the
+*      version that was current when its read section began, however long
+*      the writer takes, and an old version is freed once no read section
+*      can still be using it.
+*/
+
+#ifndef STOREVIEW_H
+#define STOREVIEW_H
+
+#include "RecordStore.h"
+#include "IdIndex.h"
+
+#define VIEW_MAX_READERS 256    // Threads that can be inside read sections without locking
+#define VIEW_MAX_RECENT STORE_CHUNK_RECORDS // Appended IDs kept apart before the index is rebuilt
+
+// Read-only version of one record store
+typedef struct {
+    unsigned char** chunks;     // Record chunks (STORE_CHUNK_RECORDS records each)
+    int chunkCount;             // Entries in chunks
+    size_t recordSize;          // Size of one record in bytes
+    int count;                  // Records in this version
+    IdIndex* index;             // ID to position of the first indexedCount records, shared while they are unchanged
+    int indexedCount;           // Records covered by index
+    IdIndex* recent;            // ID to position of the records after indexedCount, NULL if none
+} StoreView;
+
+// Versions of the customer and part stores published together
+typedef struct {
+    StoreView customers;
+    StoreView parts;
+    unsigned long long version; // Publish count, 1 for the first version
+} DataView;
+
+//
+// FUNCTION    : viewAt
+// DESCRIPTION : Returns a record of a published version
+// PARAMETERS  :
+//      const StoreView* view : Version to read
+//      int index            : Record position (0 to count-1)
+// RETURNS     : const void* - Address of the record
+//
+inline const void* viewAt(const StoreView* view, int index) {
+    return view->chunks[index >> STORE_CHUNK_SHIFT] + (size_t)(index & STORE_CHUNK_MASK) * view->recordSize;
+}
+
+// Function prototypes
+bool viewPublish(RecordStore* customers, RecordStore* parts); // Publish the live stores, false if out of memory
+const DataView* viewReadBegin();                    // Start a read section, returns the current version
+void viewReadEnd();                                 // End the read section
+const void* viewFind(const StoreView* view, long long id); // Record with an ID, NULL if absent
+void viewFree();                                    // Release every version (no readers left)
+
+#endif
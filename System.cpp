@@ -8,13 +8,20 @@
 *      - Menu display functions
 *      - System logging functionality
 *      - User interface helpers
+*      - Status messages held per thread while loads run side by side
+*      - Status messages dropped on threads serving requests
 */
 
 #include "System.h"
+#include "Logger.h"
+#include <stdarg.h>
 #include <string.h> 
 #include <stdio.h>
 #include <time.h>
 
+static thread_local HeldOutput* heldOutput = NULL;  // Where this thread's status messages go (NULL = stdout)
+static thread_local bool statusQuiet = false;       // This thread's status messages are dropped
+
 //
 // FUNCTION    : mainMenu
 // DESCRIPTION : Displays the main system menu options
@@ -85,28 +92,121 @@ void orderSubMenu() {
     printf("5. Load Order Database\n");
     printf("6. Save Order Database\n");
     printf("7. Return to Main Menu\n");
+    printf("8. Ingest Orders from Feed File\n");
     printf("---------------------------\n");
     printf("Select option: ");
 }
 
 //
 // FUNCTION    : logMessage
-// DESCRIPTION : Logs system messages to file with timestamp
+// DESCRIPTION : Logs system messages to file with timestamp. The message is
+//               queued for the background log writer, so the caller does
+//               no file I/O.
 // PARAMETERS  :
 //      const char* message : Message to log
 // RETURNS     : void
 //
 void logMessage(const char* message) {
-    FILE* logFile;
-    errno_t err = fopen_s(&logFile, "system.log", "a");
-    if (err == 0 && logFile != NULL) {
-        time_t now;
-        time(&now);
-        char timestamp[26];
-        ctime_s(timestamp, sizeof(timestamp), &now);
-        timestamp[strlen(timestamp) - 1] = '\0';
-
-        fprintf(logFile, "[%s] %s\n", timestamp, message);
-        fclose(logFile);
+    logEvent(LOG_EVENT_TEXT, message);
+}
+
+//
+// FUNCTION    : logEvent
+// DESCRIPTION : Logs one of the events in LogEvents.h. The arguments are the
+//               ones its format takes, as for printf; they are queued
+//               unformatted and turned into text by the log writer, or kept
+//               raw in the binary log for LogDecode.
+// PARAMETERS  :
+//      int eventId : LogEventId of the event
+//      ...         : Arguments of the event's format
+// RETURNS     : void
+//
+void logEvent(int eventId, ...) {
+    va_list arguments;
+    va_start(arguments, eventId);
+    loggerPost(eventId, arguments);
+    va_end(arguments);
+}
+
+//
+// FUNCTION    : statusPrintf
+// DESCRIPTION : Prints a status message as printf does, or adds it to the
+//               calling thread's held output (see holdOutput). Used by
+//               code that may run beside other work, such as the loaders,
+//               or for a service client, which gets a reply instead (see
+//               quietStatus). A message that does not fit is printed at once.
+// PARAMETERS  :
+//      const char* format : printf format
+//      ...                : Its arguments
+// RETURNS     : void
+//
+void statusPrintf(const char* format, ...) {
+    if (statusQuiet) return;
+
+    va_list arguments;
+    va_start(arguments, format);
+
+    HeldOutput* held = heldOutput;
+    if (held == NULL) {
+        vprintf(format, arguments);
+        va_end(arguments);
+        return;
+    }
+
+    size_t room = sizeof(held->text) - held->length;
+    int length = vsnprintf(held->text + held->length, room, format, arguments);
+    va_end(arguments);
+
+    if (length >= 0 && (size_t)length < room) {
+        held->length += (size_t)length;
+        return;
     }
-}
\ No newline at end of file
+    held->text[held->length] = '\0';
+    va_start(arguments, format);
+    vprintf(format, arguments);
+    va_end(arguments);
+}
+
+//
+// FUNCTION    : holdOutput
+// DESCRIPTION : Makes the calling thread's status messages go to a held
+//               output until the previous holder is restored. Tasks set
+//               their own and restore the previous one when they finish,
+//               so a task run while another waits keeps its messages apart.
+// PARAMETERS  :
+//      HeldOutput* held : Output to fill (empty), NULL to print directly
+// RETURNS     : HeldOutput* - The previous holder, to restore afterwards
+//
+HeldOutput* holdOutput(HeldOutput* held) {
+    HeldOutput* previous = heldOutput;
+    heldOutput = held;
+    return previous;
+}
+
+//
+// FUNCTION    : printHeldOutput
+// DESCRIPTION : Prints the messages held in an output and empties it
+// PARAMETERS  :
+//      HeldOutput* held : Output to print
+// RETURNS     : void
+//
+void printHeldOutput(HeldOutput* held) {
+    fwrite(held->text, 1, held->length, stdout);
+    held->length = 0;
+}
+
+//
+// FUNCTION    : quietStatus
+// DESCRIPTION : Drops or restores the calling thread's status messages.
+//               Service workers drop them: their clients get a reply, and
+//               the daemon's console would otherwise fill with a line per
+//               request written while the stores are locked.
+// PARAMETERS  :
+//      bool quiet : true to drop status messages
+// RETURNS     : bool - The previous setting, to restore afterwards
+//
+bool quietStatus(bool quiet) {
+    bool previous = statusQuiet;
+    statusQuiet = quiet;
+    return previous;
+}
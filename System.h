@@ -8,16 +8,35 @@
 *      - Main menu navigation
 *      - Submenu displays
 *      - System logging functionality
+*      - Status messages held back while loads run side by side
+*      - Status messages dropped on threads serving requests
 */
 
 #ifndef SYSTEM_H
 #define SYSTEM_H
 
+#include "LogEvents.h"
+#include <stddef.h>
+
+#define HELD_OUTPUT_BYTES 2048  // Status text one held output keeps before printing the rest directly
+
+// Status messages of one thread kept back to be printed later, so work
+// run side by side reports in a fixed order (see holdOutput)
+typedef struct {
+    char text[HELD_OUTPUT_BYTES];
+    size_t length;              // Bytes of text used
+} HeldOutput;
+
 // Function prototypes
 void mainMenu();             // Display main system menu
 void partsSubMenu();         // Display parts management submenu
 void customerSubMenu();      // Display customer management submenu
 void orderSubMenu();         // Display order management submenu
 void logMessage(const char* message);  // Log system messages to file
+void logEvent(int eventId, ...);       // Log an event with its raw arguments
+void statusPrintf(const char* format, ...);     // Print a status message (or hold it)
+HeldOutput* holdOutput(HeldOutput* held);       // Hold this thread's status messages
+void printHeldOutput(HeldOutput* held);         // Print and empty held messages
+bool quietStatus(bool quiet);                   // Drop this thread's status messages
 
 #endif
\ No newline at end of file
@@ -0,0 +1,445 @@
+/*
+* FILE          : TaskPool.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of the shared work-stealing task pool including:
+*      - One double-ended task queue per pool thread and a shared queue
+*        for tasks spawned by other threads
+*      - Pool threads that run their own tasks newest first and steal
+*        the oldest tasks of the other queues
+*      - Group waits that run queued tasks instead of blocking
+*      - Sleeping while no task is queued, with a wake-up counter so a
+*        spawn cannot be missed
+*      The pool starts on first use with poolThreads - 1 threads; the
+*      thread waiting for a group makes up the last one. With one thread
+*      every task runs on the thread that spawns it.
+*/
+
+#include "TaskPool.h"
+#include <stdlib.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// One queued task
+typedef struct {
+    TaskFunction run;
+    void* arg;
+    TaskGroup* group;
+} Task;
+
+// Ring of tasks. The owner adds and takes at the back; other threads
+// take from the front.
+typedef struct {
+    std::mutex lock;
+    Task* tasks;                // TASK_QUEUE_CAPACITY entries
+    int first;                  // Position of the oldest task
+    int count;                  // Tasks queued
+} TaskQueue;
+
+// Shared parallel loop over [0, count)
+typedef struct {
+    TaskGroup group;
+    std::atomic<int> next;      // First index of the next piece
+    int count;
+    int grain;                  // Indexes in one piece
+    TaskRangeFunction body;
+    void* arg;
+} TaskRange;
+
+int poolThreads = 0;
+
+static TaskQueue* queues = NULL;        // One per pool thread
+static TaskQueue* sharedQueue = NULL;   // Tasks spawned by other threads
+static int queueCount = 0;              // Entries in queues
+static std::thread* workers = NULL;     // Pool threads
+static int workerCount = 0;             // Pool threads started
+static std::atomic<bool> poolStarted(false);
+static std::atomic<bool> poolStopping(false);
+static bool stopAtExit = false;         // taskPoolStop is registered with atexit
+static std::mutex poolLock;             // Serializes starting and stopping the pool
+
+static std::mutex sleepLock;            // Guards sleeping on wakeUp
+static std::condition_variable wakeUp;
+static std::atomic<unsigned int> wakeCount(0);  // Changed by every spawn and finished group
+static std::atomic<int> sleepers(0);            // Threads sleeping on wakeUp
+
+static thread_local int workerIndex = -1;       // Queue of the current pool thread, -1 elsewhere
+
+//
+// FUNCTION    : pushTask
+// DESCRIPTION : Adds a task at the back of a queue
+// PARAMETERS  :
+//      TaskQueue* queue : Queue
+//      const Task* task : Task to add
+// RETURNS     : bool - false if the queue is full
+//
+static bool pushTask(TaskQueue* queue, const Task* task) {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    if (queue->count == TASK_QUEUE_CAPACITY) return false;
+    queue->tasks[(queue->first + queue->count) % TASK_QUEUE_CAPACITY] = *task;
+    queue->count++;
+    return true;
+}
+
+//
+// FUNCTION    : takeTask
+// DESCRIPTION : Removes the newest or the oldest task of a queue
+// PARAMETERS  :
+//      TaskQueue* queue : Queue
+//      bool newest      : true to take from the back, false from the front
+//      Task* task       : Receives the task
+// RETURNS     : bool - false if the queue is empty
+//
+static bool takeTask(TaskQueue* queue, bool newest, Task* task) {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    if (queue->count == 0) return false;
+    if (newest) {
+        *task = queue->tasks[(queue->first + queue->count - 1) % TASK_QUEUE_CAPACITY];
+    }
+    else {
+        *task = queue->tasks[queue->first];
+        queue->first = (queue->first + 1) % TASK_QUEUE_CAPACITY;
+    }
+    queue->count--;
+    return true;
+}
+
+//
+// FUNCTION    : findTask
+// DESCRIPTION : Finds a task for the current thread: its own newest task,
+//               then the oldest shared task, then the oldest task of
+//               another pool thread
+// PARAMETERS  :
+//      Task* task : Receives the task
+// RETURNS     : bool - false if every queue is empty
+//
+static bool findTask(Task* task) {
+    int self = workerIndex;
+
+    if (self >= 0 && takeTask(&queues[self], true, task)) return true;
+    if (takeTask(sharedQueue, false, task)) return true;
+
+    int start = self >= 0 ? self + 1 : 0;
+    for (int i = 0; i < queueCount; i++) {
+        int victim = (start + i) % queueCount;
+        if (victim != self && takeTask(&queues[victim], false, task)) return true;
+    }
+    return false;
+}
+
+//
+// FUNCTION    : signalPool
+// DESCRIPTION : Wakes sleeping threads after a spawn or a finished group
+// PARAMETERS  :
+//      bool everyone : true to wake all sleepers (group waits), false for one
+// RETURNS     : void
+//
+static void signalPool(bool everyone) {
+    wakeCount.fetch_add(1);
+    if (sleepers.load() == 0) return;
+
+    std::lock_guard<std::mutex> guard(sleepLock);
+    if (everyone) wakeUp.notify_all();
+    else wakeUp.notify_one();
+}
+
+//
+// FUNCTION    : sleepUntilSignal
+// DESCRIPTION : Sleeps unless the pool was signalled since seen was read
+// PARAMETERS  :
+//      unsigned int seen : wakeCount read before the queues were searched
+// RETURNS     : void
+//
+static void sleepUntilSignal(unsigned int seen) {
+    std::unique_lock<std::mutex> guard(sleepLock);
+    sleepers.fetch_add(1);
+    if (wakeCount.load() == seen && !poolStopping.load()) {
+        wakeUp.wait(guard);
+    }
+    sleepers.fetch_sub(1);
+}
+
+//
+// FUNCTION    : runTask
+// DESCRIPTION : Runs a task unless its group was cancelled, then counts it
+//               as finished. The group may be gone once the count reaches
+//               zero, so it is not touched after that.
+// PARAMETERS  :
+//      const Task* task : Task
+// RETURNS     : void
+//
+static void runTask(const Task* task) {
+    if (!task->group->cancelled.load(std::memory_order_relaxed)) {
+        task->run(task->arg);
+    }
+    if (task->group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        signalPool(true);
+    }
+}
+
+//
+// FUNCTION    : poolThread
+// DESCRIPTION : Pool thread. Runs tasks until the pool stops.
+// PARAMETERS  :
+//      int index : Queue of this thread
+// RETURNS     : void
+//
+static void poolThread(int index) {
+    Task task;
+    workerIndex = index;
+
+    while (!poolStopping.load()) {
+        unsigned int seen = wakeCount.load();
+        if (findTask(&task)) runTask(&task);
+        else sleepUntilSignal(seen);
+    }
+}
+
+//
+// FUNCTION    : startPool
+// DESCRIPTION : Starts the pool threads on first use. If some cannot be
+//               started the pool runs with the ones that did; their
+//               queues stay empty. Registers taskPoolStop to run at exit
+//               so no pool thread outlives the program's statics.
+// PARAMETERS  : None
+// RETURNS     : bool - true if the pool has at least one thread
+//
+static bool startPool() {
+    if (poolStarted.load(std::memory_order_acquire)) return workerCount > 0;
+
+    std::lock_guard<std::mutex> guard(poolLock);
+    if (poolStarted.load(std::memory_order_relaxed)) return workerCount > 0;
+
+    int threadCount = poolThreads > 0 ? poolThreads : (int)std::thread::hardware_concurrency();
+    int wanted = threadCount > 1 ? threadCount - 1 : 0;
+    bool ready = true;
+
+    queues = new TaskQueue[wanted + 1];
+    for (int i = 0; i <= wanted; i++) {
+        queues[i].tasks = (Task*)malloc(sizeof(Task) * TASK_QUEUE_CAPACITY);
+        queues[i].first = 0;
+        queues[i].count = 0;
+        if (queues[i].tasks == NULL) ready = false;
+    }
+
+    if (!ready) {
+        // Without memory for every queue all tasks run on their spawning thread
+        for (int i = 1; i <= wanted; i++) {
+            free(queues[i].tasks);
+        }
+        wanted = 0;
+    }
+
+    // Queues must be ready before any thread can steal from them
+    queueCount = wanted;
+    sharedQueue = &queues[wanted];
+    workers = new std::thread[queueCount];
+    workerCount = 0;
+    try {
+        for (; workerCount < queueCount; workerCount++) {
+            workers[workerCount] = std::thread(poolThread, workerCount);
+        }
+    }
+    catch (...) {
+    }
+
+    if (!stopAtExit) {
+        atexit(taskPoolStop);
+        stopAtExit = true;
+    }
+    poolStarted.store(true, std::memory_order_release);
+    return workerCount > 0;
+}
+
+//
+// FUNCTION    : taskGroupInit
+// DESCRIPTION : Prepares an empty group
+// PARAMETERS  :
+//      TaskGroup* group : Group to initialize
+// RETURNS     : void
+//
+void taskGroupInit(TaskGroup* group) {
+    group->pending = 0;
+    group->cancelled = false;
+}
+
+//
+// FUNCTION    : taskSpawn
+// DESCRIPTION : Queues a task in a group. A pool thread queues it on its
+//               own queue, any other thread on the shared queue. With no
+//               pool threads, or a full queue, the task runs at once.
+// PARAMETERS  :
+//      TaskGroup* group : Group of the task
+//      TaskFunction run : Function to run
+//      void* arg        : Argument passed to run
+// RETURNS     : void
+//
+void taskSpawn(TaskGroup* group, TaskFunction run, void* arg) {
+    Task task = { run, arg, group };
+    group->pending.fetch_add(1, std::memory_order_relaxed);
+
+    if (!startPool() || !pushTask(workerIndex >= 0 ? &queues[workerIndex] : sharedQueue, &task)) {
+        runTask(&task);
+        return;
+    }
+    signalPool(false);
+}
+
+//
+// FUNCTION    : taskGroupWait
+// DESCRIPTION : Returns once every task of a group has finished, running
+//               queued tasks (of any group) on this thread meanwhile
+// PARAMETERS  :
+//      TaskGroup* group : Group
+// RETURNS     : void
+//
+void taskGroupWait(TaskGroup* group) {
+    Task task;
+
+    while (group->pending.load(std::memory_order_acquire) > 0) {
+        unsigned int seen = wakeCount.load();
+        if (findTask(&task)) runTask(&task);
+        else if (group->pending.load(std::memory_order_acquire) > 0) sleepUntilSignal(seen);
+    }
+}
+
+//
+// FUNCTION    : taskGroupCancel
+// DESCRIPTION : Cancels a group. Its tasks that have not started are
+//               skipped; running tasks can stop early by checking
+//               taskGroupCancelled. The group must still be waited for.
+// PARAMETERS  :
+//      TaskGroup* group : Group
+// RETURNS     : void
+//
+void taskGroupCancel(TaskGroup* group) {
+    group->cancelled.store(true, std::memory_order_relaxed);
+}
+
+//
+// FUNCTION    : taskGroupCancelled
+// DESCRIPTION : Tells whether a group was cancelled
+// PARAMETERS  :
+//      const TaskGroup* group : Group
+// RETURNS     : bool - true once taskGroupCancel was called
+//
+bool taskGroupCancelled(const TaskGroup* group) {
+    return group->cancelled.load(std::memory_order_relaxed);
+}
+
+//
+// FUNCTION    : taskRunShared
+// DESCRIPTION : Runs a worker loop on the calling thread and as width - 1
+//               tasks, and waits for all of them. The loop must share out
+//               its work itself (e.g. an atomic counter) and must not wait
+//               for the other copies, since they may only start once it
+//               has finished.
+// PARAMETERS  :
+//      TaskGroup* group  : Empty group used for the copies
+//      int width         : Copies to run, including the caller's
+//      TaskFunction work : Worker loop
+//      void* arg         : Argument passed to work
+// RETURNS     : void
+//
+void taskRunShared(TaskGroup* group, int width, TaskFunction work, void* arg) {
+    for (int i = 1; i < width; i++) {
+        taskSpawn(group, work, arg);
+    }
+    if (!taskGroupCancelled(group)) work(arg);
+    taskGroupWait(group);
+}
+
+//
+// FUNCTION    : runRange
+// DESCRIPTION : Worker loop of a parallel loop. Takes pieces until none
+//               are left.
+// PARAMETERS  :
+//      void* arg : TaskRange
+// RETURNS     : void
+//
+static void runRange(void* arg) {
+    TaskRange* range = (TaskRange*)arg;
+    int first;
+
+    while ((first = range->next.fetch_add(range->grain)) < range->count) {
+        int last = first + range->grain < range->count ? first + range->grain : range->count;
+        range->body(range->arg, first, last);
+    }
+}
+
+//
+// FUNCTION    : taskParallelFor
+// DESCRIPTION : Runs a loop body over [0, count) in pieces of grain
+//               indexes, on up to width threads. Every piece starts at a
+//               multiple of grain, whatever the number of threads.
+// PARAMETERS  :
+//      int count              : Number of indexes
+//      int grain              : Indexes in one piece (at least 1)
+//      int width              : Threads to use (0 = the whole pool)
+//      TaskRangeFunction body : Runs one piece
+//      void* arg              : Argument passed to body
+// RETURNS     : void
+//
+void taskParallelFor(int count, int grain, int width, TaskRangeFunction body, void* arg) {
+    int pieces = (count + grain - 1) / grain;
+
+    if (pieces <= 1) width = 1;
+    else if (width <= 0) width = taskPoolThreads();
+    if (width > pieces) width = pieces;
+
+    TaskRange range;
+    taskGroupInit(&range.group);
+    range.next = 0;
+    range.count = count;
+    range.grain = grain;
+    range.body = body;
+    range.arg = arg;
+
+    taskRunShared(&range.group, width, runRange, &range);
+}
+
+//
+// FUNCTION    : taskPoolThreads
+// DESCRIPTION : Returns the number of threads that run tasks, counting the
+//               thread that waits. Starts the pool if needed.
+// PARAMETERS  : None
+// RETURNS     : int - Pool threads plus one
+//
+int taskPoolThreads() {
+    startPool();
+    return workerCount + 1;
+}
+
+//
+// FUNCTION    : taskPoolStop
+// DESCRIPTION : Stops and releases the pool threads. No task may be queued
+//               or running. The next use starts the pool again, so a new
+//               poolThreads value takes effect.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void taskPoolStop() {
+    std::lock_guard<std::mutex> guard(poolLock);
+    if (!poolStarted.load()) return;
+
+    poolStopping = true;
+    signalPool(true);
+    for (int i = 0; i < workerCount; i++) {
+        workers[i].join();
+    }
+    for (int i = 0; i <= queueCount; i++) {
+        free(queues[i].tasks);
+    }
+    delete[] workers;
+    delete[] queues;
+    workers = NULL;
+    queues = NULL;
+    sharedQueue = NULL;
+    queueCount = 0;
+    workerCount = 0;
+    poolStopping = false;
+    poolStarted = false;
+}
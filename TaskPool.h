@@ -0,0 +1,54 @@
+/*
+* FILE          : TaskPool.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for the shared work-stealing task pool including:
+*      - Task groups for fork-join work, with cancellation
+*      - Pool size setting shared by every parallel feature
+*      - Function prototypes for spawning, waiting and parallel loops
+*      Each pool thread has its own task queue: it runs its newest task
+*      first and idle threads steal the oldest tasks of the others. Tasks
+*      spawned by other threads go to a shared queue. A thread waiting for
+*      a group runs queued tasks until the group is done, so tasks may
+*      spawn and wait for their own groups.
+*      Loading, end of day, search and reports run on the pool. Ingest
+*      stages and service workers block on I/O and keep their own threads.
+*/
+
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <atomic>
+
+#define TASK_QUEUE_CAPACITY 1024    // Tasks one queue holds; a spawn into a full queue runs at once
+
+// Function run by a task
+typedef void (*TaskFunction)(void* arg);
+
+// Function run on a range [first, last) of a parallel loop
+typedef void (*TaskRangeFunction)(void* arg, int first, int last);
+
+// Tasks spawned together and waited for together. Initialize with
+// taskGroupInit; it must outlive its tasks (taskGroupWait returns).
+typedef struct {
+    std::atomic<int> pending;       // Tasks spawned and not yet finished
+    std::atomic<bool> cancelled;    // Tasks not yet started are skipped
+} TaskGroup;
+
+extern int poolThreads;         // Threads running tasks, including a waiting caller (0 = one per core)
+
+// Function prototypes
+void taskGroupInit(TaskGroup* group);                           // Prepare an empty group
+void taskSpawn(TaskGroup* group, TaskFunction run, void* arg);  // Queue a task in a group
+void taskGroupWait(TaskGroup* group);                           // Run tasks until the group is done
+void taskGroupCancel(TaskGroup* group);                         // Skip the group's unstarted tasks
+bool taskGroupCancelled(const TaskGroup* group);                // true once the group was cancelled
+void taskRunShared(TaskGroup* group, int width, TaskFunction work, void* arg); // Run a worker loop width times at once
+void taskParallelFor(int count, int grain, int width, TaskRangeFunction body,
+    void* arg);                                                 // Run body over [0, count) in pieces
+int taskPoolThreads();                                          // Threads that run tasks (starts the pool)
+void taskPoolStop();                                            // Stop the pool threads (no tasks running)
+
+#endif
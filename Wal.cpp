@@ -0,0 +1,845 @@
+/*
+* FILE          : Wal.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of the write-ahead log including:
+*      - Record buffering shared by every thread that changes a store
+*      - Background thread writing and syncing the buffered records
+*      - Group commit: every waiting thread is released by one sync
+*      - Start-up replay that stops at the first damaged record
+*      - Dropping the records a background checkpoint has saved
+*      Records are appended to one buffer while the flusher thread writes
+*      the other, so logging a change never waits for the disk. Only
+*      walCommit does.
+*/
+
+#include "Wal.h"
+#include "DbReader.h"
+#include "FileIo.h"
+#include "System.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Growable byte buffer holding encoded records
+typedef struct {
+    char* data;
+    size_t length;              // Bytes used
+    size_t capacity;            // Bytes allocated
+} WalBuffer;
+
+// Body of a WAL_CUSTOMER_BALANCE record
+typedef struct {
+    int customerID;
+    float accountBalance;
+} WalBalance;
+
+// Body of a WAL_PART_STOCK record
+typedef struct {
+    int partID;
+    int quantityOnHand;
+    int partStatus;
+} WalStock;
+
+// Body of a WAL_ORDER_STATUS record
+typedef struct {
+    long long orderID;
+    int orderStatus;
+    int reserved;               // Zero
+} WalStatus;
+
+static std::mutex walLock;                  // Guards everything below except durableBytes
+static std::condition_variable walWork;     // Wakes the flusher
+static std::condition_variable walDone;     // Wakes threads waiting for a write
+static std::thread walFlusher;
+static FILE* walFile = NULL;
+static WalBuffer walBuffers[2];             // Records being appended, records being written
+static int pendingBuffer = 0;               // Index of the buffer records are appended to
+static unsigned long long appendedBytes = 0;    // Log position after the last record appended
+static unsigned long long fileBase = 0;         // Log position of the first record in the file
+static unsigned long long requestedBytes = 0;   // Bytes a committing thread is waiting for
+static bool walFlushing = false;            // The flusher is writing outside the lock
+static bool walFailed = false;              // A write or buffer failed; commits fail until a checkpoint
+static bool walStopping = false;
+static bool walReported = false;            // The failure message was printed
+static bool walOpen = false;                // walRecover started the flusher
+static std::atomic<bool> walActive(false);  // The log is open for appending
+static std::atomic<unsigned long long> durableBytes(0); // Log position up to which records are on disk
+
+static thread_local unsigned long long lastAppended = 0;    // End of this thread's last record
+static thread_local bool recordsDropped = false;            // One of this thread's records could not be logged
+static thread_local int groupDepth = 0;                     // Nesting of walGroupBegin calls
+static thread_local WalBuffer groupBuffer;                  // Records of this thread's open group
+
+//
+// FUNCTION    : walReserve
+// DESCRIPTION : Makes room for more bytes at the end of a buffer
+// PARAMETERS  :
+//      WalBuffer* buffer : Buffer to grow
+//      size_t bytes      : Bytes about to be added
+// RETURNS     : bool - false if out of memory (the buffer is unchanged)
+//
+static bool walReserve(WalBuffer* buffer, size_t bytes) {
+    if (buffer->length + bytes <= buffer->capacity) return true;
+
+    size_t capacity = buffer->capacity > 0 ? buffer->capacity * 2 : 64 * 1024;
+    while (capacity < buffer->length + bytes) capacity *= 2;
+
+    char* data = (char*)realloc(buffer->data, capacity);
+    if (data == NULL) return false;
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+//
+// FUNCTION    : walHeaderChecksum
+// DESCRIPTION : Checksum of a log header with its own checksum field zeroed
+// PARAMETERS  :
+//      const WalHeader* header : Header to check
+// RETURNS     : unsigned long long - Checksum
+//
+static unsigned long long walHeaderChecksum(const WalHeader* header) {
+    WalHeader copy = *header;
+    copy.headerChecksum = 0;
+    return checksumBlock(&copy, sizeof(copy));
+}
+
+//
+// FUNCTION    : walMakeHeader
+// DESCRIPTION : Fills in the header for logs written by this build
+// PARAMETERS  :
+//      WalHeader* header : Receives the header
+// RETURNS     : void
+//
+static void walMakeHeader(WalHeader* header) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, WAL_MAGIC, sizeof(header->magic));
+    header->version = WAL_VERSION;
+    header->customerSize = (unsigned int)sizeof(Customer);
+    header->partSize = (unsigned int)sizeof(Parts);
+    header->orderSize = (unsigned int)sizeof(Order);
+    header->lineSize = (unsigned int)sizeof(OrderItem);
+    header->headerChecksum = walHeaderChecksum(header);
+}
+
+//
+// FUNCTION    : walReportFailure
+// DESCRIPTION : Tells the user once that changes are no longer protected
+//               by the log. Called with walLock held.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+static void walReportFailure() {
+    if (walReported) return;
+    walReported = true;
+    printf("Changes could not be written to %s; save to keep them.\n", WAL_FILE);
+    logMessage("Write-ahead log failed");
+}
+
+//
+// FUNCTION    : walWrite
+// DESCRIPTION : Encodes one record (header, body and an optional second
+//               part of the body). Inside a group it goes to the thread's
+//               group; otherwise it is added to the shared buffer and the
+//               flusher is woken once a full buffer is waiting.
+// PARAMETERS  :
+//      WalRecordType type : Kind of record
+//      const void* body   : Start of the body
+//      size_t length      : Bytes at body
+//      const void* extra  : Rest of the body (NULL for none)
+//      size_t extraLength : Bytes at extra
+// RETURNS     : void
+//
+static void walWrite(WalRecordType type, const void* body, size_t length, const void* extra, size_t extraLength) {
+    if (!walActive.load(std::memory_order_acquire)) return;
+
+    WalRecordHeader header;
+    header.checksum = 0;
+    header.type = (unsigned int)type;
+    header.length = (unsigned int)(length + extraLength);
+    size_t size = sizeof(header) + header.length;
+
+    if (groupDepth > 0) {
+        if (groupBuffer.length == 0 || !walReserve(&groupBuffer, size)) {
+            recordsDropped = true;
+            return;
+        }
+        char* record = groupBuffer.data + groupBuffer.length;
+        memcpy(record, &header, sizeof(header));
+        memcpy(record + sizeof(header), body, length);
+        if (extraLength > 0) memcpy(record + sizeof(header) + length, extra, extraLength);
+        groupBuffer.length += size;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(walLock);
+    WalBuffer* pending = &walBuffers[pendingBuffer];
+    if (walFailed || !walReserve(pending, size)) {
+        recordsDropped = true;
+        return;
+    }
+
+    char* record = pending->data + pending->length;
+    memcpy(record, &header, sizeof(header));
+    memcpy(record + sizeof(header), body, length);
+    if (extraLength > 0) memcpy(record + sizeof(header) + length, extra, extraLength);
+    header.checksum = checksumBlock(record + sizeof(header.checksum), size - sizeof(header.checksum));
+    memcpy(record, &header.checksum, sizeof(header.checksum));
+
+    pending->length += size;
+    appendedBytes += size;
+    lastAppended = appendedBytes;
+    if (pending->length >= WAL_FLUSH_BYTES) walWork.notify_one();
+}
+
+//
+// FUNCTION    : flushLoop
+// DESCRIPTION : Flusher thread. Whenever a thread is waiting to commit or
+//               a full buffer is pending, swaps the buffers and writes and
+//               syncs the records outside the lock (one linked submission
+//               with io_uring), then releases every thread whose records
+//               are now on disk.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+static void flushLoop() {
+    std::unique_lock<std::mutex> lock(walLock);
+    while (true) {
+        walWork.wait(lock, [] {
+            const WalBuffer* pending = &walBuffers[pendingBuffer];
+            return walStopping || (pending->length > 0 &&
+                (requestedBytes > durableBytes.load() || pending->length >= WAL_FLUSH_BYTES));
+        });
+
+        WalBuffer* writing = &walBuffers[pendingBuffer];
+        if (writing->length == 0) break;    // Stopping with nothing left to write
+
+        pendingBuffer = 1 - pendingBuffer;
+        unsigned long long end = appendedBytes;
+        walFlushing = true;
+        lock.unlock();
+
+        bool written = walFile != NULL && ioAppendSync(walFile, writing->data, writing->length);
+
+        lock.lock();
+        writing->length = 0;
+        walFlushing = false;
+        if (written) durableBytes.store(end, std::memory_order_release);
+        else walFailed = true;
+        walDone.notify_all();
+    }
+}
+
+//
+// FUNCTION    : walCommit
+// DESCRIPTION : Waits until every record the calling thread has logged is
+//               on disk. Threads committing at the same time are released
+//               by the same write.
+// PARAMETERS  : None
+// RETURNS     : bool - false if the records could not be logged or
+//               written (a message is printed once)
+//
+bool walCommit() {
+    if (recordsDropped) {
+        recordsDropped = false;
+        std::lock_guard<std::mutex> lock(walLock);
+        walReportFailure();
+        return false;
+    }
+
+    unsigned long long target = lastAppended;
+    if (durableBytes.load(std::memory_order_acquire) >= target) return true;
+
+    std::unique_lock<std::mutex> lock(walLock);
+    if (!walOpen) return true;
+    if (requestedBytes < target) requestedBytes = target;
+    walWork.notify_one();
+    walDone.wait(lock, [target] { return durableBytes.load() >= target || walFailed; });
+
+    if (durableBytes.load() >= target) return true;
+    walReportFailure();
+    return false;
+}
+
+//
+// FUNCTION    : walGroupBegin
+// DESCRIPTION : Starts collecting the calling thread's records so they are
+//               logged together by walGroupEnd. Groups may nest; only the
+//               outermost end logs them.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void walGroupBegin() {
+    if (groupDepth++ > 0) return;
+    groupBuffer.length = 0;
+
+    // Room for the header of the group record; without it the group's
+    // records are dropped and the next commit fails
+    if (walActive.load(std::memory_order_acquire) && walReserve(&groupBuffer, sizeof(WalRecordHeader))) {
+        groupBuffer.length = sizeof(WalRecordHeader);
+    }
+}
+
+//
+// FUNCTION    : walGroupEnd
+// DESCRIPTION : Logs the records collected since walGroupBegin as one
+//               WAL_GROUP record, which is replayed all or not at all
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void walGroupEnd() {
+    if (groupDepth == 0 || --groupDepth > 0) return;
+
+    size_t body = groupBuffer.length > sizeof(WalRecordHeader) ? groupBuffer.length - sizeof(WalRecordHeader) : 0;
+    if (body > 0) {
+        WalRecordHeader header;
+        header.type = WAL_GROUP;
+        header.length = (unsigned int)body;
+        memcpy(groupBuffer.data + sizeof(header.checksum), &header.type, sizeof(header) - sizeof(header.checksum));
+        header.checksum = checksumBlock(groupBuffer.data + sizeof(header.checksum),
+            groupBuffer.length - sizeof(header.checksum));
+        memcpy(groupBuffer.data, &header.checksum, sizeof(header.checksum));
+
+        std::lock_guard<std::mutex> lock(walLock);
+        WalBuffer* pending = &walBuffers[pendingBuffer];
+        if (!walFailed && walReserve(pending, groupBuffer.length)) {
+            memcpy(pending->data + pending->length, groupBuffer.data, groupBuffer.length);
+            pending->length += groupBuffer.length;
+            appendedBytes += groupBuffer.length;
+            lastAppended = appendedBytes;
+            if (pending->length >= WAL_FLUSH_BYTES) walWork.notify_one();
+        }
+        else {
+            recordsDropped = true;
+        }
+    }
+
+    free(groupBuffer.data);
+    groupBuffer.data = NULL;
+    groupBuffer.length = 0;
+    groupBuffer.capacity = 0;
+}
+
+//
+// FUNCTION    : walLogCustomer
+// DESCRIPTION : Logs a customer that was added or had its details changed
+// PARAMETERS  :
+//      const Customer* c : Customer as it is now
+// RETURNS     : void
+//
+void walLogCustomer(const Customer* c) {
+    walWrite(WAL_CUSTOMER, c, sizeof(*c), NULL, 0);
+}
+
+//
+// FUNCTION    : walLogCustomerBalance
+// DESCRIPTION : Logs a customer's account balance
+// PARAMETERS  :
+//      const Customer* c : Customer as it is now
+// RETURNS     : void
+//
+void walLogCustomerBalance(const Customer* c) {
+    WalBalance balance = { c->customerID, c->accountBalance };
+    walWrite(WAL_CUSTOMER_BALANCE, &balance, sizeof(balance), NULL, 0);
+}
+
+//
+// FUNCTION    : walLogPart
+// DESCRIPTION : Logs a part that was added
+// PARAMETERS  :
+//      const Parts* part : Part as it is now
+// RETURNS     : void
+//
+void walLogPart(const Parts* part) {
+    walWrite(WAL_PART, part, sizeof(*part), NULL, 0);
+}
+
+//
+// FUNCTION    : walLogPartStock
+// DESCRIPTION : Logs a part's quantity on hand and status
+// PARAMETERS  :
+//      const Parts* part : Part as it is now
+// RETURNS     : void
+//
+void walLogPartStock(const Parts* part) {
+    WalStock stock = { part->PartID, part->QuantityOnHand, part->PartStatus };
+    walWrite(WAL_PART_STOCK, &stock, sizeof(stock), NULL, 0);
+}
+
+//
+// FUNCTION    : walLogOrder
+// DESCRIPTION : Logs an order that was added, followed by its lines. The
+//               lines are copied out one by one since they may cross a
+//               chunk of the line arena.
+// PARAMETERS  :
+//      const Order* order : Order as it is now
+// RETURNS     : void
+//
+void walLogOrder(const Order* order) {
+    OrderItem lines[MAX_PARTS_PER_ORDER];
+    int count = order->DistinctParts < MAX_PARTS_PER_ORDER ? order->DistinctParts : MAX_PARTS_PER_ORDER;
+    for (int j = 0; j < count; j++) lines[j] = *orderLine(order, j);
+    walWrite(WAL_ORDER, order, sizeof(*order), lines, (size_t)count * sizeof(OrderItem));
+}
+
+//
+// FUNCTION    : walLogOrderStatus
+// DESCRIPTION : Logs an order's status
+// PARAMETERS  :
+//      const Order* order : Order as it is now
+// RETURNS     : void
+//
+void walLogOrderStatus(const Order* order) {
+    WalStatus status = { order->OrderID, order->OrderStatus, 0 };
+    walWrite(WAL_ORDER_STATUS, &status, sizeof(status), NULL, 0);
+}
+
+//
+// FUNCTION    : walLogReload
+// DESCRIPTION : Logs that a store was replaced by importing its text
+//               database, which replay repeats
+// PARAMETERS  :
+//      SnapshotKind store : Store that was imported
+// RETURNS     : void
+//
+void walLogReload(SnapshotKind store) {
+    unsigned int kind = (unsigned int)store;
+    walWrite(WAL_RELOAD, &kind, sizeof(kind), NULL, 0);
+}
+
+//
+// FUNCTION    : replayRecord
+// DESCRIPTION : Applies one logged change to the stores. Added records
+//               replace a record with the same ID if there is one, so a
+//               change applied twice has the same effect as once.
+// PARAMETERS  :
+//      unsigned int type      : WalRecordType
+//      const char* body       : Record body
+//      size_t length          : Bytes in the body
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : bool - false if the record is malformed or could not be
+//               applied
+//
+static bool replayRecord(unsigned int type, const char* body, size_t length, RecordStore* customers,
+    RecordStore* parts, RecordStore* orders) {
+    switch (type) {
+    case WAL_CUSTOMER: {
+        Customer c;
+        if (length != sizeof(c)) return false;
+        memcpy(&c, body, sizeof(c));
+
+        int i = findCustomer(customers, c.customerID);
+        Customer* slot = i != -1 ? customerAt(customers, i) : (Customer*)storeAppend(customers);
+        if (slot == NULL) return false;
+        *slot = c;
+        if (i != -1) storeMarkDirty(customers, i);
+        return true;
+    }
+    case WAL_CUSTOMER_BALANCE: {
+        WalBalance balance;
+        if (length != sizeof(balance)) return false;
+        memcpy(&balance, body, sizeof(balance));
+
+        int i = findCustomer(customers, balance.customerID);
+        if (i != -1) {
+            customerAt(customers, i)->accountBalance = balance.accountBalance;
+            storeMarkDirty(customers, i);
+        }
+        return true;
+    }
+    case WAL_PART: {
+        Parts part;
+        if (length != sizeof(part)) return false;
+        memcpy(&part, body, sizeof(part));
+
+        int i = findPart(parts, part.PartID);
+        Parts* slot = i != -1 ? partAt(parts, i) : (Parts*)storeAppend(parts);
+        if (slot == NULL) return false;
+        *slot = part;
+        if (i != -1) storeMarkDirty(parts, i);
+        return true;
+    }
+    case WAL_PART_STOCK: {
+        WalStock stock;
+        if (length != sizeof(stock)) return false;
+        memcpy(&stock, body, sizeof(stock));
+
+        int i = findPart(parts, stock.partID);
+        if (i != -1) {
+            partAt(parts, i)->QuantityOnHand = stock.quantityOnHand;
+            partAt(parts, i)->PartStatus = stock.partStatus;
+            storeMarkDirty(parts, i);
+        }
+        return true;
+    }
+    case WAL_ORDER: {
+        Order order;
+        if (length < sizeof(order)) return false;
+        memcpy(&order, body, sizeof(order));
+        if (order.DistinctParts < 1 || order.DistinctParts > MAX_PARTS_PER_ORDER ||
+            length != sizeof(order) + (size_t)order.DistinctParts * sizeof(OrderItem)) return false;
+
+        OrderItem items[MAX_PARTS_PER_ORDER];
+        memcpy(items, body + sizeof(order), (size_t)order.DistinctParts * sizeof(OrderItem));
+        return replayOrder(orders, &order, items);
+    }
+    case WAL_ORDER_STATUS: {
+        WalStatus status;
+        if (length != sizeof(status)) return false;
+        memcpy(&status, body, sizeof(status));
+
+        replayOrderStatus(orders, status.orderID, status.orderStatus);
+        return true;
+    }
+    case WAL_RELOAD: {
+        unsigned int kind;
+        if (length != sizeof(kind)) return false;
+        memcpy(&kind, body, sizeof(kind));
+
+        if (kind == SNAPSHOT_CUSTOMERS) loadCustomers(customers);
+        else if (kind == SNAPSHOT_PARTS) loadfromfile("parts.db", parts);
+        else if (kind == SNAPSHOT_ORDERS) loadOrderFromFile(orders, customers);
+        else return false;
+        return true;
+    }
+    case WAL_GROUP: {
+        size_t offset = 0;
+        while (offset < length) {
+            WalRecordHeader header;
+            if (length - offset < sizeof(header)) return false;
+            memcpy(&header, body + offset, sizeof(header));
+            offset += sizeof(header);
+            if (header.type == WAL_GROUP || length - offset < header.length ||
+                !replayRecord(header.type, body + offset, header.length, customers, parts, orders)) return false;
+            offset += header.length;
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+//
+// FUNCTION    : replayLog
+// DESCRIPTION : Applies the records of a mapped log in order, stopping at
+//               the first record that is cut short or fails its checksum
+// PARAMETERS  :
+//      const MappedFile* file : Mapped log (header already checked)
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+//      int* replayed          : Receives the number of records applied
+// RETURNS     : size_t - Bytes of the file holding valid records, including
+//               the header
+//
+static size_t replayLog(const MappedFile* file, RecordStore* customers, RecordStore* parts,
+    RecordStore* orders, int* replayed) {
+    size_t offset = sizeof(WalHeader);
+    *replayed = 0;
+
+    while (file->size - offset >= sizeof(WalRecordHeader)) {
+        WalRecordHeader header;
+        memcpy(&header, file->data + offset, sizeof(header));
+        size_t size = sizeof(header) + header.length;
+        if (file->size - offset < size) break;
+
+        const char* record = file->data + offset;
+        if (checksumBlock(record + sizeof(header.checksum), size - sizeof(header.checksum)) != header.checksum) break;
+        if (!replayRecord(header.type, record + sizeof(header), header.length, customers, parts, orders)) {
+            printf("Could not replay a change from %s; later changes were not replayed.\n", WAL_FILE);
+            break;
+        }
+
+        offset += size;
+        (*replayed)++;
+    }
+    return offset;
+}
+
+//
+// FUNCTION    : truncateFile
+// DESCRIPTION : Cuts an open file to a length and syncs it
+// PARAMETERS  :
+//      FILE* fp      : File opened for writing
+//      size_t length : New length in bytes
+// RETURNS     : bool - true on success
+//
+static bool truncateFile(FILE* fp, size_t length) {
+    if (fflush(fp) != 0) return false;
+#ifdef _WIN32
+    if (_chsize_s(_fileno(fp), (long long)length) != 0) return false;
+#else
+    if (ftruncate(fileno(fp), (off_t)length) != 0) return false;
+#endif
+    return syncFile(fp);
+}
+
+//
+// FUNCTION    : walRecover
+// DESCRIPTION : Replays pwh.wal on top of the loaded stores, drops any
+//               damaged tail left by a crash, and opens the log for the
+//               changes that follow. A log written by another build is
+//               moved to pwh.wal.old. Call once, after loading.
+// PARAMETERS  :
+//      RecordStore* customers : Customer store
+//      RecordStore* parts     : Part store
+//      RecordStore* orders    : Order store
+// RETURNS     : void
+//
+void walRecover(RecordStore* customers, RecordStore* parts, RecordStore* orders) {
+    WalHeader expected;
+    walMakeHeader(&expected);
+
+    size_t validBytes = 0;
+    size_t fileBytes = 0;
+    MappedFile file;
+    if (mapDbFile(&file, WAL_FILE)) {
+        fileBytes = file.size;
+        if (file.size >= sizeof(WalHeader) && memcmp(file.data, &expected, sizeof(expected)) == 0) {
+            int replayed = 0;
+            validBytes = replayLog(&file, customers, parts, orders, &replayed);
+            if (replayed > 0) {
+                printf("Replayed %d changes from %s\n", replayed, WAL_FILE);
+                logMessage("Write-ahead log replayed");
+            }
+        }
+        unmapDbFile(&file);
+
+        if (validBytes == 0 && fileBytes > 0) {
+            remove(WAL_OLD_FILE);
+            if (rename(WAL_FILE, WAL_OLD_FILE) == 0) {
+                printf("%s is damaged or from another version; moved it to %s\n", WAL_FILE, WAL_OLD_FILE);
+            }
+            fileBytes = 0;
+        }
+    }
+
+    FILE* fp = NULL;
+    errno_t err = fopen_s(&fp, WAL_FILE, "ab");
+    if (err != 0 || fp == NULL) {
+        printf("Could not open %s; changes are only kept by saving.\n", WAL_FILE);
+        return;
+    }
+
+    bool ready;
+    if (validBytes == 0) {
+        ready = truncateFile(fp, 0) && fwrite(&expected, sizeof(expected), 1, fp) == 1 && syncFile(fp);
+    }
+    else {
+        if (validBytes < fileBytes) {
+            printf("Dropped %zu bytes of an incomplete change from %s\n", fileBytes - validBytes, WAL_FILE);
+        }
+        ready = validBytes == fileBytes || truncateFile(fp, validBytes);
+    }
+    if (!ready) {
+        fclose(fp);
+        printf("Could not prepare %s; changes are only kept by saving.\n", WAL_FILE);
+        return;
+    }
+
+    // Positions continue from the records kept in the file
+    std::lock_guard<std::mutex> lock(walLock);
+    walFile = fp;
+    fileBase = 0;
+    appendedBytes = validBytes > sizeof(WalHeader) ? validBytes - sizeof(WalHeader) : 0;
+    requestedBytes = appendedBytes;
+    durableBytes.store(appendedBytes, std::memory_order_release);
+    walOpen = true;
+    walStopping = false;
+    walFlusher = std::thread(flushLoop);
+    walActive.store(true, std::memory_order_release);
+    atexit(walClose);
+}
+
+//
+// FUNCTION    : walCheckpoint
+// DESCRIPTION : Empties the log once every store has been saved to its
+//               snapshot. Everything logged must have been committed
+//               before the snapshots were written, so a crash before the
+//               log is emptied replays the whole log over the new
+//               snapshots. Clears an earlier write failure.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void walCheckpoint() {
+    std::unique_lock<std::mutex> lock(walLock);
+    if (!walOpen) return;
+    walDone.wait(lock, [] { return !walFlushing; });
+
+    walBuffers[pendingBuffer].length = 0;
+    fileBase = appendedBytes;
+    if (walFile != NULL && truncateFile(walFile, sizeof(WalHeader))) {
+        walFailed = false;
+        walReported = false;
+    }
+    else {
+        walFailed = true;
+    }
+    durableBytes.store(appendedBytes, std::memory_order_release);
+    requestedBytes = appendedBytes;
+    walDone.notify_all();
+}
+
+//
+// FUNCTION    : walPosition
+// DESCRIPTION : Returns the log position after the last record appended.
+//               Read it while no thread can change a store, and every
+//               change made before is logged before that position.
+// PARAMETERS  : None
+// RETURNS     : unsigned long long - Log position
+//
+unsigned long long walPosition() {
+    std::lock_guard<std::mutex> lock(walLock);
+    return appendedBytes;
+}
+
+//
+// FUNCTION    : walLength
+// DESCRIPTION : Returns how many bytes of records a restart would replay
+// PARAMETERS  : None
+// RETURNS     : unsigned long long - Bytes of records in the log
+//
+unsigned long long walLength() {
+    std::lock_guard<std::mutex> lock(walLock);
+    return appendedBytes - fileBase;
+}
+
+//
+// FUNCTION    : copyLogTail
+// DESCRIPTION : Copies the records written to the log file from a log
+//               position on to another file. Called with walLock held and
+//               the flusher idle.
+// PARAMETERS  :
+//      FILE* out                   : File receiving the records
+//      unsigned long long position : First log position copied
+//      unsigned long long end      : Log position where the file ends
+// RETURNS     : bool - true on success
+//
+static bool copyLogTail(FILE* out, unsigned long long position, unsigned long long end) {
+    FILE* in = NULL;
+    errno_t err = fopen_s(&in, WAL_FILE, "rb");
+    if (err != 0 || in == NULL) return false;
+
+    bool copied = _fseeki64(in, (long long)(sizeof(WalHeader) + position - fileBase), SEEK_SET) == 0;
+    static char block[64 * 1024];
+    while (copied && position < end) {
+        size_t want = end - position < sizeof(block) ? (size_t)(end - position) : sizeof(block);
+        copied = fread(block, 1, want, in) == want && fwrite(block, 1, want, out) == want;
+        position += want;
+    }
+
+    fclose(in);
+    return copied;
+}
+
+//
+// FUNCTION    : walCheckpointAt
+// DESCRIPTION : Drops the records before a log position once snapshots
+//               holding every change up to it were saved. The records
+//               after it are copied to a new log that replaces the old
+//               one, so a crash at any point leaves a log that replays
+//               over either set of snapshots. Nothing is dropped after a
+//               write failure or when a later full checkpoint already
+//               emptied the log.
+// PARAMETERS  :
+//      unsigned long long position : walPosition when the snapshots were taken
+// RETURNS     : bool - true if the log now starts at the position
+//
+bool walCheckpointAt(unsigned long long position) {
+    std::unique_lock<std::mutex> lock(walLock);
+    if (!walOpen || walFile == NULL) return false;
+    walDone.wait(lock, [] { return !walFlushing; });
+    if (walFailed) return false;
+    if (position <= fileBase) return true;
+
+    // The file holds [fileBase, written); the pending buffer the rest
+    unsigned long long written = durableBytes.load();
+    WalHeader header;
+    walMakeHeader(&header);
+
+    const char* temp = WAL_FILE SNAPSHOT_TEMP_SUFFIX;
+    FILE* out = NULL;
+    errno_t err = fopen_s(&out, temp, "wb");
+    if (err != 0 || out == NULL) return false;
+
+    bool ready = fwrite(&header, sizeof(header), 1, out) == 1 &&
+        (position >= written || copyLogTail(out, position, written));
+    ready = syncFile(out) && ready;
+    fclose(out);
+    if (!ready) {
+        remove(temp);
+        return false;
+    }
+
+    // The open log must be closed before it can be replaced on Windows
+    fclose(walFile);
+    walFile = NULL;
+    bool replaced = replaceFile(temp, WAL_FILE);
+    if (!replaced) remove(temp);
+
+    err = fopen_s(&walFile, WAL_FILE, "ab");
+    if (err != 0 || walFile == NULL) {
+        walFile = NULL;
+        walFailed = true;
+        walDone.notify_all();
+        return false;
+    }
+    if (!replaced) return false;
+
+    // Records still buffered before the position are in the snapshots
+    if (position > written) {
+        WalBuffer* pending = &walBuffers[pendingBuffer];
+        size_t drop = (size_t)(position - written);
+        memmove(pending->data, pending->data + drop, pending->length - drop);
+        pending->length -= drop;
+        durableBytes.store(position, std::memory_order_release);
+        walDone.notify_all();
+    }
+    fileBase = position;
+    return true;
+}
+
+//
+// FUNCTION    : walClose
+// DESCRIPTION : Writes and syncs whatever is still buffered, stops the
+//               flusher and closes the log. Safe to call more than once.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void walClose() {
+    {
+        std::lock_guard<std::mutex> lock(walLock);
+        if (!walOpen) return;
+        walOpen = false;
+        walActive.store(false, std::memory_order_release);
+        walStopping = true;
+        walWork.notify_one();
+    }
+    walFlusher.join();
+
+    std::lock_guard<std::mutex> lock(walLock);
+    if (walFile != NULL) fclose(walFile);
+    walFile = NULL;
+    for (int i = 0; i < 2; i++) {
+        free(walBuffers[i].data);
+        walBuffers[i].data = NULL;
+        walBuffers[i].length = 0;
+        walBuffers[i].capacity = 0;
+    }
+}
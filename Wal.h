@@ -0,0 +1,88 @@
+/*
+* FILE          : Wal.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for the write-ahead log including:
+*      - Log file layout and record types
+*      - Function prototypes for logging changes, committing them and
+*        replaying the log at start-up
+*      Every change to a store is appended to pwh.wal as a small record
+*      holding the new value of what changed, keyed by record ID. Records
+*      are buffered in memory and a background thread writes and syncs
+*      them; walCommit waits until the calling thread's changes are on
+*      disk, so changes committed at the same time share one sync.
+*      Saving the snapshots empties the log; a background checkpoint
+*      drops only the records before the point it saved. At start-up the log is
+*      replayed on top of what was loaded; replaying a record twice gives
+*      the same result, so a crash during a save loses nothing.
+*      Changes that must survive together (an end-of-day run) are logged
+*      as one group and replayed all or not at all.
+*/
+
+#ifndef WAL_H
+#define WAL_H
+
+#include "Order.h"
+#include "Snapshot.h"
+
+#define WAL_FILE "pwh.wal"              // Log of changes since the last snapshot save
+#define WAL_OLD_FILE "pwh.wal.old"      // Where a log from another build is moved aside
+#define WAL_MAGIC "PWHWAL1"             // First 8 bytes of the log (with terminator)
+#define WAL_VERSION 1                   // Bumped whenever the record layout changes
+#define WAL_FLUSH_BYTES (1024 * 1024)   // Buffered bytes that start a write without a commit
+
+// Kinds of log record
+typedef enum {
+    WAL_CUSTOMER = 1,           // Customer added or edited (whole record)
+    WAL_CUSTOMER_BALANCE = 2,   // Customer account balance
+    WAL_PART = 3,               // Part added (whole record)
+    WAL_PART_STOCK = 4,         // Part quantity on hand and status
+    WAL_ORDER = 5,              // Order added (record and its lines)
+    WAL_ORDER_STATUS = 6,       // Order status
+    WAL_RELOAD = 7,             // Store imported from its text database
+    WAL_GROUP = 8               // Records replayed all or not at all
+} WalRecordType;
+
+// Log file header, followed by records until the end of the file. Record
+// bodies are raw structs, so the log is only valid for the build that
+// wrote it; the sizes guard against replaying another layout.
+typedef struct {
+    char magic[8];                  // WAL_MAGIC
+    unsigned int version;           // WAL_VERSION
+    unsigned int customerSize;      // sizeof(Customer)
+    unsigned int partSize;          // sizeof(Parts)
+    unsigned int orderSize;         // sizeof(Order)
+    unsigned int lineSize;          // sizeof(OrderItem)
+    unsigned int reserved;          // Zero
+    unsigned long long headerChecksum; // Checksum of this header with this field zero
+} WalHeader;
+
+// Header of one record; the body of length bytes follows. The checksum
+// covers the type, length and body (records inside a group have none).
+typedef struct {
+    unsigned long long checksum;
+    unsigned int type;              // WalRecordType
+    unsigned int length;            // Bytes in the body
+} WalRecordHeader;
+
+// Function prototypes
+void walRecover(RecordStore* customers, RecordStore* parts, RecordStore* orders); // Replay the log and start logging
+bool walCommit();                                           // Wait until this thread's changes are on disk
+void walCheckpoint();                                       // Empty the log after every snapshot was saved
+bool walCheckpointAt(unsigned long long position);          // Drop the records before a saved position
+unsigned long long walPosition();                           // Log position after the last record
+unsigned long long walLength();                             // Bytes of records a restart would replay
+void walClose();                                            // Write what is buffered and close the log
+void walGroupBegin();                                       // Start collecting this thread's records as a group
+void walGroupEnd();                                         // Log the collected records as one group
+void walLogCustomer(const Customer* c);                     // Log a customer added or edited
+void walLogCustomerBalance(const Customer* c);              // Log a customer's balance
+void walLogPart(const Parts* part);                         // Log a part added
+void walLogPartStock(const Parts* part);                    // Log a part's quantity and status
+void walLogOrder(const Order* order);                       // Log an order added, with its lines
+void walLogOrderStatus(const Order* order);                 // Log an order's status
+void walLogReload(SnapshotKind store);                      // Log a store imported from text
+
+#endif
@@ -0,0 +1,304 @@
+/*
+* FILE          : Warmup.cpp
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS   : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Implementation of lazy start-up warming including:
+*      - Queue of mapped files opened when they are mapped
+*      - Background thread faulting each mapping in a step at a time
+*      - Checksum check of each file, stopping the program if one fails
+*      Each file is opened when it is queued, so the check reads the file
+*      that was mapped even if a save has replaced it since.
+*/
+
+#include "Warmup.h"
+#include "RecordStore.h"
+#include "System.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// File queued for warming and checking
+typedef struct {
+    char filename[FILENAME_MAX];
+    int fd;                     // Open descriptor of the file as mapped
+    char* live;                 // Mapping the program uses (NULL if only checked)
+    size_t liveBytes;
+    WarmupCheck check;          // NULL if only warmed
+    long long context;          // Passed to check
+    bool rebuildable;           // Derived from other files; removed instead of stopping if damaged
+    bool damaged;               // Found damaged, not yet reported by warmupRebuildNeeded
+} WarmupFile;
+
+bool lazyStart = false;
+
+static std::mutex warmupLock;                   // Guards the queue, warmupStarted and warmupRunning
+static std::condition_variable warmupDone;      // Wakes threads waiting for the check
+static std::thread warmupThread;
+static RecordStore warmupFiles = { NULL, 0, 0, sizeof(WarmupFile), 0, NULL, NULL, 0, NULL, 0 };
+static bool warmupStarted = false;              // warmupStart was called (no more files queued)
+static bool warmupRunning = false;              // The thread has files left to check
+static std::atomic<bool> warmupStopping(false);
+static std::atomic<int> warmupDamaged(0);       // Damaged rebuildable files not yet reported
+
+//
+// FUNCTION    : lazyStartAvailable
+// DESCRIPTION : Tells whether snapshots can be mapped at start-up here. On
+//               Windows a mapped file cannot be replaced, which every save
+//               does, so lazy start is POSIX only.
+// PARAMETERS  : None
+// RETURNS     : bool - true if pwh -l maps the snapshots
+//
+bool lazyStartAvailable() {
+#ifdef _WIN32
+    return false;
+#else
+    return true;
+#endif
+}
+
+#ifndef _WIN32
+//
+// FUNCTION    : faultIn
+// DESCRIPTION : Reads a mapping into memory WARMUP_STEP_BYTES at a time,
+//               so records are in memory before they are first used.
+//               Falls back to a read-ahead hint on kernels without
+//               MADV_POPULATE_READ. Stops early when asked to.
+// PARAMETERS  :
+//      char* data   : Start of the mapping (page aligned)
+//      size_t bytes : Length of the mapping
+// RETURNS     : void
+//
+static void faultIn(char* data, size_t bytes) {
+    for (size_t done = 0; done < bytes && !warmupStopping; done += WARMUP_STEP_BYTES) {
+        size_t step = bytes - done < WARMUP_STEP_BYTES ? bytes - done : WARMUP_STEP_BYTES;
+#ifdef MADV_POPULATE_READ
+        if (madvise(data + done, step, MADV_POPULATE_READ) == 0) continue;
+#endif
+        madvise(data + done, step, MADV_WILLNEED);
+    }
+}
+
+//
+// FUNCTION    : checkFile
+// DESCRIPTION : Maps a queued file read-only and runs its check
+// PARAMETERS  :
+//      const WarmupFile* file : File to check
+// RETURNS     : bool - false if the file could not be read or is damaged
+//
+static bool checkFile(const WarmupFile* file) {
+    struct stat info;
+    if (fstat(file->fd, &info) != 0) return false;
+    if (info.st_size == 0) return file->check(NULL, 0, file->context);
+
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, file->fd, 0);
+    if (data == MAP_FAILED) return false;
+
+    bool intact = file->check((const char*)data, (size_t)info.st_size, file->context);
+    munmap(data, (size_t)info.st_size);
+    return intact;
+}
+#endif
+
+//
+// FUNCTION    : warmLoop
+// DESCRIPTION : Warm-up thread. Faults in and checks every queued file in
+//               turn. A damaged snapshot stops the program: records from
+//               it may already be in use, and saving them would replace
+//               the damaged file's good copies on disk. A damaged index is
+//               removed and flagged for its owner to rebuild.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+static void warmLoop() {
+#ifndef _WIN32
+    for (int i = 0; i < warmupFiles.count && !warmupStopping; i++) {
+        WarmupFile* file = (WarmupFile*)storeAt(&warmupFiles, i);
+        if (file->live != NULL) faultIn(file->live, file->liveBytes);
+
+        if (file->check != NULL && !warmupStopping && !checkFile(file)) {
+            if (file->rebuildable) {
+                // Only if no save has replaced it since it was queued
+                struct stat queued, current;
+                if (fstat(file->fd, &queued) == 0 && stat(file->filename, &current) == 0
+                    && queued.st_ino == current.st_ino && queued.st_dev == current.st_dev) {
+                    remove(file->filename);
+                }
+                logMessage("Lazy start found a damaged index; it is rebuilt from the records");
+                std::lock_guard<std::mutex> lock(warmupLock);
+                file->damaged = true;
+                warmupDamaged++;
+                continue;
+            }
+            printf("%s is damaged; restart without -l to load the text databases.\n", file->filename);
+            fflush(stdout);
+            logMessage("Lazy start found a damaged snapshot");
+            _Exit(EXIT_FAILURE);
+        }
+    }
+#endif
+
+    std::lock_guard<std::mutex> lock(warmupLock);
+    warmupRunning = false;
+    warmupDone.notify_all();
+}
+
+//
+// FUNCTION    : warmupAdd
+// DESCRIPTION : Queues a mapped file to be faulted in and checked once
+//               warmupStart is called. The file is opened now. The
+//               stores load side by side, so this may be called from
+//               several threads.
+// PARAMETERS  :
+//      const char* filename : File that was mapped
+//      void* live           : Start of the program's mapping of it (page
+//                             aligned), NULL to only check the file
+//      size_t liveBytes     : Length of that mapping
+//      WarmupCheck check    : Check of the file's contents, NULL for none
+//      long long context    : Passed to check
+//      bool rebuildable     : The file is derived from others (an index);
+//                             if damaged it is removed and reported by
+//                             warmupRebuildNeeded instead of stopping
+// RETURNS     : bool - false if the file could not be opened or warming
+//               has already started (the caller should load eagerly)
+//
+bool warmupAdd(const char* filename, void* live, size_t liveBytes, WarmupCheck check, long long context,
+    bool rebuildable) {
+#ifdef _WIN32
+    (void)filename; (void)live; (void)liveBytes; (void)check; (void)context; (void)rebuildable;
+    return false;
+#else
+    std::lock_guard<std::mutex> lock(warmupLock);
+    if (warmupStarted) return false;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+
+    WarmupFile* file = (WarmupFile*)storeAppend(&warmupFiles);
+    if (file == NULL) {
+        close(fd);
+        return false;
+    }
+    strcpy_s(file->filename, sizeof(file->filename), filename);
+    file->fd = fd;
+    file->live = (char*)live;
+    file->liveBytes = liveBytes;
+    file->check = check;
+    file->context = context;
+    file->rebuildable = rebuildable;
+    file->damaged = false;
+    return true;
+#endif
+}
+
+//
+// FUNCTION    : warmupRebuildNeeded
+// DESCRIPTION : Tells the owner of a rebuildable file that the warm-up
+//               check found it damaged, so it stops using the mapping and
+//               rebuilds from the records. Each damaged file is reported
+//               once. Cheap while nothing is damaged, so lookups can ask.
+// PARAMETERS  :
+//      const char* filename : File as queued
+// RETURNS     : bool - true the first time after the file failed its check
+//
+bool warmupRebuildNeeded(const char* filename) {
+    if (warmupDamaged.load() == 0) return false;
+
+    std::lock_guard<std::mutex> lock(warmupLock);
+    for (int i = 0; i < warmupFiles.count; i++) {
+        WarmupFile* file = (WarmupFile*)storeAt(&warmupFiles, i);
+        if (file->damaged && strcmp(file->filename, filename) == 0) {
+            file->damaged = false;
+            warmupDamaged--;
+            return true;
+        }
+    }
+    return false;
+}
+
+//
+// FUNCTION    : warmupRebuildPending
+// DESCRIPTION : Tells without locking whether some rebuildable file was
+//               found damaged and not yet reported, so callers that must
+//               lock their stores to rebuild can skip that otherwise
+// PARAMETERS  : None
+// RETURNS     : bool - true if warmupRebuildNeeded has something to report
+//
+bool warmupRebuildPending() {
+    return warmupDamaged.load() != 0;
+}
+
+//
+// FUNCTION    : warmupStart
+// DESCRIPTION : Starts the warm-up thread on the files queued so far. Call
+//               once, after loading. Does nothing if none were queued.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void warmupStart() {
+    std::lock_guard<std::mutex> lock(warmupLock);
+    if (warmupStarted) return;
+    warmupStarted = true;
+    if (warmupFiles.count == 0) return;
+
+    warmupRunning = true;
+    warmupStopping = false;
+    warmupThread = std::thread(warmLoop);
+    atexit(warmupStop);
+}
+
+//
+// FUNCTION    : warmupWait
+// DESCRIPTION : Waits until every queued file has been checked. Returns at
+//               once when nothing was mapped; if a file is damaged the
+//               program stops instead of returning.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void warmupWait() {
+    std::unique_lock<std::mutex> lock(warmupLock);
+    warmupDone.wait(lock, [] { return !warmupRunning; });
+}
+
+//
+// FUNCTION    : warmupFinished
+// DESCRIPTION : Tells without waiting whether every queued file has been
+//               checked, for callers that would rather try again later
+// PARAMETERS  : None
+// RETURNS     : bool - true if warmupWait would return at once
+//
+bool warmupFinished() {
+    std::lock_guard<std::mutex> lock(warmupLock);
+    return !warmupRunning;
+}
+
+//
+// FUNCTION    : warmupStop
+// DESCRIPTION : Stops the warm-up thread between steps and closes the
+//               queued files. Safe to call more than once.
+// PARAMETERS  : None
+// RETURNS     : void
+//
+void warmupStop() {
+    warmupStopping = true;
+    if (warmupThread.joinable()) warmupThread.join();
+
+#ifndef _WIN32
+    for (int i = 0; i < warmupFiles.count; i++) {
+        close(((WarmupFile*)storeAt(&warmupFiles, i))->fd);
+    }
+#endif
+    storeFree(&warmupFiles);
+}
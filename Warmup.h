@@ -0,0 +1,51 @@
+/*
+* FILE          : Warmup.h
+* PROJECT       : PWH Warehouse Management System
+* PROGRAMMERS    : Najaf Ali, Che-Ping Chien, Nadil Devnath Ranasinghe, Xinming Xu
+* FIRST VERSION : 2026-10-17
+* DESCRIPTION   :
+*      Header file for lazy start-up including:
+*      - Lazy start setting (pwh -l)
+*      - Background thread warming and checking mapped files
+*      - Function prototypes for queueing files and waiting for the check
+*      With lazy start the snapshots are mapped copy-on-write instead of
+*      read (mapSnapshot) and the record ID indexes are mapped from the
+*      .idx files saved beside them (idIndexMap), so start-up only reads
+*      their headers and its time does not depend on the size of the
+*      stores. Records are read from disk when first used. The warm-up
+*      thread then faults the rest of every mapping in and checks each
+*      file's checksums, which the eager load checks before it starts.
+*      Saves, checkpoints and exports wait for the check, so a damaged
+*      file is never written back. A damaged snapshot stops the program
+*      with a message and the next start without -l imports the text
+*      databases instead; a damaged index file is removed and its owner
+*      rebuilds the index from the records (warmupRebuildNeeded). Not
+*      available on Windows, which cannot replace a snapshot while it is
+*      mapped; -l loads normally there.
+*/
+
+#ifndef WARMUP_H
+#define WARMUP_H
+
+#include <stddef.h>
+
+#define WARMUP_STEP_BYTES (8 << 20)     // Bytes faulted in between checks for a stop request
+
+// Checks the contents of a queued file. Runs on the warm-up thread over a
+// read-only mapping of the file as it was when queued.
+typedef bool (*WarmupCheck)(const char* data, size_t size, long long context);
+
+extern bool lazyStart;          // Map snapshots and indexes at start-up (pwh -l)
+
+// Function prototypes
+bool lazyStartAvailable();                                  // Lazy start works on this platform
+bool warmupAdd(const char* filename, void* live, size_t liveBytes,
+    WarmupCheck check, long long context, bool rebuildable); // Queue a mapped file to warm and check
+bool warmupRebuildNeeded(const char* filename);             // A rebuildable file was found damaged
+bool warmupRebuildPending();                                 // Some damaged file is not yet reported
+void warmupStart();                                         // Start warming the queued files
+void warmupWait();                                          // Wait until every queued file is checked
+bool warmupFinished();                                      // Every queued file is checked
+void warmupStop();                                          // Stop warming (at exit)
+
+#endif